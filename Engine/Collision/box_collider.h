@@ -13,33 +13,33 @@ namespace Engine {
         BoxCollider(const XMFLOAT3& center, const XMFLOAT3& size);
         ~BoxCollider() override = default;
 
-        // Rs[E[u
+        // コピー・ムーブ
         BoxCollider(const BoxCollider& other);
         BoxCollider& operator=(const BoxCollider& other);
         BoxCollider(BoxCollider&& other) noexcept = default;
         BoxCollider& operator=(BoxCollider&& other) noexcept = default;
 
-        // Collider
+        // Collider実装
         ColliderType GetType() const override { return ColliderType::BOX; }
         bool Intersects(const Collider* other) const override;
         XMFLOAT3 GetCenter() const override;
         void GetBounds(XMFLOAT3& outMin, XMFLOAT3& outMax) const override;
 
-        // ݒ
+        // 設定
         void SetCenter(const XMFLOAT3& center);
         void SetSize(const XMFLOAT3& size);
         void SetTransform(const XMFLOAT3& position, const XMFLOAT3& rotation, const XMFLOAT3& scale);
 
-        // 擾
+        // 取得
         XMFLOAT3 GetSize() const { return m_size; }
         XMFLOAT3 GetMin() const { return m_worldMin; }
         XMFLOAT3 GetMax() const { return m_worldMax; }
 
-        // 
+        // 判定
         bool Contains(const XMFLOAT3& point) const;
         bool ComputePenetration(const BoxCollider* other, XMFLOAT3& outPenetration) const;
 
-        // t@Ng
+        // ファクトリ
         static std::unique_ptr<BoxCollider> Create(const XMFLOAT3& center, const XMFLOAT3& size);
 
     private:
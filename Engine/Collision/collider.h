@@ -1,6 +1,6 @@
 #pragma once
 
-#include <DirectXMath.h>
+#include "Engine/Core/math_types.h"
 
 namespace Engine {
     using namespace DirectX;
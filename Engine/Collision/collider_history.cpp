@@ -0,0 +1,168 @@
+#include "pch.h"
+#include "collider_history.h"
+#include <cmath>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Engine {
+
+    void ColliderHistory::Clear() {
+        m_head = 0;
+        m_count = 0;
+    }
+
+    void ColliderHistory::BeginTick(double time) {
+        // 満杯なら最も古いティックを上書きする
+        if (m_count == MAX_TICKS) {
+            m_head = (m_head + 1) % MAX_TICKS;
+            --m_count;
+        }
+        Tick& tick = m_ticks[(m_head + m_count) % MAX_TICKS];
+        tick.time = time;
+        tick.mask = 0;
+        ++m_count;
+    }
+
+    void ColliderHistory::Record(int slot, const XMFLOAT3& min, const XMFLOAT3& max) {
+        if (m_count == 0 || slot < 0 || slot >= MAX_SLOTS) return;
+        Tick& tick = m_ticks[(m_head + m_count - 1) % MAX_TICKS];
+        tick.minX[slot] = min.x; tick.minY[slot] = min.y; tick.minZ[slot] = min.z;
+        tick.maxX[slot] = max.x; tick.maxY[slot] = max.y; tick.maxZ[slot] = max.z;
+        tick.mask |= 1ull << slot;
+    }
+
+    double ColliderHistory::OldestTime() const {
+        return m_count > 0 ? At(0).time : 0.0;
+    }
+
+    double ColliderHistory::NewestTime() const {
+        return m_count > 0 ? At(m_count - 1).time : 0.0;
+    }
+
+    bool ColliderHistory::Find(double time, Sample& out) const {
+        if (m_count == 0) return false;
+
+        const Tick& oldest = At(0);
+        const Tick& newest = At(m_count - 1);
+        if (time <= oldest.time) {
+            out = { &oldest, &oldest, 0.0f, oldest.mask };
+            return true;
+        }
+        if (time >= newest.time) {
+            out = { &newest, &newest, 0.0f, newest.mask };
+            return true;
+        }
+
+        // time以下で最も新しいティックを二分探索する（時刻は古い順に並んでいる）
+        int lo = 0, hi = m_count - 1;
+        while (hi - lo > 1) {
+            int mid = (lo + hi) / 2;
+            if (At(mid).time <= time) lo = mid;
+            else hi = mid;
+        }
+        const Tick& a = At(lo);
+        const Tick& b = At(hi);
+        out = { &a, &b, (float)((time - a.time) / (b.time - a.time)), a.mask | b.mask };
+        return true;
+    }
+
+    int ColliderHistory::LowestSlot(uint64_t mask) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, mask);
+        return (int)index;
+#else
+        return __builtin_ctzll(mask);
+#endif
+    }
+
+    void ColliderHistory::Lerp(const Sample& s, int slot, XMFLOAT3& outMin, XMFLOAT3& outMax) {
+        const uint64_t bit = 1ull << slot;
+        const Tick* a = (s.a->mask & bit) ? s.a : s.b;
+        const Tick* b = (s.b->mask & bit) ? s.b : s.a;
+        const float t = s.t;
+        outMin.x = a->minX[slot] + (b->minX[slot] - a->minX[slot]) * t;
+        outMin.y = a->minY[slot] + (b->minY[slot] - a->minY[slot]) * t;
+        outMin.z = a->minZ[slot] + (b->minZ[slot] - a->minZ[slot]) * t;
+        outMax.x = a->maxX[slot] + (b->maxX[slot] - a->maxX[slot]) * t;
+        outMax.y = a->maxY[slot] + (b->maxY[slot] - a->maxY[slot]) * t;
+        outMax.z = a->maxZ[slot] + (b->maxZ[slot] - a->maxZ[slot]) * t;
+    }
+
+    bool ColliderHistory::GetBounds(int slot, double time, XMFLOAT3& outMin, XMFLOAT3& outMax) const {
+        if (slot < 0 || slot >= MAX_SLOTS) return false;
+        Sample s;
+        if (!Find(time, s) || !(s.mask & (1ull << slot))) return false;
+        Lerp(s, slot, outMin, outMax);
+        return true;
+    }
+
+    int ColliderHistory::OverlapBox(double time, const XMFLOAT3& min, const XMFLOAT3& max,
+        int ignoreSlot) const {
+        Sample s;
+        if (!Find(time, s)) return -1;
+
+        // 記録のあるスロットだけを回る（64スロットでも居る人数分で済む）
+        uint64_t mask = s.mask;
+        if (ignoreSlot >= 0 && ignoreSlot < MAX_SLOTS) mask &= ~(1ull << ignoreSlot);
+        for (; mask != 0; mask &= mask - 1) {
+            const int slot = LowestSlot(mask);
+            XMFLOAT3 bmin, bmax;
+            Lerp(s, slot, bmin, bmax);
+            if (min.x <= bmax.x && max.x >= bmin.x &&
+                min.y <= bmax.y && max.y >= bmin.y &&
+                min.z <= bmax.z && max.z >= bmin.z) {
+                return slot;
+            }
+        }
+        return -1;
+    }
+
+    int ColliderHistory::Raycast(double time, const XMFLOAT3& origin, const XMFLOAT3& dir,
+        float maxDist, int ignoreSlot, float& outDist) const {
+        Sample s;
+        if (!Find(time, s)) return -1;
+
+        // 軸ごとの逆数（0方向はその軸の板の内側にあるかだけで決まる）
+        const float o[3] = { origin.x, origin.y, origin.z };
+        const float d[3] = { dir.x, dir.y, dir.z };
+        float inv[3];
+        for (int i = 0; i < 3; ++i) inv[i] = (std::fabs(d[i]) > 1e-8f) ? 1.0f / d[i] : 0.0f;
+
+        int hitSlot = -1;
+        float nearest = maxDist;
+        uint64_t mask = s.mask;
+        if (ignoreSlot >= 0 && ignoreSlot < MAX_SLOTS) mask &= ~(1ull << ignoreSlot);
+        for (; mask != 0; mask &= mask - 1) {
+            const int slot = LowestSlot(mask);
+            XMFLOAT3 bmin, bmax;
+            Lerp(s, slot, bmin, bmax);
+            const float lo[3] = { bmin.x, bmin.y, bmin.z };
+            const float hi[3] = { bmax.x, bmax.y, bmax.z };
+
+            // スラブ法
+            float tEnter = 0.0f, tExit = nearest;
+            bool miss = false;
+            for (int i = 0; i < 3 && !miss; ++i) {
+                if (inv[i] == 0.0f) {
+                    miss = (o[i] < lo[i] || o[i] > hi[i]);
+                    continue;
+                }
+                float t0 = (lo[i] - o[i]) * inv[i];
+                float t1 = (hi[i] - o[i]) * inv[i];
+                if (t0 > t1) { float tmp = t0; t0 = t1; t1 = tmp; }
+                if (t0 > tEnter) tEnter = t0;
+                if (t1 < tExit) tExit = t1;
+                miss = (tEnter > tExit);
+            }
+            if (!miss) {
+                nearest = tEnter;
+                hitSlot = slot;
+            }
+        }
+        if (hitSlot >= 0) outDist = nearest;
+        return hitSlot;
+    }
+
+} // namespace Engine
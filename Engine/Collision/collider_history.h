@@ -0,0 +1,75 @@
+#pragma once
+
+#include "box_collider.h"
+#include <cstdint>
+
+namespace Engine {
+
+    // ============================================================
+    // ColliderHistory
+    // ティックごとのAABBを固定長のリングに記録し、過去の時刻で当たり判定する
+    // （ラグ補償: 撃った側が見ていた時点の位置に戻して判定する）
+    //
+    // 1ティック分を成分ごとの配列（minX[スロット]...）で持つので、
+    // 記録はコピーだけ、判定は同じ配列を順に読むだけで済む。確保は一切しない。
+    // 指定時刻が2つの記録の間なら線形補間した箱を使う。
+    // ============================================================
+    class ColliderHistory {
+    public:
+        // 記録できるスロット数（スロット番号 = プレイヤーID - 1など）
+        static const int MAX_SLOTS = 64;
+        // 保持するティック数（60Hzで約1秒）
+        static const int MAX_TICKS = 64;
+
+        void Clear();
+
+        // 1ティック分の記録を始める（time: 秒、前回より新しいこと）
+        void BeginTick(double time);
+        // 現在のティックにスロットの箱を記録する（記録しなかったスロットはそのティックに居ない扱い）
+        void Record(int slot, const XMFLOAT3& min, const XMFLOAT3& max);
+
+        // 記録の範囲（空なら0）
+        double OldestTime() const;
+        double NewestTime() const;
+        bool Empty() const { return m_count == 0; }
+
+        // time時点のスロットの箱（範囲外の時刻は端の記録に丸める）
+        bool GetBounds(int slot, double time, XMFLOAT3& outMin, XMFLOAT3& outMax) const;
+
+        // time時点で箱と重なるスロット（ignoreSlotは除く）、無ければ-1
+        int OverlapBox(double time, const XMFLOAT3& min, const XMFLOAT3& max, int ignoreSlot) const;
+
+        // time時点でレイ（ヒットスキャン）が最初に当たるスロット、無ければ-1
+        // dirは正規化済み、outDistに当たった距離を返す
+        int Raycast(double time, const XMFLOAT3& origin, const XMFLOAT3& dir, float maxDist,
+            int ignoreSlot, float& outDist) const;
+
+    private:
+        struct Tick {
+            double time = 0.0;
+            uint64_t mask = 0;   // 記録したスロットのビット
+            float minX[MAX_SLOTS], minY[MAX_SLOTS], minZ[MAX_SLOTS];
+            float maxX[MAX_SLOTS], maxY[MAX_SLOTS], maxZ[MAX_SLOTS];
+        };
+
+        // timeを挟む2つのティックと補間係数（a == b ならその記録をそのまま使う）
+        struct Sample {
+            const Tick* a;
+            const Tick* b;
+            float t;
+            uint64_t mask;
+        };
+
+        bool Find(double time, Sample& out) const;
+        static void Lerp(const Sample& s, int slot, XMFLOAT3& outMin, XMFLOAT3& outMax);
+        // maskの最下位の立っているビットの位置（maskは0でないこと）
+        static int LowestSlot(uint64_t mask);
+
+        const Tick& At(int i) const { return m_ticks[(m_head + i) % MAX_TICKS]; }
+
+        Tick m_ticks[MAX_TICKS];
+        int m_head = 0;    // 最も古いティックの位置
+        int m_count = 0;
+    };
+
+} // namespace Engine
@@ -1,6 +1,9 @@
 #include "pch.h"
 #include "map_collision.h"
 #include <cmath>
+#include <cfloat>
+#include <cstdlib>
+#include <utility>
 
 namespace Engine {
 
@@ -88,6 +91,72 @@ namespace Engine {
         return false;
     }
 
+    bool MapCollision::IsSegmentBlocked(const XMFLOAT3& from, const XMFLOAT3& to) const {
+        if (m_grid.empty()) return false;
+
+        const float o[3] = { from.x, from.y, from.z };
+        const float d[3] = { to.x - from.x, to.y - from.y, to.z - from.z };
+
+        // 線分とブロックのAABBの交差（スラブ法、t は 0-1）
+        auto hitsBlock = [&](const BoxCollider* block) {
+            const XMFLOAT3 mn = block->GetMin();
+            const XMFLOAT3 mx = block->GetMax();
+            const float lo[3] = { mn.x, mn.y, mn.z };
+            const float hi[3] = { mx.x, mx.y, mx.z };
+            float tEnter = 0.0f, tExit = 1.0f;
+            for (int i = 0; i < 3; ++i) {
+                if (std::fabs(d[i]) < 1e-8f) {
+                    if (o[i] < lo[i] || o[i] > hi[i]) return false;
+                    continue;
+                }
+                float t0 = (lo[i] - o[i]) / d[i];
+                float t1 = (hi[i] - o[i]) / d[i];
+                if (t0 > t1) std::swap(t0, t1);
+                if (t0 > tEnter) tEnter = t0;
+                if (t1 < tExit) tExit = t1;
+                if (tEnter > tExit) return false;
+            }
+            return true;
+        };
+
+        // 線分が通るセルを順にたどる（3D DDA）
+        int cell[3], end[3];
+        GetCellCoord(from, cell[0], cell[1], cell[2]);
+        GetCellCoord(to, end[0], end[1], end[2]);
+        int step[3];
+        float tMax[3], tDelta[3];
+        for (int i = 0; i < 3; ++i) {
+            if (d[i] > 0.0f) {
+                step[i] = 1;
+                tDelta[i] = m_cellSize / d[i];
+                tMax[i] = ((cell[i] + 1) * m_cellSize - o[i]) / d[i];
+            } else if (d[i] < 0.0f) {
+                step[i] = -1;
+                tDelta[i] = -m_cellSize / d[i];
+                tMax[i] = (cell[i] * m_cellSize - o[i]) / d[i];
+            } else {
+                step[i] = 0;
+                tDelta[i] = tMax[i] = FLT_MAX;
+            }
+        }
+
+        const int maxSteps = std::abs(end[0] - cell[0]) + std::abs(end[1] - cell[1]) +
+            std::abs(end[2] - cell[2]) + 1;
+        for (int n = 0; n < maxSteps; ++n) {
+            auto it = m_grid.find(GetCellKey(cell[0], cell[1], cell[2]));
+            if (it != m_grid.end()) {
+                for (const BoxCollider* block : it->second) {
+                    if (hitsBlock(block)) return true;
+                }
+            }
+            // 次に境界を越える軸へ進む
+            int axis = (tMax[0] < tMax[1]) ? (tMax[0] < tMax[2] ? 0 : 2) : (tMax[1] < tMax[2] ? 1 : 2);
+            cell[axis] += step[axis];
+            tMax[axis] += tDelta[axis];
+        }
+        return false;
+    }
+
     std::vector<XMFLOAT3> MapCollision::CheckCollisionAll(BoxCollider* movingCollider, float checkRadius) {
         std::vector<XMFLOAT3> penetrations;
         if (!movingCollider) return penetrations;
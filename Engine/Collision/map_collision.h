@@ -21,6 +21,10 @@ namespace Engine {
         bool CheckCollision(BoxCollider* movingCollider, XMFLOAT3& outPenetration);
         std::vector<XMFLOAT3> CheckCollisionAll(BoxCollider* movingCollider, float checkRadius = 3.0f);
 
+        // fromからtoへの線分がブロックに遮られているか（見通しの判定用）
+        // 線分が通るセルに登録されたブロックだけを調べるので、隣のセルからはみ出た角は見逃すことがある
+        bool IsSegmentBlocked(const XMFLOAT3& from, const XMFLOAT3& to) const;
+
     private:
         MapCollision() = default;
 
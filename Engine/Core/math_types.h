@@ -0,0 +1,59 @@
+#pragma once
+
+// ============================================================
+// シミュレーション・当たり判定で使うベクトル型
+// WindowsではDirectXMathをそのまま使う。それ以外（Linuxの専用サーバー）では、
+// シミュレーションが使う分（XMFLOAT2/3/4と角度の変換）だけを同じ名前で用意する。
+// 行列の計算（XMMATRIX）は描画側（DirectXMath）でしか使わないこと
+// ============================================================
+#ifdef _WIN32
+
+#include <DirectXMath.h>
+
+#else
+
+namespace DirectX {
+
+    constexpr float XM_PI = 3.141592654f;
+    constexpr float XM_2PI = 6.283185307f;
+
+    struct XMFLOAT2 {
+        float x;
+        float y;
+
+        XMFLOAT2() = default;
+        constexpr XMFLOAT2(float _x, float _y) : x(_x), y(_y) {}
+    };
+
+    struct XMFLOAT3 {
+        float x;
+        float y;
+        float z;
+
+        XMFLOAT3() = default;
+        constexpr XMFLOAT3(float _x, float _y, float _z) : x(_x), y(_y), z(_z) {}
+    };
+
+    struct XMFLOAT4 {
+        float x;
+        float y;
+        float z;
+        float w;
+
+        XMFLOAT4() = default;
+        constexpr XMFLOAT4(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
+    };
+
+    // 行列は描画のためにオブジェクトに持たせておくだけ（計算はしない）
+    struct XMFLOAT4X4 {
+        float m[4][4];
+
+        XMFLOAT4X4() = default;
+    };
+
+    constexpr float XMConvertToRadians(float degrees) { return degrees * (XM_PI / 180.0f); }
+    constexpr float XMConvertToDegrees(float radians) { return radians * (180.0f / XM_PI); }
+
+} // namespace DirectX
+
+#endif
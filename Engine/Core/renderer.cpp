@@ -12,7 +12,7 @@
 namespace Engine {
 
     // ==========================================================
-    // VOgCX^X擾
+    // シングルトンインスタンス取得
     // ==========================================================
     Renderer& Renderer::GetInstance() {
         static Renderer instance;
@@ -20,12 +20,12 @@ namespace Engine {
     }
 
     // ==========================================================
-    // Initialize - D3D11foCXEXbv`F[EVF[_[̏
+    // Initialize - D3D11デバイス・スワップチェーン・シェーダーの初期化
     // ==========================================================
     bool Renderer::Initialize(HINSTANCE hInstance, HWND hWnd, bool windowed) {
         HRESULT hr = S_OK;
 
-        // --- Xbv`F[ݒ ---
+        // --- スワップチェーン設定 ---
         DXGI_SWAP_CHAIN_DESC sd = {};
         sd.BufferCount = 1;
         sd.BufferDesc.Width = m_screenWidth;
@@ -46,7 +46,7 @@ namespace Engine {
         };
         D3D_FEATURE_LEVEL featureLevel;
 
-        // --- foCXƃXbv`F[쐬i܂n[hEFAj ---
+        // --- デバイスとスワップチェーンを作成（まずハードウェアを試す） ---
         hr = D3D11CreateDeviceAndSwapChain(
             nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr, 0,
             featureLevels, ARRAYSIZE(featureLevels),
@@ -54,7 +54,7 @@ namespace Engine {
             &m_pSwapChain, &m_pDevice, &featureLevel, &m_pContext
         );
 
-        // n[hEFA_Ȃ\tgEFAiWARPjɃtH[obN
+        // ハードウェアがダメならソフトウェア（WARP）にフォールバック
         if (FAILED(hr)) {
             hr = D3D11CreateDeviceAndSwapChain(
                 nullptr, D3D_DRIVER_TYPE_WARP, nullptr, 0,
@@ -65,12 +65,12 @@ namespace Engine {
             if (FAILED(hr)) return false;
         }
 
-        // --- _[^[Qbgr[쐬 ---
+        // --- レンダーターゲットビューを作成 ---
         ComPtr<ID3D11Texture2D> pBackBuffer;
         m_pSwapChain->GetBuffer(0, __uuidof(ID3D11Texture2D), &pBackBuffer);
         m_pDevice->CreateRenderTargetView(pBackBuffer.Get(), nullptr, &m_pRenderTargetView);
 
-        // --- [xXeVeNX`ƃr[쐬 ---
+        // --- 深度ステンシルテクスチャとビューを作成 ---
         D3D11_TEXTURE2D_DESC td = {};
         td.Width = m_screenWidth;
         td.Height = m_screenHeight;
@@ -89,11 +89,11 @@ namespace Engine {
         dsvd.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
         m_pDevice->CreateDepthStencilView(pDepthTexture.Get(), &dsvd, &m_pDepthStencilView);
 
-        // _[^[QbgƐ[xobt@oCh
+        // レンダーターゲットと深度バッファをバインド
         ID3D11RenderTargetView* rtv = m_pRenderTargetView.Get();
         m_pContext->OMSetRenderTargets(1, &rtv, m_pDepthStencilView.Get());
 
-        // --- r[|[gݒ ---
+        // --- ビューポートを設定 ---
         D3D11_VIEWPORT vp = {};
         vp.Width = static_cast<float>(m_screenWidth);
         vp.Height = static_cast<float>(m_screenHeight);
@@ -101,7 +101,7 @@ namespace Engine {
         vp.MaxDepth = 1.0f;
         m_pContext->RSSetViewports(1, &vp);
 
-        // --- X^CU[Xe[gݒ ---
+        // --- ラスタライザーステートを設定 ---
         D3D11_RASTERIZER_DESC rd = {};
         rd.FillMode = D3D11_FILL_SOLID;
         rd.CullMode = D3D11_CULL_BACK;
@@ -111,7 +111,7 @@ namespace Engine {
         m_pDevice->CreateRasterizerState(&rd, &pRasterizerState);
         m_pContext->RSSetState(pRasterizerState.Get());
 
-        // --- At@uhLɂ ---
+        // --- アルファブレンドを有効にする ---
         D3D11_BLEND_DESC blendDesc = {};
         blendDesc.RenderTarget[0].BlendEnable = TRUE;
         blendDesc.RenderTarget[0].SrcBlend = D3D11_BLEND_SRC_ALPHA;
@@ -127,7 +127,7 @@ namespace Engine {
         float blendFactor[4] = { 0, 0, 0, 0 };
         m_pContext->OMSetBlendState(pBlendState.Get(), blendFactor, 0xffffffff);
 
-        // --- [xXeVXe[g쐬iL/2ށj ---
+        // --- 深度ステンシルステートを作成（有効/無効の2種類） ---
         D3D11_DEPTH_STENCIL_DESC dsDesc = {};
         dsDesc.DepthEnable = TRUE;
         dsDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
@@ -139,7 +139,7 @@ namespace Engine {
 
         m_pContext->OMSetDepthStencilState(m_pDepthStateEnable.Get(), 0);
 
-        // --- eNX`Tv[ݒ ---
+        // --- テクスチャサンプラーを設定 ---
         D3D11_SAMPLER_DESC samplerDesc = {};
         samplerDesc.Filter = D3D11_FILTER_ANISOTROPIC;
         samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
@@ -154,7 +154,7 @@ namespace Engine {
         ID3D11SamplerState* sampler = pSamplerState.Get();
         m_pContext->PSSetSamplers(0, 1, &sampler);
 
-        // --- _VF[_[RpCE쐬 ---
+        // --- 頂点シェーダーをコンパイル・作成 ---
         ComPtr<ID3DBlob> pVSBlob;
         ComPtr<ID3DBlob> pErrorBlob;
 
@@ -169,7 +169,7 @@ namespace Engine {
 
         m_pDevice->CreateVertexShader(pVSBlob->GetBufferPointer(), pVSBlob->GetBufferSize(), nullptr, &m_pVertexShader);
 
-        // --- ̓CAEg쐬 ---
+        // --- 入力レイアウトを作成 ---
         D3D11_INPUT_ELEMENT_DESC layout[] = {
             { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT,    0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
             { "NORMAL",   0, DXGI_FORMAT_R32G32B32_FLOAT,    0, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 },
@@ -180,7 +180,7 @@ namespace Engine {
         m_pDevice->CreateInputLayout(layout, ARRAYSIZE(layout),
             pVSBlob->GetBufferPointer(), pVSBlob->GetBufferSize(), &m_pInputLayout);
 
-        // --- sNZVF[_[RpCE쐬 ---
+        // --- ピクセルシェーダーをコンパイル・作成 ---
         ComPtr<ID3DBlob> pPSBlob;
         pErrorBlob.Reset();
         hr = D3DCompileFromFile(L"shader.hlsl", nullptr, nullptr, "PixelShaderPolygon", "ps_4_0_level_9_3",
@@ -194,7 +194,7 @@ namespace Engine {
 
         m_pDevice->CreatePixelShader(pPSBlob->GetBufferPointer(), pPSBlob->GetBufferSize(), nullptr, &m_pPixelShader);
 
-        // --- WVP萔obt@쐬 ---
+        // --- WVP定数バッファを作成 ---
         D3D11_BUFFER_DESC cbDesc = {};
         cbDesc.ByteWidth = sizeof(XMMATRIX);
         cbDesc.Usage = D3D11_USAGE_DEFAULT;
@@ -203,25 +203,25 @@ namespace Engine {
         ID3D11Buffer* cb = m_pConstantBuffer.Get();
         m_pContext->VSSetConstantBuffers(0, 1, &cb);
 
-        // --- }eA萔obt@쐬 ---
-        cbDesc.ByteWidth = 80;  // MaterialDatãTCY
+        // --- マテリアル定数バッファを作成 ---
+        cbDesc.ByteWidth = 80;  // MaterialDataのサイズ
         m_pDevice->CreateBuffer(&cbDesc, nullptr, &m_pMaterialBuffer);
         ID3D11Buffer* mb = m_pMaterialBuffer.Get();
         m_pContext->VSSetConstantBuffers(1, 1, &mb);
 
-        // --- VF[_[Ɠ̓CAEgpCvCɃZbg ---
+        // --- シェーダーと入力レイアウトをパイプラインにセット ---
         m_pContext->IASetInputLayout(m_pInputLayout.Get());
         m_pContext->VSSetShader(m_pVertexShader.Get(), nullptr, 0);
         m_pContext->PSSetShader(m_pPixelShader.Get(), nullptr, 0);
 
-        // --- 2D UI`p\[X̏ ---
+        // --- 2D UI描画用リソースの初期化 ---
         InitUI();
 
         return true;
     }
 
     // ==========================================================
-    // Finalize - S\[X̉
+    // Finalize - 全リソースの解放
     // ==========================================================
     void Renderer::Finalize() {
         FinalizeUI();
@@ -245,7 +245,7 @@ namespace Engine {
     }
 
     // ==========================================================
-    // Clear - ʂƐ[xobt@NA
+    // Clear - 画面と深度バッファをクリアする
     // ==========================================================
     void Renderer::Clear(float r, float g, float b, float a) {
         float clearColor[4] = { r, g, b, a };
@@ -254,14 +254,14 @@ namespace Engine {
     }
 
     // ==========================================================
-    // Present - obNobt@ʂɕ\
+    // Present - バックバッファを画面に表示する
     // ==========================================================
     void Renderer::Present() {
         m_pSwapChain->Present(0, 0);
     }
 
     // ==========================================================
-    // SetDepthEnable - [xeXg̗L/؂ւ
+    // SetDepthEnable - 深度テストの有効/無効を切り替える
     // ==========================================================
     void Renderer::SetDepthEnable(bool enable) {
         m_pContext->OMSetDepthStencilState(
@@ -269,7 +269,7 @@ namespace Engine {
     }
 
     // ==========================================================
-    // sݒiݒɒ萔obt@𑦍ɍXVj
+    // 行列設定（設定後に定数バッファを即座に更新する）
     // ==========================================================
     void Renderer::SetWorldMatrix(const XMMATRIX& matrix) {
         m_worldMatrix = matrix;
@@ -287,7 +287,7 @@ namespace Engine {
     }
 
     // ==========================================================
-    // UpdateConstantBuffer - WVPs]uGPUɓ]
+    // UpdateConstantBuffer - WVP行列を転置してGPUに転送する
     // ==========================================================
     void Renderer::UpdateConstantBuffer() {
         XMMATRIX wvp = m_worldMatrix * m_viewMatrix * m_projectionMatrix;
@@ -299,8 +299,8 @@ namespace Engine {
     }
 
     // ==========================================================
-    // SetupFor2D - 2D`惂[hɐ؂ւ
-    // ˉesi㌴_AsNZWnjA[xeXg
+    // SetupFor2D - 2D描画モードに切り替える
+    // 正射影行列（左上原点、ピクセル座標系）、深度テスト無効
     // ==========================================================
     void Renderer::SetupFor2D() {
         m_projectionMatrix = XMMatrixOrthographicOffCenterLH(
@@ -315,7 +315,7 @@ namespace Engine {
     }
 
     // ==========================================================
-    // SetupFor3D - 3D`惂[hɖ߂i[xeXgLj
+    // SetupFor3D - 3D描画モードに戻す（深度テスト有効）
     // ==========================================================
     void Renderer::SetupFor3D() {
         SetDepthEnable(true);
@@ -323,16 +323,16 @@ namespace Engine {
 
     // ==========================================================
     //
-    //  ȉA2D UI`VXe̎
+    //  以下、2D UI描画システムの実装
     //
     // ==========================================================
 
     // ----------------------------------------------------------
-    // rbg}bvtHg̃hbgf[^
-    // ASCII 32(' ')`126('~')95
-    // e8x12sNZ
-    // 1s = 8bit = 1oCgA12s = 12oCg/
-    // rbgzu: MSB(bit7) = [sNZ
+    // ビットマップフォントのドットデータ
+    // ASCII 32(' ')～126('~')の95文字分
+    // 各文字は8x12ピクセル
+    // 1行 = 8bit = 1バイト、12行 = 12バイト/文字
+    // ビット配置: MSB(bit7) = 左端ピクセル
     // ----------------------------------------------------------
     static const unsigned char g_fontData[][12] = {
         {0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, // 32: ' '
@@ -432,16 +432,16 @@ namespace Engine {
         {0x76,0xDC,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}, // 126: '~'
     };
 
-    // tHg̕iASCII 32`126 = 95j
+    // フォントの文字数（ASCII 32～126 = 95文字）
     static const int FONT_GLYPH_COUNT = sizeof(g_fontData) / sizeof(g_fontData[0]);
 
     // ==========================================================
-    // InitUI - 2D`pGPU\[Xꊇ쐬
+    // InitUI - 2D描画用のGPUリソースを一括作成する
     // ==========================================================
     bool Renderer::InitUI() {
         if (m_uiInitialized) return true;
 
-        // --- ``p̓I_obt@i6_ = Op`2j ---
+        // --- 矩形描画用の動的頂点バッファ（6頂点 = 三角形2枚） ---
         {
             D3D11_BUFFER_DESC bd = {};
             bd.Usage = D3D11_USAGE_DYNAMIC;
@@ -454,7 +454,7 @@ namespace Engine {
             }
         }
 
-        // --- eLXg`p̓I_obt@i1=6_ ~ ő128j ---
+        // --- テキスト描画用の動的頂点バッファ（1文字=6頂点 × 最大128文字） ---
         {
             D3D11_BUFFER_DESC bd = {};
             bd.Usage = D3D11_USAGE_DYNAMIC;
@@ -467,12 +467,12 @@ namespace Engine {
             }
         }
 
-        // --- rbg}bvtHgeNX`̐ ---
+        // --- ビットマップフォントテクスチャの生成 ---
         if (!CreateFontTexture()) {
             return false;
         }
 
-        // --- 1x1eNX`̐ ---
+        // --- 1x1白テクスチャの生成 ---
         if (!CreateWhiteTexture()) {
             return false;
         }
@@ -482,7 +482,7 @@ namespace Engine {
     }
 
     // ==========================================================
-    // FinalizeUI - UIp\[XSĉ
+    // FinalizeUI - UI用リソースを全て解放する
     // ==========================================================
     void Renderer::FinalizeUI() {
         m_pUIVertexBuffer.Reset();
@@ -493,18 +493,18 @@ namespace Engine {
     }
 
     // ==========================================================
-    // CreateFontTexture - hbgf[^tHgeNX`𐶐
-    // g_fontDatåerbg𔒐FssNZɕϊA
-    // 128x72̃eNX`ƂGPUɓ]i16x6s̃Obhj
+    // CreateFontTexture - ドットデータからフォントテクスチャを生成する
+    // g_fontDataの各ビットを白色不透明ピクセルに変換し、
+    // 128x72のテクスチャとしてGPUに転送する（16文字x6行のグリッド）
     // ==========================================================
     bool Renderer::CreateFontTexture() {
         const int texW = FONT_TEX_W;  // 128px
         const int texH = FONT_TEX_H;  // 72px
 
-        // Sēŏ
+        // 全て透明で初期化
         std::vector<uint32_t> pixels(texW * texH, 0x00000000);
 
-        // ẽhbgf[^eNX`ɏ
+        // 各文字のドットデータをテクスチャに書き込む
         for (int glyphIdx = 0; glyphIdx < FONT_GLYPH_COUNT; glyphIdx++) {
             int col = glyphIdx % FONT_COLS;
             int row = glyphIdx / FONT_COLS;
@@ -514,17 +514,17 @@ namespace Engine {
             for (int y = 0; y < FONT_CHAR_H; y++) {
                 unsigned char line = g_fontData[glyphIdx][y];
                 for (int x = 0; x < FONT_CHAR_W; x++) {
-                    // MSB珇Ƀ`FbNibit7 = [sNZj
+                    // MSBから順にチェック（bit7 = 左端ピクセル）
                     if (line & (0x80 >> x)) {
                         int px = baseX + x;
                         int py = baseY + y;
-                        pixels[py * texW + px] = 0xFFFFFFFF;  // Fs
+                        pixels[py * texW + px] = 0xFFFFFFFF;  // 白色不透明
                     }
                 }
             }
         }
 
-        // GPUpeNX`쐬
+        // GPU用テクスチャを作成
         D3D11_TEXTURE2D_DESC td = {};
         td.Width = texW;
         td.Height = texH;
@@ -557,8 +557,8 @@ namespace Engine {
     }
 
     // ==========================================================
-    // CreateWhiteTexture - 1x1eNX`𐶐
-    // ``掞ɃeNX`Z𖳌邽
+    // CreateWhiteTexture - 1x1白テクスチャを生成する
+    // 矩形描画時にテクスチャ乗算を無効化するため
     // ==========================================================
     bool Renderer::CreateWhiteTexture() {
         uint32_t whitePixel = 0xFFFFFFFF;
@@ -591,31 +591,31 @@ namespace Engine {
     }
 
     // ==========================================================
-    // DrawRect2D - ʏɐFt``悷
+    // DrawRect2D - 画面上に色付き矩形を描画する
     //
-    // ̗:
-    //   1. 3Dsۑ  2D[hɐؑ
-    //   2. eNX`oChieNX`~_J[ = _J[̂܂܁j
-    //   3. Op`2Ŏlp``
-    //   4. 3D[hɕA
+    // 処理の流れ:
+    //   1. 3D行列を保存 → 2Dモードに切替
+    //   2. 白テクスチャをバインド（テクスチャ×頂点カラー = 頂点カラーそのまま）
+    //   3. 三角形2枚で四角形を描画
+    //   4. 3Dモードに復帰
     // ==========================================================
     void Renderer::DrawRect2D(float x, float y, float width, float height, const XMFLOAT4& col) {
         if (!m_uiInitialized) return;
 
-        // ݂̍sۑ
+        // 現在の行列を保存
         XMMATRIX savedWorld = m_worldMatrix;
         XMMATRIX savedView = m_viewMatrix;
         XMMATRIX savedProj = m_projectionMatrix;
 
         SetupFor2D();
 
-        // lp`̒_W
+        // 四角形の頂点座標
         float x0 = x;
         float y0 = y;
         float x1 = x + width;
         float y1 = y + height;
 
-        // _wp[iVertex3D̃o: position, normal, color, texCoordj
+        // 頂点を作るヘルパー（Vertex3Dのメンバ名: position, normal, color, texCoord）
         auto makeVert = [&](float vx, float vy) -> Vertex3D {
             Vertex3D v;
             v.position = { vx, vy, 0.0f };
@@ -625,23 +625,23 @@ namespace Engine {
             return v;
             };
 
-        // 6_ŎOp`2
+        // 6頂点で三角形2枚
         Vertex3D verts[6];
-        verts[0] = makeVert(x0, y0);  // 
-        verts[1] = makeVert(x1, y0);  // E
-        verts[2] = makeVert(x0, y1);  // 
-        verts[3] = makeVert(x1, y0);  // E
-        verts[4] = makeVert(x1, y1);  // E
-        verts[5] = makeVert(x0, y1);  // 
-
-        // Iobt@ɏ
+        verts[0] = makeVert(x0, y0);  // 左上
+        verts[1] = makeVert(x1, y0);  // 右上
+        verts[2] = makeVert(x0, y1);  // 左下
+        verts[3] = makeVert(x1, y0);  // 右上
+        verts[4] = makeVert(x1, y1);  // 右下
+        verts[5] = makeVert(x0, y1);  // 左下
+
+        // 動的バッファに書き込む
         D3D11_MAPPED_SUBRESOURCE mapped;
         if (SUCCEEDED(m_pContext->Map(m_pUIVertexBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
             memcpy(mapped.pData, verts, sizeof(verts));
             m_pContext->Unmap(m_pUIVertexBuffer.Get(), 0);
         }
 
-        // }eA𔒂ɐݒ
+        // マテリアルを白に設定
         struct MaterialData {
             XMFLOAT4 diffuse;
             XMFLOAT4 ambient;
@@ -654,11 +654,11 @@ namespace Engine {
         mat.diffuse = { 1.0f, 1.0f, 1.0f, 1.0f };
         m_pContext->UpdateSubresource(m_pMaterialBuffer.Get(), 0, nullptr, &mat, 0, 0);
 
-        // eNX`oCh
+        // 白テクスチャをバインド
         ID3D11ShaderResourceView* whiteSRV = m_pWhiteSRV.Get();
         m_pContext->PSSetShaderResources(0, 1, &whiteSRV);
 
-        // `
+        // 描画
         UINT stride = sizeof(Vertex3D);
         UINT offset = 0;
         ID3D11Buffer* vb = m_pUIVertexBuffer.Get();
@@ -666,7 +666,7 @@ namespace Engine {
         m_pContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
         m_pContext->Draw(6, 0);
 
-        // 3D[hɕA
+        // 3Dモードに復帰
         SetupFor3D();
         m_worldMatrix = savedWorld;
         m_viewMatrix = savedView;
@@ -675,28 +675,28 @@ namespace Engine {
     }
 
     // ==========================================================
-    // DrawText2D - ʏASCIIeLXg`悷
+    // DrawText2D - 画面上にASCIIテキストを描画する
     //
-    // ̗:
-    //   1. 3Dsۑ  2D[hɐؑ
-    //   2. etHgeNX`UVɃ}bsO
-    //   3. 1 = 6_iOp`2jŒ_f[^\z
-    //   4. tHgeNX`oChĈꊇ`
-    //   5. 3D[hɕA
+    // 処理の流れ:
+    //   1. 3D行列を保存 → 2Dモードに切替
+    //   2. 各文字をフォントテクスチャ上のUVにマッピング
+    //   3. 1文字 = 6頂点（三角形2枚）で頂点データを構築
+    //   4. フォントテクスチャをバインドして一括描画
+    //   5. 3Dモードに復帰
     //
-    // \TCY: hbgtHg2{gi8x12  16x24sNZj
+    // 表示サイズ: ドットフォントの2倍拡大（8x12 → 16x24ピクセル）
     // ==========================================================
     void Renderer::DrawText2D(float x, float y, const char* text, const XMFLOAT4& col) {
         if (!m_uiInitialized || !text || !m_pFontSRV) return;
 
-        // ݂̍sۑ
+        // 現在の行列を保存
         XMMATRIX savedWorld = m_worldMatrix;
         XMMATRIX savedView = m_viewMatrix;
         XMMATRIX savedProj = m_projectionMatrix;
 
         SetupFor2D();
 
-        // 擾i`FbNj
+        // 文字数を取得（上限チェック）
         int len = (int)strlen(text);
         if (len > MAX_TEXT_CHARS) len = MAX_TEXT_CHARS;
         if (len == 0) {
@@ -708,15 +708,15 @@ namespace Engine {
             return;
         }
 
-        // tHgeNX`̃TCYiUVKpj
+        // フォントテクスチャのサイズ（UV正規化用）
         float texW = (float)FONT_TEX_W;
         float texH = (float)FONT_TEX_H;
 
-        // 1̕\TCYi2{gj
+        // 1文字の表示サイズ（2倍拡大）
         float charDisplayW = (float)FONT_CHAR_W * 2.0f;  // 16px
         float charDisplayH = (float)FONT_CHAR_H * 2.0f;  // 24px
 
-        // S̒_f[^\z
+        // 全文字分の頂点データを構築
         std::vector<Vertex3D> verts;
         verts.reserve(len * 6);
 
@@ -724,30 +724,30 @@ namespace Engine {
         for (int i = 0; i < len; i++) {
             unsigned char ch = (unsigned char)text[i];
 
-            // ASCII 32`126͈̔͊O̓Xy[XiJ[\i߂j
+            // ASCII 32～126の範囲外はスペース扱い（カーソルだけ進める）
             if (ch < 32 || ch > 126) {
                 cursorX += charDisplayW;
                 continue;
             }
 
-            // tHgeNX`̃OtʒuvZ
+            // フォントテクスチャ上のグリフ位置を計算
             int glyphIdx = ch - 32;
             int gc = glyphIdx % FONT_COLS;
             int gr = glyphIdx / FONT_COLS;
 
-            // UVW
+            // UV座標
             float u0 = (float)(gc * FONT_CHAR_W) / texW;
             float v0 = (float)(gr * FONT_CHAR_H) / texH;
             float u1 = (float)((gc + 1) * FONT_CHAR_W) / texW;
             float v1 = (float)((gr + 1) * FONT_CHAR_H) / texH;
 
-            // ʏ̎lp`W
+            // 画面上の四角形座標
             float sx0 = cursorX;
             float sy0 = y;
             float sx1 = cursorX + charDisplayW;
             float sy1 = y + charDisplayH;
 
-            // _wp[
+            // 頂点を作るヘルパー
             auto makeVert = [&](float vx, float vy, float vu, float vv) -> Vertex3D {
                 Vertex3D v;
                 v.position = { vx, vy, 0.0f };
@@ -757,13 +757,13 @@ namespace Engine {
                 return v;
                 };
 
-            // Op`21̎lp`
-            verts.push_back(makeVert(sx0, sy0, u0, v0));  // 
-            verts.push_back(makeVert(sx1, sy0, u1, v0));  // E
-            verts.push_back(makeVert(sx0, sy1, u0, v1));  // 
-            verts.push_back(makeVert(sx1, sy0, u1, v0));  // E
-            verts.push_back(makeVert(sx1, sy1, u1, v1));  // E
-            verts.push_back(makeVert(sx0, sy1, u0, v1));  // 
+            // 三角形2枚で1文字分の四角形
+            verts.push_back(makeVert(sx0, sy0, u0, v0));  // 左上
+            verts.push_back(makeVert(sx1, sy0, u1, v0));  // 右上
+            verts.push_back(makeVert(sx0, sy1, u0, v1));  // 左下
+            verts.push_back(makeVert(sx1, sy0, u1, v0));  // 右上
+            verts.push_back(makeVert(sx1, sy1, u1, v1));  // 右下
+            verts.push_back(makeVert(sx0, sy1, u0, v1));  // 左下
 
             cursorX += charDisplayW;
         }
@@ -777,14 +777,14 @@ namespace Engine {
             return;
         }
 
-        // Iobt@ɏ
+        // 動的バッファに書き込む
         D3D11_MAPPED_SUBRESOURCE mapped;
         if (SUCCEEDED(m_pContext->Map(m_pTextVertexBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
             memcpy(mapped.pData, verts.data(), verts.size() * sizeof(Vertex3D));
             m_pContext->Unmap(m_pTextVertexBuffer.Get(), 0);
         }
 
-        // }eA𔒂ɐݒ
+        // マテリアルを白に設定
         struct MaterialData {
             XMFLOAT4 diffuse;
             XMFLOAT4 ambient;
@@ -797,11 +797,11 @@ namespace Engine {
         mat.diffuse = { 1.0f, 1.0f, 1.0f, 1.0f };
         m_pContext->UpdateSubresource(m_pMaterialBuffer.Get(), 0, nullptr, &mat, 0, 0);
 
-        // tHgeNX`oCh
+        // フォントテクスチャをバインド
         ID3D11ShaderResourceView* fontSRV = m_pFontSRV.Get();
         m_pContext->PSSetShaderResources(0, 1, &fontSRV);
 
-        // ꊇ`
+        // 一括描画
         UINT stride = sizeof(Vertex3D);
         UINT offset = 0;
         ID3D11Buffer* vb = m_pTextVertexBuffer.Get();
@@ -809,7 +809,7 @@ namespace Engine {
         m_pContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
         m_pContext->Draw((UINT)verts.size(), 0);
 
-        // 3D[hɕA
+        // 3Dモードに復帰
         SetupFor3D();
         m_worldMatrix = savedWorld;
         m_viewMatrix = savedView;
@@ -6,7 +6,7 @@
 namespace Engine {
     using namespace DirectX;
 
-    // O錾
+    // 前方宣言
     class Collider;
     class BoxCollider;
     class SphereCollider;
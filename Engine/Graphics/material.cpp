@@ -58,7 +58,7 @@ namespace Engine {
             m_pTexture->Release();
         }
         m_pTexture = pTexture;
-        m_ownsTexture = false;  // O󂯎̂ŏLȂ
+        m_ownsTexture = false;  // 外部から受け取ったので所有しない
     }
 
     void Material::Apply(ID3D11DeviceContext* pContext, ID3D11Buffer* pMaterialBuffer) {
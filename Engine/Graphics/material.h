@@ -14,7 +14,7 @@ namespace Engine {
         XMFLOAT4 specular = { 0.0f, 0.0f, 0.0f, 1.0f };
         XMFLOAT4 emission = { 0.0f, 0.0f, 0.0f, 1.0f };
         float shininess = 0.0f;
-        float padding[3] = { 0.0f, 0.0f, 0.0f };  // 16byteE
+        float padding[3] = { 0.0f, 0.0f, 0.0f };  // 16byte境界
     };
 
     class Material {
@@ -27,23 +27,23 @@ namespace Engine {
         Material(Material&& other) noexcept;
         Material& operator=(Material&& other) noexcept;
 
-        // vpeBݒ
+        // プロパティ設定
         void SetDiffuse(const XMFLOAT4& color);
         void SetAmbient(const XMFLOAT4& color);
         void SetSpecular(const XMFLOAT4& color, float shininess);
         void SetEmission(const XMFLOAT4& color);
 
-        // eNX`ݒ
+        // テクスチャ設定
         void SetTexture(ID3D11ShaderResourceView* pTexture);
         ID3D11ShaderResourceView* GetTexture() const { return m_pTexture; }
 
-        // GPUKp
+        // GPU適用
         void Apply(ID3D11DeviceContext* pContext, ID3D11Buffer* pMaterialBuffer);
 
-        // ANZT
+        // アクセサ
         const MaterialData& GetData() const { return m_data; }
 
-        // t@Ng
+        // ファクトリ
         static std::shared_ptr<Material> CreateDefault();
 
     private:
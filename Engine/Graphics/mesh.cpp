@@ -64,7 +64,7 @@ namespace Engine {
 
         ReleaseBuffers();
 
-        // _obt@쐬
+        // 頂点バッファ作成
         D3D11_BUFFER_DESC vbDesc = {};
         vbDesc.Usage = D3D11_USAGE_DEFAULT;
         vbDesc.ByteWidth = static_cast<UINT>(sizeof(Vertex3D) * m_vertices.size());
@@ -76,7 +76,7 @@ namespace Engine {
         HRESULT hr = pDevice->CreateBuffer(&vbDesc, &vbData, &m_pVertexBuffer);
         if (FAILED(hr)) return false;
 
-        // CfbNXobt@쐬i΁j
+        // インデックスバッファ作成（あれば）
         if (!m_indices.empty()) {
             D3D11_BUFFER_DESC ibDesc = {};
             ibDesc.Usage = D3D11_USAGE_DEFAULT;
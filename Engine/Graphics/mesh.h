@@ -12,24 +12,24 @@ namespace Engine {
         Mesh();
         virtual ~Mesh();
 
-        // Rs[֎~A[u
+        // コピー禁止、ムーブ許可
         Mesh(const Mesh&) = delete;
         Mesh& operator=(const Mesh&) = delete;
         Mesh(Mesh&& other) noexcept;
         Mesh& operator=(Mesh&& other) noexcept;
 
-        // _f[^ݒ
+        // 頂点データ設定
         void SetVertices(const std::vector<Vertex3D>& vertices);
         void SetVertices(std::vector<Vertex3D>&& vertices);
         void SetIndices(const std::vector<uint32_t>& indices);
         void SetIndices(std::vector<uint32_t>&& indices);
 
-        // GPUobt@
+        // GPUバッファ操作
         bool Upload(ID3D11Device* pDevice);
         void Bind(ID3D11DeviceContext* pContext);
         void Draw(ID3D11DeviceContext* pContext);
 
-        // ANZT
+        // アクセサ
         const std::vector<Vertex3D>& GetVertices() const { return m_vertices; }
         const std::vector<uint32_t>& GetIndices() const { return m_indices; }
         uint32_t GetVertexCount() const { return static_cast<uint32_t>(m_vertices.size()); }
@@ -37,7 +37,7 @@ namespace Engine {
         bool IsUploaded() const { return m_pVertexBuffer != nullptr; }
         bool HasIndices() const { return !m_indices.empty(); }
 
-        // EiMeshColliderpj
+        // 境界情報（MeshCollider用）
         void GetBounds(XMFLOAT3& outMin, XMFLOAT3& outMax) const;
 
     protected:
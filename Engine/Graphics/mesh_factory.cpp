@@ -11,32 +11,32 @@ namespace Engine {
         float hz = sizeZ * 0.5f;
 
         std::vector<Vertex3D> vertices = {
-            // O (Z = -hz)
+            // 前面 (Z = -hz)
             {{ -hx,  hy, -hz }, { 0, 0, -1 }, { 1, 1, 1, 1 }, { 0, 0 }},
             {{  hx,  hy, -hz }, { 0, 0, -1 }, { 1, 1, 1, 1 }, { 1, 0 }},
             {{ -hx, -hy, -hz }, { 0, 0, -1 }, { 1, 1, 1, 1 }, { 0, 1 }},
             {{  hx, -hy, -hz }, { 0, 0, -1 }, { 1, 1, 1, 1 }, { 1, 1 }},
-            // w (Z = +hz)
+            // 背面 (Z = +hz)
             {{  hx,  hy,  hz }, { 0, 0, 1 }, { 1, 1, 1, 1 }, { 0, 0 }},
             {{ -hx,  hy,  hz }, { 0, 0, 1 }, { 1, 1, 1, 1 }, { 1, 0 }},
             {{  hx, -hy,  hz }, { 0, 0, 1 }, { 1, 1, 1, 1 }, { 0, 1 }},
             {{ -hx, -hy,  hz }, { 0, 0, 1 }, { 1, 1, 1, 1 }, { 1, 1 }},
-            //  (X = -hx)
+            // 左面 (X = -hx)
             {{ -hx,  hy,  hz }, { -1, 0, 0 }, { 1, 1, 1, 1 }, { 0, 0 }},
             {{ -hx,  hy, -hz }, { -1, 0, 0 }, { 1, 1, 1, 1 }, { 1, 0 }},
             {{ -hx, -hy,  hz }, { -1, 0, 0 }, { 1, 1, 1, 1 }, { 0, 1 }},
             {{ -hx, -hy, -hz }, { -1, 0, 0 }, { 1, 1, 1, 1 }, { 1, 1 }},
-            // E (X = +hx)
+            // 右面 (X = +hx)
             {{  hx,  hy, -hz }, { 1, 0, 0 }, { 1, 1, 1, 1 }, { 0, 0 }},
             {{  hx,  hy,  hz }, { 1, 0, 0 }, { 1, 1, 1, 1 }, { 1, 0 }},
             {{  hx, -hy, -hz }, { 1, 0, 0 }, { 1, 1, 1, 1 }, { 0, 1 }},
             {{  hx, -hy,  hz }, { 1, 0, 0 }, { 1, 1, 1, 1 }, { 1, 1 }},
-            //  (Y = +hy)
+            // 上面 (Y = +hy)
             {{ -hx,  hy,  hz }, { 0, 1, 0 }, { 1, 1, 1, 1 }, { 0, 0 }},
             {{  hx,  hy,  hz }, { 0, 1, 0 }, { 1, 1, 1, 1 }, { 1, 0 }},
             {{ -hx,  hy, -hz }, { 0, 1, 0 }, { 1, 1, 1, 1 }, { 0, 1 }},
             {{  hx,  hy, -hz }, { 0, 1, 0 }, { 1, 1, 1, 1 }, { 1, 1 }},
-            //  (Y = -hy)
+            // 下面 (Y = -hy)
             {{ -hx, -hy, -hz }, { 0, -1, 0 }, { 1, 1, 1, 1 }, { 0, 0 }},
             {{  hx, -hy, -hz }, { 0, -1, 0 }, { 1, 1, 1, 1 }, { 1, 0 }},
             {{ -hx, -hy,  hz }, { 0, -1, 0 }, { 1, 1, 1, 1 }, { 0, 1 }},
@@ -44,17 +44,17 @@ namespace Engine {
         };
 
         std::vector<uint32_t> indices = {
-            // O
+            // 前面
             0, 1, 2, 2, 1, 3,
-            // w
+            // 背面
             4, 5, 6, 6, 5, 7,
-            // 
+            // 左面
             8, 9, 10, 10, 9, 11,
-            // E
+            // 右面
             12, 13, 14, 14, 13, 15,
-            // 
+            // 上面
             16, 17, 18, 18, 17, 19,
-            // 
+            // 下面
             20, 21, 22, 22, 21, 23,
         };
 
@@ -93,7 +93,7 @@ namespace Engine {
 
         constexpr float PI = 3.14159265358979323846f;
 
-        // _
+        // 頂点生成
         for (uint32_t stack = 0; stack <= stacks; ++stack) {
             float phi = PI * static_cast<float>(stack) / static_cast<float>(stacks);
             float sinPhi = std::sin(phi);
@@ -114,7 +114,7 @@ namespace Engine {
             }
         }
 
-        // CfbNX
+        // インデックス生成
         for (uint32_t stack = 0; stack < stacks; ++stack) {
             for (uint32_t slice = 0; slice < slices; ++slice) {
                 uint32_t first = stack * (slices + 1) + slice;
@@ -137,7 +137,7 @@ namespace Engine {
     }
 
     std::shared_ptr<Mesh> MeshFactory::CreateFromFile(const std::string& filePath) {
-        // TODO: OBJ/FBXǂݍݎ
+        // TODO: OBJ/FBX読み込み実装
         return nullptr;
     }
 }
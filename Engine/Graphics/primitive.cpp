@@ -6,51 +6,6 @@
 namespace Engine {
     static ID3D11ShaderResourceView* g_pDefaultTexture = nullptr;
 
-    Vertex3D BoxVertices[36] = {
-        // O (Z = -0.5)
-        {{-0.5f,  0.5f, -0.5f}, {0, 0, -1}, {1, 1, 1, 1}, {0, 0}},
-        {{ 0.5f,  0.5f, -0.5f}, {0, 0, -1}, {1, 1, 1, 1}, {1, 0}},
-        {{-0.5f, -0.5f, -0.5f}, {0, 0, -1}, {1, 1, 1, 1}, {0, 1}},
-        {{-0.5f, -0.5f, -0.5f}, {0, 0, -1}, {1, 1, 1, 1}, {0, 1}},
-        {{ 0.5f,  0.5f, -0.5f}, {0, 0, -1}, {1, 1, 1, 1}, {1, 0}},
-        {{ 0.5f, -0.5f, -0.5f}, {0, 0, -1}, {1, 1, 1, 1}, {1, 1}},
-        // w (Z = 0.5)
-        {{ 0.5f,  0.5f,  0.5f}, {0, 0, 1}, {1, 1, 1, 1}, {0, 0}},
-        {{-0.5f,  0.5f,  0.5f}, {0, 0, 1}, {1, 1, 1, 1}, {1, 0}},
-        {{ 0.5f, -0.5f,  0.5f}, {0, 0, 1}, {1, 1, 1, 1}, {0, 1}},
-        {{ 0.5f, -0.5f,  0.5f}, {0, 0, 1}, {1, 1, 1, 1}, {0, 1}},
-        {{-0.5f,  0.5f,  0.5f}, {0, 0, 1}, {1, 1, 1, 1}, {1, 0}},
-        {{-0.5f, -0.5f,  0.5f}, {0, 0, 1}, {1, 1, 1, 1}, {1, 1}},
-        //  (X = -0.5)
-        {{-0.5f,  0.5f,  0.5f}, {-1, 0, 0}, {1, 1, 1, 1}, {0, 0}},
-        {{-0.5f,  0.5f, -0.5f}, {-1, 0, 0}, {1, 1, 1, 1}, {1, 0}},
-        {{-0.5f, -0.5f,  0.5f}, {-1, 0, 0}, {1, 1, 1, 1}, {0, 1}},
-        {{-0.5f, -0.5f,  0.5f}, {-1, 0, 0}, {1, 1, 1, 1}, {0, 1}},
-        {{-0.5f,  0.5f, -0.5f}, {-1, 0, 0}, {1, 1, 1, 1}, {1, 0}},
-        {{-0.5f, -0.5f, -0.5f}, {-1, 0, 0}, {1, 1, 1, 1}, {1, 1}},
-        // E (X = 0.5)
-        {{ 0.5f,  0.5f, -0.5f}, {1, 0, 0}, {1, 1, 1, 1}, {0, 0}},
-        {{ 0.5f,  0.5f,  0.5f}, {1, 0, 0}, {1, 1, 1, 1}, {1, 0}},
-        {{ 0.5f, -0.5f, -0.5f}, {1, 0, 0}, {1, 1, 1, 1}, {0, 1}},
-        {{ 0.5f, -0.5f, -0.5f}, {1, 0, 0}, {1, 1, 1, 1}, {0, 1}},
-        {{ 0.5f,  0.5f,  0.5f}, {1, 0, 0}, {1, 1, 1, 1}, {1, 0}},
-        {{ 0.5f, -0.5f,  0.5f}, {1, 0, 0}, {1, 1, 1, 1}, {1, 1}},
-        //  (Y = 0.5)
-        {{-0.5f,  0.5f,  0.5f}, {0, 1, 0}, {1, 1, 1, 1}, {0, 0}},
-        {{ 0.5f,  0.5f,  0.5f}, {0, 1, 0}, {1, 1, 1, 1}, {1, 0}},
-        {{-0.5f,  0.5f, -0.5f}, {0, 1, 0}, {1, 1, 1, 1}, {0, 1}},
-        {{-0.5f,  0.5f, -0.5f}, {0, 1, 0}, {1, 1, 1, 1}, {0, 1}},
-        {{ 0.5f,  0.5f,  0.5f}, {0, 1, 0}, {1, 1, 1, 1}, {1, 0}},
-        {{ 0.5f,  0.5f, -0.5f}, {0, 1, 0}, {1, 1, 1, 1}, {1, 1}},
-        //  (Y = -0.5)
-        {{-0.5f, -0.5f, -0.5f}, {0, -1, 0}, {1, 1, 1, 1}, {0, 0}},
-        {{ 0.5f, -0.5f, -0.5f}, {0, -1, 0}, {1, 1, 1, 1}, {1, 0}},
-        {{-0.5f, -0.5f,  0.5f}, {0, -1, 0}, {1, 1, 1, 1}, {0, 1}},
-        {{-0.5f, -0.5f,  0.5f}, {0, -1, 0}, {1, 1, 1, 1}, {0, 1}},
-        {{ 0.5f, -0.5f, -0.5f}, {0, -1, 0}, {1, 1, 1, 1}, {1, 0}},
-        {{ 0.5f, -0.5f,  0.5f}, {0, -1, 0}, {1, 1, 1, 1}, {1, 1}},
-    };
-
     void InitPrimitives(ID3D11Device* pDevice) {
         g_pDefaultTexture = TextureLoader::Load(pDevice, L"resource/texture/white.png");
         if (!g_pDefaultTexture) {
@@ -69,15 +24,3 @@ namespace Engine {
         return g_pDefaultTexture;
     }
 }
-
-// O[oJp
-Engine::Vertex3D Box[36];
-
-// ÓIŃRs[
-namespace {
-    struct BoxInitializer {
-        BoxInitializer() {
-            memcpy(Box, Engine::BoxVertices, sizeof(Box));
-        }
-    } g_boxInit;
-}
@@ -0,0 +1,64 @@
+// system/graphics/primitive_data.cpp
+// プリミティブの頂点データ（Direct3Dを使わないので専用サーバーもリンクする）
+#include "pch.h"
+#include "primitive_data.h"
+#include <cstring>
+
+namespace Engine {
+    Vertex3D BoxVertices[36] = {
+        // 前面 (Z = -0.5)
+        {{-0.5f,  0.5f, -0.5f}, {0, 0, -1}, {1, 1, 1, 1}, {0, 0}},
+        {{ 0.5f,  0.5f, -0.5f}, {0, 0, -1}, {1, 1, 1, 1}, {1, 0}},
+        {{-0.5f, -0.5f, -0.5f}, {0, 0, -1}, {1, 1, 1, 1}, {0, 1}},
+        {{-0.5f, -0.5f, -0.5f}, {0, 0, -1}, {1, 1, 1, 1}, {0, 1}},
+        {{ 0.5f,  0.5f, -0.5f}, {0, 0, -1}, {1, 1, 1, 1}, {1, 0}},
+        {{ 0.5f, -0.5f, -0.5f}, {0, 0, -1}, {1, 1, 1, 1}, {1, 1}},
+        // 背面 (Z = 0.5)
+        {{ 0.5f,  0.5f,  0.5f}, {0, 0, 1}, {1, 1, 1, 1}, {0, 0}},
+        {{-0.5f,  0.5f,  0.5f}, {0, 0, 1}, {1, 1, 1, 1}, {1, 0}},
+        {{ 0.5f, -0.5f,  0.5f}, {0, 0, 1}, {1, 1, 1, 1}, {0, 1}},
+        {{ 0.5f, -0.5f,  0.5f}, {0, 0, 1}, {1, 1, 1, 1}, {0, 1}},
+        {{-0.5f,  0.5f,  0.5f}, {0, 0, 1}, {1, 1, 1, 1}, {1, 0}},
+        {{-0.5f, -0.5f,  0.5f}, {0, 0, 1}, {1, 1, 1, 1}, {1, 1}},
+        // 左面 (X = -0.5)
+        {{-0.5f,  0.5f,  0.5f}, {-1, 0, 0}, {1, 1, 1, 1}, {0, 0}},
+        {{-0.5f,  0.5f, -0.5f}, {-1, 0, 0}, {1, 1, 1, 1}, {1, 0}},
+        {{-0.5f, -0.5f,  0.5f}, {-1, 0, 0}, {1, 1, 1, 1}, {0, 1}},
+        {{-0.5f, -0.5f,  0.5f}, {-1, 0, 0}, {1, 1, 1, 1}, {0, 1}},
+        {{-0.5f,  0.5f, -0.5f}, {-1, 0, 0}, {1, 1, 1, 1}, {1, 0}},
+        {{-0.5f, -0.5f, -0.5f}, {-1, 0, 0}, {1, 1, 1, 1}, {1, 1}},
+        // 右面 (X = 0.5)
+        {{ 0.5f,  0.5f, -0.5f}, {1, 0, 0}, {1, 1, 1, 1}, {0, 0}},
+        {{ 0.5f,  0.5f,  0.5f}, {1, 0, 0}, {1, 1, 1, 1}, {1, 0}},
+        {{ 0.5f, -0.5f, -0.5f}, {1, 0, 0}, {1, 1, 1, 1}, {0, 1}},
+        {{ 0.5f, -0.5f, -0.5f}, {1, 0, 0}, {1, 1, 1, 1}, {0, 1}},
+        {{ 0.5f,  0.5f,  0.5f}, {1, 0, 0}, {1, 1, 1, 1}, {1, 0}},
+        {{ 0.5f, -0.5f,  0.5f}, {1, 0, 0}, {1, 1, 1, 1}, {1, 1}},
+        // 上面 (Y = 0.5)
+        {{-0.5f,  0.5f,  0.5f}, {0, 1, 0}, {1, 1, 1, 1}, {0, 0}},
+        {{ 0.5f,  0.5f,  0.5f}, {0, 1, 0}, {1, 1, 1, 1}, {1, 0}},
+        {{-0.5f,  0.5f, -0.5f}, {0, 1, 0}, {1, 1, 1, 1}, {0, 1}},
+        {{-0.5f,  0.5f, -0.5f}, {0, 1, 0}, {1, 1, 1, 1}, {0, 1}},
+        {{ 0.5f,  0.5f,  0.5f}, {0, 1, 0}, {1, 1, 1, 1}, {1, 0}},
+        {{ 0.5f,  0.5f, -0.5f}, {0, 1, 0}, {1, 1, 1, 1}, {1, 1}},
+        // 下面 (Y = -0.5)
+        {{-0.5f, -0.5f, -0.5f}, {0, -1, 0}, {1, 1, 1, 1}, {0, 0}},
+        {{ 0.5f, -0.5f, -0.5f}, {0, -1, 0}, {1, 1, 1, 1}, {1, 0}},
+        {{-0.5f, -0.5f,  0.5f}, {0, -1, 0}, {1, 1, 1, 1}, {0, 1}},
+        {{-0.5f, -0.5f,  0.5f}, {0, -1, 0}, {1, 1, 1, 1}, {0, 1}},
+        {{ 0.5f, -0.5f, -0.5f}, {0, -1, 0}, {1, 1, 1, 1}, {1, 0}},
+        {{ 0.5f, -0.5f,  0.5f}, {0, -1, 0}, {1, 1, 1, 1}, {1, 1}},
+    };
+}
+
+// グローバル公開用
+Engine::Vertex3D Box[36];
+
+// 静的初期化でコピー
+namespace {
+    struct BoxInitializer {
+        BoxInitializer() {
+            memcpy(Box, Engine::BoxVertices, sizeof(Box));
+        }
+    } g_boxInit;
+}
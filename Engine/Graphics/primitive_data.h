@@ -0,0 +1,23 @@
+// system/graphics/primitive_data.h
+#pragma once
+
+#include "vertex.h"
+
+struct ID3D11ShaderResourceView;
+
+// ============================================================
+// プリミティブの頂点データと既定のテクスチャ
+// Direct3Dのヘッダーを読まないので、描画しない専用サーバーのシミュレーションからも使える
+// （専用サーバーのGetDefaultTextureはnullptrを返す）
+// ============================================================
+namespace Engine {
+    // 立方体の頂点データ（36頂点）
+    extern Vertex3D BoxVertices[36];
+
+    // デフォルトテクスチャ取得
+    ID3D11ShaderResourceView* GetDefaultTexture();
+}
+
+// グローバル公開
+extern Engine::Vertex3D Box[36];
+inline ID3D11ShaderResourceView* GetPolygonTexture() { return Engine::GetDefaultTexture(); }
@@ -39,7 +39,7 @@ namespace Engine {
         float hw = size.x * 0.5f;
         float hh = size.y * 0.5f;
 
-        // ]s
+        // 回転行列
         float cosR = std::cos(rotation);
         float sinR = std::sin(rotation);
 
@@ -63,19 +63,19 @@ namespace Engine {
             pContext->Unmap(s_pVertexBuffer, 0);
         }
 
-        // }eAݒ
+        // マテリアル設定
         if (pMaterialBuffer) {
             MaterialData mat = {};
             mat.diffuse = { 1, 1, 1, 1 };
             pContext->UpdateSubresource(pMaterialBuffer, 0, nullptr, &mat, 0, 0);
         }
 
-        // eNX`ݒ
+        // テクスチャ設定
         if (pTexture) {
             pContext->PSSetShaderResources(0, 1, &pTexture);
         }
 
-        // `
+        // 描画
         UINT stride = sizeof(Vertex3D);
         UINT offset = 0;
         pContext->IASetVertexBuffers(0, 1, &s_pVertexBuffer, &stride, &offset);
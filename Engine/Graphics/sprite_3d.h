@@ -13,7 +13,7 @@ namespace Engine {
         static bool Initialize(ID3D11Device* pDevice);
         static void Finalize();
 
-        // 3DԂɔzuXvCg
+        // 3D空間に配置するスプライト
         static void Draw(
             ID3D11DeviceContext* pContext,
             ID3D11Buffer* pMaterialBuffer,
@@ -24,7 +24,7 @@ namespace Engine {
             const XMFLOAT3& rotation = { 0.0f, 0.0f, 0.0f }
         );
 
-        // r{[hiɃJj
+        // ビルボード（常にカメラを向く）
         static void DrawBillboard(
             ID3D11DeviceContext* pContext,
             ID3D11Buffer* pMaterialBuffer,
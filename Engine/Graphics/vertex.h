@@ -1,11 +1,12 @@
 #pragma once
 
-#include <DirectXMath.h>
+#include "Engine/Core/math_types.h"
+#include <cstdint>
 
 namespace Engine {
     using namespace DirectX;
 
-    // {3D_
+    // 基本3D頂点
     struct Vertex3D {
         XMFLOAT3 position;
         XMFLOAT3 normal;
@@ -28,7 +29,7 @@ namespace Engine {
         }
     };
 
-    // ̃XLbVp
+    // 将来のスキンメッシュ用
     struct VertexSkinned {
         XMFLOAT3 position;
         XMFLOAT3 normal;
@@ -38,7 +39,7 @@ namespace Engine {
         float boneWeights[4];
     };
 
-    // 2D_iXvCgpj
+    // 2D頂点（スプライト用）
     struct Vertex2D {
         XMFLOAT3 position;
         XMFLOAT4 color;
@@ -34,11 +34,11 @@ int GameController::GetGamepadValue(int id, int func) {
 bool GameController::GetWinMMState(GamepadState& state) {
     static int s_workingControllerId = -1;
 
-    // 삷Rg[[IDT
+    // 動作するコントローラーIDを探す
     if (s_workingControllerId == -1) {
         for (int id = 0; id < 16; id++) {
-            int testValue = GetGamepadValue(id, 3); // {^Ԃ擾ăeXg
-            if (testValue != 32767) { // G[łȂꍇ
+            int testValue = GetGamepadValue(id, 3); // ボタン状態を取得してテスト
+            if (testValue != 32767) { // エラーでない場合
                 s_workingControllerId = id;
                 break;
             }
@@ -50,36 +50,36 @@ bool GameController::GetWinMMState(GamepadState& state) {
         }
     }
 
-    // inport`Ŏ擾
+    // 元のinport形式で取得
     int leftX = GetGamepadValue(s_workingControllerId,0);
     int leftY = GetGamepadValue(s_workingControllerId,1);
-    //EXeBbN dwRpos (4)  dwUpos (5)
+    //右スティックは dwRpos (4) と dwUpos (5)
     int rightX = GetGamepadValue(s_workingControllerId,4);
     int rightY = GetGamepadValue(s_workingControllerId,5);
-    // gK[ Z/RȂǂ̑g̃}bsOێ
+    // トリガーは Z/Rなどの組合せだが既存のマッピングを維持
     int triggerL = GetGamepadValue(s_workingControllerId,2);
     int triggerR = GetGamepadValue(s_workingControllerId,6);
     int buttons = GetGamepadValue(s_workingControllerId,3);
 
-    // foCXؒf
+    // デバイス切断
     if (leftX ==32767) {
-        s_workingControllerId = -1; // IDZbgčČo
+        s_workingControllerId = -1; // IDをリセットして再検出させる
         state.connected = false;
         return false;
     }
 
     state.connected = true;
 
-    // l𐳋K
+    // 軸値を正規化
     state.leftStickX = (float)(leftX -32760) /32767.0f;
     state.leftStickY = (float)(leftY -32760) /32767.0f;
     state.rightStickX = (float)(rightX -32760) /32767.0f;
     state.rightStickY = (float)(rightY -32760) /32767.0f;
-    // gK[0..655350..1
+    // トリガーは0..65535を0..1へ
     state.leftTrigger = (float)triggerL /65535.0f;
     state.rightTrigger = (float)triggerR /65535.0f;
 
-    // {^
+    // ボタン
     for (int i = 0; i < 32; i++) {
         state.buttons[i] = (buttons & (1 << i)) != 0;
     }
@@ -115,7 +115,7 @@ bool GameController::TryOpenPS5() {
         attrib.Size = sizeof(HIDD_ATTRIBUTES);
 
         if (HidD_GetAttributes(hDev, &attrib)) {
-            // PS5 DualSense `FbN
+            // PS5 DualSense チェック
             if (attrib.VendorID == 0x054C && (attrib.ProductID == 0x0CE6 || attrib.ProductID == 0x0DF2)) {
                 s_hidHandle = hDev;
                 SetupDiDestroyDeviceInfoList(deviceInfoSet);
@@ -157,7 +157,7 @@ bool GameController::TryOpenPS4() {
         attrib.Size = sizeof(HIDD_ATTRIBUTES);
 
         if (HidD_GetAttributes(hDev, &attrib)) {
-            // PS4 DualShock4 `FbN
+            // PS4 DualShock4 チェック
             if (attrib.VendorID == 0x054C && (attrib.ProductID == 0x09CC || attrib.ProductID == 0x05C4 || attrib.ProductID == 0x0BA0)) {
                 s_hidHandle = hDev;
                 SetupDiDestroyDeviceInfoList(deviceInfoSet);
@@ -199,7 +199,7 @@ bool GameController::TryOpenSwitch() {
         attrib.Size = sizeof(HIDD_ATTRIBUTES);
 
         if (HidD_GetAttributes(hDev, &attrib)) {
-            // Nintendo Switch `FbN
+            // Nintendo Switch チェック
             if (attrib.VendorID == 0x057E && (attrib.ProductID == 0x2009 || attrib.ProductID == 0x2006 || attrib.ProductID == 0x2007)) {
                 s_hidHandle = hDev;
                 SetupDiDestroyDeviceInfoList(deviceInfoSet);
@@ -227,13 +227,13 @@ bool GameController::ReadPS5Extended(GamepadState& state) {
 
     state.extendedType = 2;
 
-    // WC
+    // ジャイロ
     state.gyro.available = true;
     state.gyro.gyroPitch = (float)(int16_t)(buffer[16] | (buffer[17] << 8)) * 0.001064f;
     state.gyro.gyroYaw = (float)(int16_t)(buffer[18] | (buffer[19] << 8)) * 0.001064f;
     state.gyro.gyroRoll = (float)(int16_t)(buffer[20] | (buffer[21] << 8)) * 0.001064f;
 
-    // ^b`pbh
+    // タッチパッド
     state.touchpad.available = true;
     state.touchpad.touched = (buffer[33] & 0x80) == 0;
     if (state.touchpad.touched) {
@@ -258,13 +258,13 @@ bool GameController::ReadPS4Extended(GamepadState& state) {
 
     state.extendedType = 1;
 
-    // PS4̃WCiPS5ƃItZbgႤꍇj
+    // PS4のジャイロ（PS5とオフセットが少し違う場合がある）
     state.gyro.available = true;
     state.gyro.gyroPitch = (float)(int16_t)(buffer[13] | (buffer[14] << 8)) * 0.00875f;
     state.gyro.gyroYaw = (float)(int16_t)(buffer[15] | (buffer[16] << 8)) * 0.00875f;
     state.gyro.gyroRoll = (float)(int16_t)(buffer[17] | (buffer[18] << 8)) * 0.00875f;
 
-    // PS4̃^b`pbh
+    // PS4のタッチパッド
     state.touchpad.available = true;
     state.touchpad.touched = (buffer[35] & 0x80) == 0;
     if (state.touchpad.touched) {
@@ -292,7 +292,7 @@ bool GameController::ReadSwitchExtended(GamepadState& state) {
 
     state.extendedType = 3;
 
-    // Switch̃WCi^b`pbh͂Ȃj
+    // Switchのジャイロ（タッチパッドはなし）
     state.gyro.available = true;
     int16_t gyroX = (int16_t)(buffer[19] | (buffer[20] << 8));
     int16_t gyroY = (int16_t)(buffer[21] | (buffer[22] << 8));
@@ -303,7 +303,7 @@ bool GameController::ReadSwitchExtended(GamepadState& state) {
     state.gyro.gyroYaw = gyroY * SWITCH_GYRO_SCALE;
     state.gyro.gyroRoll = gyroZ * SWITCH_GYRO_SCALE;
 
-    // Switchɂ̓^b`pbhȂ
+    // Switchにはタッチパッドなし
     state.touchpad.available = false;
     state.touchpad.touched = false;
 
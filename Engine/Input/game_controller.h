@@ -11,14 +11,14 @@
 #pragma comment(lib, "winmm.lib")
 
 struct GamepadState {
-    // {́iWinMMj
+    // 基本入力（WinMM）
     float leftStickX = 0.0f, leftStickY = 0.0f;
     float rightStickX = 0.0f, rightStickY = 0.0f;
     float leftTrigger = 0.0f, rightTrigger = 0.0f;
     bool buttons[32] = {};
     bool connected = false;
 
-    // g@\iHIDj
+    // 拡張機能（HID）
     struct {
         float gyroPitch = 0.0f, gyroYaw = 0.0f, gyroRoll = 0.0f;
         bool available = false;
@@ -32,7 +32,7 @@ struct GamepadState {
 
     int extendedType = 0; // 0=None, 1=PS4, 2=PS5, 3=Switch
 
-    // ֗\bh
+    // 便利メソッド
     bool IsAnyButtonPressed() const {
         for (int i = 0; i < 32; i++) {
             if (buttons[i]) return true;
@@ -54,7 +54,7 @@ private:
     static int s_extendedType;
     static bool s_hidInitialized;
 
-    // HIDg@\p
+    // HID拡張機能用
     static bool TryOpenPS5();
     static bool TryOpenPS4();
     static bool TryOpenSwitch();
@@ -65,7 +65,7 @@ private:
 public:
     static int GetGamepadValue(int id, int func);
     static bool Initialize() {
-        // HIDg@\̏isĂOKj
+        // HID拡張機能の初期化（失敗してもOK）
         if (TryOpenPS5()) {
             s_extendedType = 2;
             s_hidInitialized = true;
@@ -83,14 +83,14 @@ public:
             s_hidInitialized = false;
         }
 
-        return true; // WinMM͏ɗp\ƂĈ
+        return true; // WinMMは常に利用可能として扱う
     }
 
     static bool GetState(GamepadState& state) {
-        // {͂WinMMŎ擾
+        // 基本入力をWinMMで取得
         bool winmmSuccess = GetWinMMState(state);
 
-        // g@\HIDŎ擾isĂOKj
+        // 拡張機能をHIDで取得（失敗してもOK）
         if (s_hidInitialized && winmmSuccess) {
             switch (s_extendedType) {
             case 2: ReadPS5Extended(state); break;
@@ -132,8 +132,8 @@ private:
 };
 
 
-// pad.buttons[] ̃CfbNX
-// [0] = A/Cross/B (Wv)
+// pad.buttons[] のインデックス
+// [0] = A/Cross/B (ジャンプ)
 // [1] = B/Circle/A
 // [2] = X/Square/Y  
 // [3] = Y/Triangle/X
@@ -1,11 +1,11 @@
 //--------------------------------------------------------------------------------------
 // File: mouse.cpp
 //
-// ֗ȃ}EXW[
+// 便利なマウスモジュール
 //
 //--------------------------------------------------------------------------------------
 // 2025/06/27
-//     DirectXTKAȂ񂿂CpɃVFCvAbv
+//     DirectXTKより、なんちゃってC言語用にシェイプアップ改変
 //
 // Licensed under the MIT License.
 //
@@ -183,7 +183,7 @@ void Mouse_ProcessMessage(UINT message, WPARAM wParam, LPARAM lParam)
         point.x = gLastX;
         point.y = gLastY;
 
-        // [gfBXNgbvɑΉ邽߂ɈړOɃJ[\\
+        // リモートディスクトップに対応するために移動前にカーソルを表示する
         ShowCursor(TRUE);
 
         if (MapWindowPoints(gWindow, nullptr, &point, 1)) {
@@ -255,7 +255,7 @@ void Mouse_ProcessMessage(UINT message, WPARAM wParam, LPARAM lParam)
                 }
                 else if (raw.data.mouse.usFlags & MOUSE_VIRTUAL_DESKTOP) {
 
-                    // [gfBXNgbvȂǂɑΉ
+                    // リモートディスクトップなどに対応
                     const int width = GetSystemMetrics(SM_CXVIRTUALSCREEN);
                     const int height = GetSystemMetrics(SM_CYVIRTUALSCREEN);
 
@@ -341,13 +341,13 @@ void Mouse_ProcessMessage(UINT message, WPARAM wParam, LPARAM lParam)
         break;
 
     default:
-        // }EXɑ΂郁bZ[W͖c
+        // マウスに対するメッセージは無かった…
         return;
     }
 
     if (gMode == MOUSE_POSITION_MODE_ABSOLUTE) {
 
-        // ׂẴ}EXbZ[Wɑ΂ĐVW擾
+        // すべてのマウスメッセージに対して新しい座標を取得する
         int xPos = GET_X_LPARAM(lParam);
         int yPos = GET_Y_LPARAM(lParam);
 
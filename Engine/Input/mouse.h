@@ -1,11 +1,11 @@
 //--------------------------------------------------------------------------------------
 // File: mouse.h
 //
-// ֗ȃ}EXW[
+// 便利なマウスモジュール
 //
 //--------------------------------------------------------------------------------------
 // 2025/06/27
-//     DirectXTKAȂ񂿂CpɃVFCvAbv
+//     DirectXTKより、なんちゃってC言語用にシェイプアップ改変
 //
 // Licensed under the MIT License.
 //
@@ -21,15 +21,15 @@
 #include <memory>
 
 
-// }EX[h
+// マウスモード
 typedef enum Mouse_PositionMode_tag
 {
-    MOUSE_POSITION_MODE_ABSOLUTE, // ΍W[h
-    MOUSE_POSITION_MODE_RELATIVE, // ΍W[h
+    MOUSE_POSITION_MODE_ABSOLUTE, // 絶対座標モード
+    MOUSE_POSITION_MODE_RELATIVE, // 相対座標モード
 } Mouse_PositionMode;
 
 
-// }EXԍ\
+// マウス状態構造体
 typedef struct MouseState_tag
 {
     bool leftButton;
@@ -44,41 +44,41 @@ typedef struct MouseState_tag
 } Mouse_State;
 
 
-// }EXW[̏
+// マウスモジュールの初期化
 void Mouse_Initialize(HWND window);
 
-// }EXW[̏I
+// マウスモジュールの終了処理
 void Mouse_Finalize(void);
 
-// }EX̏Ԃ擾
+// マウスの状態を取得する
 void Mouse_GetState(Mouse_State* pState);
 
-// ݐς}EXXN[zC[lZbg
+// 累積したマウススクロールホイール値をリセットする
 void Mouse_ResetScrollWheelValue(void);
 
-// }EX̃|WV[hݒ肷iftHg͐΍W[hj
+// マウスのポジションモードを設定する（デフォルトは絶対座標モード）
 void Mouse_SetMode(Mouse_PositionMode mode);
 
-// }EX̐ڑo
+// マウスの接続を検出する
 bool Mouse_IsConnected(void);
 
-// }EXJ[\\Ă邩mF
+// マウスカーソルが表示されているか確認する
 bool Mouse_IsVisible(void);
 
-// }EXJ[\\ݒ肷
+// マウスカーソル表示を設定する
 void Mouse_SetVisible(bool visible);
 
-// }EX̂߂̃EBhEbZ[WvV[WtbN֐
+// マウス制御のためのウィンドウメッセージプロシージャフック関数
 void Mouse_ProcessMessage(UINT message, WPARAM wParam, LPARAM lParam);
 
 
-// @
+// 導入方法
 //
-// Ώۂ̃EBhEꂽ炻̃EBhEnhɏ֐Ă
+// 対象のウィンドウが生成されたらそのウィンドウハンドルを引数に初期化関数を呼ぶ
 //
 // Mouse_Initialize(hwnd);
 //
-// EBhEbZ[WvV[W}EXptbN֐Ăяo
+// ウィンドウメッセージプロシージャからマウス制御用フック関数を呼び出す
 //
 // LResult CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 // {
@@ -13,8 +13,36 @@
 namespace Game {
 
     void BulletManager::CheckBulletPlayerHits() {
-        // 全プレイヤーIDをチェック（現在は1と2）
-        for (int pid = 1; pid <= 2; ++pid) {
+        auto applyHit = [](Bullet& b, Player* player) {
+            b.Deactivate();
+            player->TakeDamage(1);
+
+            std::cout << "[BulletManager Hit!] Player " << player->GetPlayerId()
+                << " HP=" << player->GetHP() << "/" << player->GetMaxHP() << "\n";
+
+            if (!player->IsAlive()) {
+                std::cout << "[BulletManager Kill!] Player " << player->GetPlayerId()
+                    << " eliminated!\n";
+            }
+        };
+
+        // ラグ補償する弾（ホストがクライアントから受け取った弾）は、
+        // 撃った側が見ていた時刻のプレイヤーの位置と判定する
+        const Engine::ColliderHistory& history = PlayerManager::GetInstance().GetColliderHistory();
+        for (auto& b : m_bullets) {
+            if (!b || !b->active || b->rewindSeconds <= 0.0) continue;
+
+            // 履歴のスロット番号 = プレイヤーID - 1
+            const int hitSlot = history.OverlapBox(history.NewestTime() - b->rewindSeconds,
+                b->collider.GetMin(), b->collider.GetMax(), b->ownerPlayerId - 1);
+            if (hitSlot < 0) continue;
+
+            Player* player = PlayerManager::GetInstance().GetPlayer(hitSlot + 1);
+            if (player && player->IsAlive()) applyHit(*b, player);
+        }
+
+        // それ以外の弾は現在の位置で判定する（出現中のプレイヤーだけをチェック）
+        for (int pid : PlayerManager::GetInstance().GetActivePlayerIds()) {
             Player* player = PlayerManager::GetInstance().GetPlayer(pid);
             if (!player || !player->IsAlive()) continue;
 
@@ -26,23 +54,41 @@ namespace Game {
 
                 // 自分の弾には当たらない
                 if (b->ownerPlayerId == player->GetPlayerId()) continue;
+                // ラグ補償する弾は上で判定済み
+                if (b->rewindSeconds > 0.0) continue;
 
                 // 弾の collider とプレイヤーの collider で直接 AABB 交差判定
                 if (b->collider.Intersects(playerCol)) {
-                    b->Deactivate();
-                    player->TakeDamage(1);
-
-                    std::cout << "[BulletManager Hit!] Player " << player->GetPlayerId()
-                        << " HP=" << player->GetHP() << "/" << player->GetMaxHP() << "\n";
-
-                    if (!player->IsAlive()) {
-                        std::cout << "[BulletManager Kill!] Player " << player->GetPlayerId()
-                            << " eliminated!\n";
-                    }
+                    applyHit(*b, player);
                     break;  // この弾は消えたので次の弾へ
                 }
             }
         }
     }
 
+    void OnBulletPlayerCollision(const Engine::CollisionHit& hit) {
+        Bullet* bullet = nullptr;
+        Player* player = nullptr;
+        if (Engine::HasFlag(hit.dataA->layer, Engine::CollisionLayer::PROJECTILE))
+            bullet = static_cast<Bullet*>(hit.dataA->userData);
+        if (Engine::HasFlag(hit.dataB->layer, Engine::CollisionLayer::PROJECTILE))
+            bullet = static_cast<Bullet*>(hit.dataB->userData);
+        if (Engine::HasFlag(hit.dataA->layer, Engine::CollisionLayer::PLAYER))
+            player = static_cast<Player*>(hit.dataA->userData);
+        if (Engine::HasFlag(hit.dataB->layer, Engine::CollisionLayer::PLAYER))
+            player = static_cast<Player*>(hit.dataB->userData);
+        if (bullet && player && bullet->active && player->IsAlive()) {
+            if (bullet->ownerPlayerId == player->GetPlayerId()) return;
+            // ラグ補償する弾はBulletManagerが過去の位置で判定する
+            if (bullet->rewindSeconds > 0.0) return;
+            bullet->Deactivate();
+            player->TakeDamage(1);
+            std::cout << "[Hit!] Player " << player->GetPlayerId()
+                << " HP=" << player->GetHP() << "/" << player->GetMaxHP() << "\n";
+            if (!player->IsAlive()) {
+                std::cout << "[Kill!] Player " << player->GetPlayerId() << " eliminated!\n";
+            }
+        }
+    }
+
 } // namespace Game
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "Game/Objects/bullet.h"
+#include "Engine/Collision/collision_system.h"
 #include <memory>
 #include <vector>
 
@@ -64,4 +65,8 @@ namespace Game {
         void CheckBulletPlayerHits();
     };
 
+    // CollisionSystemの衝突コールバック（弾とプレイヤーの当たり）
+    // クライアントのSceneGameと専用サーバーで共通
+    void OnBulletPlayerCollision(const Engine::CollisionHit& hit);
+
 } // namespace Game
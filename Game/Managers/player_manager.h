@@ -7,48 +7,79 @@
 #pragma once
 
 #include "Game/Objects/player.h"
-#include "Game/Objects/camera.h"
+#include "Engine/Collision/collider_history.h"
 #include <memory>
 #include <vector>
 
+class NetworkManager;
+
 namespace Game {
 
 class Map;
 class Bullet;
 
 class PlayerManager {
+public:
+    // 同時に出現できるプレイヤー数（プレイヤーIDは1-MAX_PLAYERS）
+    static const int MAX_PLAYERS = 64;
+
 private:
     static PlayerManager* instance;
-    Player player1;
-    Player player2;
+    Player players[MAX_PLAYERS];      // プレイヤーのプール（添字 = ID - 1、確保し直さない）
+    int activeIndex[MAX_PLAYERS];     // 出現中ならactiveIdsの中の位置、いなければ-1
+    std::vector<int> activeIds;       // 出現中のプレイヤーID（更新・判定・同期はこれだけを回る）
+    Map* mapRef;
+    ID3D11ShaderResourceView* textureRef;
+    NetworkManager* networkRef;       // 入力・弾の送信と予測の記録に使う（nullptrならオフライン）
     int activePlayerId;
-    bool player1Initialized;
-    bool player2Initialized;
     bool initialPlayerLocked;
+    Engine::ColliderHistory colliderHistory;  // ラグ補償用の当たり判定の履歴（ホストのみ記録）
 
-    PlayerManager();
+    // 今回のティックのプレイヤーの当たり判定を履歴に記録する
+    void RecordColliderHistory();
 
 public:
     static PlayerManager& GetInstance();
+    // ゲームはGetInstance()の1つを使う。ホストとクライアントのワールドを同じプロセスで
+    // 分けて動かすとき（自己テスト）だけ別に作り、NetworkManager::set_player_managerで渡す
+    PlayerManager();
 
-    void Initialize(Map* map, ID3D11ShaderResourceView* texture);
+    // マップ・テクスチャ・通信を覚え、出現中のプレイヤーをすべて消す（出現はSpawnPlayerで行う）
+    // networkがnullptrなら通信しない（入力も弾も送らず、予測も記録しない）
+    void Initialize(Map* map, ID3D11ShaderResourceView* texture, NetworkManager* network);
     void SetInitialActivePlayer(int playerId);
     void Update(float deltaTime);
+    // 入力・カメラを使わない部分（プレイヤーの移動、弾、当たり判定の履歴）だけ進める
+    // 専用サーバーはこちらを呼ぶ
+    void UpdateSimulation(float deltaTime);
     void Draw();
 
+    // playerIdのプレイヤーを出現地点に出す（出現中ならそのまま返す、IDが範囲外ならnullptr）
+    Player* SpawnPlayer(int playerId);
+    // playerIdのプレイヤーを消す（当たり判定の登録も外す）
+    void DespawnPlayer(int playerId);
+    // 出現中のプレイヤーID（出現順）
+    const std::vector<int>& GetActivePlayerIds() const { return activeIds; }
+    // IDごとの出現地点
+    static XMFLOAT3 GetSpawnPoint(int playerId);
+
     void SetActivePlayer(int playerId);
     int GetActivePlayerId() const { return activePlayerId; }
 
     Player* GetActivePlayer();
+    // 出現中のプレイヤー（いなければnullptr）
     Player* GetPlayer(int playerId);
 
     void HandleInput(float deltaTime);
 
+    // 過去のプレイヤーの当たり判定（スロット番号 = プレイヤーID - 1、時刻はNetworkManager::get_time()）
+    const Engine::ColliderHistory& GetColliderHistory() const { return colliderHistory; }
+
     // 相手の位置を外部から更新する
     void ForceUpdatePlayer(int playerId, const XMFLOAT3& pos, const XMFLOAT3& rot);
 };
 
-void InitializePlayers(Map* map, ID3D11ShaderResourceView* texture);
+void InitializePlayers(Map* map, ID3D11ShaderResourceView* texture, NetworkManager* network);
 void UpdatePlayers();
 void DrawPlayers();
 GameObject* GetActivePlayerGameObject();
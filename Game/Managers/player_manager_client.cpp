@@ -0,0 +1,192 @@
+/*********************************************************************
+  \file    プレイヤーマネージャー（入力・カメラ・描画） [player_manager_client.cpp]
+
+  \Author  Ryoto Kikuchi
+  \data    2025
+ *********************************************************************/
+// クライアントだけが使う部分（キーボード・マウス・ゲームパッドの入力、カメラ、描画）
+// 専用サーバーはplayer_manager.cppのシミュレーションだけをリンクする
+#include "pch.h"
+#include "player_manager.h"
+#include "bullet_manager.h"
+#include "Game/Objects/bullet.h"
+#include "Game/Objects/camera.h"
+#include "Engine/Graphics/primitive.h"
+#include "NetWork/network_manager.h"
+#include "NetWork/network_common.h"
+#include "Engine/Input/keyboard.h"
+#include "Engine/Input/mouse.h"
+#include "Engine/Input/game_controller.h"
+#include <cmath>
+#include <memory>
+
+namespace Game {
+
+    void PlayerManager::Update(float deltaTime) {
+        HandleInput(deltaTime);
+        UpdateSimulation(deltaTime);
+    }
+
+    void PlayerManager::Draw() {
+        for (int id : activeIds) players[id - 1].Draw();
+        BulletManager::GetInstance().Draw();
+    }
+
+    void PlayerManager::SetActivePlayer(int playerId) {
+        if (initialPlayerLocked) return;
+
+        if (GetPlayer(playerId)) {
+            Player* current = GetActivePlayer();
+            CameraManager& camMgr = CameraManager::GetInstance();
+            if (current) {
+                current->SetCameraAngles(camMgr.GetRotation(), camMgr.GetPitch());
+            }
+
+            activePlayerId = playerId;
+
+            Player* next = GetActivePlayer();
+            if (next) {
+                camMgr.SetRotation(next->GetCameraYaw());
+                camMgr.SetPitch(next->GetCameraPitch());
+                camMgr.UpdateCameraForPlayer(activePlayerId);
+            }
+        }
+    }
+
+    void PlayerManager::HandleInput(float deltaTime) {
+        static bool was1Down = false;
+        static bool was2Down = false;
+
+        // プレイヤー切り替え（ロックされていなければ1/2キーで切り替え可能）
+        if (!initialPlayerLocked) {
+            if (Keyboard_IsKeyDown(KK_D1) && !was1Down) SetActivePlayer(1);
+            if (Keyboard_IsKeyDown(KK_D2) && !was2Down) SetActivePlayer(2);
+        }
+
+        was1Down = Keyboard_IsKeyDown(KK_D1);
+        was2Down = Keyboard_IsKeyDown(KK_D2);
+
+        Player* activePlayer = GetActivePlayer();
+        if (!activePlayer) return;
+
+        // ========== 移動入力 ==========
+        XMFLOAT3 moveDirection = { 0.0f, 0.0f, 0.0f };
+
+        float yawRad = XMConvertToRadians(activePlayer->GetRotation().y);
+        XMFLOAT3 forward = { sinf(yawRad), 0.0f, cosf(yawRad) };
+        XMFLOAT3 right = { cosf(yawRad), 0.0f, -sinf(yawRad) };
+
+        // キーボード入力
+        if (Keyboard_IsKeyDown(KK_W)) { moveDirection.x += forward.x; moveDirection.z += forward.z; }
+        if (Keyboard_IsKeyDown(KK_S)) { moveDirection.x -= forward.x; moveDirection.z -= forward.z; }
+        if (Keyboard_IsKeyDown(KK_A)) { moveDirection.x -= right.x;   moveDirection.z -= right.z; }
+        if (Keyboard_IsKeyDown(KK_D)) { moveDirection.x += right.x;   moveDirection.z += right.z; }
+
+        // ゲームパッド左スティック入力
+        GamepadState padState;
+        if (GameController::GetState(padState)) {
+            float lx = padState.leftStickX;
+            float ly = padState.leftStickY;
+            const float deadzone = 0.2f;
+            if (fabsf(lx) > deadzone || fabsf(ly) > deadzone) {
+                moveDirection.x += -forward.x * ly + right.x * lx;
+                moveDirection.z += -forward.z * ly + right.z * lx;
+            }
+        }
+
+        // 移動方向を正規化
+        float moveLength = sqrtf(moveDirection.x * moveDirection.x + moveDirection.z * moveDirection.z);
+        if (moveLength > 0.0f) {
+            moveDirection.x /= moveLength;
+            moveDirection.z /= moveLength;
+        }
+
+        // ジャンプ
+        bool jump = Keyboard_IsKeyDown(KK_SPACE);
+
+        // クライアント: 入力をホストへ送り、ホストが受け取るのと同じ（量子化後の）値で先に動かす
+        // 位置はホストが同じ入力から計算し、ずれていればNetworkManagerが巻き戻して再計算する
+        if (networkRef && !networkRef->is_host() && networkRef->getMyPlayerId() != 0) {
+            PacketInput input = {};
+            input.type = PKT_INPUT;
+            input.playerId = (uint32_t)activePlayer->GetPlayerId();
+            input.moveX = moveDirection.x;
+            input.moveY = moveDirection.y;
+            input.moveZ = moveDirection.z;
+            input.yaw = activePlayer->GetRotation().y;
+            input.buttons = jump ? INPUT_BUTTON_JUMP : 0;
+            networkRef->send_input(input);
+            moveDirection = { input.moveX, input.moveY, input.moveZ };
+        }
+
+        activePlayer->ApplyInput(moveDirection, jump, deltaTime);
+
+        // ========== 射撃（左クリック or ENTERキー） ==========
+
+        // マウス左ボタンのトリガー検出
+        Mouse_State mouseState;
+        Mouse_GetState(&mouseState);
+        static bool wasLButtonDown = false;
+        bool lClickTrigger = (mouseState.leftButton && !wasLButtonDown);
+        wasLButtonDown = mouseState.leftButton;
+
+        bool shootTrigger = Keyboard_IsKeyDownTrigger(KK_ENTER) || lClickTrigger;
+
+        if (activePlayer->IsAlive() && shootTrigger) {
+            // カメラの向きから発射方向を計算（pitch込みで上下にも飛ぶ）
+            CameraManager& cam = CameraManager::GetInstance();
+            float shootYaw = XMConvertToRadians(cam.GetRotation());
+            float shootPitch = XMConvertToRadians(cam.GetPitch());
+
+            XMFLOAT3 dir = {
+                sinf(shootYaw) * cosf(shootPitch),
+                sinf(shootPitch),
+                cosf(shootYaw) * cosf(shootPitch)
+            };
+
+            // 発射位置: プレイヤーの目の高さ + 前方に少しオフセット
+            XMFLOAT3 pos = activePlayer->GetPosition();
+            pos.y += 1.0f;
+            pos.x += dir.x * 0.6f;
+            pos.y += dir.y * 0.6f;
+            pos.z += dir.z * 0.6f;
+
+            // 弾を生成（撃ったプレイヤーのIDを渡して自弾判定に使う）
+            auto b = std::make_unique<Bullet>();
+            b->Initialize(GetPolygonTexture(), pos, dir, activePlayer->GetPlayerId());
+            BulletManager::GetInstance().Add(std::move(b));
+            // ネットワーク接続中なら弾の発射情報を送信
+            if (networkRef && (networkRef->is_host() || networkRef->getMyPlayerId() != 0)) {
+                PacketBullet pb = {};
+                pb.type = PKT_BULLET;
+                pb.seq = 0;
+                pb.ownerPlayerId = (uint32_t)activePlayer->GetPlayerId();
+                pb.viewTime = networkRef->get_view_time_ms16();
+                pb.posX = pos.x; pb.posY = pos.y; pb.posZ = pos.z;
+                pb.dirX = dir.x; pb.dirY = dir.y; pb.dirZ = dir.z;
+                networkRef->send_bullet(pb);
+            }
+        }
+    }
+
+    // === グローバル関数ラッパー ===
+
+    void UpdatePlayers() {
+        constexpr float fixedDelta = 1.0f / 60.0f;
+        PlayerManager::GetInstance().Update(fixedDelta);
+    }
+
+    void DrawPlayers() {
+        PlayerManager::GetInstance().Draw();
+    }
+
+    GameObject* GetActivePlayerGameObject() {
+        Player* activePlayer = PlayerManager::GetInstance().GetActivePlayer();
+        return activePlayer ? activePlayer->GetGameObject() : nullptr;
+    }
+
+    Player* GetActivePlayer() {
+        return PlayerManager::GetInstance().GetActivePlayer();
+    }
+
+} // namespace Game
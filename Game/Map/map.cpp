@@ -7,8 +7,7 @@
 #include "pch.h"
 #include "map.h"
 #include "Game/Objects/game_object.h"
-#include "map_renderer.h"
-#include "Engine/Graphics/primitive.h"
+#include "Engine/Graphics/primitive_data.h"
 
 namespace Game {
 
@@ -45,12 +44,12 @@ Map::~Map() {
 //=============================================================================
 // ����������
 //=============================================================================
-HRESULT Map::Initialize(ID3D11ShaderResourceView* texture) {
+bool Map::Initialize(ID3D11ShaderResourceView* texture) {
     // �T���v���}�b�v�f�[�^���쐬
     CreateSampleMap();
     GenerateBlockObjects(texture);
 
-    return S_OK;
+    return true;
 }
 
 //=============================================================================
@@ -6,20 +6,13 @@
  *********************************************************************/
 #pragma once
 
-#include "main.h"
 #include <vector>
 #include <memory>
 #include "Game/Objects/game_object.h"
+#include "map_config.h"   // MAP_WIDTH / MAP_HEIGHT / MAP_DEPTH
 
 namespace Game {
 
-//*****************************************************************************
-// �}�N����`
-//*****************************************************************************
-#define MAP_WIDTH  50    // �}�b�v�̕�
-#define MAP_HEIGHT 50    // �}�b�v�̍���
-#define MAP_DEPTH  50    // �}�b�v�̉��s��
-
 //*****************************************************************************
 // �\���̂̒�`
 //*****************************************************************************
@@ -44,7 +37,7 @@ public:
     ~Map();
 
     // �������E�I������
-    HRESULT Initialize(ID3D11ShaderResourceView* texture); // �e�N�X�`�����󂯎��悤�ύX
+    bool Initialize(ID3D11ShaderResourceView* texture); // �e�N�X�`�����󂯎��悤�ύX
     void Uninitialize();
 
     // �}�b�v�f�[�^�A�N�Z�X
@@ -0,0 +1,19 @@
+/*********************************************************************
+  \file    マップサイズ定義 [map_config.h]
+
+  描画やDirectXに依存しないマップの寸法定数。
+  ネットワーク層（座標の量子化範囲）からも参照する。
+
+  \Author  Ryoto Kikuchi
+  \data    2026/10/16
+ *********************************************************************/
+#pragma once
+
+//*****************************************************************************
+// マクロ定義
+//*****************************************************************************
+#define MAP_WIDTH  50    // マップの幅
+#define MAP_HEIGHT 50    // マップの高さ
+#define MAP_DEPTH  50    // マップの奥行き
+
+#define BOX_SIZE 1.0f    // 1つのボックスのサイズ
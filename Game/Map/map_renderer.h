@@ -11,14 +11,10 @@
 #include "Engine/Graphics/vertex.h"
 #include "Engine/Graphics/material.h"
 #include "map.h"
+#include "map_config.h"   // BOX_SIZE
 
 namespace Game {
 
-//*****************************************************************************
-// �}�N����`
-//*****************************************************************************
-#define BOX_SIZE 1.0f  // 1�̃{�b�N�X�̃T�C�Y
-
 //*****************************************************************************
 // �N���X��`
 //*****************************************************************************
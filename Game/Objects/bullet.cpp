@@ -1,7 +1,6 @@
 #include "pch.h"
 #include "bullet.h"
-#include "Engine/Core/renderer.h"
-#include "Engine/Graphics/primitive.h"
+#include "Engine/Graphics/primitive_data.h"
 #include "Engine/Collision/collision_system.h"
 #include "Engine/Collision/map_collision.h"
 
@@ -32,7 +31,8 @@ namespace Game {
         , collider(std::move(other.collider))
         , visual(std::move(other.visual))
         , m_collisionId(other.m_collisionId)
-        , ownerPlayerId(other.ownerPlayerId) {
+        , ownerPlayerId(other.ownerPlayerId)
+        , rewindSeconds(other.rewindSeconds) {
         other.m_collisionId = 0;
     }
 
@@ -50,6 +50,7 @@ namespace Game {
             visual = std::move(other.visual);
             m_collisionId = other.m_collisionId;
             ownerPlayerId = other.ownerPlayerId;
+            rewindSeconds = other.rewindSeconds;
 
             other.m_collisionId = 0;
         }
@@ -62,6 +63,7 @@ namespace Game {
         lifeTime = 3.0f;
         active = true;
         ownerPlayerId = ownerId;   // 弾を撃ったプレイヤーのIDを記録
+        rewindSeconds = 0.0;
 
         // 見た目の初期化
         visual.position = position;
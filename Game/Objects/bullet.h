@@ -1,8 +1,7 @@
 #pragma once
-#include "main.h"
+#include "Engine/Core/math_types.h"
 #include "Game/Objects/game_object.h"
 #include "Engine/Collision/box_collider.h"
-#include <DirectXMath.h>
 
 using namespace DirectX;
 
@@ -18,7 +17,11 @@ namespace Game {
         GameObject visual;
         uint32_t m_collisionId = 0;
 
-        int ownerPlayerId = 0;   // ̒evC[IDiɂ͓Ȃ悤ɂj
+        int ownerPlayerId = 0;   // この弾を撃ったプレイヤーのID（自分には当たらないようにする）
+
+        // ラグ補償: 撃った側が見ていた時刻までの遅れ（秒）
+        // 0より大きければ、現在ではなくその分だけ過去のプレイヤーの位置と判定する（ホストのみ）
+        double rewindSeconds = 0.0;
 
         Bullet();
         ~Bullet();
@@ -28,7 +31,7 @@ namespace Game {
         Bullet(Bullet&&) noexcept;
         Bullet& operator=(Bullet&&) noexcept;
 
-        // ownerId󂯎悤ɕύX
+        // ownerIdを受け取るように変更
         void Initialize(ID3D11ShaderResourceView* texture, const XMFLOAT3& pos, const XMFLOAT3& dir, int ownerId = 0);
         void Update(float deltaTime);
         void Draw();
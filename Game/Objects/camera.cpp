@@ -32,7 +32,7 @@ Camera& GetMainCamera() {
 
 // �v���C���[�������p�i�O������͌Ă΂Ȃ��j
 void InitializePlayer(Map* map, ID3D11ShaderResourceView* texture) {
-	InitializePlayers(map, texture);
+	InitializePlayers(map, texture, &g_network);
 }
 
 // �v���C���[�`��p
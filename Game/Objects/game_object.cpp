@@ -22,10 +22,7 @@ GameObject::GameObject()
 }
 
 GameObject::~GameObject() {
-    if (vertexBuffer) {
-        vertexBuffer->Release();
-        vertexBuffer = nullptr;
-    }
+    releaseVertexBuffer();
 }
 
 GameObject::GameObject(GameObject&& other) noexcept
@@ -52,7 +49,7 @@ GameObject::GameObject(GameObject&& other) noexcept
 
 GameObject& GameObject::operator=(GameObject&& other) noexcept {
     if (this != &other) {
-        if (vertexBuffer) vertexBuffer->Release();
+        releaseVertexBuffer();
 
         position = other.position;
         velocity = other.velocity;
@@ -110,69 +107,6 @@ void GameObject::setMesh(const Engine::Vertex3D* vertices, int count, ID3D11Shad
     bufferNeedsUpdate = true;
 }
 
-void GameObject::createVertexBuffer() {
-    if (vertexBuffer) {
-        vertexBuffer->Release();
-        vertexBuffer = nullptr;
-    }
-
-    if (!meshVertices || meshVertexCount == 0) return;
-
-    D3D11_BUFFER_DESC bd = {};
-    bd.Usage = D3D11_USAGE_DEFAULT;
-    bd.ByteWidth = sizeof(Engine::Vertex3D) * meshVertexCount;
-    bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-
-    D3D11_SUBRESOURCE_DATA subResource = {};
-    subResource.pSysMem = meshVertices;
-
-    Engine::GetDevice()->CreateBuffer(&bd, &subResource, &vertexBuffer);
-}
-
-void GameObject::draw() {
-    if (!meshVertices || meshVertexCount == 0) return;
-
-    if (bufferNeedsUpdate || !vertexBuffer) {
-        createVertexBuffer();
-        bufferNeedsUpdate = false;
-    }
-
-    if (!vertexBuffer) return;
-
-    if (m_worldMatrixDirty) {
-        XMMATRIX S = XMMatrixScaling(scale.x, scale.y, scale.z);
-        XMMATRIX R = XMMatrixRotationRollPitchYaw(
-            XMConvertToRadians(rotation.x),
-            XMConvertToRadians(rotation.y),
-            XMConvertToRadians(rotation.z));
-        XMMATRIX T = XMMatrixTranslation(position.x, position.y, position.z);
-        m_cachedWorldMatrix = S * R * T;
-        m_worldMatrixDirty = false;
-    }
-
-    Engine::Renderer::GetInstance().SetWorldMatrix(m_cachedWorldMatrix);
-
-    if (texture) {
-        Engine::GetDeviceContext()->PSSetShaderResources(0, 1, &texture);
-    }
-
-    UINT stride = sizeof(Engine::Vertex3D);
-    UINT offset = 0;
-    Engine::GetDeviceContext()->IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
-    Engine::GetDeviceContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-
-    Engine::MaterialData mat = {};
-    mat.diffuse = XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
-
-    auto* ctx = Engine::Renderer::GetInstance().GetContext();
-    auto* buf = Engine::Renderer::GetInstance().GetMaterialBuffer();
-    if (ctx && buf) {
-        ctx->UpdateSubresource(buf, 0, nullptr, &mat, 0, 0);
-    }
-
-    Engine::GetDeviceContext()->Draw(meshVertexCount, 0);
-}
-
 void GameObject::Move(const XMFLOAT3& direction, float speed, float deltaTime) {
     position.x += direction.x * speed * deltaTime;
     position.y += direction.y * speed * deltaTime;
@@ -182,35 +116,25 @@ void GameObject::Move(const XMFLOAT3& direction, float speed, float deltaTime) {
     updateColliderTransform();
 }
 
-void GameObject::setNetworkTarget(const XMFLOAT3& targetPos, const XMFLOAT3& targetRot) {
-    m_netTargetPos = targetPos;
-    m_netTargetRot = targetRot;
-    m_hasNetTarget = true;
+void GameObject::setNetworkTarget(const XMFLOAT3& targetPos, const XMFLOAT3& targetRot, double time) {
+    ObjectState os = {};
+    os.id = id;
+    os.posX = targetPos.x; os.posY = targetPos.y; os.posZ = targetPos.z;
+    os.rotX = targetRot.x; os.rotY = targetRot.y; os.rotZ = targetRot.z;
+    m_netBuffer.push(time, os);
 }
 
-void GameObject::updateNetworkInterpolation(float lerpFactor) {
-    if (!m_hasNetTarget) return;
+void GameObject::updateNetworkInterpolation(double renderTime) {
+    // 表示時刻を挟む2つのスナップショットを補間する（遅れているときは少しだけ外挿）
+    ObjectState os;
+    if (!m_netBuffer.sample(renderTime, os)) return;
 
-    // `ԂŌ݈ʒu^[Qbgɋ߂Â
-    position.x += (m_netTargetPos.x - position.x) * lerpFactor;
-    position.y += (m_netTargetPos.y - position.y) * lerpFactor;
-    position.z += (m_netTargetPos.z - position.z) * lerpFactor;
-
-    rotation.x += (m_netTargetRot.x - rotation.x) * lerpFactor;
-    rotation.y += (m_netTargetRot.y - rotation.y) * lerpFactor;
-    rotation.z += (m_netTargetRot.z - rotation.z) * lerpFactor;
+    position = { os.posX, os.posY, os.posZ };
+    rotation = { os.rotX, os.rotY, os.rotZ };
 
     m_worldMatrixDirty = true;
     bufferNeedsUpdate = true;
     updateColliderTransform();
-
-    // \߂ÂԏI
-    float dx = m_netTargetPos.x - position.x;
-    float dy = m_netTargetPos.y - position.y;
-    float dz = m_netTargetPos.z - position.z;
-    if ((dx * dx + dy * dy + dz * dz) < 0.0001f) {
-        m_hasNetTarget = false;
-    }
 }
 
 } // namespace Game
@@ -1,14 +1,17 @@
 #pragma once
 
 #include <memory>
-#include "Engine/Core/renderer.h"
+#include "Engine/Core/math_types.h"
 #include "Engine/Graphics/vertex.h"
 #include "Engine/Collision/box_collider.h"
-#include "Engine/Graphics/material.h"
-#include <DirectXMath.h>
+#include "NetWork/interpolation_buffer.h"
 
 using namespace DirectX;
 
+// 描画のリソースはポインターで持つだけ（d3d11.hを読まない専用サーバーでもこのヘッダーを使う）
+struct ID3D11Buffer;
+struct ID3D11ShaderResourceView;
+
 namespace Game {
 
 // オブジェクト種別を識別する列挙型
@@ -49,11 +52,12 @@ public:
     // ライフサイクル仮想関数
     virtual void Initialize() {}
     virtual void Finalize() {}
-    virtual void Update(float deltaTime) {}
-    virtual void OnCollision(GameObject* other) {}
+    virtual void Update(float /*deltaTime*/) {}
+    virtual void OnCollision(GameObject* /*other*/) {}
 
     void setBoxCollider(const XMFLOAT3& size);
     void setMesh(const Engine::Vertex3D* vertices, int count, ID3D11ShaderResourceView* tex);
+    // 描画（game_object_draw.cpp、専用サーバーでは何もしない）
     virtual void draw();
 
     void markBufferForUpdate() { bufferNeedsUpdate = true; m_worldMatrixDirty = true; }
@@ -90,26 +94,30 @@ protected:
 
 private:
     uint32_t id = 0;
-    XMMATRIX m_cachedWorldMatrix = XMMatrixIdentity();
+    XMFLOAT4X4 m_cachedWorldMatrix = {};  // draw()で計算した行列（m_worldMatrixDirtyなら作り直す）
     bool m_worldMatrixDirty = true;
 
     void createVertexBuffer();
+    void releaseVertexBuffer();
     void updateColliderTransform();
 
-    // ネットワーク補間用
-    XMFLOAT3 m_netTargetPos = { 0.0f, 0.0f, 0.0f };
-    XMFLOAT3 m_netTargetRot = { 0.0f, 0.0f, 0.0f };
-    bool m_hasNetTarget = false;
+    // ネットワーク補間用（受信したスナップショットの履歴）
+    InterpolationBuffer m_netBuffer;
 
 public:
-    // ネットワーク受信時の補間ターゲットを設定する
-    void setNetworkTarget(const XMFLOAT3& targetPos, const XMFLOAT3& targetRot);
+    // ネットワークで受信した状態を補間バッファに追加する
+    // time: そのスナップショットのローカル時刻（NetworkManager::get_time()の時間軸）
+    void setNetworkTarget(const XMFLOAT3& targetPos, const XMFLOAT3& targetRot, double time);
+
+    // 毎フレーム呼んで、renderTime時点の状態を補間して反映する
+    // renderTime: NetworkManager::get_render_time()（現在時刻から表示遅延を引いた時刻）
+    void updateNetworkInterpolation(double renderTime);
 
-    // 毎フレーム呼んで補間ターゲットに向かって滑らかに移動する
-    void updateNetworkInterpolation(float lerpFactor = 0.2f);
+    // 補間するスナップショットがあるか
+    bool hasNetworkTarget() const { return !m_netBuffer.empty(); }
 
-    // 補間ターゲットがあるか
-    bool hasNetworkTarget() const { return m_hasNetTarget; }
+    // 補間バッファを空にする（プールのオブジェクトを別の出現に使い回すとき）
+    void clearNetworkTarget() { m_netBuffer.clear(); }
 };
 
 } // namespace Game
@@ -0,0 +1,77 @@
+// GameObjectの描画（頂点バッファの作成・解放とdraw）
+// Direct3Dを使うのでクライアントだけが持つ。専用サーバーはServer/headless_render.cppの空の実装を使う
+#include "pch.h"
+#include "game_object.h"
+#include "Engine/Core/renderer.h"
+#include "Engine/Graphics/material.h"
+
+namespace Game {
+
+void GameObject::releaseVertexBuffer() {
+    if (vertexBuffer) {
+        vertexBuffer->Release();
+        vertexBuffer = nullptr;
+    }
+}
+
+void GameObject::createVertexBuffer() {
+    releaseVertexBuffer();
+
+    if (!meshVertices || meshVertexCount == 0) return;
+
+    D3D11_BUFFER_DESC bd = {};
+    bd.Usage = D3D11_USAGE_DEFAULT;
+    bd.ByteWidth = sizeof(Engine::Vertex3D) * meshVertexCount;
+    bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+
+    D3D11_SUBRESOURCE_DATA subResource = {};
+    subResource.pSysMem = meshVertices;
+
+    Engine::GetDevice()->CreateBuffer(&bd, &subResource, &vertexBuffer);
+}
+
+void GameObject::draw() {
+    if (!meshVertices || meshVertexCount == 0) return;
+
+    if (bufferNeedsUpdate || !vertexBuffer) {
+        createVertexBuffer();
+        bufferNeedsUpdate = false;
+    }
+
+    if (!vertexBuffer) return;
+
+    if (m_worldMatrixDirty) {
+        XMMATRIX S = XMMatrixScaling(scale.x, scale.y, scale.z);
+        XMMATRIX R = XMMatrixRotationRollPitchYaw(
+            XMConvertToRadians(rotation.x),
+            XMConvertToRadians(rotation.y),
+            XMConvertToRadians(rotation.z));
+        XMMATRIX T = XMMatrixTranslation(position.x, position.y, position.z);
+        XMStoreFloat4x4(&m_cachedWorldMatrix, S * R * T);
+        m_worldMatrixDirty = false;
+    }
+
+    Engine::Renderer::GetInstance().SetWorldMatrix(XMLoadFloat4x4(&m_cachedWorldMatrix));
+
+    if (texture) {
+        Engine::GetDeviceContext()->PSSetShaderResources(0, 1, &texture);
+    }
+
+    UINT stride = sizeof(Engine::Vertex3D);
+    UINT offset = 0;
+    Engine::GetDeviceContext()->IASetVertexBuffers(0, 1, &vertexBuffer, &stride, &offset);
+    Engine::GetDeviceContext()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+    Engine::MaterialData mat = {};
+    mat.diffuse = XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+
+    auto* ctx = Engine::Renderer::GetInstance().GetContext();
+    auto* buf = Engine::Renderer::GetInstance().GetMaterialBuffer();
+    if (ctx && buf) {
+        ctx->UpdateSubresource(buf, 0, nullptr, &mat, 0, 0);
+    }
+
+    Engine::GetDeviceContext()->Draw(meshVertexCount, 0);
+}
+
+} // namespace Game
@@ -1,7 +1,7 @@
 #include "pch.h"
 #include "player.h"
 #include "Game/Map/map.h"
-#include "Engine/Graphics/primitive.h"
+#include "Engine/Graphics/primitive_data.h"
 #include "Engine/Collision/collision_system.h"
 #include "Engine/Collision/map_collision.h"
 #include <cmath>
@@ -28,6 +28,10 @@ namespace Game {
     }
 
     Player::~Player() {
+        Uninitialize();
+    }
+
+    void Player::Uninitialize() {
         if (m_collisionId != 0) {
             Engine::CollisionSystem::GetInstance().Unregister(m_collisionId);
             m_collisionId = 0;
@@ -35,6 +39,9 @@ namespace Game {
     }
 
     void Player::Initialize(Map* map, ID3D11ShaderResourceView* texture, int id, ViewMode mode) {
+        // プールで使い回すので、前の登録が残っていれば外してから登録し直す
+        Uninitialize();
+
         mapRef = map;
         playerId = id;
         viewMode = mode;
@@ -116,11 +123,18 @@ namespace Game {
         visualObject.markBufferForUpdate();
     }
 
-    void Player::Move(const XMFLOAT3& direction, float deltaTime) {
+    void Player::Move(const XMFLOAT3& direction, float /*deltaTime*/) {
         velocity.x = direction.x * MOVE_SPEED;
         velocity.z = direction.z * MOVE_SPEED;
     }
 
+    void Player::ApplyInput(const XMFLOAT3& moveDirection, bool jump, float deltaTime) {
+        Move(moveDirection, deltaTime);
+        if (jump) {
+            Jump();
+        }
+    }
+
     void Player::Jump() {
         // 接地中のみジャンプ可能
         if (isGrounded) {
@@ -170,6 +184,14 @@ namespace Game {
         UpdateCollider();
     }
 
+    void Player::ResetMovementState(const XMFLOAT3& pos, float velocityY, bool grounded) {
+        // ForceSetPositionと違い地面への補正はしない（ホストで計算済みの値をそのまま使う）
+        position = pos;
+        velocity.y = velocityY;
+        isGrounded = grounded;
+        UpdateCollider();
+    }
+
     void Player::ForceSetRotation(const XMFLOAT3& rot) {
         rotation = rot;
         visualObject.rotation = rotation;
@@ -1,8 +1,7 @@
 #pragma once
-#include "main.h"
+#include "Engine/Core/math_types.h"
 #include "Game/Objects/game_object.h"
 #include "Engine/Collision/box_collider.h"
-#include <DirectXMath.h>
 
 using namespace DirectX;
 
@@ -29,20 +28,20 @@ namespace Game {
         int hp;
         bool isAlive;
 
-        // --- vC[̃TCY萔 ---
+        // --- プレイヤーのサイズ定数 ---
         static constexpr float WIDTH = 0.8f;
         static constexpr float HEIGHT = 1.8f;
         static constexpr float DEPTH = 0.8f;
 
-        // --- 萔 ---
+        // --- 物理定数 ---
         static constexpr float GRAVITY = -9.8f;
         static constexpr float JUMP_POWER = 5.0f;
         static constexpr float MOVE_SPEED = 5.0f;
         static constexpr float FRICTION = 0.85f;
 
-        // --- HPݒ ---
-        static constexpr int MAX_HP = 10;   // őHP
-        static constexpr int BULLET_DMG = 1;    // e1̃_[W
+        // --- HP設定 ---
+        static constexpr int MAX_HP = 10;   // 最大HP
+        static constexpr int BULLET_DMG = 1;    // 弾1発あたりのダメージ
 
         bool isGrounded;
         Map* mapRef;
@@ -59,15 +58,22 @@ namespace Game {
         ~Player();
 
         void Initialize(Map* map, ID3D11ShaderResourceView* texture, int id = 0, ViewMode mode = ViewMode::THIRD_PERSON);
+        // 衝突システムへの登録を外す（もう一度Initializeすれば使い直せる）
+        void Uninitialize();
         void Update(float deltaTime);
         void Draw();
 
         void Move(const XMFLOAT3& direction, float deltaTime);
         void Jump();
 
-        // --- ʒuEԂ̎擾 ---
+        // 1ティック分の入力を適用する（Move + Jump）
+        // ローカル操作・ホストでのクライアント入力・予測の再計算で同じ処理を使う
+        void ApplyInput(const XMFLOAT3& moveDirection, bool jump, float deltaTime);
+
+        // --- 位置・状態の取得 ---
         XMFLOAT3 GetPosition() const { return position; }
         XMFLOAT3 GetRotation() const { return rotation; }
+        XMFLOAT3 GetVelocity() const { return velocity; }
         const Engine::BoxCollider& GetCollider() const { return collider; }
         Engine::BoxCollider* GetColliderPtr() { return &collider; }
         bool IsGrounded() const { return isGrounded; }
@@ -75,28 +81,31 @@ namespace Game {
         ViewMode GetViewMode() const { return viewMode; }
         uint32_t GetCollisionId() const { return m_collisionId; }
 
-        // --- ʒuEԂ̐ݒ ---
+        // --- 位置・状態の設定 ---
         void SetPosition(const XMFLOAT3& pos);
         void SetRotation(const XMFLOAT3& rot) { rotation = rot; }
         void SetViewMode(ViewMode mode) { viewMode = mode; }
         void SetGrounded(bool grounded) { isGrounded = grounded; }
 
-        // --- Jpx̕ۑEA ---
+        // --- カメラ角度の保存・復帰 ---
         void SetCameraAngles(float yaw, float pitch);
         float GetCameraYaw() const;
         float GetCameraPitch() const;
 
-        // --- Փˏ ---
+        // --- 衝突処理 ---
         void ApplyPenetration(const XMFLOAT3& penetration);
 
-        // --- GameObjectւ̃ANZX ---
+        // --- GameObjectへのアクセス ---
         GameObject* GetGameObject();
 
-        // --- lbg[Np̋ʒuݒ ---
+        // --- ネットワーク用の強制位置設定 ---
         void ForceSetPosition(const XMFLOAT3& pos);
         void ForceSetRotation(const XMFLOAT3& rot);
 
-        // --- HP֘A ---
+        // --- ネットワーク用: ホストの結果に移動状態を戻す（クライアント側予測の照合） ---
+        void ResetMovementState(const XMFLOAT3& pos, float velocityY, bool grounded);
+
+        // --- HP関連 ---
         int GetHP() const { return hp; }
         int GetMaxHP() const { return MAX_HP; }
         bool IsAlive() const { return isAlive; }
@@ -17,6 +17,7 @@
 #include "Game/Map/map_renderer.h"
 #include "Game/Objects/player.h"
 #include "Game/Managers/player_manager.h"
+#include "Game/Managers/bullet_manager.h"
 #include "Game/Objects/camera.h"
 #include "NetWork/network_manager.h"
 #include "Game/Objects/bullet.h"
@@ -66,11 +67,11 @@ namespace Game {
             "Select Role", MB_YESNO | MB_ICONQUESTION | MB_DEFBUTTON1);
         bool isHost = (msgRes == IDYES);
 
-        // ホスト→Player1操作, クライアント→Player2操作
+        // ホスト→Player1操作, クライアント→ホストが割り当てたIDのプレイヤー（JOIN_ACKで決まる）
         PlayerManager::GetInstance().SetInitialActivePlayer(isHost ? 1 : 2);
 
-        // === 両方のプレイヤーを初期化（衝突システム登録のため必須） ===
-        InitializePlayers(m_pMap, Engine::GetDefaultTexture());
+        // === プレイヤーの準備（出現させるのは衝突システムの初期化の後） ===
+        InitializePlayers(m_pMap, Engine::GetDefaultTexture(), &g_network);
 
         // === カメラ初期化 ===
         InitializeCameraSystem();
@@ -94,69 +95,48 @@ namespace Game {
             }
         }
 
-        // === 衝突コールバック（変更なし） ===
-        Engine::CollisionSystem::GetInstance().SetCallback(
-            [](const Engine::CollisionHit& hit) {
-                /* ... 既存のコールバックコードそのまま ... */
-                Bullet* bullet = nullptr;
-                Player* player = nullptr;
-                if (Engine::HasFlag(hit.dataA->layer, Engine::CollisionLayer::PROJECTILE))
-                    bullet = static_cast<Bullet*>(hit.dataA->userData);
-                if (Engine::HasFlag(hit.dataB->layer, Engine::CollisionLayer::PROJECTILE))
-                    bullet = static_cast<Bullet*>(hit.dataB->userData);
-                if (Engine::HasFlag(hit.dataA->layer, Engine::CollisionLayer::PLAYER))
-                    player = static_cast<Player*>(hit.dataA->userData);
-                if (Engine::HasFlag(hit.dataB->layer, Engine::CollisionLayer::PLAYER))
-                    player = static_cast<Player*>(hit.dataB->userData);
-                if (bullet && player && bullet->active && player->IsAlive()) {
-                    if (bullet->ownerPlayerId == player->GetPlayerId()) return;
-                    bullet->Deactivate();
-                    player->TakeDamage(1);
-                    std::cout << "[Hit!] Player " << player->GetPlayerId()
-                        << " HP=" << player->GetHP() << "/" << player->GetMaxHP() << "\n";
-                    if (!player->IsAlive()) {
-                        std::cout << "[Kill!] Player " << player->GetPlayerId() << " eliminated!\n";
-                    }
-                }
-            }
-        );
+        // === 衝突コールバック（専用サーバーと共通） ===
+        Engine::CollisionSystem::GetInstance().SetCallback(OnBulletPlayerCollision);
 
         // === ネットワーク起動 ===
+        bool joining = false;
         if (isHost) {
             if (g_network.start_as_host()) {
                 std::cout << "[SceneGame] HOST started - waiting for client...\n";
             }
         } else {
             if (g_network.start_as_client()) {
-                std::string hostIp;
-                if (g_network.discover_and_join(hostIp)) {
-                    std::cout << "[SceneGame] CLIENT connected to " << hostIp << "\n";
-                } else {
-                    std::cout << "[SceneGame] CLIENT: host not found\n";
-                }
+                // 探索は待たずに進める（結果はg_network.update()の中で届く）
+                joining = g_network.start_discovery([this](bool found, const DiscoveredHost& host) {
+                    if (found) {
+                        std::cout << "[SceneGame] CLIENT connected to " << host.endpoint.ip_string()
+                            << " (channel " << host.channel << ", " << host.playerCount << "/"
+                            << host.maxPlayers << " players, " << host.rttMs << " ms)\n";
+                    } else {
+                        std::cout << "[SceneGame] CLIENT: host not found\n";
+                        m_spawnOfflinePlayer = true;
+                    }
+                });
             }
         }
 
-        // === ローカルプレイヤーのID設定 ===
-        GameObject* localGo = GetLocalPlayerGameObject();
-        if (localGo) {
-            localGo->setId(isHost ? 1 : 2);
-            m_worldObjects.push_back(MakeNonOwning(localGo));
-        }
-
-        // === 相手プレイヤーのGameObjectもworldObjectsに登録 ===
-        Player* otherPlayer = PlayerManager::GetInstance().GetPlayer(isHost ? 2 : 1);
-        if (otherPlayer) {
-            GameObject* otherGo = otherPlayer->GetGameObject();
-            if (otherGo) {
-                otherGo->setId(isHost ? 2 : 1);
-                m_worldObjects.push_back(MakeNonOwning(otherGo));
-            }
+        // === ローカルプレイヤーの出現 ===
+        // 参加中のクライアントは、JOIN_ACKで割り当てられたIDのプレイヤーをNetworkManagerが出す
+        // 他のプレイヤーは参加やSTATEの受信に合わせてNetworkManagerが出し入れする
+        if (!joining) {
+            SpawnLocalPlayer(isHost ? 1 : 2);
         }
 
         return S_OK;
     }
 
+    void SceneGame::SpawnLocalPlayer(int playerId) {
+        Player* localPlayer = PlayerManager::GetInstance().SpawnPlayer(playerId);
+        if (localPlayer) {
+            m_worldObjects.push_back(MakeNonOwning(localPlayer->GetGameObject()));
+        }
+    }
+
 
 
     void SceneGame::Finalize() {
@@ -179,33 +159,32 @@ namespace Game {
     }
 
     void SceneGame::Update() {
-        static int frameCounter = 0;
-        frameCounter++;
-
         // === ネットワーク更新 ===
         GameObject* localGo = GetLocalPlayerGameObject();
         constexpr float fixedDt = 1.0f / 60.0f;
         g_network.update(fixedDt, localGo, m_worldObjects);
 
+        // ホストが見つからなければ、1人で遊べるように自分のプレイヤーを出す
+        if (m_spawnOfflinePlayer) {
+            m_spawnOfflinePlayer = false;
+            SpawnLocalPlayer(2);
+            localGo = GetLocalPlayerGameObject();
+        }
+
         // ネットワーク補間（ローカル以外）
+        // 全員を同じ「少し過去の時刻」で補間する（遅れはジッターに合わせて自動調整）
+        const double renderTime = g_network.get_render_time();
         for (const auto& go : m_worldObjects) {
             if (!go) continue;
             if (localGo && go->getId() == localGo->getId()) continue;
-            go->updateNetworkInterpolation(0.2f);
+            go->updateNetworkInterpolation(renderTime);
 
-            int goId = (int)go->getId();
-            if (goId == 1 || goId == 2) {
-                PlayerManager::GetInstance().ForceUpdatePlayer(
-                    goId, go->getPosition(), go->getRotation());
-            }
-        }
+            // ホストが入力から動かしているクライアントのプレイヤーは補間対象外
+            if (!go->hasNetworkTarget()) continue;
 
-        // === フレーム同期（3フレームごと） ===
-        if (frameCounter % 3 == 0) {
-            bool isNetworkActive = g_network.is_host() || g_network.getMyPlayerId() != 0;
-            if (isNetworkActive) {
-                g_network.FrameSync(localGo, m_worldObjects);
-            }
+            // 補間するのはプレイヤーだけ（IDがプレイヤーでなければForceUpdatePlayerは何もしない）
+            PlayerManager::GetInstance().ForceUpdatePlayer(
+                (int)go->getId(), go->getPosition(), go->getRotation());
         }
 
         // === ゲームロジック更新 ===
@@ -213,6 +192,12 @@ namespace Game {
         UpdateCameraSystem();
         UpdatePlayer();  // ← この中で BulletManager::Update() が弾を移動させる
         Engine::CollisionSystem::GetInstance().Update();  // ← 移動後の位置で衝突判定
+
+        // === ホスト: このフレームの結果を公開する（STATEはワーカースレッドが10Hzで送る） ===
+        g_network.publish_snapshot();
+
+        // === このフレームで溜めた送信（入力・弾・STATE）を接続ごとに1パケットにまとめて送る ===
+        g_network.flush_messages();
     }
 
 
@@ -69,6 +69,10 @@ namespace Game {
         Map* m_pMap = nullptr;
         MapRenderer* m_pMapRenderer = nullptr;
         std::vector<std::shared_ptr<GameObject>> m_worldObjects;
+        bool m_spawnOfflinePlayer = false;  // ホストが見つからなかった（次のUpdateで自分のプレイヤーを出す）
+
+        // ローカルプレイヤーを出してワールドに加える（参加していないとき）
+        void SpawnLocalPlayer(int playerId);
 
         // HP表示UIの描画（画面左上にHPバー＋テキスト）
         void DrawHPDisplay();
@@ -0,0 +1,113 @@
+/*********************************************************************
+ * \file   bit_stream.cpp
+ * \brief  BitWriter / BitReader クラスの実装
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#include "pch.h"
+#include "bit_stream.h"
+
+// ============================================================
+// BitWriter
+// ============================================================
+
+BitWriter::BitWriter(void* buffer, int capacityBytes)
+    : m_data(static_cast<uint8_t*>(buffer))
+    , m_capacityBits(capacityBytes * 8) {
+}
+
+// ============================================================
+// write_bits - 下位ビットから順に1バイトずつ詰める
+// バイトの先頭に書くときは代入して前の内容を消す（バッファ全体を先にゼロクリアしない）
+// ============================================================
+void BitWriter::write_bits(uint32_t value, int bits) {
+    if (m_overflow || bits <= 0) return;
+    if (m_bitPos + bits > m_capacityBits) {
+        m_overflow = true;
+        return;
+    }
+    if (bits < 32) value &= (1u << bits) - 1u;
+
+    while (bits > 0) {
+        int byteIndex = m_bitPos >> 3;
+        int bitOffset = m_bitPos & 7;
+        int chunk = 8 - bitOffset;          // このバイトに入る残りビット数
+        if (chunk > bits) chunk = bits;
+
+        const uint8_t bitsInByte = (uint8_t)((value & ((1u << chunk) - 1u)) << bitOffset);
+        if (bitOffset == 0) {
+            m_data[byteIndex] = bitsInByte;
+        } else {
+            m_data[byteIndex] |= bitsInByte;
+        }
+        value >>= chunk;
+        bits -= chunk;
+        m_bitPos += chunk;
+    }
+}
+
+// ============================================================
+// write_varint - 7ビットずつ書き、続きがあるかを1ビットで示す
+// ============================================================
+void BitWriter::write_varint(uint32_t value) {
+    do {
+        uint32_t group = value & 0x7F;
+        value >>= 7;
+        write_bits(group, 7);
+        write_bool(value != 0);
+    } while (value != 0);
+}
+
+// ============================================================
+// BitReader
+// ============================================================
+
+BitReader::BitReader(const void* buffer, int sizeBytes)
+    : m_data(static_cast<const uint8_t*>(buffer))
+    , m_sizeBits(sizeBytes * 8) {
+}
+
+// ============================================================
+// read_bits - write_bits() と同じ順番で取り出す
+// ============================================================
+uint32_t BitReader::read_bits(int bits) {
+    if (m_overflow || bits <= 0) return 0;
+    if (m_bitPos + bits > m_sizeBits) {
+        m_overflow = true;
+        return 0;
+    }
+
+    uint32_t value = 0;
+    int shift = 0;
+    while (bits > 0) {
+        int byteIndex = m_bitPos >> 3;
+        int bitOffset = m_bitPos & 7;
+        int chunk = 8 - bitOffset;
+        if (chunk > bits) chunk = bits;
+
+        uint32_t part = (m_data[byteIndex] >> bitOffset) & ((1u << chunk) - 1u);
+        value |= part << shift;
+        shift += chunk;
+        bits -= chunk;
+        m_bitPos += chunk;
+    }
+    return value;
+}
+
+// ============================================================
+// read_varint - 継続ビットが0になるまで7ビットずつ読む
+// 32ビットを超える長さは壊れたデータとして扱う
+// ============================================================
+uint32_t BitReader::read_varint() {
+    uint32_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        uint32_t group = read_bits(7);
+        const bool more = read_bool();
+        if (m_overflow) return 0;  // 途中で切れていれば、読めたところまでの値も返さない
+        value |= group << shift;
+        if (!more) return value;
+    }
+    m_overflow = true;
+    return 0;
+}
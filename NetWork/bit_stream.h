@@ -0,0 +1,82 @@
+/*********************************************************************
+ * \file   bit_stream.h
+ * \brief  ビット単位の書き込み・読み込み（パケットのビットパッキング用）
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include <cstdint>
+
+// ============================================================
+// BitWriter クラス
+// 呼び出し側が用意したバッファに下位ビットから順に詰めて書き込む。
+// 書き込んだバイト（bytes_written()まで）だけを上書きし、その先の内容は変えない。
+// 容量を超えた書き込みは無視し、overflowed() がtrueになる。
+// ============================================================
+class BitWriter {
+public:
+    BitWriter(void* buffer, int capacityBytes);
+
+    // valueの下位bits（1-32）ビットを書き込む
+    void write_bits(uint32_t value, int bits);
+
+    // 1ビットのフラグを書き込む
+    void write_bool(bool value) { write_bits(value ? 1u : 0u, 1); }
+
+    // 可変長整数（7ビットずつ、続きがあれば継続ビット1）を書き込む
+    // 小さいIDほど短くなる（0-127なら8ビット）
+    void write_varint(uint32_t value);
+
+    // write_varint(value) で書かれるビット数（パケットに入るかの見積もり用）
+    static int varint_bits(uint32_t value) {
+        int groups = 1;
+        while (value >= 0x80) { value >>= 7; ++groups; }
+        return groups * 8;
+    }
+
+    // 書き込んだビット数 / バイト数（端数は切り上げ）
+    int bits_written() const { return m_bitPos; }
+    int bytes_written() const { return (m_bitPos + 7) / 8; }
+
+    // 容量不足で書き込めなかったデータがあるか
+    bool overflowed() const { return m_overflow; }
+
+private:
+    uint8_t* m_data;      // 書き込み先
+    int m_capacityBits;   // 容量（ビット）
+    int m_bitPos = 0;     // 次に書き込むビット位置
+    bool m_overflow = false;
+};
+
+// ============================================================
+// BitReader クラス
+// BitWriterで書いたデータを同じ順番で読み出す。
+// データ末尾を超えて読もうとするとoverflowed() がtrueになり、0を返す。
+// ============================================================
+class BitReader {
+public:
+    BitReader(const void* buffer, int sizeBytes);
+
+    // bits（1-32）ビットを読み出す
+    uint32_t read_bits(int bits);
+
+    // 1ビットのフラグを読み出す
+    bool read_bool() { return read_bits(1) != 0; }
+
+    // write_varint() で書いた可変長整数を読み出す
+    uint32_t read_varint();
+
+    // 読み出したビット数
+    int bits_read() const { return m_bitPos; }
+
+    // データ不足（壊れたパケット）を検出したか
+    bool overflowed() const { return m_overflow; }
+
+private:
+    const uint8_t* m_data;  // 読み出し元
+    int m_sizeBits;         // データサイズ（ビット）
+    int m_bitPos = 0;       // 次に読み出すビット位置
+    bool m_overflow = false;
+};
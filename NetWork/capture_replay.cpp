@@ -0,0 +1,94 @@
+/*********************************************************************
+ * \file   capture_replay.cpp
+ * \brief  replay_captureの実装
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#include "pch.h"
+#include "capture_replay.h"
+#include "net_capture.h"
+#include "network_manager.h"
+#include <chrono>
+#include <thread>
+
+bool replay_capture(const std::string& path, NetworkManager& net, bool realTime,
+    Game::GameObject* localPlayer,
+    std::vector<std::shared_ptr<Game::GameObject>>& worldObjects,
+    CaptureReplayResult& out, std::string& error) {
+    typedef std::chrono::steady_clock Clock;
+
+    out = CaptureReplayResult();
+    CaptureReader reader;
+    if (!reader.open(path, error)) return false;
+
+    // 役割は最初の受信の直前に記録されていたもので決める
+    // （キャプチャを起動より前に始めると、クライアント→ホストの順に2つ記録される）
+    int role = -1;               // -1=未記録, CAPTURE_START_HOST / CAPTURE_START_CLIENT
+    bool hasLocalPlayer = true;
+    bool started = false;
+    bool joined = false;
+
+    const Clock::time_point begin = Clock::now();
+    CaptureRecord rec;
+    while (reader.next(rec)) {
+        ++out.records;
+        out.captureSeconds = (double)rec.timeUs / 1000000.0;
+
+        switch (rec.kind) {
+        case CAPTURE_START_HOST:
+            if (!started) {
+                role = CAPTURE_START_HOST;
+                hasLocalPlayer = rec.data.empty() || rec.data[0] != 0;
+            }
+            continue;
+        case CAPTURE_START_CLIENT:
+            if (!started) role = CAPTURE_START_CLIENT;
+            continue;
+        case CAPTURE_SEND:
+        case CAPTURE_SEND_DISCOVERY:
+            ++out.sent;
+            continue;
+        case CAPTURE_RECV:
+        case CAPTURE_RECV_DISCOVERY:
+            break;
+        default:
+            continue;  // 新しい版で増えた記録は飛ばす
+        }
+
+        if (!started) {
+            if (role < 0) {
+                error = path + " has no role record before the first received packet";
+                return false;
+            }
+            const bool ok = (role == CAPTURE_START_HOST) ?
+                net.start_as_host(hasLocalPlayer) : net.start_as_client();
+            if (!ok) {
+                error = "failed to start the network manager for replay";
+                return false;
+            }
+            started = true;
+        }
+
+        const bool isDiscovery = rec.kind == CAPTURE_RECV_DISCOVERY;
+        if (!net.is_host() && !isDiscovery && !joined) {
+            // 元のクライアントもJOINを送ってから受信していた（ReliableLinkを同じ状態から始める）
+            net.join(rec.endpoint);
+            joined = true;
+        }
+
+        if (realTime) {
+            std::this_thread::sleep_until(begin + std::chrono::microseconds(rec.timeUs));
+        }
+
+        const Clock::time_point t0 = Clock::now();
+        net.replay_received(rec.data.data(), (int)rec.data.size(), rec.endpoint, isDiscovery,
+            localPlayer, worldObjects);
+        out.processSeconds += std::chrono::duration<double>(Clock::now() - t0).count();
+        ++out.replayed;
+    }
+
+    out.wallSeconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    out.truncated = reader.is_truncated();
+    return true;
+}
@@ -0,0 +1,47 @@
+/*********************************************************************
+ * \file   capture_replay.h
+ * \brief  キャプチャの再生（記録した受信をソケットを使わずにNetworkManagerへ流し直す）
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class NetworkManager;
+namespace Game { class GameObject; }
+
+// ============================================================
+// CaptureReplayResult 構造体
+// ============================================================
+struct CaptureReplayResult {
+    uint64_t records = 0;        // 読んだ記録の数
+    uint64_t replayed = 0;       // 受信として処理した数
+    uint64_t sent = 0;           // 送信の記録の数（再生では送らない）
+    double captureSeconds = 0.0; // キャプチャの長さ（最後の記録の時刻）
+    double wallSeconds = 0.0;    // 再生にかかった時間
+    double processSeconds = 0.0; // そのうち受信の処理（replay_received）にかかった時間
+    bool truncated = false;      // 最後の記録が途中で切れていた
+};
+
+// ============================================================
+// replay_capture - キャプチャの受信をnetに流し直す
+//
+// netはまだ起動していないもので、宛先の無いNetTransport（相手のいない
+// LoopbackTransportなど）を渡して作っておく。再生中の送信は捨てられる。
+// キャプチャに記録された役割でnetを起動し、クライアントなら最初に受信した
+// ゲーム通信の送信元へjoin()してから、受信を記録された順にreplay_received()へ渡す。
+// ホストの入力の適用（update()）やシミュレーションは行わないので、
+// 再生されるのは受信の処理（STATEの復元と補間バッファへの追加、弾の生成など）だけ。
+//
+// realTime: trueなら記録された時刻に合わせて待つ、falseなら待たずに流す（ベンチマーク用）
+// 戻り値: 最後まで再生できたか（読めなければfalseで、errorに理由が入る）
+// ============================================================
+bool replay_capture(const std::string& path, NetworkManager& net, bool realTime,
+    Game::GameObject* localPlayer,
+    std::vector<std::shared_ptr<Game::GameObject>>& worldObjects,
+    CaptureReplayResult& out, std::string& error);
@@ -0,0 +1,107 @@
+/*********************************************************************
+ * \file   interest_grid.cpp
+ * \brief  InterestGridクラスの実装
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#include "pch.h"
+#include "interest_grid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // セル座標に足すオフセット（21ビットの真ん中）
+    const int CELL_BIAS = 1 << 20;
+    const int64_t CELL_MASK = 0x1FFFFF;
+}
+
+// ============================================================
+// cell_key / cell_coord - セルキーとセル座標
+// ============================================================
+int64_t InterestGrid::cell_key(int x, int y, int z) {
+    return ((int64_t)((x + CELL_BIAS) & CELL_MASK) << 42) |
+        ((int64_t)((y + CELL_BIAS) & CELL_MASK) << 21) |
+        (int64_t)((z + CELL_BIAS) & CELL_MASK);
+}
+
+int InterestGrid::cell_coord(float v) {
+    return (int)std::floor(v / CELL_SIZE);
+}
+
+// ============================================================
+// rebuild - オブジェクトをセルキー順に並べる
+// ============================================================
+void InterestGrid::rebuild(const std::vector<ObjectState>& states) {
+    m_states = &states;
+    m_entries.resize(states.size());
+    for (size_t i = 0; i < states.size(); ++i) {
+        const ObjectState& os = states[i];
+        m_entries[i].key = cell_key(cell_coord(os.posX), cell_coord(os.posY), cell_coord(os.posZ));
+        m_entries[i].index = (uint32_t)i;
+    }
+    std::sort(m_entries.begin(), m_entries.end(),
+        [](const Entry& a, const Entry& b) { return a.key < b.key; });
+}
+
+// ============================================================
+// query - 視点の周りのセルから送るオブジェクトを選ぶ
+// ============================================================
+void InterestGrid::query(const ObjectState& viewer, uint32_t viewerId,
+    std::vector<Relevant>& out) const {
+    out.clear();
+    if (!m_states) return;
+    const std::vector<ObjectState>& states = *m_states;
+
+    const int range = (int)std::ceil(VIEW_RADIUS / CELL_SIZE);
+    const int cx = cell_coord(viewer.posX);
+    const int cy = cell_coord(viewer.posY);
+    const int cz = cell_coord(viewer.posZ);
+    const float eyeY = viewer.posY + EYE_HEIGHT;
+
+    auto less_key = [](const Entry& e, int64_t key) { return e.key < key; };
+    int64_t viewerIndex = -1;
+
+    for (int x = cx - range; x <= cx + range; ++x) {
+        for (int y = cy - range; y <= cy + range; ++y) {
+            // 同じx,yのセルはzの順に連続しているので、範囲の先頭を探して順に読む
+            const int64_t first = cell_key(x, y, cz - range);
+            const int64_t last = cell_key(x, y, cz + range);
+            auto it = std::lower_bound(m_entries.begin(), m_entries.end(), first, less_key);
+            for (; it != m_entries.end() && it->key <= last; ++it) {
+                const ObjectState& os = states[it->index];
+                if (os.id == viewerId) {
+                    // 自分自身は最後に必ず入れる
+                    viewerIndex = it->index;
+                    continue;
+                }
+
+                const float dx = os.posX - viewer.posX;
+                const float dy = os.posY - viewer.posY;
+                const float dz = os.posZ - viewer.posZ;
+                const float dist = std::sqrt(dx * dx + dy * dy + dz * dz);
+                float score = 1.0f - dist / VIEW_RADIUS;
+                if (score < MIN_RELEVANCE) continue;
+
+                // 見えていなくても送る距離なら、見通しで関連度を下げる
+                if (m_lineOfSight && !m_lineOfSight(viewer.posX, eyeY, viewer.posZ,
+                    os.posX, os.posY + EYE_HEIGHT, os.posZ)) {
+                    score *= OCCLUDED_SCALE;
+                    if (score < MIN_RELEVANCE) continue;
+                }
+                out.push_back({ it->index, score });
+            }
+        }
+    }
+
+    // 多すぎれば関連度の高いものだけ残す（自分の分を1つ空けておく）
+    auto by_score = [](const Relevant& a, const Relevant& b) { return a.score > b.score; };
+    if (out.size() >= (size_t)MAX_RELEVANT) {
+        std::nth_element(out.begin(), out.begin() + (MAX_RELEVANT - 1), out.end(), by_score);
+        out.resize(MAX_RELEVANT - 1);
+    }
+    std::sort(out.begin(), out.end(), by_score);
+
+    // クライアント自身のプレイヤー（予測の照合に必要）は必ず先頭に入れる
+    if (viewerIndex >= 0) out.insert(out.begin(), { (uint32_t)viewerIndex, 1.0f });
+}
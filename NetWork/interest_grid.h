@@ -0,0 +1,78 @@
+/*********************************************************************
+ * \file   interest_grid.h
+ * \brief  ホスト側の関心領域（Area of Interest）管理
+ *         複製するオブジェクトを粗い空間グリッドに振り分け、
+ *         クライアントごとに近くのセルから送るべきオブジェクトを選ぶ
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include "network_common.h"  // ObjectState
+#include <cstdint>
+#include <vector>
+
+// ============================================================
+// InterestGrid クラス
+//
+// 1. rebuild() で送信するオブジェクト一覧をセル（MapCollisionと同じ
+//    int64_tのセルキー）ごとに並べる。キーでソートした配列なので、
+//    使い回せば確保は起きない。
+// 2. query() で視点（クライアントのプレイヤー）の周りのセルだけを調べ、
+//    距離と見通しから関連度（0-1）を付けて、関連度の高い順に返す。
+//
+//   関連度 = (1 - 距離 / VIEW_RADIUS) x （見えなければ OCCLUDED_SCALE）
+//
+// MIN_RELEVANCE 未満は送らない。クライアントの数や全体のオブジェクト数ではなく、
+// 視点の周りにあるオブジェクトの数だけで1クライアント分の手間と帯域が決まる。
+// ============================================================
+class InterestGrid {
+public:
+    // セルの大きさ（メートル、マップは50m四方）
+    static constexpr float CELL_SIZE = 8.0f;
+    // これより遠いオブジェクトは送らない
+    static constexpr float VIEW_RADIUS = 32.0f;
+    // 遮られて見えないオブジェクトの関連度に掛ける係数
+    static constexpr float OCCLUDED_SCALE = 0.25f;
+    // 送る関連度の下限（見えていれば約29m、遮られていれば約19mまで）
+    static constexpr float MIN_RELEVANCE = 0.1f;
+    // 1クライアントに送る最大数（関連度の高い順に残す）
+    static const int MAX_RELEVANT = 64;
+    // 見通しを判定する目の高さ（オブジェクトの位置は足元）
+    static constexpr float EYE_HEIGHT = 1.5f;
+
+    // 見通しの判定（fromからtoが見えればtrue）。nullptrなら常に見えている扱い
+    typedef bool (*LineOfSightFn)(float fromX, float fromY, float fromZ,
+        float toX, float toY, float toZ);
+
+    // 送る候補1つ分（rebuild()に渡した配列の添字と関連度）
+    struct Relevant {
+        uint32_t index;
+        float score;
+    };
+
+    void set_line_of_sight(LineOfSightFn fn) { m_lineOfSight = fn; }
+
+    // オブジェクト一覧をセルに振り分ける（query()はこの配列の添字を返す）
+    void rebuild(const std::vector<ObjectState>& states);
+
+    // viewerの位置から送るべきオブジェクトを関連度の高い順にoutへ返す
+    // viewerIdのオブジェクト（クライアント自身のプレイヤー）は関連度1で必ず含める
+    void query(const ObjectState& viewer, uint32_t viewerId, std::vector<Relevant>& out) const;
+
+private:
+    struct Entry {
+        int64_t key;
+        uint32_t index;
+    };
+
+    // MapCollision::GetCellKey と同じ形のキー（各軸21ビット）
+    // 座標にオフセットを足して負にならないようにし、同じx,yのセルはzの順に並ぶようにする
+    static int64_t cell_key(int x, int y, int z);
+    static int cell_coord(float v);
+
+    const std::vector<ObjectState>* m_states = nullptr;
+    std::vector<Entry> m_entries;   // セルキー順
+    LineOfSightFn m_lineOfSight = nullptr;
+};
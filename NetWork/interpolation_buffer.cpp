@@ -0,0 +1,144 @@
+/*********************************************************************
+ * \file   interpolation_buffer.cpp
+ * \brief  PlayoutClock / InterpolationBuffer クラスの実装
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#include "pch.h"
+#include "interpolation_buffer.h"
+#include <cmath>
+
+namespace {
+    // 表示遅延を目標値に近づける割合（1スナップショットごと）
+    const double DELAY_SMOOTHING = 0.05;
+    // オフセットを遅い方向へ戻す割合（時計のずれ・経路の変化に追従する）
+    const double OFFSET_DRIFT = 0.002;
+
+    // 角度の差を -180から180 の範囲にする
+    float wrap_degrees(float d) {
+        d = std::fmod(d, 360.0f);
+        if (d > 180.0f) d -= 360.0f;
+        if (d < -180.0f) d += 360.0f;
+        return d;
+    }
+}
+
+// ============================================================
+// PlayoutClock::on_snapshot - 受信した時刻から遅れと揺らぎを更新する
+// ============================================================
+bool PlayoutClock::on_snapshot(uint16_t sendMs, double arrival, double& outLocalTime) {
+    // 16ビットの時刻を前回との差で展開する（約32秒以内の差なら正しく戻る）
+    int64_t sendFull = sendMs;
+    if (m_hasTime) {
+        int16_t diff = (int16_t)(uint16_t)(sendMs - (uint16_t)m_lastSendMs);
+        if (diff <= 0) return false;
+        sendFull = m_lastSendMs + diff;
+    }
+    const double sendTime = sendFull / 1000.0;
+    const double transit = arrival - sendTime;
+
+    if (!m_hasTime) {
+        m_hasTime = true;
+        m_offset = transit;
+        m_lastTransit = transit;
+    } else {
+        // 送信間隔の平均
+        const double gap = (sendFull - m_lastSendMs) / 1000.0;
+        m_interval += (gap - m_interval) * 0.1;
+
+        // ジッター: 前回との遅れの差の平均（RFC 3550）
+        const double d = std::fabs(transit - m_lastTransit);
+        m_jitter += (d - m_jitter) / 16.0;
+        m_lastTransit = transit;
+
+        // オフセット: 最も速く届いたときの遅れを基準にする
+        if (transit < m_offset) {
+            m_offset = transit;
+        } else {
+            m_offset += (transit - m_offset) * OFFSET_DRIFT;
+        }
+    }
+    m_lastSendMs = sendFull;
+
+    // 次のスナップショットが届くまで補間できるだけ遅らせる
+    double target = m_interval + JITTER_SCALE * m_jitter;
+    if (target < MIN_DELAY) target = MIN_DELAY;
+    if (target > MAX_DELAY) target = MAX_DELAY;
+    m_delay += (target - m_delay) * DELAY_SMOOTHING;
+
+    outLocalTime = sendTime + m_offset;
+    return true;
+}
+
+// ============================================================
+// InterpolationBuffer::push - スナップショットを追加する
+// ============================================================
+void InterpolationBuffer::push(double time, const ObjectState& state) {
+    if (m_count > 0) {
+        // オフセットが縮んだ直後などで時刻が前後した場合は、最新の直後に置く
+        const double newest = at(m_count - 1).time;
+        if (time <= newest) time = newest + 0.001;
+    }
+
+    if (m_count == CAPACITY) {
+        // 満杯なら最も古いものを捨てる
+        m_head = (m_head + 1) % CAPACITY;
+        --m_count;
+    }
+    Entry& e = m_entries[(m_head + m_count) % CAPACITY];
+    e.time = time;
+    e.state = state;
+    ++m_count;
+}
+
+// ============================================================
+// InterpolationBuffer::sample - 表示時刻の状態を求める
+// ============================================================
+bool InterpolationBuffer::sample(double renderTime, ObjectState& out) const {
+    if (m_count == 0) return false;
+
+    const Entry& oldest = at(0);
+    const Entry& newest = at(m_count - 1);
+
+    // まだ最初のスナップショットの時刻に達していない
+    if (renderTime <= oldest.time || m_count == 1) {
+        out = (renderTime <= oldest.time) ? oldest.state : newest.state;
+        return true;
+    }
+
+    // 表示時刻を挟む2つを新しい方から探す
+    if (renderTime < newest.time) {
+        for (int i = m_count - 2; i >= 0; --i) {
+            const Entry& a = at(i);
+            if (a.time <= renderTime) {
+                const Entry& b = at(i + 1);
+                float t = (float)((renderTime - a.time) / (b.time - a.time));
+                lerp_state(a.state, b.state, t, out);
+                return true;
+            }
+        }
+    }
+
+    // 最新より先: 直近2つの速度で少しだけ外挿する
+    const Entry& prev = at(m_count - 2);
+    double ahead = renderTime - newest.time;
+    if (ahead > MAX_EXTRAPOLATION) ahead = MAX_EXTRAPOLATION;
+    float t = 1.0f + (float)(ahead / (newest.time - prev.time));
+    lerp_state(prev.state, newest.state, t, out);
+    return true;
+}
+
+// ============================================================
+// lerp_state - 2つの状態を補間する（t > 1 なら外挿）
+// ============================================================
+void InterpolationBuffer::lerp_state(const ObjectState& a, const ObjectState& b, float t,
+    ObjectState& out) {
+    out.id = b.id;
+    out.posX = a.posX + (b.posX - a.posX) * t;
+    out.posY = a.posY + (b.posY - a.posY) * t;
+    out.posZ = a.posZ + (b.posZ - a.posZ) * t;
+    out.rotX = a.rotX + wrap_degrees(b.rotX - a.rotX) * t;
+    out.rotY = a.rotY + wrap_degrees(b.rotY - a.rotY) * t;
+    out.rotZ = a.rotZ + wrap_degrees(b.rotZ - a.rotZ) * t;
+}
@@ -0,0 +1,103 @@
+/*********************************************************************
+ * \file   interpolation_buffer.h
+ * \brief  リモートオブジェクトのスナップショット補間
+ *         受信した状態を時刻付きで保持し、少し過去の時刻で補間して表示する
+ *         表示の遅れ（プレイアウト遅延）は受信間隔と揺らぎから自動で決める
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include "network_common.h"  // ObjectState
+#include <cstdint>
+
+// ============================================================
+// PlayoutClock クラス（接続ごと）
+//
+// STATEに載っている送信側の時刻（ミリ秒の下位16ビット）を受信側の時間軸に直し、
+// 受信の揺らぎ（ジッター）を測って、どれだけ遅らせて表示すればよいかを決める。
+//
+//   ローカル時刻 = 送信時刻 + オフセット（これまでで最も速く届いたときの遅れ）
+//   表示遅延     = 送信間隔 + JITTER_SCALE x ジッター（MIN_DELAY-MAX_DELAYに制限）
+//
+// 表示遅延は急に変えると動きが跳ぶので、目標値に少しずつ近づける。
+// 時刻はすべて秒（NetworkManagerの起動からの経過時間）。
+// ============================================================
+class PlayoutClock {
+public:
+    // 表示遅延の範囲（秒）
+    static constexpr double MIN_DELAY = 0.03;
+    static constexpr double MAX_DELAY = 0.5;
+    // ジッターに掛ける係数（大きいほど遅れるが途切れにくい）
+    static constexpr double JITTER_SCALE = 3.0;
+
+    // スナップショットを受信した
+    // sendMs: 送信側の取得時刻、arrival: 受信したローカル時刻
+    // outLocalTime にそのスナップショットのローカル時刻を返す
+    // 前回より新しくない時刻（キープアライブの再送など）ならfalse
+    bool on_snapshot(uint16_t sendMs, double arrival, double& outLocalTime);
+
+    // 現在の表示遅延（秒）
+    double delay() const { return m_delay; }
+
+    // ローカル時刻を送信側の時刻（秒）に戻す（on_snapshotの逆）
+    double to_sender_time(double localTime) const { return localTime - m_offset; }
+
+    // 測定値（ミリ秒、表示・ログ用）
+    float jitter_ms() const { return (float)(m_jitter * 1000.0); }
+    float interval_ms() const { return (float)(m_interval * 1000.0); }
+
+    void reset() { *this = PlayoutClock(); }
+
+private:
+    bool m_hasTime = false;
+    int64_t m_lastSendMs = 0;    // 折り返しを展開した送信時刻（ミリ秒）
+    double m_offset = 0.0;       // ローカル時刻 - 送信時刻 の推定値
+    double m_lastTransit = 0.0;  // 前回の 受信時刻 - 送信時刻
+    double m_jitter = 0.0;       // 遅れの揺らぎ（RFC 3550と同じ平滑化）
+    double m_interval = 0.1;     // 送信間隔の平均
+    double m_delay = 0.1;        // 表示遅延
+};
+
+// ============================================================
+// InterpolationBuffer クラス（オブジェクトごと）
+//
+// 時刻付きのスナップショットをリングバッファに保持し、
+// 指定した表示時刻を前後から挟む2つを線形補間する。
+// 表示時刻が最新のスナップショットを過ぎた（パケットが遅れている）場合は、
+// 直近の速度で MAX_EXTRAPOLATION 秒まで先を予測し、その後は止める。
+// ============================================================
+class InterpolationBuffer {
+public:
+    // 保持するスナップショット数
+    static const int CAPACITY = 32;
+    // 外挿する最大時間（秒）
+    static constexpr double MAX_EXTRAPOLATION = 0.25;
+
+    // スナップショットを追加する（time: ローカル時刻）
+    // 時刻は増えていく前提で、最新より前の時刻は最新の直後に詰める
+    void push(double time, const ObjectState& state);
+
+    // renderTimeでの状態をoutに返す（空ならfalse）
+    bool sample(double renderTime, ObjectState& out) const;
+
+    bool empty() const { return m_count == 0; }
+    void clear() { m_count = 0; }
+
+private:
+    struct Entry {
+        double time = 0.0;
+        ObjectState state = {};
+    };
+
+    Entry m_entries[CAPACITY];
+    int m_head = 0;   // 最も古いエントリの位置
+    int m_count = 0;
+
+    // 古い方からi番目のエントリ
+    const Entry& at(int i) const { return m_entries[(m_head + i) % CAPACITY]; }
+
+    // a→bをtで補間する（回転は度数法で近い方向に回る）
+    static void lerp_state(const ObjectState& a, const ObjectState& b, float t, ObjectState& out);
+};
@@ -0,0 +1,333 @@
+/*********************************************************************
+ * \file   link_conditioner.cpp
+ * \brief  LinkConditionerクラスの実装
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#include "pch.h"
+#include "link_conditioner.h"
+#include "network_common.h"  // MAX_UDP_PACKET
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    // 受信側の乱数の種を送信側とずらす値
+    const uint32_t INCOMING_SEED_SALT = 0x9E3779B9u;
+
+    // ヒープの比較（期限が早く、同じなら先に入ったものが先頭）
+    struct LaterDue {
+        template <typename T>
+        bool operator()(const T& a, const T& b) const {
+            if (a.due != b.due) return a.due > b.due;
+            return a.order > b.order;
+        }
+    };
+}
+
+// ============================================================
+// LinkConditions::parse - "key=value,..." を読む
+// ============================================================
+bool LinkConditions::parse(const char* text, LinkConditions& out) {
+    if (!text) return false;
+    bool any = false;
+    const char* p = text;
+
+    while (*p) {
+        // 区切りを飛ばしてキーを読む
+        while (*p == ',' || *p == ' ' || *p == '\t') ++p;
+        const char* key = p;
+        while (*p && *p != '=' && *p != ',' && *p != ' ' && *p != '\t') ++p;
+        const size_t keyLen = (size_t)(p - key);
+        if (*p != '=') continue;
+        ++p;
+
+        char* end = nullptr;
+        const double v = std::strtod(p, &end);
+        if (end == p) continue;
+        p = end;
+
+        auto is = [&](const char* name) {
+            return std::strlen(name) == keyLen && std::strncmp(key, name, keyLen) == 0;
+        };
+        bool known = true;
+        if (is("latency"))        out.latencyMs = (int)v;
+        else if (is("jitter"))    out.jitterMs = (int)v;
+        else if (is("loss"))      out.lossPercent = (float)v;
+        else if (is("burst"))     out.burstPercent = (float)v;
+        else if (is("burstlen"))  out.burstLength = (int)v;
+        else if (is("dup"))       out.duplicatePercent = (float)v;
+        else if (is("reorder"))   out.reorderPercent = (float)v;
+        else if (is("reorderms")) out.reorderMs = (int)v;
+        else if (is("bandwidth")) out.bandwidthKbps = (int)v;
+        else if (is("queue"))     out.queueMs = (int)v;
+        else if (is("seed"))      out.seed = (uint32_t)v;
+        else known = false;
+        any = any || known;
+    }
+    return any;
+}
+
+LinkConditioner::LinkConditioner(NetTransport& net)
+    : m_net(&net), m_scratch(MAX_UDP_PACKET) {
+}
+
+// ============================================================
+// set_conditions / get_conditions - 条件の設定
+// ============================================================
+void LinkConditioner::set_conditions(const LinkConditions& conditions) {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_conditions = conditions;
+
+    m_out.rng.seed(conditions.seed);
+    m_in.rng.seed(conditions.seed ^ INCOMING_SEED_SALT);
+    for (Direction* dir : { &m_out, &m_in }) {
+        dir->inBurst = false;
+        dir->linkFree = Clock::time_point();
+        dir->stats = LinkStats();
+    }
+
+    const bool on = conditions.enabled();
+    if (!on) {
+        // 素通しに戻る前に、遅らせていた送信を出し切る
+        send_due(Clock::time_point::max());
+        m_in.heap.clear();
+    }
+    m_enabled.store(on, std::memory_order_relaxed);
+}
+
+LinkConditions LinkConditioner::get_conditions() const {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return m_conditions;
+}
+
+// ============================================================
+// send_to / send_batch - 送信（条件があれば送信待ちに入れる）
+// 戻り値: 受け付けた件数（条件で捨てたものも含む）
+// ============================================================
+bool LinkConditioner::send_to(const Endpoint& to, const void* data, int len) {
+    UdpSendItem item = { to, data, len };
+    return send_batch(&item, 1) == 1;
+}
+
+int LinkConditioner::send_batch(const UdpSendItem* items, int count) {
+    if (!enabled()) return m_net->send_batch(items, count);
+
+    std::lock_guard<std::mutex> lk(m_mutex);
+    const Clock::time_point now = Clock::now();
+    for (int i = 0; i < count; ++i) {
+        admit(m_out, items[i].to, items[i].data, items[i].len, now);
+    }
+    send_due(now);
+    return count;
+}
+
+// ============================================================
+// recv_batch / recv_from - 受信（条件があれば期限の来た分だけ返す）
+// ============================================================
+int LinkConditioner::recv_batch(UdpRecvItem* items, int count) {
+    if (!enabled()) return m_net->recv_batch(items, count);
+
+    std::lock_guard<std::mutex> lk(m_mutex);
+    const Clock::time_point now = Clock::now();
+    read_socket(now);
+
+    int n = 0;
+    Held h;
+    while (n < count && pop_due(m_in, now, h)) {
+        UdpRecvItem& it = items[n++];
+        it.len = std::min((int)h.data.size(), it.capacity);
+        std::memcpy(it.buffer, h.data.data(), (size_t)it.len);
+        it.from = h.peer;
+        ++m_in.stats.delivered;
+        m_in.pool.push_back(std::move(h.data));
+    }
+    return n;
+}
+
+int LinkConditioner::recv_from(char* buffer, int bufferSize, Endpoint& from) {
+    if (!enabled()) return m_net->recv_from(buffer, bufferSize, from);
+
+    UdpRecvItem item;
+    item.buffer = buffer;
+    item.capacity = bufferSize;
+    item.len = 0;
+    if (recv_batch(&item, 1) <= 0) return 0;
+    from = item.from;
+    return item.len;
+}
+
+// ============================================================
+// pump - 期限の来た送信待ちを送る
+// ============================================================
+void LinkConditioner::pump() {
+    if (!enabled()) return;
+    std::lock_guard<std::mutex> lk(m_mutex);
+    send_due(Clock::now());
+}
+
+// ============================================================
+// next_due_ms / has_due_incoming - 次の期限
+// ============================================================
+int LinkConditioner::next_due_ms() const {
+    if (!enabled()) return -1;
+    std::lock_guard<std::mutex> lk(m_mutex);
+
+    bool any = false;
+    Clock::time_point due;
+    for (const Direction* dir : { &m_out, &m_in }) {
+        if (dir->heap.empty()) continue;
+        if (!any || dir->heap.front().due < due) due = dir->heap.front().due;
+        any = true;
+    }
+    if (!any) return -1;
+
+    const auto wait = std::chrono::duration_cast<std::chrono::microseconds>(due - Clock::now());
+    if (wait.count() <= 0) return 0;
+    // 切り上げて、期限より前に起きて空振りしないようにする
+    return (int)((wait.count() + 999) / 1000);
+}
+
+bool LinkConditioner::has_due_incoming() const {
+    if (!enabled()) return false;
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return !m_in.heap.empty() && m_in.heap.front().due <= Clock::now();
+}
+
+// ============================================================
+// clear - 待っているパケットを捨てる
+// ============================================================
+void LinkConditioner::clear() {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    for (Direction* dir : { &m_out, &m_in }) {
+        for (Held& h : dir->heap) dir->pool.push_back(std::move(h.data));
+        dir->heap.clear();
+        dir->inBurst = false;
+        dir->linkFree = Clock::time_point();
+    }
+}
+
+LinkStats LinkConditioner::get_outgoing_stats() const {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return m_out.stats;
+}
+
+LinkStats LinkConditioner::get_incoming_stats() const {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return m_in.stats;
+}
+
+// ============================================================
+// admit - 1パケットを条件に通す
+// ============================================================
+void LinkConditioner::admit(Direction& dir, const Endpoint& peer, const void* data, int len,
+    Clock::time_point now) {
+    const LinkConditions& c = m_conditions;
+    ++dir.stats.packets;
+    dir.stats.bytes += (uint64_t)len;
+
+    // 1. 帯域: 前のパケットが回線に出終わるまで待ち、自分の分の時間だけ回線を使う
+    Clock::time_point depart = now;
+    if (c.bandwidthKbps > 0) {
+        const Clock::time_point start = std::max(dir.linkFree, now);
+        if (start - now > std::chrono::milliseconds(c.queueMs)) {
+            ++dir.stats.queueDropped;
+            return;
+        }
+        // len x 8ビット / (kbps x 1000ビット/秒) 秒
+        dir.linkFree = start + std::chrono::microseconds((int64_t)len * 8000 / c.bandwidthKbps);
+        depart = dir.linkFree;
+    }
+
+    // 2. 連続ロス（2状態のGilbertモデル）: 始まったら平均burstLength個続けて捨てる
+    if (!dir.inBurst && chance(dir.rng, c.burstPercent)) dir.inBurst = true;
+    if (dir.inBurst) {
+        ++dir.stats.burstLost;
+        if (c.burstLength <= 1 || chance(dir.rng, 100.0f / (float)c.burstLength)) {
+            dir.inBurst = false;
+        }
+        return;
+    }
+
+    // 3. ランダムなロス
+    if (chance(dir.rng, c.lossPercent)) {
+        ++dir.stats.lost;
+        return;
+    }
+
+    // 4. 遅延: 固定 + ジッター。追い越される分はさらに遅らせる
+    auto delay = [&]() {
+        return std::chrono::microseconds((int64_t)c.latencyMs * 1000 +
+            (int64_t)(random01(dir.rng) * (float)c.jitterMs * 1000.0f));
+    };
+    Clock::time_point due = depart + delay();
+    if (chance(dir.rng, c.reorderPercent)) {
+        due += std::chrono::milliseconds(c.reorderMs);
+        ++dir.stats.reordered;
+    }
+    push_held(dir, peer, data, len, due);
+
+    // 5. 重複: 写しは別の遅延で届く
+    if (chance(dir.rng, c.duplicatePercent)) {
+        push_held(dir, peer, data, len, depart + delay());
+        ++dir.stats.duplicated;
+    }
+}
+
+void LinkConditioner::push_held(Direction& dir, const Endpoint& peer, const void* data, int len,
+    Clock::time_point due) {
+    Held h;
+    h.due = due;
+    h.order = dir.order++;
+    h.peer = peer;
+    if (!dir.pool.empty()) {
+        h.data = std::move(dir.pool.back());
+        dir.pool.pop_back();
+    }
+    h.data.assign((const char*)data, (const char*)data + len);
+    dir.heap.push_back(std::move(h));
+    std::push_heap(dir.heap.begin(), dir.heap.end(), LaterDue());
+}
+
+bool LinkConditioner::pop_due(Direction& dir, Clock::time_point now, Held& out) {
+    if (dir.heap.empty() || dir.heap.front().due > now) return false;
+    std::pop_heap(dir.heap.begin(), dir.heap.end(), LaterDue());
+    out = std::move(dir.heap.back());
+    dir.heap.pop_back();
+    return true;
+}
+
+// ============================================================
+// read_socket / send_due - ソケットとの受け渡し
+// ============================================================
+void LinkConditioner::read_socket(Clock::time_point now) {
+    Endpoint from;
+    for (;;) {
+        const int r = m_net->recv_from(m_scratch.data(), (int)m_scratch.size(), from);
+        if (r <= 0) break;
+        admit(m_in, from, m_scratch.data(), r, now);
+    }
+}
+
+void LinkConditioner::send_due(Clock::time_point now) {
+    Held h;
+    while (pop_due(m_out, now, h)) {
+        m_net->send_to(h.peer, h.data.data(), (int)h.data.size());
+        ++m_out.stats.delivered;
+        m_out.pool.push_back(std::move(h.data));
+    }
+}
+
+// ============================================================
+// random01 / chance - 乱数
+// ============================================================
+float LinkConditioner::random01(std::mt19937& rng) {
+    // 上位24ビットを使う（floatの仮数部に収まる）
+    return (float)(rng() >> 8) * (1.0f / 16777216.0f);
+}
+
+bool LinkConditioner::chance(std::mt19937& rng, float percent) {
+    if (percent <= 0.0f) return false;
+    return random01(rng) * 100.0f < percent;
+}
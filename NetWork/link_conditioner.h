@@ -0,0 +1,159 @@
+/*********************************************************************
+ * \file   link_conditioner.h
+ * \brief  回線状態の再現（遅延・ジッター・ロス・重複・順序入れ替え・帯域制限）
+ *         NetTransportの送受信を包み、悪い回線をループバックやLAN上で再現する
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include "net_transport.h"   // NetTransport, UdpSendItem, UdpRecvItem
+#include "net_endpoint.h"    // Endpoint
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <vector>
+
+// ============================================================
+// LinkConditions 構造体
+// 片方向あたりの回線状態。LinkConditionerは送信と受信の両方に同じ条件を掛けるので、
+// 片側だけに設定すれば往復で latencyMs x 2 の遅延になる
+// ============================================================
+struct LinkConditions {
+    int latencyMs = 0;             // 固定の遅延（ミリ秒）
+    int jitterMs = 0;              // 遅延に足す0-jitterMsのばらつき（ミリ秒）
+    float lossPercent = 0.0f;      // 1パケットごとのランダムなロス（%）
+    float burstPercent = 0.0f;     // 連続ロスが始まる確率（%、1パケットごと）
+    int burstLength = 4;           // 連続ロスの平均の長さ（パケット数）
+    float duplicatePercent = 0.0f; // 重複して届く確率（%）
+    float reorderPercent = 0.0f;   // 後のパケットに追い越される確率（%）
+    int reorderMs = 40;            // 追い越されるパケットに足す遅延（ミリ秒）
+    int bandwidthKbps = 0;         // 帯域（キロビット/秒、0=無制限）
+    int queueMs = 500;             // 帯域待ちの上限（ミリ秒、超えた分は捨てる）
+    uint32_t seed = 1;             // 乱数の種（同じ種と同じ送受信なら同じ結果になる）
+
+    // 何か1つでも条件が付いているか（付いていなければ素通しする）
+    bool enabled() const {
+        return latencyMs > 0 || jitterMs > 0 || lossPercent > 0.0f || burstPercent > 0.0f ||
+            duplicatePercent > 0.0f || reorderPercent > 0.0f || bandwidthKbps > 0;
+    }
+
+    // "latency=80,jitter=20,loss=2,burst=1,burstlen=4,dup=1,reorder=2,reorderms=40,
+    //  bandwidth=256,queue=500,seed=7" の形式を読む（区切りはカンマか空白、順不同）
+    // 知らないキーは無視する（シナリオ実行の設定と同じ文字列に書けるように）
+    // 戻り値: 1つでもキーを読めればtrue
+    static bool parse(const char* text, LinkConditions& out);
+};
+
+// 片方向の統計
+struct LinkStats {
+    uint64_t packets = 0;       // 入ってきたパケット数
+    uint64_t bytes = 0;         // 入ってきたバイト数
+    uint64_t lost = 0;          // ランダムなロスで捨てた数
+    uint64_t burstLost = 0;     // 連続ロスで捨てた数
+    uint64_t queueDropped = 0;  // 帯域待ちがqueueMsを超えて捨てた数
+    uint64_t duplicated = 0;    // 重複させた数
+    uint64_t reordered = 0;     // 追い越されるように遅らせた数
+    uint64_t delivered = 0;     // 送った（受信なら渡した）数（重複を含む）
+};
+
+// ============================================================
+// LinkConditioner クラス
+//
+// 別のNetTransport（UdpNetworkやLoopbackTransport）を包むNetTransportで、
+// 条件が無ければそのまま中に渡す。条件があれば:
+//   送信: パケットを写して送信待ちに入れ、期限が来たら pump() で送る
+//   受信: ソケットから読んだ分を受信待ちに入れ、期限が来た分だけ返す
+// 1パケットごとの判定は 帯域待ち → ロス（ランダム、連続） → 遅延（固定+ジッター、
+// 追い越し） → 重複 の順。乱数は方向ごとに種から作り、標準ライブラリの分布は
+// 使わないので、同じ種と同じ送受信なら環境によらず同じパケットが捨てられる。
+//
+// 送受信はどのスレッドから呼んでもよい（内部のミューテックスで守る）。
+// 期限が来てもソケットは読み込み可能にならないので、呼び出し側は
+// next_due_ms() まで待って pump() と受信（has_due_incoming()なら）を行う。
+// ============================================================
+class LinkConditioner : public NetTransport {
+public:
+    explicit LinkConditioner(NetTransport& net);
+
+    // 包むNetTransportを差し替える（送受信を始める前に呼ぶ）
+    void set_transport(NetTransport& net) { m_net = &net; }
+
+    // 条件を設定する（乱数と統計は初期化する）
+    // 条件を外したときは送信待ちをすぐに送り、受信待ちは捨てる
+    void set_conditions(const LinkConditions& conditions);
+    LinkConditions get_conditions() const;
+    bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // NetTransport
+    bool send_to(const Endpoint& to, const void* data, int len) override;
+    int send_batch(const UdpSendItem* items, int count) override;
+    int recv_from(char* buffer, int bufferSize, Endpoint& from) override;
+    int recv_batch(UdpRecvItem* items, int count) override;
+    SOCKET get_handle() const override { return m_net->get_handle(); }
+
+    // 期限の来た送信待ちを送る
+    void pump();
+
+    // 次に送信待ち・受信待ちの期限が来るまでのミリ秒（0=もう来ている、-1=何も待っていない）
+    int next_due_ms() const;
+
+    // 期限の来た受信待ちがあるか（ソケットが空でもrecv_batchが返すものがある）
+    bool has_due_incoming() const;
+
+    // 待っているパケットを捨てる（ソケットを作り直すときなど）
+    void clear();
+
+    LinkStats get_outgoing_stats() const;
+    LinkStats get_incoming_stats() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    // 遅延中のパケット1つ
+    struct Held {
+        Clock::time_point due;  // 送る（渡す）時刻
+        uint64_t order;         // 同じ時刻なら入った順
+        Endpoint peer;          // 送信なら宛先、受信なら送信元
+        std::vector<char> data;
+    };
+
+    // 片方向の状態
+    struct Direction {
+        std::mt19937 rng;
+        bool inBurst = false;       // 連続ロスの途中か
+        Clock::time_point linkFree; // 帯域待ちが空く時刻
+        uint64_t order = 0;
+        std::vector<Held> heap;     // 期限の早い順のヒープ
+        std::vector<std::vector<char>> pool;  // 使い終わったパケットのバッファ（使い回す）
+        LinkStats stats;
+    };
+
+    // 1パケットを条件に通して待ちに入れる（m_mutexを保持して呼ぶ）
+    void admit(Direction& dir, const Endpoint& peer, const void* data, int len,
+        Clock::time_point now);
+    void push_held(Direction& dir, const Endpoint& peer, const void* data, int len,
+        Clock::time_point due);
+    // 期限が来ていれば先頭を取り出す（m_mutexを保持して呼ぶ）
+    static bool pop_due(Direction& dir, Clock::time_point now, Held& out);
+    // ソケットに届いている分をすべて受信待ちに入れる（m_mutexを保持して呼ぶ）
+    void read_socket(Clock::time_point now);
+    // 送信待ちの期限が来た分を送る（m_mutexを保持して呼ぶ）
+    void send_due(Clock::time_point now);
+
+    // [0, 1) の一様乱数（標準の分布クラスは実装ごとに結果が違うので使わない）
+    static float random01(std::mt19937& rng);
+    // percent% の確率でtrue
+    static bool chance(std::mt19937& rng, float percent);
+
+    NetTransport* m_net;
+    mutable std::mutex m_mutex;
+    std::atomic<bool> m_enabled{ false };
+    LinkConditions m_conditions;
+    Direction m_out;   // 送信
+    Direction m_in;    // 受信
+    std::vector<char> m_scratch;  // ソケットから読む作業用
+};
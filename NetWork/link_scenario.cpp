@@ -0,0 +1,208 @@
+/*********************************************************************
+ * \file   link_scenario.cpp
+ * \brief  回線状態のシナリオ実行の実装
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#include "pch.h"
+#include "link_scenario.h"
+#include "udp_network.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    // 送るパケットの先頭（残りは0で埋めてpacketBytesにする）
+    struct Probe {
+        uint32_t seq;
+        int64_t sentUs;  // 送信時刻（シナリオ開始からのマイクロ秒）
+    };
+
+    // 送り終えてから、何も届かなくなってこれだけ経ったら終わる
+    const std::chrono::milliseconds QUIET_TIME{ 200 };
+
+    // "key=数値" を探す（キーは先頭か区切りの直後にあるものだけ）
+    bool find_int(const char* text, const char* key, int& out) {
+        const size_t keyLen = std::strlen(key);
+        for (const char* p = std::strstr(text, key); p; p = std::strstr(p + 1, key)) {
+            const bool atStart = (p == text || p[-1] == ',' || p[-1] == ' ' || p[-1] == '\t');
+            if (atStart && p[keyLen] == '=') {
+                out = std::atoi(p + keyLen + 1);
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+// ============================================================
+// LinkScenario::parse - シナリオの設定を読む
+// ============================================================
+LinkScenario LinkScenario::parse(const char* text) {
+    LinkScenario sc;
+    if (!text) return sc;
+    LinkConditions::parse(text, sc.conditions);
+    find_int(text, "count", sc.packetCount);
+    find_int(text, "interval", sc.intervalMs);
+    find_int(text, "size", sc.packetBytes);
+    return sc;
+}
+
+// ============================================================
+// run_link_scenario - ループバックで送受信して統計を表示する
+// 1. 送信側・受信側のソケットをループバックで用意し、送信側に条件を掛ける
+// 2. intervalMsごとに番号と送信時刻を入れたパケットを送り、その間に受信する
+// 3. 遅らせているパケットが出切るまで受信を続ける
+// 4. 番号ごとの届いた回数と遅延から統計を出す
+// ============================================================
+int run_link_scenario(const LinkScenario& scenario) {
+    const int count = std::max(scenario.packetCount, 1);
+    const int interval = std::max(scenario.intervalMs, 0);
+    const int size = std::min(std::max(scenario.packetBytes, (int)sizeof(Probe)), MAX_UDP_PACKET);
+
+    // --- 1. ソケットの用意 ---
+    // ポート0でOSに選ばせ、実際のポートはget_current_port()で読む
+    UdpNetwork sender, receiver;
+    if (!sender.initialize(0)) {
+        std::cerr << "[LinkScenario] sender socket failed\n";
+        return 1;
+    }
+    if (!receiver.initialize(0)) {
+        std::cerr << "[LinkScenario] receiver socket failed\n";
+        return 1;
+    }
+    LinkConditioner link(sender);
+    link.set_conditions(scenario.conditions);
+    const Endpoint to = Endpoint::from_string("127.0.0.1", receiver.get_current_port());
+
+    const Clock::time_point start = Clock::now();
+    auto now_us = [&]() {
+        return (int64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+            Clock::now() - start).count();
+    };
+
+    std::vector<char> sendBuf((size_t)size, 0);
+    std::vector<char> recvBuf(MAX_UDP_PACKET);
+    std::vector<uint16_t> arrivals((size_t)count, 0);  // 番号ごとの届いた回数
+    std::vector<double> latencyMs((size_t)count, 0.0); // 番号ごとの最初に届いたときの遅延
+    std::vector<double> latencies;                     // 届いた順の遅延
+    uint64_t received = 0, duplicates = 0, reordered = 0;
+    bool any = false;
+    uint32_t highest = 0;
+
+    auto receive = [&]() {
+        Endpoint from;
+        for (;;) {
+            const int r = receiver.recv_from(recvBuf.data(), (int)recvBuf.size(), from);
+            if (r <= 0) break;
+            if (r < (int)sizeof(Probe)) continue;
+            Probe p;
+            std::memcpy(&p, recvBuf.data(), sizeof(p));
+            if (p.seq >= (uint32_t)count) continue;
+
+            ++received;
+            if (arrivals[p.seq]++ > 0) {
+                ++duplicates;
+                continue;
+            }
+            const double ms = (double)(now_us() - p.sentUs) / 1000.0;
+            latencyMs[p.seq] = ms;
+            latencies.push_back(ms);
+            // 後の番号が先に届いていた
+            if (any && p.seq < highest) ++reordered;
+            if (!any || p.seq > highest) highest = p.seq;
+            any = true;
+        }
+    };
+
+    // --- 2. 送信（待つ間も条件の送信待ちを出して受信する） ---
+    for (int i = 0; i < count; ++i) {
+        const Clock::time_point sendAt = start + std::chrono::milliseconds((int64_t)i * interval);
+        while (Clock::now() < sendAt) {
+            link.pump();
+            receive();
+            std::this_thread::yield();
+        }
+        Probe p;
+        p.seq = (uint32_t)i;
+        p.sentUs = now_us();
+        std::memcpy(sendBuf.data(), &p, sizeof(p));
+        UdpSendItem item = { to, sendBuf.data(), size };
+        link.send_batch(&item, 1);
+    }
+
+    // --- 3. 遅らせている分が出切り、しばらく何も届かなくなるまで受信する ---
+    Clock::time_point lastArrival = Clock::now();
+    for (;;) {
+        const uint64_t before = received;
+        link.pump();
+        receive();
+        const Clock::time_point now = Clock::now();
+        if (received != before) lastArrival = now;
+        if (link.next_due_ms() < 0 && now - lastArrival >= QUIET_TIME) break;
+        std::this_thread::yield();
+    }
+
+    // --- 4. 統計 ---
+    const uint64_t unique = latencies.size();
+    const uint64_t lost = (uint64_t)count - unique;
+    int longestRun = 0, run = 0;
+    for (int i = 0; i < count; ++i) {
+        run = arrivals[i] ? 0 : run + 1;
+        longestRun = std::max(longestRun, run);
+    }
+
+    double minMs = 0.0, maxMs = 0.0, avgMs = 0.0, p95Ms = 0.0, stddevMs = 0.0, jitterMs = 0.0;
+    if (unique > 0) {
+        std::vector<double> sorted = latencies;
+        std::sort(sorted.begin(), sorted.end());
+        minMs = sorted.front();
+        maxMs = sorted.back();
+        p95Ms = sorted[(size_t)((double)(sorted.size() - 1) * 0.95)];
+        for (double v : sorted) avgMs += v;
+        avgMs /= (double)unique;
+        for (double v : sorted) stddevMs += (v - avgMs) * (v - avgMs);
+        stddevMs = std::sqrt(stddevMs / (double)unique);
+
+        // 番号の隣り合う2つがどちらも届いたときの遅延の差の平均（RFC 3550のジッターに近いもの）
+        int pairs = 0;
+        for (int i = 1; i < count; ++i) {
+            if (!arrivals[i] || !arrivals[i - 1]) continue;
+            jitterMs += std::fabs(latencyMs[i] - latencyMs[i - 1]);
+            ++pairs;
+        }
+        if (pairs > 0) jitterMs /= pairs;
+    }
+
+    const LinkConditions& c = scenario.conditions;
+    const LinkStats st = link.get_outgoing_stats();
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "[LinkScenario] latency=" << c.latencyMs << "ms jitter=" << c.jitterMs
+        << "ms loss=" << c.lossPercent << "% burst=" << c.burstPercent << "%x" << c.burstLength
+        << " dup=" << c.duplicatePercent << "% reorder=" << c.reorderPercent
+        << "%(+" << c.reorderMs << "ms) bandwidth=" << c.bandwidthKbps
+        << "kbps queue=" << c.queueMs << "ms seed=" << c.seed << "\n";
+    std::cout << "  sent        " << count << " packets x " << size << " B every "
+        << interval << " ms\n";
+    std::cout << "  received    " << received << " (unique " << unique
+        << ", duplicates " << duplicates << ")\n";
+    std::cout << "  lost        " << lost << " (" << (100.0 * (double)lost / count)
+        << "%), longest run " << longestRun << "\n";
+    std::cout << "  reordered   " << reordered << "\n";
+    std::cout << "  latency ms  min " << minMs << " / avg " << avgMs << " / p95 " << p95Ms
+        << " / max " << maxMs << " / stddev " << stddevMs << " / jitter " << jitterMs << "\n";
+    std::cout << "  conditioner lost " << st.lost << ", burst lost " << st.burstLost
+        << ", queue dropped " << st.queueDropped << ", duplicated " << st.duplicated
+        << ", reordered " << st.reordered << ", sent " << st.delivered << "\n";
+    std::cout.flush();
+    return 0;
+}
@@ -0,0 +1,29 @@
+/*********************************************************************
+ * \file   link_scenario.h
+ * \brief  回線状態のシナリオ実行（ループバックで送受信してパケット単位の統計を表示する）
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include "link_conditioner.h"  // LinkConditions
+
+// ============================================================
+// LinkScenario 構造体
+// 送信側ソケットの送信にだけ条件を掛け、番号付きのパケットを一定間隔で送って
+// 受信側で届き方（ロス・重複・順序・遅延）を数える
+// ============================================================
+struct LinkScenario {
+    LinkConditions conditions;
+    int packetCount = 500;   // 送るパケット数
+    int intervalMs = 16;     // 送る間隔（ミリ秒）
+    int packetBytes = 64;    // 1パケットの大きさ（バイト）
+
+    // LinkConditions::parse と同じ文字列から読む（追加のキー: count, interval, size）
+    static LinkScenario parse(const char* text);
+};
+
+// シナリオを実行して結果を標準出力に表示する
+// 戻り値: 0=実行できた、1=ソケットを用意できなかった
+int run_link_scenario(const LinkScenario& scenario);
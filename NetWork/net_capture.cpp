@@ -0,0 +1,177 @@
+/*********************************************************************
+ * \file   net_capture.cpp
+ * \brief  NetCapture / CaptureReaderクラスの実装
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#include "pch.h"
+#include "net_capture.h"
+#include <cstring>
+
+namespace {
+    const char CAPTURE_MAGIC[4] = { 'N', 'C', 'A', 'P' };
+}
+
+// ============================================================
+// NetCapture
+// ============================================================
+NetCapture::~NetCapture() {
+    close();
+}
+
+bool NetCapture::open(const std::string& path) {
+    close();
+
+    m_file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open()) return false;
+
+    CaptureFileHeader header;
+    memcpy(header.magic, CAPTURE_MAGIC, sizeof(header.magic));
+    header.version = CAPTURE_VERSION;
+    header.reserved = 0;
+    m_file.write((const char*)&header, sizeof(header));
+
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_pending.clear();
+        m_pending.reserve(FLUSH_BYTES * 2);
+        m_stop = false;
+        m_recorded = 0;
+        m_dropped = 0;
+        m_start = std::chrono::steady_clock::now();
+    }
+    m_writer = std::thread(&NetCapture::writer_loop, this);
+    m_open.store(true, std::memory_order_release);
+    return true;
+}
+
+void NetCapture::close() {
+    if (!m_open.exchange(false)) return;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_one();
+    if (m_writer.joinable()) m_writer.join();
+    m_file.close();
+}
+
+// ============================================================
+// record - 1記録をバッファに追記する
+// 時刻はロックの中で取るので、別々のスレッドからの記録でもファイルの中で減らない
+// ============================================================
+void NetCapture::record(CaptureRecordKind kind, const Endpoint& endpoint,
+    const void* data, int len) {
+    if (!m_open.load(std::memory_order_acquire) || len < 0 || len > 0xFFFF) return;
+
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        if (m_stop) return;
+        const size_t size = sizeof(CaptureRecordHeader) + (size_t)len;
+        if (m_pending.size() + size > MAX_BUFFER_BYTES) {
+            ++m_dropped;
+            return;
+        }
+
+        CaptureRecordHeader h;
+        h.timeUs = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - m_start).count();
+        h.kind = kind;
+        h.addr = endpoint.addr;
+        h.port = endpoint.port;
+        h.len = (uint16_t)len;
+
+        const size_t offset = m_pending.size();
+        m_pending.resize(offset + size);
+        memcpy(m_pending.data() + offset, &h, sizeof(h));
+        if (len > 0) memcpy(m_pending.data() + offset + sizeof(h), data, (size_t)len);
+        ++m_recorded;
+
+        // 溜まった境目で1回だけ起こす（毎回notifyしない）
+        wake = offset < FLUSH_BYTES && m_pending.size() >= FLUSH_BYTES;
+    }
+    if (wake) m_cv.notify_one();
+}
+
+uint64_t NetCapture::get_recorded() const {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return m_recorded;
+}
+
+uint64_t NetCapture::get_dropped() const {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return m_dropped;
+}
+
+// ============================================================
+// writer_loop - 書き込みスレッド
+// 溜まった分をロックの中で手元のバッファと入れ替え、ロックを外してから書く
+// ============================================================
+void NetCapture::writer_loop() {
+    std::vector<char> writing;
+    writing.reserve(FLUSH_BYTES * 2);
+
+    for (;;) {
+        bool stop = false;
+        {
+            std::unique_lock<std::mutex> lk(m_mutex);
+            m_cv.wait_for(lk, std::chrono::milliseconds(FLUSH_INTERVAL_MS),
+                [this] { return m_stop || m_pending.size() >= FLUSH_BYTES; });
+            writing.swap(m_pending);
+            stop = m_stop;
+        }
+
+        if (!writing.empty()) {
+            m_file.write(writing.data(), (std::streamsize)writing.size());
+            m_file.flush();
+            writing.clear();
+        }
+        if (stop) break;
+    }
+}
+
+// ============================================================
+// CaptureReader
+// ============================================================
+bool CaptureReader::open(const std::string& path, std::string& error) {
+    m_file.open(path, std::ios::in | std::ios::binary);
+    if (!m_file.is_open()) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    CaptureFileHeader header;
+    if (!m_file.read((char*)&header, sizeof(header)) ||
+        memcmp(header.magic, CAPTURE_MAGIC, sizeof(header.magic)) != 0) {
+        error = path + " is not a capture file";
+        return false;
+    }
+    if (header.version != CAPTURE_VERSION) {
+        error = path + " has capture version " + std::to_string(header.version) +
+            " (expected " + std::to_string(CAPTURE_VERSION) + ")";
+        return false;
+    }
+    m_truncated = false;
+    return true;
+}
+
+bool CaptureReader::next(CaptureRecord& out) {
+    CaptureRecordHeader h;
+    if (!m_file.read((char*)&h, sizeof(h))) {
+        // 記録の境目で終わっていれば正常な終わり
+        m_truncated = m_file.gcount() != 0;
+        return false;
+    }
+
+    out.timeUs = h.timeUs;
+    out.kind = (CaptureRecordKind)h.kind;
+    out.endpoint = Endpoint(h.addr, h.port);
+    out.data.resize(h.len);
+    if (h.len > 0 && !m_file.read(out.data.data(), h.len)) {
+        m_truncated = true;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,147 @@
+/*********************************************************************
+ * \file   net_capture.h
+ * \brief  送受信したデータグラムのキャプチャ（バイナリファイルへの記録と読み込み）
+ *         現場で起きた不具合の再現や、受信処理のベンチマークに使う（再生はCaptureReplay）
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include "net_endpoint.h"  // Endpoint
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ============================================================
+// キャプチャファイルの形式（リトルエンディアン）
+//
+//   CaptureFileHeader
+//   CaptureRecordHeader + data[len]
+//   CaptureRecordHeader + data[len]
+//   ...
+//
+// timeUsはキャプチャを始めてからのマイクロ秒で、ファイルの中で減ることはない。
+// 受信はメインスレッドが受信キューから取り出した時点（処理した順）、
+// 送信はソケットに渡す時点で記録する。回線状態の再現（LinkConditioner）を
+// 使っている場合は、その内側（ゲームから見た送受信）になる。
+// ============================================================
+
+// キャプチャの記録の種類
+enum CaptureRecordKind : uint8_t {
+    CAPTURE_RECV = 0,             // ゲーム通信ソケットで受信（PacketHeader付きのまま）
+    CAPTURE_SEND = 1,             // ゲーム通信ソケットで送信（同上）
+    CAPTURE_RECV_DISCOVERY = 2,   // 探索ソケットで受信
+    CAPTURE_SEND_DISCOVERY = 3,   // 探索ソケットで送信（ブロードキャストの宛先は255.255.255.255）
+    CAPTURE_START_HOST = 4,       // ホストとして動いている（data[0] = ホスト自身のプレイヤーがいるか）
+    CAPTURE_START_CLIENT = 5,     // クライアントとして動いている（dataなし）
+};
+
+#pragma pack(push, 1)
+struct CaptureFileHeader {
+    char     magic[4];  // "NCAP"
+    uint16_t version;   // CAPTURE_VERSION
+    uint16_t reserved;
+};
+
+struct CaptureRecordHeader {
+    uint64_t timeUs;    // キャプチャを始めてからの時刻（マイクロ秒）
+    uint8_t  kind;      // CaptureRecordKind
+    uint32_t addr;      // 相手のアドレス（Endpoint::addr、ネットワークバイト順）
+    uint16_t port;      // 相手のポート
+    uint16_t len;       // 続くデータの長さ
+};
+#pragma pack(pop)
+
+static const uint16_t CAPTURE_VERSION = 1;
+
+// 読み込んだ記録1つ分
+struct CaptureRecord {
+    uint64_t timeUs = 0;
+    CaptureRecordKind kind = CAPTURE_RECV;
+    Endpoint endpoint;
+    std::vector<char> data;
+};
+
+// ============================================================
+// NetCapture クラス
+// record()はどのスレッドから呼んでもよい（ワーカースレッドの送信も記録する）。
+// 記録はメモリ上のバッファに追記するだけで、ファイルへの書き込みは
+// 専用のスレッドがバッファを入れ替えてまとめて行う（送受信を待たせない）。
+// 書き込みが追いつかずにバッファがMAX_BUFFER_BYTESを超えた分は捨てて数える。
+// ============================================================
+class NetCapture {
+public:
+    // 書き込みスレッドを起こす溜まり具合
+    static const size_t FLUSH_BYTES = 64 * 1024;
+    // 書き込み待ちの上限（これを超える記録は捨てる）
+    static const size_t MAX_BUFFER_BYTES = 16 * 1024 * 1024;
+    // 溜まっていなくても書き込む間隔（ミリ秒、止まったときに失う量を抑える）
+    static const int FLUSH_INTERVAL_MS = 200;
+
+    NetCapture() {}
+    ~NetCapture();
+    NetCapture(const NetCapture&) = delete;
+    NetCapture& operator=(const NetCapture&) = delete;
+
+    // pathを作り直してキャプチャを始める（既に開いていれば閉じてから）
+    bool open(const std::string& path);
+
+    // 残りを書き出して閉じる
+    void close();
+
+    bool is_open() const { return m_open.load(std::memory_order_relaxed); }
+
+    // 記録する（開いていなければ何もしない）
+    void record(CaptureRecordKind kind, const Endpoint& endpoint, const void* data, int len);
+
+    // 記録した数 / バッファが溢れて捨てた数
+    uint64_t get_recorded() const;
+    uint64_t get_dropped() const;
+
+private:
+    void writer_loop();
+
+    std::ofstream m_file;            // 書き込みスレッドだけが触る（open / closeの間を除く）
+    std::atomic<bool> m_open{ false };  // open()とclose()の間だけtrue（開け閉めは持ち主のスレッドだけ）
+    std::chrono::steady_clock::time_point m_start;
+
+    mutable std::mutex m_mutex;      // 以下を保護する
+    std::condition_variable m_cv;
+    std::vector<char> m_pending;     // 書き込み待ちの記録
+    bool m_stop = false;
+    uint64_t m_recorded = 0;
+    uint64_t m_dropped = 0;
+
+    std::thread m_writer;
+};
+
+// ============================================================
+// CaptureReader クラス
+// キャプチャファイルを先頭から1記録ずつ読む
+// ============================================================
+class CaptureReader {
+public:
+    CaptureReader() {}
+    CaptureReader(const CaptureReader&) = delete;
+    CaptureReader& operator=(const CaptureReader&) = delete;
+
+    // 開いてファイルヘッダーを確かめる（違う形式・版ならfalseで、errorに理由が入る）
+    bool open(const std::string& path, std::string& error);
+
+    // 次の記録を読む（終わり、または途中で切れていればfalse）
+    bool next(CaptureRecord& out);
+
+    // 最後の記録が途中で切れていたか（書き込み中に止まったキャプチャ）
+    bool is_truncated() const { return m_truncated; }
+
+private:
+    std::ifstream m_file;
+    bool m_truncated = false;
+};
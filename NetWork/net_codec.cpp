@@ -0,0 +1,236 @@
+/*********************************************************************
+ * \file   net_codec.cpp
+ * \brief  パケットの量子化とビットパッキングの実装
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#include "pch.h"
+#include "net_codec.h"
+#include <cmath>
+
+namespace NetCodec {
+
+    // ============================================================
+    // quantize - 範囲内の実数をbitsビットの整数に丸める
+    // ============================================================
+    uint32_t quantize(float value, float minValue, float maxValue, int bits) {
+        const uint32_t maxQ = (bits >= 32) ? 0xFFFFFFFFu : ((1u << bits) - 1u);
+        if (!(value > minValue)) return 0;          // NaNもここで0にする
+        if (value >= maxValue) return maxQ;
+        float t = (value - minValue) / (maxValue - minValue);
+        uint32_t q = (uint32_t)(t * (float)maxQ + 0.5f);
+        return (q > maxQ) ? maxQ : q;
+    }
+
+    // ============================================================
+    // dequantize - quantize() の逆変換
+    // 誤差は最大で (maxValue - minValue) / (2^bits - 1) / 2
+    // ============================================================
+    float dequantize(uint32_t q, float minValue, float maxValue, int bits) {
+        const uint32_t maxQ = (bits >= 32) ? 0xFFFFFFFFu : ((1u << bits) - 1u);
+        if (q > maxQ) q = maxQ;
+        return minValue + (maxValue - minValue) * ((float)q / (float)maxQ);
+    }
+
+    // ============================================================
+    // quantize_angle - 角度を0-360に正規化して量子化する
+    // 360度は0度と同じなので、2^bits等分して端は折り返す
+    // ============================================================
+    uint32_t quantize_angle(float degrees) {
+        if (!std::isfinite(degrees)) return 0;
+        float a = std::fmod(degrees, 360.0f);
+        if (a < 0.0f) a += 360.0f;
+        const uint32_t steps = 1u << ROT_BITS;
+        uint32_t q = (uint32_t)(a / 360.0f * (float)steps + 0.5f);
+        return q % steps;
+    }
+
+    float dequantize_angle(uint32_t q) {
+        const uint32_t steps = 1u << ROT_BITS;
+        return (float)(q % steps) * (360.0f / (float)steps);
+    }
+
+    // ============================================================
+    // ObjectStateのフィールド単位の量子化
+    // ============================================================
+    uint32_t quantize_field(const ObjectState& os, int field) {
+        switch (field) {
+        case 0: return quantize(os.posX, -POS_HALF_X, POS_HALF_X, POS_BITS);
+        case 1: return quantize(os.posY, -POS_HALF_Y, POS_HALF_Y, POS_BITS);
+        case 2: return quantize(os.posZ, -POS_HALF_Z, POS_HALF_Z, POS_BITS);
+        case 3: return quantize_angle(os.rotX);
+        case 4: return quantize_angle(os.rotY);
+        case 5: return quantize_angle(os.rotZ);
+        default: return 0;
+        }
+    }
+
+    void dequantize_field(ObjectState& os, int field, uint32_t q) {
+        switch (field) {
+        case 0: os.posX = dequantize(q, -POS_HALF_X, POS_HALF_X, POS_BITS); break;
+        case 1: os.posY = dequantize(q, -POS_HALF_Y, POS_HALF_Y, POS_BITS); break;
+        case 2: os.posZ = dequantize(q, -POS_HALF_Z, POS_HALF_Z, POS_BITS); break;
+        case 3: os.rotX = dequantize_angle(q); break;
+        case 4: os.rotY = dequantize_angle(q); break;
+        case 5: os.rotZ = dequantize_angle(q); break;
+        default: break;
+        }
+    }
+
+    int field_bits(int field) {
+        return (field < 3) ? POS_BITS : ROT_BITS;
+    }
+
+    // ============================================================
+    // PacketInput
+    // type(8) seq(32) playerId(varint) count-1(3)
+    //   最新: move(16x3) yaw(12) buttons(varint)
+    //   1つ前から順に: フィールドごとに changed(1) [値]（1つ新しい入力と同じなら1ビット）
+    // 入力は数ティック同じことが多いので、控えは1つあたり数ビットで済む
+    // ============================================================
+    namespace {
+        // 入力の量子化値（フィールド順: moveX, moveY, moveZ, yaw, buttons）
+        const int INPUT_FIELD_COUNT = 5;
+
+        void quantize_input(const PacketInput& pi, uint32_t (&q)[INPUT_FIELD_COUNT]) {
+            q[0] = quantize(pi.moveX, -INPUT_MOVE_RANGE, INPUT_MOVE_RANGE, INPUT_MOVE_BITS);
+            q[1] = quantize(pi.moveY, -INPUT_MOVE_RANGE, INPUT_MOVE_RANGE, INPUT_MOVE_BITS);
+            q[2] = quantize(pi.moveZ, -INPUT_MOVE_RANGE, INPUT_MOVE_RANGE, INPUT_MOVE_BITS);
+            q[3] = quantize_angle(pi.yaw);
+            q[4] = pi.buttons;
+        }
+
+        void dequantize_input(const uint32_t (&q)[INPUT_FIELD_COUNT], PacketInput& pi) {
+            pi.moveX = dequantize(q[0], -INPUT_MOVE_RANGE, INPUT_MOVE_RANGE, INPUT_MOVE_BITS);
+            pi.moveY = dequantize(q[1], -INPUT_MOVE_RANGE, INPUT_MOVE_RANGE, INPUT_MOVE_BITS);
+            pi.moveZ = dequantize(q[2], -INPUT_MOVE_RANGE, INPUT_MOVE_RANGE, INPUT_MOVE_BITS);
+            pi.yaw = dequantize_angle(q[3]);
+            pi.buttons = q[4];
+        }
+
+        void write_input_field(BitWriter& w, int field, uint32_t value) {
+            if (field < 3) w.write_bits(value, INPUT_MOVE_BITS);
+            else if (field == 3) w.write_bits(value, ROT_BITS);
+            else w.write_varint(value);
+        }
+
+        uint32_t read_input_field(BitReader& r, int field) {
+            if (field < 3) return r.read_bits(INPUT_MOVE_BITS);
+            if (field == 3) return r.read_bits(ROT_BITS);
+            return r.read_varint();
+        }
+    }
+
+    int write_input(const PacketInput* inputs, int count, void* out, int capacity) {
+        if (count < 1 || count > MAX_INPUTS_PER_PACKET) return 0;
+
+        BitWriter w(out, capacity);
+        w.write_bits(PKT_INPUT, 8);
+        w.write_bits(inputs[0].seq, 32);
+        w.write_varint(inputs[0].playerId);
+        w.write_bits((uint32_t)(count - 1), INPUT_COUNT_BITS);
+
+        uint32_t prev[INPUT_FIELD_COUNT];
+        quantize_input(inputs[0], prev);
+        for (int f = 0; f < INPUT_FIELD_COUNT; ++f) write_input_field(w, f, prev[f]);
+
+        for (int i = 1; i < count; ++i) {
+            uint32_t q[INPUT_FIELD_COUNT];
+            quantize_input(inputs[i], q);
+            for (int f = 0; f < INPUT_FIELD_COUNT; ++f) {
+                const bool changed = q[f] != prev[f];
+                w.write_bool(changed);
+                if (changed) write_input_field(w, f, q[f]);
+                prev[f] = q[f];
+            }
+        }
+        return w.overflowed() ? 0 : w.bytes_written();
+    }
+
+    int read_input(const void* buf, int len, PacketInput* outInputs) {
+        BitReader r(buf, len);
+        if (r.read_bits(8) != PKT_INPUT) return 0;
+
+        const uint32_t seq = r.read_bits(32);
+        const uint32_t playerId = r.read_varint();
+        const int count = (int)r.read_bits(INPUT_COUNT_BITS) + 1;
+
+        uint32_t q[INPUT_FIELD_COUNT];
+        for (int i = 0; i < count; ++i) {
+            for (int f = 0; f < INPUT_FIELD_COUNT; ++f) {
+                if (i == 0 || r.read_bool()) q[f] = read_input_field(r, f);
+            }
+            PacketInput pi = {};
+            pi.type = PKT_INPUT;
+            pi.seq = seq - (uint32_t)i;
+            pi.playerId = playerId;
+            dequantize_input(q, pi);
+            outInputs[i] = pi;
+        }
+        return r.overflowed() ? 0 : count;
+    }
+
+    // ============================================================
+    // InputAck
+    // inputSeq(32) velY(16) grounded(1)
+    // ============================================================
+    void write_input_ack(BitWriter& w, const InputAck& ack) {
+        w.write_bits(ack.inputSeq, 32);
+        w.write_bits(quantize(ack.velY, -VEL_RANGE, VEL_RANGE, VEL_BITS), VEL_BITS);
+        w.write_bool(ack.grounded != 0);
+    }
+
+    void read_input_ack(BitReader& r, InputAck& outAck) {
+        outAck.inputSeq = r.read_bits(32);
+        outAck.velY = dequantize(r.read_bits(VEL_BITS), -VEL_RANGE, VEL_RANGE, VEL_BITS);
+        outAck.grounded = r.read_bool() ? 1 : 0;
+    }
+
+    // ============================================================
+    // PacketBullet
+    // type(8) seq(varint) owner(varint) viewTime(16) pos(14x3) dir(12x3)
+    // ============================================================
+    int write_bullet(const PacketBullet& pb, void* out, int capacity) {
+        BitWriter w(out, capacity);
+        w.write_bits(PKT_BULLET, 8);
+        w.write_varint(pb.seq);
+        w.write_varint(pb.ownerPlayerId);
+        w.write_bits(pb.viewTime, 16);
+        w.write_bits(quantize(pb.posX, -POS_HALF_X, POS_HALF_X, POS_BITS), POS_BITS);
+        w.write_bits(quantize(pb.posY, -POS_HALF_Y, POS_HALF_Y, POS_BITS), POS_BITS);
+        w.write_bits(quantize(pb.posZ, -POS_HALF_Z, POS_HALF_Z, POS_BITS), POS_BITS);
+        w.write_bits(quantize(pb.dirX, -1.0f, 1.0f, DIR_BITS), DIR_BITS);
+        w.write_bits(quantize(pb.dirY, -1.0f, 1.0f, DIR_BITS), DIR_BITS);
+        w.write_bits(quantize(pb.dirZ, -1.0f, 1.0f, DIR_BITS), DIR_BITS);
+        return w.overflowed() ? 0 : w.bytes_written();
+    }
+
+    bool read_bullet(const void* buf, int len, PacketBullet& outBullet) {
+        BitReader r(buf, len);
+        if (r.read_bits(8) != PKT_BULLET) return false;
+
+        PacketBullet pb = {};
+        pb.type = PKT_BULLET;
+        pb.seq = r.read_varint();
+        pb.ownerPlayerId = r.read_varint();
+        pb.viewTime = (uint16_t)r.read_bits(16);
+        pb.posX = dequantize(r.read_bits(POS_BITS), -POS_HALF_X, POS_HALF_X, POS_BITS);
+        pb.posY = dequantize(r.read_bits(POS_BITS), -POS_HALF_Y, POS_HALF_Y, POS_BITS);
+        pb.posZ = dequantize(r.read_bits(POS_BITS), -POS_HALF_Z, POS_HALF_Z, POS_BITS);
+        pb.dirX = dequantize(r.read_bits(DIR_BITS), -1.0f, 1.0f, DIR_BITS);
+        pb.dirY = dequantize(r.read_bits(DIR_BITS), -1.0f, 1.0f, DIR_BITS);
+        pb.dirZ = dequantize(r.read_bits(DIR_BITS), -1.0f, 1.0f, DIR_BITS);
+        if (r.overflowed()) return false;
+
+        // 量子化で長さがわずかにずれるので正規化し直す
+        float l = std::sqrt(pb.dirX * pb.dirX + pb.dirY * pb.dirY + pb.dirZ * pb.dirZ);
+        if (l > 0.0001f) {
+            pb.dirX /= l; pb.dirY /= l; pb.dirZ /= l;
+        }
+
+        outBullet = pb;
+        return true;
+    }
+
+} // namespace NetCodec
@@ -0,0 +1,99 @@
+/*********************************************************************
+ * \file   net_codec.h
+ * \brief  パケットの量子化とビットパッキング（送受信のワイヤーフォーマット）
+ *         network_common.h の構造体はメモリ上の表現として使い、
+ *         実際に送るバイト列はここでビット単位に詰めて作る
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include "network_common.h"      // PacketInput, PacketBullet, ObjectState
+#include "bit_stream.h"          // BitWriter, BitReader
+#include "Game/Map/map_config.h" // MAP_WIDTH / MAP_HEIGHT / MAP_DEPTH, BOX_SIZE
+#include <cstdint>
+
+namespace NetCodec {
+
+    // ------------------------------------------------------------
+    // 量子化パラメータ
+    // ------------------------------------------------------------
+
+    // 座標: マップ範囲（中心が原点）に余白を足した範囲の固定小数点
+    // 50ブロック+余白で約66ユニット → 14ビットで約4mm刻み
+    static const int   POS_BITS = 14;
+    static const float POS_MARGIN = 8.0f;
+    static const float POS_HALF_X = MAP_WIDTH * BOX_SIZE * 0.5f + POS_MARGIN;
+    static const float POS_HALF_Y = MAP_HEIGHT * BOX_SIZE * 0.5f + POS_MARGIN;
+    static const float POS_HALF_Z = MAP_DEPTH * BOX_SIZE * 0.5f + POS_MARGIN;
+
+    // 回転: オイラー角（度）を0-360に正規化して12ビット（約0.09度刻み）
+    static const int ROT_BITS = 12;
+
+    // 方向ベクトル: 各成分-1から1を12ビット
+    static const int DIR_BITS = 12;
+
+    // 入力の移動量: 各成分±INPUT_MOVE_RANGEを16ビット
+    static const int   INPUT_MOVE_BITS = 16;
+    static const float INPUT_MOVE_RANGE = 1.0f;
+
+    // 1つのINPUTに載せる入力の数（最新と、その前の入力の控え）: 1-2^INPUT_COUNT_BITS
+    static const int INPUT_COUNT_BITS = 3;
+    static const int MAX_INPUTS_PER_PACKET = 1 << INPUT_COUNT_BITS;
+
+    // 縦速度（InputAck）: ±VEL_RANGEを16ビット
+    static const int   VEL_BITS = 16;
+    static const float VEL_RANGE = 32.0f;
+
+    // ObjectStateのフィールド数（posXYZ, rotXYZ の順）
+    static const int STATE_FIELD_COUNT = 6;
+
+    // ------------------------------------------------------------
+    // 量子化ヘルパー
+    // ------------------------------------------------------------
+
+    // [minValue, maxValue] をbitsビットの整数に変換する（範囲外はクランプ）
+    uint32_t quantize(float value, float minValue, float maxValue, int bits);
+
+    // quantize() の逆変換
+    float dequantize(uint32_t q, float minValue, float maxValue, int bits);
+
+    // 角度（度）を0-360に正規化して量子化する
+    uint32_t quantize_angle(float degrees);
+    float dequantize_angle(uint32_t q);
+
+    // ObjectStateのfield番目（0-2=pos, 3-5=rot）を量子化した値
+    uint32_t quantize_field(const ObjectState& os, int field);
+
+    // 量子化値からObjectStateのfield番目を復元して設定する
+    void dequantize_field(ObjectState& os, int field, uint32_t q);
+
+    // field番目のビット数
+    int field_bits(int field);
+
+    // ------------------------------------------------------------
+    // パケットの符号化・復元
+    // 先頭8ビットは常にPacketTypeなので、受信側は buf[0] で種別を判定できる
+    // ------------------------------------------------------------
+
+    // 符号化後の最大サイズ（送信バッファの確保用、INPUTは入力をMAX_INPUTS_PER_PACKET個載せたとき）
+    static const int MAX_INPUT_BYTES = 128;
+    static const int MAX_BULLET_BYTES = 32;
+
+    // PacketInputを新しい順にcount個（1-MAX_INPUTS_PER_PACKET）書き込み、書いたバイト数を返す（容量不足なら0）
+    // inputs[0]が最新で、inputs[i]のseqはinputs[0].seq - iであること（古い入力は1つ新しい入力との差分で詰める）
+    int write_input(const PacketInput* inputs, int count, void* out, int capacity);
+    // 新しい順にoutInputs[0]から読み、読んだ数を返す（壊れていれば0）
+    // outInputsはMAX_INPUTS_PER_PACKET個分あること
+    int read_input(const void* buf, int len, PacketInput* outInputs);
+
+    // InputAckをSTATEの途中に書き込む / 読み込む（ヘッダーはSnapshotDeltaが書く）
+    void write_input_ack(BitWriter& w, const InputAck& ack);
+    void read_input_ack(BitReader& r, InputAck& outAck);
+
+    // PacketBulletを書き込み、書いたバイト数を返す（容量不足なら0）
+    int write_bullet(const PacketBullet& pb, void* out, int capacity);
+    bool read_bullet(const void* buf, int len, PacketBullet& outBullet);
+
+} // namespace NetCodec
@@ -0,0 +1,82 @@
+/*********************************************************************
+ * \file   net_endpoint.h
+ * \brief  送受信先を表す値型（IPv4アドレス + ポート）
+ *         文字列IPの変換（inet_pton / inet_ntop）を送受信のたびに行わないよう、
+ *         バイナリのまま受け渡しと比較・ハッシュを行う
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include "net_platform.h"  // sockaddr_in, inet_pton, inet_ntop
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// ============================================================
+// Endpoint 構造体
+// addr はネットワークバイト順のまま持ち、sockaddr_in とそのまま相互変換する
+// ============================================================
+struct Endpoint {
+    uint32_t addr = 0;  // IPv4アドレス（ネットワークバイト順）
+    uint16_t port = 0;  // ポート番号（ホストバイト順）
+
+    Endpoint() {}
+    Endpoint(uint32_t a, uint16_t p) : addr(a), port(p) {}
+
+    // 設定済みか（アドレスもポートも0なら未設定）
+    bool is_valid() const { return addr != 0 || port != 0; }
+
+    bool operator==(const Endpoint& o) const { return addr == o.addr && port == o.port; }
+    bool operator!=(const Endpoint& o) const { return !(*this == o); }
+
+    // ----------------------------------------------------------
+    // 変換（文字列との変換は表示・設定時のみ使う）
+    // ----------------------------------------------------------
+
+    // "192.168.1.10" とポート番号から作る（不正な文字列なら未設定のまま）
+    static Endpoint from_string(const std::string& ip, int port) {
+        Endpoint ep;
+        in_addr in;
+        if (inet_pton(AF_INET, ip.c_str(), &in) == 1) {
+            ep.addr = in.s_addr;
+            ep.port = static_cast<uint16_t>(port);
+        }
+        return ep;
+    }
+
+    static Endpoint from_sockaddr(const sockaddr_in& sa) {
+        return Endpoint(sa.sin_addr.s_addr, ntohs(sa.sin_port));
+    }
+
+    sockaddr_in to_sockaddr() const {
+        sockaddr_in sa;
+        ZeroMemory(&sa, sizeof(sa));
+        sa.sin_family = AF_INET;
+        sa.sin_addr.s_addr = addr;
+        sa.sin_port = htons(port);
+        return sa;
+    }
+
+    // IPアドレス部分を文字列にする（ログや探索結果の表示用）
+    std::string ip_string() const {
+        in_addr in;
+        in.s_addr = addr;
+        char buf[INET_ADDRSTRLEN] = { 0 };
+        inet_ntop(AF_INET, &in, buf, sizeof(buf));
+        return std::string(buf);
+    }
+};
+
+// unordered_map のキーに使うためのハッシュ
+struct EndpointHash {
+    size_t operator()(const Endpoint& ep) const {
+        uint64_t key = (static_cast<uint64_t>(ep.addr) << 16) | ep.port;
+        // 64bitの混ぜ合わせ（splitmix64の最終段）
+        key ^= key >> 30; key *= 0xBF58476D1CE4E5B9ull;
+        key ^= key >> 27; key *= 0x94D049BB133111EBull;
+        key ^= key >> 31;
+        return static_cast<size_t>(key);
+    }
+};
@@ -0,0 +1,144 @@
+/*********************************************************************
+ * \file   net_loopback.cpp
+ * \brief  LoopbackNetwork / LoopbackTransport クラスの実装
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#include "pch.h"
+#include "net_loopback.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    // 127.0.0.1（ネットワークバイト順）
+    uint32_t loopback_addr() {
+        return htonl(INADDR_LOOPBACK);
+    }
+}
+
+// ============================================================
+// LoopbackNetwork
+// ============================================================
+uint64_t LoopbackNetwork::get_undeliverable() const {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return m_undeliverable;
+}
+
+Endpoint LoopbackNetwork::attach(LoopbackTransport* transport, uint16_t port) {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (port == 0) {
+        // 空いているポートを順に探す（0は使わない）
+        for (int tries = 0; tries < 65535; ++tries) {
+            const uint16_t candidate = m_nextPort++;
+            if (m_nextPort == 0) m_nextPort = FIRST_AUTO_PORT;
+            if (candidate != 0 && !m_nodes.count(Endpoint(loopback_addr(), candidate))) {
+                port = candidate;
+                break;
+            }
+        }
+        if (port == 0) return Endpoint();
+    }
+
+    const Endpoint ep(loopback_addr(), port);
+    if (!m_nodes.emplace(ep, transport).second) return Endpoint();
+    return ep;
+}
+
+void LoopbackNetwork::detach(const Endpoint& ep) {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_nodes.erase(ep);
+}
+
+bool LoopbackNetwork::deliver(const Endpoint& from, const Endpoint& to, const void* data, int len) {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto it = m_nodes.find(to);
+    if (it == m_nodes.end()) {
+        ++m_undeliverable;
+        return false;
+    }
+    // 宛先の登録解除はm_mutexを取るので、ロック中は宛先が消えない
+    it->second->push(from, data, len);
+    return true;
+}
+
+// ============================================================
+// LoopbackTransport
+// ============================================================
+LoopbackTransport::LoopbackTransport(LoopbackNetwork& network, uint16_t port)
+    : m_network(network) {
+    m_endpoint = m_network.attach(this, port);
+}
+
+LoopbackTransport::~LoopbackTransport() {
+    if (m_endpoint.is_valid()) m_network.detach(m_endpoint);
+}
+
+bool LoopbackTransport::send_to(const Endpoint& to, const void* data, int len) {
+    if (!m_endpoint.is_valid() || len <= 0) return false;
+    // UDPと同じく、宛先が無くても送信そのものは成功する
+    m_network.deliver(m_endpoint, to, data, len);
+    return true;
+}
+
+int LoopbackTransport::send_batch(const UdpSendItem* items, int count) {
+    int sent = 0;
+    for (int i = 0; i < count; ++i) {
+        if (send_to(items[i].to, items[i].data, items[i].len)) ++sent;
+    }
+    return sent;
+}
+
+int LoopbackTransport::recv_from(char* buffer, int bufferSize, Endpoint& from) {
+    UdpRecvItem item;
+    item.buffer = buffer;
+    item.capacity = bufferSize;
+    item.len = 0;
+    if (recv_batch(&item, 1) <= 0) return 0;
+    from = item.from;
+    return item.len;
+}
+
+int LoopbackTransport::recv_batch(UdpRecvItem* items, int count) {
+    if (!m_endpoint.is_valid()) return -1;
+
+    std::lock_guard<std::mutex> lk(m_mutex);
+    int n = 0;
+    while (n < count && !m_queue.empty()) {
+        Datagram& d = m_queue.front();
+        UdpRecvItem& it = items[n++];
+        // 受信バッファより大きいデータグラムはUDPと同じく切り詰める
+        it.len = std::min((int)d.data.size(), it.capacity);
+        std::memcpy(it.buffer, d.data.data(), (size_t)it.len);
+        it.from = d.from;
+        m_pool.push_back(std::move(d.data));
+        m_queue.pop_front();
+    }
+    return n;
+}
+
+size_t LoopbackTransport::get_pending() const {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return m_queue.size();
+}
+
+uint64_t LoopbackTransport::get_dropped() const {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return m_dropped;
+}
+
+void LoopbackTransport::push(const Endpoint& from, const void* data, int len) {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (m_queue.size() >= MAX_QUEUE) {
+        ++m_dropped;
+        return;
+    }
+    m_queue.emplace_back();
+    Datagram& d = m_queue.back();
+    d.from = from;
+    if (!m_pool.empty()) {
+        d.data = std::move(m_pool.back());
+        m_pool.pop_back();
+    }
+    d.data.assign((const char*)data, (const char*)data + len);
+}
@@ -0,0 +1,106 @@
+/*********************************************************************
+ * \file   net_loopback.h
+ * \brief  プロセス内のループバック通信（ソケットを使わないNetTransport）
+ *         複数のNetworkManager（ホストとクライアント）を1つのプロセスで繋ぎ、
+ *         ネットワークの無い環境でテストやベンチマークを回すのに使う
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include "net_transport.h"  // NetTransport
+#include "net_endpoint.h"   // Endpoint, EndpointHash
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class LoopbackTransport;
+
+// ============================================================
+// LoopbackNetwork クラス
+// 127.0.0.1 上の仮想的なネットワーク。LoopbackTransportはここにポートを登録し、
+// 送ったデータグラムは宛先のLoopbackTransportの受信キューに直接入る。
+// 宛先が無ければUDPと同じく黙って捨てる。
+// ============================================================
+class LoopbackNetwork {
+public:
+    // 自動で割り当てるポートの始まり
+    static const uint16_t FIRST_AUTO_PORT = 40000;
+
+    LoopbackNetwork() {}
+    LoopbackNetwork(const LoopbackNetwork&) = delete;
+    LoopbackNetwork& operator=(const LoopbackNetwork&) = delete;
+
+    // 宛先が無くて捨てたデータグラム数
+    uint64_t get_undeliverable() const;
+
+private:
+    friend class LoopbackTransport;
+
+    // portにtransportを登録する（0なら空いているポートを割り当てる）
+    // 戻り値: 登録したEndpoint（ポートが使用中なら未設定）
+    Endpoint attach(LoopbackTransport* transport, uint16_t port);
+    void detach(const Endpoint& ep);
+
+    // fromからtoへ1つ届ける（宛先が無ければfalse）
+    bool deliver(const Endpoint& from, const Endpoint& to, const void* data, int len);
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<Endpoint, LoopbackTransport*, EndpointHash> m_nodes;
+    uint16_t m_nextPort = FIRST_AUTO_PORT;
+    uint64_t m_undeliverable = 0;
+};
+
+// ============================================================
+// LoopbackTransport クラス
+// LoopbackNetworkに繋がった1つの「ソケット」。受信キューはミューテックスで守るので、
+// 別々のスレッドのNetworkManagerから送り合ってもよい。
+// 待つためのソケットは無い（get_handle()がINVALID_SOCKET）ので、
+// NetworkManagerはワーカースレッドを使わず、update()の中で受信する。
+// ============================================================
+class LoopbackTransport : public NetTransport {
+public:
+    // 受信キューの上限（超えた分はソケットの受信バッファが溢れたときと同じく捨てる）
+    static const size_t MAX_QUEUE = 4096;
+
+    // portで登録する（0なら空いているポートを割り当てる）
+    explicit LoopbackTransport(LoopbackNetwork& network, uint16_t port = 0);
+    ~LoopbackTransport() override;
+    LoopbackTransport(const LoopbackTransport&) = delete;
+    LoopbackTransport& operator=(const LoopbackTransport&) = delete;
+
+    // 自分のアドレス（127.0.0.1:ポート）。ポートが使用中で登録できなければ未設定
+    const Endpoint& get_endpoint() const { return m_endpoint; }
+
+    // NetTransport
+    bool send_to(const Endpoint& to, const void* data, int len) override;
+    int send_batch(const UdpSendItem* items, int count) override;
+    int recv_from(char* buffer, int bufferSize, Endpoint& from) override;
+    int recv_batch(UdpRecvItem* items, int count) override;
+    SOCKET get_handle() const override { return INVALID_SOCKET; }
+
+    // 受信キューに溜まっている数 / 溢れて捨てた数
+    size_t get_pending() const;
+    uint64_t get_dropped() const;
+
+private:
+    friend class LoopbackNetwork;
+
+    // LoopbackNetworkから呼ばれる: 受信キューに入れる
+    void push(const Endpoint& from, const void* data, int len);
+
+    struct Datagram {
+        Endpoint from;
+        std::vector<char> data;
+    };
+
+    LoopbackNetwork& m_network;
+    Endpoint m_endpoint;
+    mutable std::mutex m_mutex;
+    std::deque<Datagram> m_queue;
+    std::vector<std::vector<char>> m_pool;  // 受け取り終わったバッファ（使い回す）
+    uint64_t m_dropped = 0;
+};
@@ -0,0 +1,117 @@
+/*********************************************************************
+ * \file   net_platform.h
+ * \brief  ソケットAPIのプラットフォーム差分を吸収する定義
+ *         Windowsでは WinSock2 をそのまま使い、
+ *         Linux などでは BSDソケットを WinSock の名前で使えるようにする
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include <mutex>
+
+#ifdef _WIN32
+
+#include <winsock2.h>        // WinSock2 API
+#include <ws2tcpip.h>        // inet_pton, inet_ntop, socklen_t など
+
+ // WinSock2ライブラリをリンク
+#pragma comment(lib, "Ws2_32.lib")
+
+#else
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <cstring>
+
+// WinSockと同じ名前で扱えるようにする
+typedef int SOCKET;
+typedef int BOOL;
+#ifndef TRUE
+#define TRUE 1
+#endif
+#define INVALID_SOCKET (-1)
+#define SOCKET_ERROR   (-1)
+#define ZeroMemory(p, n) memset((p), 0, (n))
+#define MAKEWORD(a, b) ((unsigned short)(((a) & 0xFF) | (((b) & 0xFF) << 8)))
+
+// WSAStartup / WSACleanup はPOSIXでは不要なので何もしない
+struct WSADATA { int unused; };
+inline int WSAStartup(unsigned short, WSADATA*) { return 0; }
+inline int WSACleanup() { return 0; }
+
+inline int closesocket(SOCKET s) { return ::close(s); }
+
+#endif
+
+// ============================================================
+// net_startup / net_cleanup - WinSockの初期化をプロセス全体で参照カウントする
+// 最初のnet_startup()でだけWSAStartupを呼び、最後のnet_cleanup()でWSACleanupを呼ぶ
+// （ソケットを開け閉めするたびにWinSockを初期化し直さない）
+// 成功したnet_startup()ごとにnet_cleanup()を1回呼ぶこと。POSIXでは数えるだけ
+// ============================================================
+namespace net_detail {
+    inline std::mutex& startup_mutex() { static std::mutex m; return m; }
+    inline int& startup_count() { static int count = 0; return count; }
+}
+
+inline bool net_startup() {
+    std::lock_guard<std::mutex> lk(net_detail::startup_mutex());
+    if (net_detail::startup_count() == 0) {
+        WSADATA wsa;
+        if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return false;
+    }
+    ++net_detail::startup_count();
+    return true;
+}
+
+inline void net_cleanup() {
+    std::lock_guard<std::mutex> lk(net_detail::startup_mutex());
+    if (net_detail::startup_count() == 0) return;
+    if (--net_detail::startup_count() == 0) WSACleanup();
+}
+
+// ============================================================
+// net_set_non_blocking - ソケットをノンブロッキングモードにする
+// ============================================================
+inline bool net_set_non_blocking(SOCKET s, bool enable) {
+#ifdef _WIN32
+    u_long mode = enable ? 1 : 0;
+    return ioctlsocket(s, FIONBIO, &mode) == 0;
+#else
+    int flags = fcntl(s, F_GETFL, 0);
+    if (flags < 0) return false;
+    flags = enable ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+    return fcntl(s, F_SETFL, flags) == 0;
+#endif
+}
+
+// ============================================================
+// net_would_block - 直前のソケット呼び出しが「データなし」で失敗したか
+// ============================================================
+inline bool net_would_block() {
+#ifdef _WIN32
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+// ============================================================
+// net_connection_reset - UDPで相手ポートが閉じていた通知（ICMP）か
+// Windowsでは次のrecvfromがWSAECONNRESETで失敗するだけなので読み飛ばしてよい
+// ============================================================
+inline bool net_connection_reset() {
+#ifdef _WIN32
+    return WSAGetLastError() == WSAECONNRESET;
+#else
+    return errno == ECONNREFUSED;
+#endif
+}
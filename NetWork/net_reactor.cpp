@@ -0,0 +1,251 @@
+/*********************************************************************
+ * \file   net_reactor.cpp
+ * \brief  NetReactorクラスの実装（epoll / WSAPoll）
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#include "pch.h"
+#include "net_reactor.h"
+#include <iostream>
+#include <cstdint>
+
+#ifndef _WIN32
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
+// ============================================================
+// コンストラクタ / デストラクタ
+// ============================================================
+NetReactor::NetReactor() {}
+
+NetReactor::~NetReactor() { close(); }
+
+#ifdef _WIN32
+
+// ============================================================
+// open - 起床用のループバックUDPソケットを作る
+// WSAPollはソケットしか待てないので、自分宛てに1バイト送って起こす
+// ============================================================
+bool NetReactor::open() {
+    if (m_open) return true;
+
+    if (!net_startup()) return false;
+
+    m_wakeSock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (m_wakeSock == INVALID_SOCKET) {
+        net_cleanup();
+        return false;
+    }
+
+    ZeroMemory(&m_wakeAddr, sizeof(m_wakeAddr));
+    m_wakeAddr.sin_family = AF_INET;
+    m_wakeAddr.sin_port = 0;  // OSに空きポートを選ばせる
+    inet_pton(AF_INET, "127.0.0.1", &m_wakeAddr.sin_addr);
+
+    int addrLen = sizeof(m_wakeAddr);
+    if (bind(m_wakeSock, (sockaddr*)&m_wakeAddr, sizeof(m_wakeAddr)) == SOCKET_ERROR ||
+        getsockname(m_wakeSock, (sockaddr*)&m_wakeAddr, &addrLen) == SOCKET_ERROR) {
+        std::cerr << "NetReactor: wakeup socket setup failed\n";
+        closesocket(m_wakeSock);
+        m_wakeSock = INVALID_SOCKET;
+        net_cleanup();
+        return false;
+    }
+    net_set_non_blocking(m_wakeSock, true);
+
+    WSAPOLLFD wake = {};
+    wake.fd = m_wakeSock;
+    wake.events = POLLRDNORM;
+    m_fds.assign(1, wake);
+    m_tags.assign(1, -1);
+
+    m_open = true;
+    return true;
+}
+
+// ============================================================
+// close - 起床用ソケットを閉じる
+// ============================================================
+void NetReactor::close() {
+    if (!m_open) return;
+    closesocket(m_wakeSock);
+    m_wakeSock = INVALID_SOCKET;
+    m_fds.clear();
+    m_tags.clear();
+    m_open = false;
+    net_cleanup();
+}
+
+// ============================================================
+// add - 監視するソケットを追加する
+// ============================================================
+bool NetReactor::add(SOCKET s, int tag) {
+    if (!m_open || s == INVALID_SOCKET) return false;
+    if ((int)m_fds.size() - 1 >= MAX_SOCKETS) return false;
+
+    WSAPOLLFD fd = {};
+    fd.fd = s;
+    fd.events = POLLRDNORM;
+    m_fds.push_back(fd);
+    m_tags.push_back(tag);
+    return true;
+}
+
+// ============================================================
+// clear - 起床用ソケット以外の登録を外す
+// ============================================================
+void NetReactor::clear() {
+    if (!m_open) return;
+    m_fds.resize(1);
+    m_tags.resize(1);
+}
+
+// ============================================================
+// wait - WSAPollで全ソケットをまとめて待つ
+// ============================================================
+int NetReactor::wait(int timeout_ms, int* readyTags, int maxReady) {
+    if (!m_open) return -1;
+
+    for (auto& fd : m_fds) fd.revents = 0;
+    int n = WSAPoll(m_fds.data(), (ULONG)m_fds.size(), timeout_ms < 0 ? -1 : timeout_ms);
+    if (n == SOCKET_ERROR) return -1;
+    if (n == 0) return 0;
+
+    if (m_fds[0].revents) drain_wakeup();
+
+    int count = 0;
+    for (size_t i = 1; i < m_fds.size() && count < maxReady; ++i) {
+        // エラー通知（POLLERR）も受信で拾えるので読み込み可能として扱う
+        if (m_fds[i].revents & (POLLRDNORM | POLLERR | POLLHUP)) {
+            readyTags[count++] = m_tags[i];
+        }
+    }
+    return count;
+}
+
+// ============================================================
+// wakeup - 起床用ソケットに自分宛ての1バイトを送る
+// ============================================================
+void NetReactor::wakeup() {
+    if (!m_open) return;
+    char b = 0;
+    sendto(m_wakeSock, &b, 1, 0, (const sockaddr*)&m_wakeAddr, sizeof(m_wakeAddr));
+}
+
+// ============================================================
+// drain_wakeup - 溜まった起床通知をすべて読み捨てる
+// ============================================================
+void NetReactor::drain_wakeup() {
+    char buf[16];
+    while (recv(m_wakeSock, buf, sizeof(buf), 0) > 0) {}
+}
+
+#else
+
+// ============================================================
+// open - epollインスタンスと起床用eventfdを作る
+// ============================================================
+bool NetReactor::open() {
+    if (m_open) return true;
+
+    m_epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epoll < 0) return false;
+
+    m_eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_eventFd < 0) {
+        ::close(m_epoll);
+        m_epoll = -1;
+        return false;
+    }
+
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.u64 = (uint64_t)-1;  // 起床用（tagとして返さない）
+    if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_eventFd, &ev) != 0) {
+        std::cerr << "NetReactor: epoll_ctl(eventfd) failed\n";
+        ::close(m_eventFd);
+        ::close(m_epoll);
+        m_eventFd = m_epoll = -1;
+        return false;
+    }
+
+    m_open = true;
+    return true;
+}
+
+// ============================================================
+// close - epollとeventfdを閉じる
+// ============================================================
+void NetReactor::close() {
+    if (!m_open) return;
+    ::close(m_eventFd);
+    ::close(m_epoll);
+    m_eventFd = m_epoll = -1;
+    m_sockets.clear();
+    m_open = false;
+}
+
+// ============================================================
+// add - epollに読み込み待ちで登録する（レベルトリガー）
+// ============================================================
+bool NetReactor::add(SOCKET s, int tag) {
+    if (!m_open || s == INVALID_SOCKET) return false;
+    if ((int)m_sockets.size() >= MAX_SOCKETS) return false;
+
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.u64 = (uint64_t)(uint32_t)tag;
+    if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, s, &ev) != 0) return false;
+    m_sockets.push_back(s);
+    return true;
+}
+
+// ============================================================
+// clear - 登録済みソケットをepollから外す
+// ============================================================
+void NetReactor::clear() {
+    if (!m_open) return;
+    for (int s : m_sockets) {
+        epoll_ctl(m_epoll, EPOLL_CTL_DEL, s, nullptr);
+    }
+    m_sockets.clear();
+}
+
+// ============================================================
+// wait - epoll_waitで全ソケットをまとめて待つ
+// ============================================================
+int NetReactor::wait(int timeout_ms, int* readyTags, int maxReady) {
+    if (!m_open) return -1;
+
+    epoll_event events[MAX_SOCKETS + 1];
+    int n = epoll_wait(m_epoll, events, MAX_SOCKETS + 1, timeout_ms < 0 ? -1 : timeout_ms);
+    if (n < 0) return (errno == EINTR) ? 0 : -1;
+
+    int count = 0;
+    for (int i = 0; i < n; ++i) {
+        if (events[i].data.u64 == (uint64_t)-1) {
+            // 起床通知: カウンタを読んでリセットする
+            uint64_t v;
+            while (read(m_eventFd, &v, sizeof(v)) > 0) {}
+            continue;
+        }
+        if (count < maxReady) {
+            readyTags[count++] = (int)(uint32_t)events[i].data.u64;
+        }
+    }
+    return count;
+}
+
+// ============================================================
+// wakeup - eventfdに書き込んでepoll_waitを起こす
+// ============================================================
+void NetReactor::wakeup() {
+    if (!m_open) return;
+    uint64_t one = 1;
+    ssize_t r = write(m_eventFd, &one, sizeof(one));
+    (void)r;
+}
+
+#endif
@@ -0,0 +1,78 @@
+/*********************************************************************
+ * \file   net_reactor.h
+ * \brief  複数ソケットの受信待ちを1回の待機でまとめて行うリアクター
+ *         Linux: epoll + eventfd / Windows: WSAPoll + ループバックの起床用ソケット
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include "net_platform.h"  // SOCKET
+#include <vector>
+
+// ============================================================
+// NetReactor クラス
+//
+// ワーカースレッドが登録済みソケットのどれかが読み込み可能になるか、
+// 他のスレッドから wakeup() されるまで1回のシステムコールで待機する。
+// 読み込み可能になったソケットは登録時のtagで返す。
+//
+// 使い方:
+//   reactor.open();
+//   reactor.add(sock, TAG_GAME);
+//   int n = reactor.wait(timeout, tags, MAX);   // ワーカー
+//   reactor.wakeup();                           // 停止時など（別スレッドから可）
+// ============================================================
+class NetReactor {
+public:
+    // 同時に監視できるソケット数（起床用ハンドルは含まない）
+    static const int MAX_SOCKETS = 8;
+
+    NetReactor();
+    ~NetReactor();
+
+    NetReactor(const NetReactor&) = delete;
+    NetReactor& operator=(const NetReactor&) = delete;
+
+    // 待機用のハンドル（epoll / 起床用ハンドル）を作る
+    bool open();
+
+    // すべてのハンドルを閉じる（登録済みソケット自体は閉じない）
+    void close();
+
+    // 読み込み待ちするソケットを登録する
+    bool add(SOCKET s, int tag);
+
+    // 登録済みソケットをすべて外す（起床用ハンドルは残す）
+    void clear();
+
+    // いずれかのソケットが読み込み可能になるか、wakeup()されるか、
+    // timeout_ms（負なら無限）経過するまで待つ
+    // 戻り値: readyTagsに書き込んだ数（0=タイムアウトまたはwakeup、負=エラー）
+    int wait(int timeout_ms, int* readyTags, int maxReady);
+
+    // wait() 中のスレッドを起こす（どのスレッドから呼んでもよい）
+    void wakeup();
+
+    // open() 済みか
+    bool is_open() const { return m_open; }
+
+private:
+    bool m_open = false;
+
+#ifdef _WIN32
+    // WSAPollに渡す配列（[0]は起床用ソケット）と各要素のtag
+    std::vector<WSAPOLLFD> m_fds;
+    std::vector<int> m_tags;
+    SOCKET m_wakeSock = INVALID_SOCKET;  // 127.0.0.1にbindした起床用UDPソケット
+    sockaddr_in m_wakeAddr = {};         // 起床用ソケット自身のアドレス
+
+    // 起床用ソケットに溜まったデータを捨てる
+    void drain_wakeup();
+#else
+    int m_epoll = -1;     // epollインスタンス
+    int m_eventFd = -1;   // 起床用eventfd
+    std::vector<int> m_sockets;  // 登録済みソケット（clear()で外すため）
+#endif
+};
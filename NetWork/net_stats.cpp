@@ -0,0 +1,229 @@
+/*********************************************************************
+ * \file   net_stats.cpp
+ * \brief  ConnectionStatsクラスの実装と統計のJSON出力
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#include "pch.h"
+#include "net_stats.h"
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+namespace {
+    float elapsed_seconds(ConnectionStats::TimePoint from, ConnectionStats::TimePoint to) {
+        return std::chrono::duration<float>(to - from).count();
+    }
+
+    float per_second(uint64_t from, uint64_t to, float seconds) {
+        return seconds > 0.0f ? (float)(to - from) / seconds : 0.0f;
+    }
+}
+
+// ============================================================
+// on_packet_sent / on_packet_received - パケットを数える
+// ============================================================
+void ConnectionStats::on_packet_sent(TimePoint now, int bytes) {
+    roll(now);
+    ++m_totals.packetsOut;
+    m_totals.bytesOut += (uint64_t)bytes;
+}
+
+void ConnectionStats::on_packet_received(TimePoint now, int bytes, uint16_t seq) {
+    roll(now);
+    ++m_totals.packetsIn;
+    m_totals.bytesIn += (uint64_t)bytes;
+
+    if (!m_hasSeq) {
+        m_hasSeq = true;
+        m_baseSeq = seq;
+        m_maxSeq = seq;
+    } else {
+        // 16ビットの番号を、届いた最大の番号からの差で32ビットに広げる
+        const int16_t ahead = (int16_t)(seq - (uint16_t)m_maxSeq);
+        if (ahead > 0) {
+            m_maxSeq += (uint32_t)ahead;
+        } else {
+            // 重複は除かれているので、最大より前の番号は追い越されて届いたもの
+            ++m_totals.outOfOrder;
+        }
+    }
+    m_totals.expected = (uint64_t)(m_maxSeq - m_baseSeq) + 1;
+}
+
+// ============================================================
+// on_rtt_sample - PONGで測ったRTTを反映する
+// ============================================================
+void ConnectionStats::on_rtt_sample(float ms) {
+    if (m_pingSamples == 0) {
+        m_srttMs = ms;
+        m_rttVarMs = ms * 0.5f;
+        m_rttMinMs = ms;
+        m_rttMaxMs = ms;
+    } else {
+        m_rttVarMs = 0.75f * m_rttVarMs + 0.25f * std::fabs(m_srttMs - ms);
+        m_srttMs = 0.875f * m_srttMs + 0.125f * ms;
+        if (ms < m_rttMinMs) m_rttMinMs = ms;
+        if (ms > m_rttMaxMs) m_rttMaxMs = ms;
+        m_jitterMs += (std::fabs(ms - m_rttLastMs) - m_jitterMs) / 16.0f;
+    }
+    m_rttLastMs = ms;
+    ++m_pingSamples;
+}
+
+// ============================================================
+// キューの深さ
+// ============================================================
+void ConnectionStats::on_reliable_queued(size_t pending) {
+    if (pending > m_reliableHighWater) m_reliableHighWater = pending;
+}
+
+void ConnectionStats::on_input_queued(size_t depth) {
+    if (depth > m_inputHighWater) m_inputHighWater = depth;
+}
+
+// ============================================================
+// roll - 区間を過ぎていれば毎秒の値を確定する
+// 送受信が止まっている間は呼ばれないので、次に動いたときにまとめて確定する
+// （その区間の値は止まっていた時間を含めた平均になる）
+// ============================================================
+void ConnectionStats::roll(TimePoint now) {
+    if (!m_windowStarted) {
+        m_windowStarted = true;
+        m_windowStart = now;
+        m_windowBase = m_totals;
+        return;
+    }
+    const float seconds = elapsed_seconds(m_windowStart, now);
+    if (seconds < WINDOW_SECONDS) return;
+
+    compute_rates(m_windowBase, m_totals, seconds, m_lastRates);
+    m_windowStart = now;
+    m_windowBase = m_totals;
+}
+
+void ConnectionStats::compute_rates(const Counters& from, const Counters& to, float seconds,
+    ConnectionStatsSample& out) {
+    out.packetsInPerSec = per_second(from.packetsIn, to.packetsIn, seconds);
+    out.packetsOutPerSec = per_second(from.packetsOut, to.packetsOut, seconds);
+    out.bytesInPerSec = per_second(from.bytesIn, to.bytesIn, seconds);
+    out.bytesOutPerSec = per_second(from.bytesOut, to.bytesOut, seconds);
+
+    // 区間の前に抜けていた番号が区間の中で届くと、届いた数の方が多くなることがある
+    const uint64_t expected = to.expected - from.expected;
+    const uint64_t received = to.packetsIn - from.packetsIn;
+    out.lossPercent = (expected > received) ?
+        100.0f * (float)(expected - received) / (float)expected : 0.0f;
+    out.outOfOrderPercent = received ?
+        100.0f * (float)(to.outOfOrder - from.outOfOrder) / (float)received : 0.0f;
+}
+
+// ============================================================
+// fill - 現在の値を書き込む
+// ============================================================
+void ConnectionStats::fill(TimePoint now, ConnectionStatsSample& out) const {
+    out = m_lastRates;
+
+    // 区間を過ぎたまま送受信が無ければ、まだ確定していない区間の値を出す
+    // （止まった接続の毎秒の値が最後に動いていたときのまま残らないように）
+    if (m_windowStarted) {
+        const float seconds = elapsed_seconds(m_windowStart, now);
+        if (seconds >= WINDOW_SECONDS) compute_rates(m_windowBase, m_totals, seconds, out);
+    }
+
+    out.pingSamples = m_pingSamples;
+    out.rttMs = m_srttMs;
+    out.rttVarMs = m_rttVarMs;
+    out.rttMinMs = m_rttMinMs;
+    out.rttMaxMs = m_rttMaxMs;
+    out.rttLastMs = m_rttLastMs;
+    out.jitterMs = m_jitterMs;
+
+    out.packetsIn = m_totals.packetsIn;
+    out.packetsOut = m_totals.packetsOut;
+    out.bytesIn = m_totals.bytesIn;
+    out.bytesOut = m_totals.bytesOut;
+    out.lost = (m_totals.expected > m_totals.packetsIn) ? m_totals.expected - m_totals.packetsIn : 0;
+    out.outOfOrder = m_totals.outOfOrder;
+
+    out.reliablePendingHighWater = m_reliableHighWater;
+    out.inputQueueHighWater = m_inputHighWater;
+    out.inputDropped = m_inputDropped;
+    out.inputMissed = m_inputMissed;
+    out.inputRecovered = m_inputRecovered;
+}
+
+// ============================================================
+// write_stats_json - 1行のJSONにする（JSON Lines）
+// 例: {"time":12.500,"host":true,...,"connections":[{"playerId":2,...}]}
+// ============================================================
+void write_stats_json(const NetStatsReport& report, std::ostream& out) {
+    // 呼び出し側のストリームの書式を変えないように、一度文字列にする
+    std::ostringstream s;
+    s << std::fixed << std::setprecision(3);
+    s << "{\"time\":" << report.time
+        << ",\"host\":" << (report.isHost ? "true" : "false")
+        << ",\"myPlayerId\":" << report.myPlayerId
+        << ",\"recvShards\":" << report.recvShards
+        << ",\"recvQueueDepth\":" << report.recvQueueDepth
+        << ",\"recvQueueHighWater\":" << report.recvQueueHighWater
+        << ",\"recvQueueCapacity\":" << report.recvQueueCapacity
+        << ",\"recvPackets\":" << report.recvPackets
+        << ",\"recvShardPackets\":[";
+    for (size_t i = 0; i < report.recvShardPackets.size(); ++i) {
+        if (i > 0) s << ",";
+        s << report.recvShardPackets[i];
+    }
+    s << "]"
+        << ",\"recvDropped\":" << report.recvDropped
+        << ",\"drainLimit\":" << report.drainLimit
+        << ",\"drainHighWater\":" << report.drainHighWater
+        << ",\"drainLimited\":" << report.drainLimited
+        << ",\"stateIntervalMs\":" << report.stateIntervalMs
+        << ",\"encodeThreads\":" << report.encodeThreads
+        << ",\"encodeCount\":" << report.encodeCount
+        << ",\"encodeAvgMs\":" << (report.encodeCount ?
+            report.encodeSeconds * 1000.0 / (double)report.encodeCount : 0.0)
+        << ",\"encodeMaxMs\":" << report.encodeMaxMs
+        << ",\"connections\":[";
+
+    for (size_t i = 0; i < report.connections.size(); ++i) {
+        const NetStatsReport::Connection& c = report.connections[i];
+        const ConnectionStatsSample& st = c.stats;
+        if (i > 0) s << ",";
+        s << "{\"playerId\":" << c.playerId
+            << ",\"endpoint\":\"" << c.endpoint.ip_string() << ":" << c.endpoint.port << "\""
+            << ",\"pingSamples\":" << st.pingSamples
+            << ",\"rttMs\":" << st.rttMs
+            << ",\"rttVarMs\":" << st.rttVarMs
+            << ",\"rttMinMs\":" << st.rttMinMs
+            << ",\"rttMaxMs\":" << st.rttMaxMs
+            << ",\"rttLastMs\":" << st.rttLastMs
+            << ",\"jitterMs\":" << st.jitterMs
+            << ",\"ackRttMs\":" << c.ackRttMs
+            << ",\"rtoMs\":" << c.rtoMs
+            << ",\"packetsInPerSec\":" << st.packetsInPerSec
+            << ",\"packetsOutPerSec\":" << st.packetsOutPerSec
+            << ",\"bytesInPerSec\":" << st.bytesInPerSec
+            << ",\"bytesOutPerSec\":" << st.bytesOutPerSec
+            << ",\"lossPercent\":" << st.lossPercent
+            << ",\"outOfOrderPercent\":" << st.outOfOrderPercent
+            << ",\"packetsIn\":" << st.packetsIn
+            << ",\"packetsOut\":" << st.packetsOut
+            << ",\"bytesIn\":" << st.bytesIn
+            << ",\"bytesOut\":" << st.bytesOut
+            << ",\"lost\":" << st.lost
+            << ",\"outOfOrder\":" << st.outOfOrder
+            << ",\"resent\":" << c.resent
+            << ",\"reliablePendingHighWater\":" << st.reliablePendingHighWater
+            << ",\"inputQueueHighWater\":" << st.inputQueueHighWater
+            << ",\"inputDropped\":" << st.inputDropped
+            << ",\"inputMissed\":" << st.inputMissed
+            << ",\"inputRecovered\":" << st.inputRecovered
+            << "}";
+    }
+    s << "]}\n";
+    out << s.str();
+}
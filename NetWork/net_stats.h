@@ -0,0 +1,193 @@
+/*********************************************************************
+ * \file   net_stats.h
+ * \brief  通信の統計（接続ごとのRTT・ロス・帯域と、キューの深さ）
+ *         NetworkManager::get_stats() で取り出し、JSON Linesで定期的に書き出せる
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include "net_endpoint.h"  // Endpoint
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+// ============================================================
+// ConnectionStatsSample 構造体
+// ConnectionStats::fill() で取り出す1接続分の値
+// ============================================================
+struct ConnectionStatsSample {
+    // PING/PONGで測ったRTT（ミリ秒、pingSamples = 0 ならまだ測れていない）
+    uint64_t pingSamples = 0;
+    float rttMs = 0.0f;        // 平滑化したRTT（RFC 6298と同じ係数）
+    float rttVarMs = 0.0f;     // RTTのばらつき（同上）
+    float rttMinMs = 0.0f;
+    float rttMaxMs = 0.0f;
+    float rttLastMs = 0.0f;
+    float jitterMs = 0.0f;     // 連続したRTTの差の平滑値（RFC 3550と同じ1/16）
+
+    // 累計（ReliableLinkのヘッダーを含むバイト数、UDP/IPのヘッダーは含まない）
+    uint64_t packetsIn = 0;
+    uint64_t packetsOut = 0;
+    uint64_t bytesIn = 0;
+    uint64_t bytesOut = 0;
+    uint64_t lost = 0;         // パケット番号の抜け（届いていない数）
+    uint64_t outOfOrder = 0;   // 後の番号より遅れて届いた数
+
+    // 直前の1秒間（WINDOW_SECONDS）の値
+    float packetsInPerSec = 0.0f;
+    float packetsOutPerSec = 0.0f;
+    float bytesInPerSec = 0.0f;
+    float bytesOutPerSec = 0.0f;
+    float lossPercent = 0.0f;        // 届くはずだった数に対する抜けの割合
+    float outOfOrderPercent = 0.0f;  // 届いた数に対する順番違いの割合
+
+    // キュー（接続を始めてからの最大）
+    size_t reliablePendingHighWater = 0;  // ACK待ち・送信待ちの信頼メッセージ
+    size_t inputQueueHighWater = 0;       // ホスト: 適用待ちの入力
+    uint64_t inputDropped = 0;            // ホスト: 入力キューが溢れて捨てた入力
+
+    // ホスト: 入力の抜け（その入力無しでシミュレーションしたティックになる）
+    uint64_t inputMissed = 0;             // 控えを含めてどのINPUTにも載っていなかった入力
+    uint64_t inputRecovered = 0;          // 最新としては届かず、後のINPUTの控えで受け取れた入力
+};
+
+// ============================================================
+// ConnectionStats クラス（接続ごと）
+//
+// ReliableLinkが送受信したパケットを数え、NetworkManagerがPING/PONGのRTTと
+// 入力キューの深さを入れる。ロスと順番違いはパケット番号から求める
+// （RTPと同じく、届いた最大の番号までの数 - 届いた数 = 抜け）。
+// 毎秒の値はWINDOW_SECONDSごとに区切った直前の区間から出すので、
+// 読む側がいつ何回読んでも数え方は変わらない。
+//
+// スレッドセーフではない（持ち主のReliableLinkと同じく呼び出し側で排他する）。
+// ============================================================
+class ConnectionStats {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+
+    // 毎秒の値を区切る間隔（秒）
+    static constexpr float WINDOW_SECONDS = 1.0f;
+
+    // 送ったパケット（bytes = ヘッダーを含む大きさ）
+    void on_packet_sent(TimePoint now, int bytes);
+
+    // 受け取ったパケット（重複はReliableLinkが除いた後で呼ぶ）
+    void on_packet_received(TimePoint now, int bytes, uint16_t seq);
+
+    // PONGで測ったRTT（ミリ秒）
+    void on_rtt_sample(float ms);
+
+    // 信頼メッセージをキューに入れた後の未完了数
+    void on_reliable_queued(size_t pending);
+
+    // ホスト: 入力を積んだ後の入力キューの深さ / 溢れて捨てた
+    void on_input_queued(size_t depth);
+    void on_input_dropped() { ++m_inputDropped; }
+
+    // ホスト: seqが飛んで受け取れなかった入力の数 / 控えで受け取れた入力
+    void on_input_missed(uint32_t count) { m_inputMissed += count; }
+    void on_input_recovered() { ++m_inputRecovered; }
+
+    // 現在の値をoutに書き込む
+    void fill(TimePoint now, ConnectionStatsSample& out) const;
+
+private:
+    // 区間の集計に使う累計
+    struct Counters {
+        uint64_t packetsIn = 0;
+        uint64_t packetsOut = 0;
+        uint64_t bytesIn = 0;
+        uint64_t bytesOut = 0;
+        uint64_t expected = 0;     // 届くはずだった数（最初の番号から最大の番号まで）
+        uint64_t outOfOrder = 0;
+    };
+
+    // 区間を過ぎていれば、直前の区間の毎秒の値を確定して次の区間を始める
+    void roll(TimePoint now);
+
+    // from - to の区間の毎秒の値
+    static void compute_rates(const Counters& from, const Counters& to, float seconds,
+        ConnectionStatsSample& out);
+
+    // 累計（expectedは受信のたびに更新する）
+    Counters m_totals;
+
+    // 受信したパケット番号（折り返しを数えて32ビットに広げたもの）
+    bool m_hasSeq = false;
+    uint32_t m_baseSeq = 0;     // 最初に届いた番号
+    uint32_t m_maxSeq = 0;      // 届いた最大の番号
+
+    // 区間
+    bool m_windowStarted = false;
+    TimePoint m_windowStart;
+    Counters m_windowBase;               // 区間の始まりの累計
+    ConnectionStatsSample m_lastRates;   // 確定した直前の区間の毎秒の値（rates系のみ有効）
+
+    // RTT
+    uint64_t m_pingSamples = 0;
+    float m_srttMs = 0.0f;
+    float m_rttVarMs = 0.0f;
+    float m_rttMinMs = 0.0f;
+    float m_rttMaxMs = 0.0f;
+    float m_rttLastMs = 0.0f;
+    float m_jitterMs = 0.0f;
+
+    // キュー
+    size_t m_reliableHighWater = 0;
+    size_t m_inputHighWater = 0;
+    uint64_t m_inputDropped = 0;
+    uint64_t m_inputMissed = 0;
+    uint64_t m_inputRecovered = 0;
+};
+
+// ============================================================
+// NetStatsReport 構造体
+// NetworkManager::get_stats() で取り出す全体の統計
+// ============================================================
+struct NetStatsReport {
+    double time = 0.0;           // NetworkManager::get_time()
+    bool isHost = false;
+    uint32_t myPlayerId = 0;
+
+    // ワーカー→メインスレッドの受信キュー（受信シャードがあれば全キューの合計）
+    int recvShards = 1;             // ゲーム通信ポートを受信するソケットの数
+    size_t recvQueueDepth = 0;      // 取り出した時点で溜まっていた数
+    size_t recvQueueHighWater = 0;  // 起動してからの最大（キュー1つあたり）
+    size_t recvQueueCapacity = 0;   // キュー1つあたり
+    uint64_t recvPackets = 0;       // キューに積んだ数
+    std::vector<uint64_t> recvShardPackets;  // ソケットごとのrecvPackets（先頭は1つ目のソケットで、探索ソケットの分も含む）
+    uint64_t recvDropped = 0;       // 満杯で捨てた数
+
+    // メインスレッドの受信処理（1回のservice()あたり）
+    size_t drainLimit = 0;          // 1回で処理する上限（m_maxPacketsPerFrame + クライアント分）
+    size_t drainHighWater = 0;      // 1回で処理した数の最大
+    uint64_t drainLimited = 0;      // 上限で打ち切ってキューに残した回数
+
+    // 調整中のパラメータ（この統計を見て決めるもの）
+    uint32_t stateIntervalMs = 0;   // キープアライブの間隔
+
+    // ホスト: 全クライアント分のSTATEの符号化（起動してから）
+    int encodeThreads = 0;          // 符号化するスレッドの数（送信するワーカーを含む）
+    uint64_t encodeCount = 0;       // 符号化した回数（STATEを送った回数）
+    double encodeSeconds = 0.0;     // かかった時間の合計（秒）
+    double encodeMaxMs = 0.0;       // 1回の最大（ミリ秒）
+
+    struct Connection {
+        uint32_t playerId = 0;      // ホスト: 相手のプレイヤーID（JOIN処理前は0）、クライアント: 0（ホスト）
+        Endpoint endpoint;
+        float ackRttMs = 0.0f;      // ReliableLinkがACKから測ったRTT（再送の間隔に使う値）
+        float rtoMs = 0.0f;
+        uint64_t resent = 0;        // 再送した信頼メッセージの延べ数
+        ConnectionStatsSample stats;
+    };
+    std::vector<Connection> connections;
+};
+
+// reportを1行のJSONにしてoutに書き込む（末尾に改行）
+void write_stats_json(const NetStatsReport& report, std::ostream& out);
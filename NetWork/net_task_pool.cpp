@@ -0,0 +1,107 @@
+/*********************************************************************
+ * \file   net_task_pool.cpp
+ * \brief  NetTaskPoolクラスの実装
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#include "pch.h"
+#include "net_task_pool.h"
+
+NetTaskPool::~NetTaskPool() {
+    stop();
+}
+
+void NetTaskPool::start(int threads) {
+    stop();
+
+    if (threads <= 0) threads = static_cast<int>(std::thread::hardware_concurrency());
+    if (threads < 1) threads = 1;
+    if (threads > MAX_THREADS) threads = MAX_THREADS;
+
+    uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_stop = false;
+        m_busy = 0;
+        generation = m_generation;
+    }
+    // 前に動いていたときのrun()の回を済んだものとして渡す（0から始めると作った直前の回で起きてしまう）
+    for (int i = 1; i < threads; ++i) {
+        m_threads.emplace_back(&NetTaskPool::worker_loop, this, i, generation);
+    }
+}
+
+void NetTaskPool::stop() {
+    if (m_threads.empty()) return;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& t : m_threads) {
+        if (t.joinable()) t.join();
+    }
+    m_threads.clear();
+}
+
+// ============================================================
+// run - 添字を全スレッドで分けて処理する
+// 追加のスレッドが無い、または添字が1つだけなら、起こさずにこのスレッドで処理する
+// ============================================================
+void NetTaskPool::run(size_t count, const Task& task) {
+    if (count == 0) return;
+    if (m_threads.empty() || count == 1) {
+        for (size_t i = 0; i < count; ++i) task(0, i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_task = &task;
+        m_count = count;
+        m_next.store(0, std::memory_order_relaxed);
+        m_busy = static_cast<int>(m_threads.size());
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    work(0);
+
+    // 追加のスレッドが取った添字を処理し終えるまで待つ（taskはこの関数を抜けると無効になる）
+    std::unique_lock<std::mutex> lk(m_mutex);
+    m_done.wait(lk, [this] { return m_busy == 0; });
+    m_task = nullptr;
+}
+
+void NetTaskPool::work(int worker) {
+    for (;;) {
+        const size_t index = m_next.fetch_add(1, std::memory_order_relaxed);
+        if (index >= m_count) break;
+        (*m_task)(worker, index);
+    }
+}
+
+// ============================================================
+// worker_loop - 追加のスレッド
+// run()の回がseenから変わるまで眠り、起きたら残っている添字を処理する
+// ============================================================
+void NetTaskPool::worker_loop(int worker, uint64_t seen) {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lk(m_mutex);
+            m_wake.wait(lk, [&] { return m_stop || m_generation != seen; });
+            if (m_stop) return;
+            seen = m_generation;
+        }
+
+        work(worker);
+
+        bool last = false;
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            last = --m_busy == 0;
+        }
+        if (last) m_done.notify_one();
+    }
+}
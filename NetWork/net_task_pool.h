@@ -0,0 +1,75 @@
+/*********************************************************************
+ * \file   net_task_pool.h
+ * \brief  送信処理を複数のスレッドで分けて行うための小さなスレッドプール
+ *         ホストがクライアントごとのSTATEを並列に符号化するのに使う
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ============================================================
+// NetTaskPool クラス
+//
+// run() に渡した処理を [0, count) の添字ごとに呼び、全部終わるまで待つ。
+// 添字は空いたスレッドから1つずつ取るので、重い添字があっても偏らない。
+// run() を呼んだスレッドも worker = 0 として手伝う（追加のスレッドは1 - size()-1）。
+// 処理には worker（0 - size()-1）が渡るので、作業用バッファをスレッドごとに持たせられる。
+//
+// ・run() を呼ぶのは同時に1つのスレッドだけであること
+// ・スレッドは start() で作って run() の合間は眠らせておく（毎回作り直さない）
+// ============================================================
+class NetTaskPool {
+public:
+    // worker: 処理しているスレッドの番号、index: 処理する添字
+    using Task = std::function<void(int worker, size_t index)>;
+
+    static const int MAX_THREADS = 16;
+
+    NetTaskPool() {}
+    ~NetTaskPool();
+    NetTaskPool(const NetTaskPool&) = delete;
+    NetTaskPool& operator=(const NetTaskPool&) = delete;
+
+    // threads: run()を呼ぶスレッドを含めた数（1なら追加のスレッドを作らない、0なら論理コア数）
+    // 既に動いていれば止めてから作り直す
+    void start(int threads);
+
+    // 追加のスレッドを止めてjoinする（以降のrun()は呼んだスレッドだけで処理する）
+    void stop();
+
+    // run()を処理するスレッドの数（呼んだスレッドを含む）
+    int size() const { return static_cast<int>(m_threads.size()) + 1; }
+
+    // [0, count) の各添字についてtaskを呼び、全部終わってから戻る
+    void run(size_t count, const Task& task);
+
+private:
+    // seen: 済んだものとして扱うrun()の回（start()の時点のm_generation）
+    void worker_loop(int worker, uint64_t seen);
+
+    // 残っている添字を取っては処理する（無くなったら戻る）
+    void work(int worker);
+
+    std::vector<std::thread> m_threads;  // 追加のスレッド（worker = 1 - size()-1）
+
+    std::mutex m_mutex;                  // 以下のうちatomicでないものを保護する
+    std::condition_variable m_wake;      // run()の始まりを追加のスレッドに知らせる
+    std::condition_variable m_done;      // 追加のスレッドが全員終わったことをrun()に知らせる
+    const Task* m_task = nullptr;        // 処理中のtask（run()の間だけ有効）
+    size_t m_count = 0;                  // 処理中の添字の数
+    uint64_t m_generation = 0;           // run()の回（追加のスレッドは変わったら起きる）
+    int m_busy = 0;                      // まだ終わっていない追加のスレッドの数
+    bool m_stop = false;
+
+    std::atomic<size_t> m_next{ 0 };     // 次に処理する添字
+};
@@ -0,0 +1,58 @@
+/*********************************************************************
+ * \file   net_transport.h
+ * \brief  ゲーム通信のデータグラム送受信インターフェース
+ *         実際のUDPソケットとプロセス内のループバックを差し替えられるようにする
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include "net_platform.h"  // SOCKET, INVALID_SOCKET
+#include "net_endpoint.h"  // Endpoint
+
+// send_batch() に渡す送信1件分
+struct UdpSendItem {
+    Endpoint to;        // 送信先
+    const void* data;   // 送信データ（同じデータを複数の宛先に使ってよい）
+    int len;            // データ長
+};
+
+// recv_batch() で受信する1件分（buffer / capacity は呼び出し側が設定する）
+struct UdpRecvItem {
+    char* buffer;       // 受信先バッファ
+    int capacity;       // バッファサイズ
+    int len;            // 受信したバイト数（recv_batchが設定）
+    Endpoint from;      // 送信元（recv_batchが設定）
+};
+
+// ============================================================
+// NetTransport クラス（インターフェース）
+// NetworkManagerのゲーム通信が使う送受信。実装は
+//   UdpNetwork        : 実際のUDPソケット
+//   LoopbackTransport : 同じプロセス内のキュー（ソケットなしのテスト・ベンチマーク用）
+//   LinkConditioner   : 別のNetTransportに遅延やロスを掛ける
+// 受信は待たない（届いていなければ0を返す）。UDPと同じく、届かない・順序が
+// 入れ替わることはあっても、1つのデータグラムが分かれることはない。
+// ============================================================
+class NetTransport {
+public:
+    virtual ~NetTransport() {}
+
+    // 1つ送る。戻り値: 送れたらtrue
+    virtual bool send_to(const Endpoint& to, const void* data, int len) = 0;
+
+    // まとめて送る。戻り値: 送れた件数
+    virtual int send_batch(const UdpSendItem* items, int count) = 0;
+
+    // 1つ受信する。戻り値: 受信バイト数（0=データなし、負=エラー）
+    virtual int recv_from(char* buffer, int bufferSize, Endpoint& from) = 0;
+
+    // 最大count件まとめて受信する。戻り値: 受信した件数（0=データなし、負=エラー）
+    virtual int recv_batch(UdpRecvItem* items, int count) = 0;
+
+    // 受信を待つためのソケット（NetReactorに登録する）
+    // INVALID_SOCKETなら待てないので、NetworkManagerはワーカースレッドを使わず
+    // update()の中で受信する
+    virtual SOCKET get_handle() const = 0;
+};
@@ -1,6 +1,6 @@
 /*********************************************************************
  * \file   network_common.h
- * \brief  lbg[NʐMŎgʒ`ipPbg^A\́A|[gݒj
+ * \brief  ネットワーク通信で使う共通定義（パケット型、構造体、ポート設定）
  *
  * \author Ryoto Kikuchi
  * \date   2026/2/24
@@ -9,105 +9,188 @@
 
 #include <cstdint>
 
- // \̂̃pfBO𖳌AM̃oCg𐳊mɈv
+ // 構造体のパディングを無効化し、送受信時のバイト列を正確に一致させる
 #pragma pack(push, 1)
 
-// pPbg̐擪1oCgŎʂ𔻒肷邽߂̗񋓌^
+// パケットの先頭1バイトで種別を判定するための列挙型
 enum PacketType : uint8_t {
-    PKT_DISCOVER = 1,  // NCAgS: u[hLXgŃzXgT
-    PKT_DISCOVER_REPLY = 2,  // zXgNCAg: Tւ̉iuɂvj
-    PKT_JOIN = 3,  // NCAgzXg: Q[ւ̎QNGXg
-    PKT_JOIN_ACK = 4,  // zXgNCAg: QFi蓖ĂplayerIdԂj
-    PKT_INPUT = 5,  // NCAgzXg: vC[̓̓f[^
-    PKT_STATE = 6,  // zXgNCAg: Q[IuWFNg̏Ԉꗗ
-    PKT_PING = 7,  // mFp̌yʃpPbg
-    PKT_CHANNEL_SCAN = 8,  // `lgp󋵂̃XLv
-    PKT_CHANNEL_INFO = 9,   // `l̉
-    PKT_BULLET = 10,  // e̔ˏ
+    PKT_DISCOVER = 1,  // クライアント→全体: ブロードキャストでホストを探す（PacketDiscover）
+    PKT_DISCOVER_REPLY = 2,  // ホスト→クライアント: 探索への応答（PacketDiscoverReply、チャンネルの混み具合付き）
+    PKT_JOIN = 3,  // クライアント→ホスト: ゲームへの参加リクエスト
+    PKT_JOIN_ACK = 4,  // ホスト→クライアント: 参加承認（割り当てたplayerIdを返す、0なら満員）
+    PKT_INPUT = 5,  // クライアント→ホスト: プレイヤーの入力データ
+    PKT_STATE = 6,  // ホスト→クライアント: ゲーム内オブジェクトの状態一覧
+    PKT_PING = 7,  // RTTの測定要求（PacketPing、受け取った側は同じtimeUsをPKT_PONGで返す）
+    PKT_CHANNEL_SCAN = 8,  // チャンネル使用状況のスキャン要求（PKT_DISCOVERと同じくPKT_DISCOVER_REPLYで応答する）
+    PKT_CHANNEL_INFO = 9,   // チャンネル情報の応答
+    PKT_BULLET = 10,  // 弾の発射情報
+    PKT_STATE_ACK = 11,  // 受信側→送信側: 復元できたSTATEのシーケンス番号（デルタのベースライン）
+    PKT_RELIABLE = 12,  // 信頼メッセージの包み（ReliableMessageHeader + 元のパケット）
+    PKT_ACK = 13,  // ACK専用（受信だけが続いて相乗りできるパケットが無いとき）
+    PKT_PONG = 14,  // PKT_PINGへの応答（PacketPing、timeUsはPINGのものをそのまま返す）
+    PKT_BUNDLE = 15,  // 1つのパケットにまとめた複数のメッセージ（PacketHeaderの直後、下の説明を参照）
 };
 
-// NCAgzXg֑̓pPbgiŒ蒷j
+// ゲーム通信ソケットで送る全パケットの先頭に付くヘッダー（ReliableLinkが付け外しする）
+// この後ろに元のパケット（先頭1バイトがPacketType）が続く
+struct PacketHeader {
+    uint16_t seq;      // このパケットの通し番号（接続ごと）
+    uint16_t ack;      // 相手から受け取った最新のパケット番号
+    uint32_t ackBits;  // bitN = ack-1-N 番を受け取ったか（ackの1-32個前）
+    uint8_t  flags;    // HEADER_HAS_ACK など
+};
+
+// PacketHeader::flags
+static const uint8_t HEADER_HAS_ACK = 0x01;  // ack / ackBits が有効（まだ何も受け取っていなければ0）
+
+// PacketHeaderの後ろは、メッセージが1つならそのメッセージ、2つ以上なら束:
+//   PKT_BUNDLE(8) count(8) { len(16) message[len] } x count
+// メッセージはどちらの場合も先頭1バイトがPacketType（信頼メッセージはPKT_RELIABLEで包んだもの）
+
+// 信頼メッセージのヘッダー（PacketHeaderの直後に置き、この後ろに元のパケットが続く）
+struct ReliableMessageHeader {
+    uint8_t  type;     // パケット種別（PKT_RELIABLE）
+    uint8_t  channel;  // チャンネル番号（NetChannel）
+    uint16_t msgId;    // チャンネル内の通し番号（この順に受信側へ渡す）
+};
+
+// クライアントからホストへ送る入力パケット
+// 送信時は NetCodec::write_input() で量子化して詰める（この構造体はメモリ上の表現）
+// 1つのINPUTには最新の入力と、その直前の入力の控えが載る（ロスで入力が抜けないように）
 struct PacketInput {
-    uint8_t  type;      // pPbgʁiPKT_INPUTj
-    uint32_t seq;       // V[PXԍiԖڂ̓͂j
-    uint32_t playerId;  // MvC[ID
-    float    moveX;     // Ẍړ
-    float    moveY;     // Ÿړ
-    float    moveZ;     // Z̈ړ
-    uint32_t buttons;   // {^ԂrbgtOŊi[iWvAˌȂǁj
+    uint8_t  type;      // パケット種別（PKT_INPUT）
+    uint32_t seq;       // シーケンス番号（何番目の入力か）
+    uint32_t playerId;  // 送信元プレイヤーのID
+    float    moveX;     // X方向の移動量
+    float    moveY;     // Y方向の移動量
+    float    moveZ;     // Z方向の移動量
+    float    yaw;       // プレイヤーの向き（度）
+    uint32_t buttons;   // ボタン状態をビットフラグで格納（ジャンプ、射撃など）
+};
+
+// PacketInput::buttons のビット
+static const uint32_t INPUT_BUTTON_JUMP = 0x01;  // ジャンプ
+
+// STATEに載せる入力の処理結果（ホスト→そのクライアント宛てのSTATEにだけ付く）
+// クライアントは自分の予測とこの結果を照合し、ずれていれば巻き戻して再計算する
+struct InputAck {
+    uint32_t inputSeq;  // ホストがシミュレーションを終えた最後の入力のseq
+    float    velY;      // その時点のプレイヤーの縦速度（水平速度は入力で毎回決まるので不要）
+    uint8_t  grounded;  // その時点で接地しているか
 };
 
-// Q[IuWFNg1̏̕ԃf[^
+// ゲーム内オブジェクト1体分の状態データ
 struct ObjectState {
-    uint32_t id;                        // IuWFNg̈ӂID
-    float    posX, posY, posZ;          // [hWł̈ʒu
-    float    rotX, rotY, rotZ;          // ]iIC[pj
+    uint32_t id;                        // オブジェクトの一意なID
+    float    posX, posY, posZ;          // ワールド座標での位置
+    float    rotX, rotY, rotZ;          // 回転（オイラー角）
 };
 
-// ԃpPbg̃wb_[ǐObjectStateobjectCountj
-struct PacketStateHeader {
-    uint8_t  type;          // pPbgʁiPKT_STATEj
-    uint32_t seq;           // V[PXԍ
-    uint32_t objectCount;   // 㑱ObjectStatě
+// PKT_STATE はビット単位に詰めた可変長パケット（SnapshotDelta / NetCodec で符号化）
+//   type(8) seq(32) time(16) hasBase(1) [seq-baseSeq(5)]
+//   hasInputAck(1) [inputSeq(32) velY(16) grounded(1)] objectCount(varint)
+//   time: 送信側でその状態を取得した時刻（ミリ秒の下位16ビット、受信側の補間の時間軸）
+//   inputAck: ホスト→クライアントのみ（InputAck）
+//   各オブジェクト: id(varint) mask(6) + maskで立っているフィールドの量子化値
+//   mask: bit0-2=posXYZ, bit3-5=rotXYZ
+//   最後に removedCount(varint) + id(varint) x removedCount
+//   removed: ベースラインにあって今回は送らないオブジェクト（関心領域から外れたなど）
+
+// STATE受信確認パケット（送信側はこれを次回のデルタのベースラインにする）
+struct PacketStateAck {
+    uint8_t  type;  // パケット種別（PKT_STATE_ACK）
+    uint32_t seq;   // 復元できたSTATEのシーケンス番号
 };
 
-// `lpPbgi`l؂ւ@\Ŏgpj
+// RTTの測定パケット（PKT_PING / PKT_PONG、非信頼で送る）
+// 送信側は自分の時計をtimeUsに入れ、戻ってきたPONGとの差をRTTにする（相手の時計は使わない）
+struct PacketPing {
+    uint8_t  type;    // PKT_PING / PKT_PONG
+    uint32_t timeUs;  // PINGを送った時刻（送信側のネットワーク時刻のマイクロ秒、下位32ビット）
+};
+
+// 探索要求（PKT_DISCOVER / PKT_CHANNEL_SCAN、全チャンネルの探索ポートへブロードキャスト）
+// 1バイトだけの古い要求にも応答する（timeUsは0で返る）
+struct PacketDiscover {
+    uint8_t  type;         // PKT_DISCOVER / PKT_CHANNEL_SCAN
+    uint32_t timeUs;       // 送った時刻（送信側のネットワーク時刻のマイクロ秒、応答の遅延を測る）
+};
+
+// 探索への応答（PKT_DISCOVER_REPLY、ホストのワーカースレッドがその場で返す）
+struct PacketDiscoverReply {
+    uint8_t  type;         // PKT_DISCOVER_REPLY
+    uint32_t timeUs;       // 要求のtimeUsをそのまま返す
+    uint8_t  channelId;    // ホストのチャンネル番号
+    uint8_t  playerCount;  // 参加しているプレイヤー数（ホスト自身を含む）
+    uint8_t  maxPlayers;   // 参加できる上限（MAX_PLAYERS）
+    uint16_t gamePort;     // ゲーム通信ポート（JOINの宛先、ネットワークバイト順）
+};
+
+// チャンネル情報（探索の応答から作る、チャンネル切り替え機能で使用）
 struct ChannelInfo {
-    uint8_t  type;           // pPbgʁiPKT_CHANNEL_INFOj
-    uint32_t channelId;      // `lԍi0?5j
-    uint32_t userCount;      // ̃`l̐ڑ[U[
-    uint32_t basePort;       // Q[ʐMp|[gԍ
-    uint32_t discoveryPort;  // Tp|[gԍ
+    uint8_t  type;           // パケット種別（PKT_CHANNEL_INFO）
+    uint32_t channelId;      // チャンネル番号（0?5）
+    uint32_t userCount;      // そのチャンネルの接続ユーザー数
+    uint32_t basePort;       // ゲーム通信用ポート番号
+    uint32_t discoveryPort;  // 探索用ポート番号
 };
 
-// e̔˃pPbg
+// 弾の発射パケット
+// 送信時は NetCodec::write_bullet() で量子化して詰める（この構造体はメモリ上の表現）
 struct PacketBullet {
     uint8_t  type;          // PKT_BULLET
-    uint32_t seq;           // V[PXԍ
-    uint32_t ownerPlayerId; // vC[ID
-    float    posX, posY, posZ;  // ˈʒu
-    float    dirX, dirY, dirZ;  // ˕iKς݁j
+    uint32_t seq;           // シーケンス番号
+    uint32_t ownerPlayerId; // 撃ったプレイヤーのID
+    uint16_t viewTime;      // 撃った側が見ていたホストの時刻（ミリ秒の下位16ビット、ラグ補償用）
+    float    posX, posY, posZ;  // 発射位置
+    float    dirX, dirY, dirZ;  // 発射方向（正規化済み）
 };
 
-#pragma pack(pop)  // pfBOݒɖ߂
+#pragma pack(pop)  // パディング設定を元に戻す
 
 // ============================================================
-// |[gݒe[u
-// es = { Q[ʐM|[g, T|[g, `lԍ }
-// ftHg|[ggȂꍇAԂɃtH[obN
+// ポート設定テーブル
+// 各行 = { ゲーム通信ポート, 探索ポート, チャンネル番号 }
+// デフォルトポートが使えない場合、順番にフォールバックする
 // ============================================================
 static const int PORT_RANGES[][3] = {
-    {27777, 27778, 0},  // `l0iCj
-    {28777, 28778, 1},  // `l1i1j
-    {29777, 29778, 2},  // `l2i2j
-    {30777, 30778, 3},  // `l3i3j
-    {31777, 31778, 4},  // `l4i4j
-    {32777, 32778, 5}   // `l5i5j
+    {27777, 27778, 0},  // チャンネル0（メイン）
+    {28777, 28778, 1},  // チャンネル1（代替1）
+    {29777, 29778, 2},  // チャンネル2（代替2）
+    {30777, 30778, 3},  // チャンネル3（代替3）
+    {31777, 31778, 4},  // チャンネル4（代替4）
+    {32777, 32778, 5}   // チャンネル5（代替5）
 };
 
-// `l̑iPORT_RANGES̍s玩vZj
+// チャンネルの総数（PORT_RANGESの行数から自動計算）
 static const int NUM_CHANNELS = sizeof(PORT_RANGES) / sizeof(PORT_RANGES[0]);
 
-// ftHg̃Q[ʐM|[g
+// デフォルトのゲーム通信ポート
 static const int NET_PORT = 27777;
 
-// ftHg̒Tp|[g
+// デフォルトの探索用ポート
 static const int DISCOVERY_PORT = 27778;
 
-// UDPpPbg̍őTCYiMTUl1400oCgɐj
+// UDPパケットの最大サイズ（MTU考慮で1400バイトに制限）
 static const int MAX_UDP_PACKET = 1400;
 
+// STATE本体の最大サイズ（ReliableLinkのヘッダーを付けてもMAX_UDP_PACKETに収まる）
+static const int MAX_STATE_BYTES = MAX_UDP_PACKET - (int)sizeof(PacketHeader);
+
+// 1つのホストに同時に参加できるプレイヤー数（プレイヤーIDは1-MAX_PLAYERS、JOIN_ACKのID=0は満員）
+static const int MAX_PLAYERS = 64;
+
 // ============================================================
-// I|[g͈̓e[u
-// t@CAEH[ŌŒ|[ggȂꍇɁA
-// _ɋ󂫃|[gT͈
+// 動的ポート範囲テーブル
+// ファイアウォールで固定ポートが使えない場合に、
+// ランダムに空きポートを探す範囲
 // ============================================================
 static const int DYNAMIC_PORT_RANGES[][2] = {
-    {49152, 65535},  // IANA̓I/vCx[g|[g͈
-    {32768, 60999},  // LinuxnOSŎg͈
-    {8000,  8999},   // HTTPփ|[g͈
-    {9000,  9999}    // ėpIȑ͈֔
+    {49152, 65535},  // IANA推奨の動的/プライベートポート範囲
+    {32768, 60999},  // Linux系OSで使われる範囲
+    {8000,  8999},   // HTTP代替ポート範囲
+    {9000,  9999}    // 汎用的な代替範囲
 };
 
-// I|[g͈̓e[u̍s
+// 動的ポート範囲テーブルの行数
 static const int NUM_DYNAMIC_RANGES = sizeof(DYNAMIC_PORT_RANGES) / sizeof(DYNAMIC_PORT_RANGES[0]);
@@ -9,17 +9,21 @@
  *********************************************************************/
 #include "pch.h"
 #include "network_manager.h"
+#include "net_codec.h"                 // NetCodec（INPUT / BULLET の符号化）
 #include "Game/Objects/game_object.h"  // Game::GameObject
-#include "Game/Objects/camera.h"       // Game::GetLocalPlayerGameObject
 #include "Game/Objects/bullet.h"       // Game::Bullet
 #include "Game/Managers/bullet_manager.h" // Game::BulletManager
-#include "main.h"
-#include "Engine/Graphics/primitive.h" // Box頂点データ, GetPolygonTexture
+#include "Game/Managers/player_manager.h" // Game::PlayerManager（入力の適用・予測の再計算・出現）
+#include "Game/Objects/player.h"           // Game::Player
+#include "Engine/Graphics/primitive_data.h" // Box頂点データ, GetPolygonTexture
+#include "Engine/Collision/map_collision.h" // 関心領域の見通し判定
 #include <cstring>
 #include <chrono>
 #include <mutex>
 #include <algorithm>
 #include <condition_variable>
+#include <iostream>
+#include <cstdlib>                     // std::getenv
 
  // ============================================================
  // グローバル変数
@@ -32,9 +36,50 @@ NetworkManager g_network;
 // コンストラクタ / デストラクタ
 // ============================================================
 
-NetworkManager::NetworkManager() {
+namespace {
+    // 関心領域の見通し: マップのブロックに遮られていなければ見える
+    bool map_line_of_sight(float fromX, float fromY, float fromZ, float toX, float toY, float toZ) {
+        return !Engine::MapCollision::GetInstance().IsSegmentBlocked(
+            { fromX, fromY, fromZ }, { toX, toY, toZ });
+    }
+
+    // ネットワークとゲームでプレイヤー数の上限が違うと、割り当てたIDのプレイヤーを出せない
+    static_assert(MAX_PLAYERS == Game::PlayerManager::MAX_PLAYERS,
+        "MAX_PLAYERS must match PlayerManager::MAX_PLAYERS");
+    static_assert(MAX_PLAYERS <= 64, "player ids are kept in a 64-bit mask");
+}
+
+NetworkManager::NetworkManager(NetTransport* transport)
+    : m_link(transport ? *transport : static_cast<NetTransport&>(m_net)),
+    m_externalTransport(transport != nullptr) {
     // チャンネルスキャンの初期タイムスタンプを設定
     m_lastChannelScan = std::chrono::steady_clock::now();
+    m_clockStart = m_lastChannelScan;
+    m_lastStateSend = m_lastChannelScan;
+    m_lastTimeoutCheck = m_lastChannelScan;
+    m_lastPing = m_lastChannelScan;
+    m_lastStatsDump = m_lastChannelScan;
+    m_clients.reserve(MAX_PLAYERS);
+    m_interest.set_line_of_sight(&map_line_of_sight);
+
+    // 回線状態の再現（例: NET_CONDITIONER=latency=80,jitter=20,loss=2）
+    LinkConditions conditions;
+    if (LinkConditions::parse(std::getenv("NET_CONDITIONER"), conditions)) {
+        set_link_conditions(conditions);
+    }
+
+    // 統計の書き出し（例: NET_STATS_DUMP=net_stats.jsonl）
+    // 外から渡したNetTransportで作ったもの（ボットなど、1プロセスに何個も作る）は読まない
+    const char* statsPath = std::getenv("NET_STATS_DUMP");
+    if (!transport && statsPath && *statsPath && !set_stats_dump(statsPath)) {
+        std::cerr << "[Network] failed to open NET_STATS_DUMP: " << statsPath << "\n";
+    }
+
+    // 送受信のキャプチャ（例: NET_CAPTURE=session.ncap、再生はreplay_capture）
+    const char* capturePath = std::getenv("NET_CAPTURE");
+    if (!transport && capturePath && *capturePath && !start_capture(capturePath)) {
+        std::cerr << "[Network] failed to open NET_CAPTURE: " << capturePath << "\n";
+    }
 }
 
 NetworkManager::~NetworkManager() {
@@ -44,26 +89,101 @@ NetworkManager::~NetworkManager() {
     m_discovery.close_socket();
 }
 
+// ============================================================
+// set_transport - ゲーム通信に使うNetTransportを差し替える
+// ============================================================
+void NetworkManager::set_transport(NetTransport* transport) {
+    m_link.set_transport(transport ? *transport : static_cast<NetTransport&>(m_net));
+    m_externalTransport = (transport != nullptr);
+}
+
+// ============================================================
+// set_link_conditions - ゲーム通信ソケットに回線状態を掛ける
+// ============================================================
+void NetworkManager::set_link_conditions(const LinkConditions& conditions) {
+    m_link.set_conditions(conditions);
+    if (conditions.enabled()) {
+        std::cout << "[Network] link conditioner: latency=" << conditions.latencyMs
+            << "ms jitter=" << conditions.jitterMs << "ms loss=" << conditions.lossPercent
+            << "% burst=" << conditions.burstPercent << "%x" << conditions.burstLength
+            << " dup=" << conditions.duplicatePercent << "% reorder=" << conditions.reorderPercent
+            << "% bandwidth=" << conditions.bandwidthKbps << "kbps seed=" << conditions.seed << "\n";
+    }
+    // 待ち時間の計算をやり直させる
+    m_reactor.wakeup();
+}
+
 // 自分のプレイヤーIDを返す（クライアント側で使用）
 uint32_t NetworkManager::getMyPlayerId() const {
     return m_myPlayerId;
 }
 
+size_t NetworkManager::get_client_count() {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    size_t count = 0;
+    for (const ClientInfo& c : m_clients) {
+        if (c.playerId != 0) ++count;
+    }
+    return count;
+}
+
+// ============================================================
+// get_time / get_render_time / get_view_time_ms16 / time_ms16 - ネットワーク時刻
+// ============================================================
+double NetworkManager::get_time() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_clockStart).count();
+}
+
+double NetworkManager::get_render_time() {
+    // ホストはSTATEを受け取らない（クライアントのプレイヤーは届いた入力で動かす）ので遅らせない
+    if (m_isHost) return get_time();
+    return get_time() - m_hostPlayout.delay();
+}
+
+uint16_t NetworkManager::get_view_time_ms16() {
+    if (m_isHost) return time_ms16();
+    const double hostTime = m_hostPlayout.to_sender_time(get_render_time());
+    return (uint16_t)(int64_t)(hostTime * 1000.0);
+}
+
+uint16_t NetworkManager::time_ms16() const {
+    return (uint16_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - m_clockStart).count();
+}
+
+uint32_t NetworkManager::time_us32(std::chrono::steady_clock::time_point now) const {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        now - m_clockStart).count();
+}
+
 // ============================================================
 // start_as_host - ホストとして起動する
 // 1. ファイアウォール例外を登録（試みる）
 // 2. ソケットをフォールバック付きで初期化
-// 3. ホストのプレイヤーIDは1（クライアントには2以降を割り当て）
+// 3. ホストのプレイヤーIDは1（クライアントには空いているIDを割り当て）
+//    専用サーバーは自分のプレイヤーを持たないので、1から割り当てる
 // 4. ワーカースレッドを開始
 // ============================================================
-bool NetworkManager::start_as_host() {
-    add_firewall_exception();
-    if (!initialize_with_fallback()) {
-        return false;
+bool NetworkManager::start_as_host(bool hasLocalPlayer) {
+    if (!m_externalTransport) {
+        add_firewall_exception();
+        // 受信シャードを使うなら、1つ目のソケットもSO_REUSEPORTを付けて開く
+        m_net.set_reuse_port(m_recvShardCount > 1);
+        if (!initialize_with_fallback()) {
+            return false;
+        }
     }
     m_isHost = true;
-    // ホスト自身はID=1。クライアントにはID=2から割り当てる
-    m_nextPlayerId = 2;
+    m_hostHasLocalPlayer = hasLocalPlayer;
+    // ホスト自身はID=1を使う
+    m_usedPlayerIds = hasLocalPlayer ? 1ull : 0ull;
+    // 前に動いていたときのスナップショットを送らないように、ワーカーを始める前に3つとも空にする
+    // （キープアライブはfront()を送り直すので、back()だけでは古いワールドが残る）
+    m_snapshots.reset();
+    // STATEを符号化するスレッド（ワーカー自身を含む）と、スレッドごとの作業用バッファ
+    m_encodePool.start(m_encodeThreads);
+    m_encodeScratch.resize(m_encodePool.size());
+    record_capture_role();
     // 受信用ワーカースレッドを開始
     start_worker();
     return true;
@@ -72,94 +192,282 @@ bool NetworkManager::start_as_host() {
 // ============================================================
 // start_as_client - クライアントとして起動する
 // 1. 動的ポートでソケットを初期化（固定ポートが使えない環境対応）
-// 2. 探索用ソケットはDISCOVERY_PORT+1で初期化
+// 2. 探索用ソケットはDISCOVERY_PORT+1で初期化（同じPCの2つ目のクライアントなどで
+//    使えなければOS任せのポート。応答は要求の送信元ポートに返るのでどちらでもよい）
 // 3. ワーカースレッドを開始
 // ============================================================
 bool NetworkManager::start_as_client() {
-    add_firewall_exception();
-    // まず動的ポートを試し、ダメならポート0（OS任せ）で初期化
-    if (!m_net.initialize_dynamic_port()) {
-        if (!m_net.initialize(0)) {
+    if (!m_externalTransport) {
+        add_firewall_exception();
+        // 動的ポート（OS任せのポート0から試す）で初期化
+        m_net.set_reuse_port(false);
+        if (!m_net.initialize_dynamic_port()) {
+            return false;
+        }
+        // 探索用ソケット（ホストの探索応答を受信する）
+        if (!m_discovery.initialize_broadcast(DISCOVERY_PORT + 1) &&
+            !m_discovery.initialize_broadcast(0)) {
             return false;
         }
-    }
-    // 探索用ソケット（ホストの探索応答を受信する）
-    if (!m_discovery.initialize_broadcast(DISCOVERY_PORT + 1)) {
-        return false;
     }
     m_isHost = false;
+    record_capture_role();
     start_worker();
     return true;
 }
 
 // ============================================================
-// discover_and_join - ホストを探して参加する（ブロッキング処理）
-// 全チャンネルに順番にDISCOVERをブロードキャストし、
-// 応答があったらJOINパケットを送信する
+// start_discovery - ホストの探索を始める（結果はonDoneで受け取る）
+// 全チャンネルへ一度に送り、応答は探索ソケットからワーカー経由で届く
+// ============================================================
+bool NetworkManager::start_discovery(DiscoveryCallback onDone) {
+    if (m_isHost || !m_discovery.is_valid()) return false;
+
+    auto now = std::chrono::steady_clock::now();
+    m_discoveredHosts.clear();
+    m_discoveryDone = std::move(onDone);
+    m_discoveryStart = now;
+    m_discovering = true;
+    m_lastChannelScan = now;  // 応答がチャンネル情報にもなるので、スキャンを兼ねる
+    return send_discover_broadcast(now);
+}
+
+// ============================================================
+// send_discover_broadcast - 全チャンネルの探索ポートへ探索要求を送る
 // ============================================================
-bool NetworkManager::discover_and_join(std::string& out_host_ip) {
-    // まずチャンネル使用状況をスキャン（30秒間隔制限あり）
-    scan_channel_usage();
+bool NetworkManager::send_discover_broadcast(std::chrono::steady_clock::time_point now) {
+    PacketDiscover discover;
+    discover.type = PKT_DISCOVER;
+    discover.timeUs = time_us32(now);
+    m_lastDiscoverySend = now;
 
-    // 各チャンネルのポートに対してDISCOVERを送信
+    bool sent = false;
     for (int channelIdx = 0; channelIdx < NUM_CHANNELS; channelIdx++) {
-        int discoveryPort = PORT_RANGES[channelIdx][1];  // そのチャンネルの探索ポート
-
-        // DISCOVERパケットをブロードキャスト送信
-        uint8_t discover_pkt = PKT_DISCOVER;
-        m_discovery.send_broadcast(discoveryPort, &discover_pkt, 1);
-
-        char buf[MAX_UDP_PACKET];
-        std::string from_ip;
-        int from_port;
-
-        // 1秒間、200msごとに応答を待つ
-        auto start = std::chrono::steady_clock::now();
-        while (std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::steady_clock::now() - start).count() < 1000) {
-            int r = m_discovery.poll_recv(buf, sizeof(buf), from_ip, from_port, 200);
-            if (r > 0) {
-                uint8_t t = (uint8_t)buf[0];
-                if (t == PKT_DISCOVER_REPLY) {
-                    // ホストが見つかった
-                    out_host_ip = from_ip;
-                    m_hostIp = out_host_ip;
-                    m_hostPort = PORT_RANGES[channelIdx][0];  // ゲーム通信ポート
-                    m_currentChannel = channelIdx;
-
-                    // JOINパケットをホストのゲーム通信ポートに送信
-                    uint8_t join_pkt = PKT_JOIN;
-                    m_net.send_to(out_host_ip, m_hostPort, &join_pkt, 1);
-                    return true;
-                }
-            }
-        }
+        const int discoveryPort = PORT_RANGES[channelIdx][1];
+        if (m_discovery.send_broadcast(discoveryPort, &discover, (int)sizeof(discover))) sent = true;
+        m_capture.record(CAPTURE_SEND_DISCOVERY,
+            Endpoint::from_string("255.255.255.255", discoveryPort), &discover, (int)sizeof(discover));
     }
-    // 全チャンネルで見つからなかった
-    return false;
+    return sent;
+}
+
+// ============================================================
+// handle_discover_reply - 探索の応答を一覧に加え、探索中なら最初のホストへ参加する
+// ホストの一覧とチャンネル情報は、探索中でなくても更新する（scan_channel_usageの応答）
+// ============================================================
+void NetworkManager::handle_discover_reply(const char* buf, int len, const Endpoint& from) {
+    if (len < (int)sizeof(PacketDiscoverReply)) return;
+    PacketDiscoverReply reply;
+    memcpy(&reply, buf, sizeof(reply));
+
+    DiscoveredHost host;
+    host.endpoint = Endpoint(from.addr, ntohs(reply.gamePort));
+    host.channel = reply.channelId;
+    host.playerCount = reply.playerCount;
+    host.maxPlayers = reply.maxPlayers;
+    host.rttMs = (float)(time_us32(std::chrono::steady_clock::now()) - reply.timeUs) / 1000.0f;
+
+    ChannelInfo info;
+    info.type = PKT_CHANNEL_INFO;
+    info.channelId = reply.channelId;
+    info.userCount = reply.playerCount;
+    info.basePort = host.endpoint.port;
+    info.discoveryPort = from.port;
+    handle_channel_info(info);
+
+    // 送り直した要求への応答でも同じホストは1つにまとめる（遅延は最初の値のまま）
+    bool known = false;
+    for (const DiscoveredHost& h : m_discoveredHosts) {
+        if (h.endpoint == host.endpoint) known = true;
+    }
+    if (!known) m_discoveredHosts.push_back(host);
+
+    // 満員のホストには参加しない（他のチャンネルの応答かタイムアウトを待つ）
+    if (!m_discovering || host.playerCount >= host.maxPlayers) return;
+    m_discovering = false;
+    m_currentChannel = host.channel;
+    join(host.endpoint);
+
+    DiscoveryCallback done;
+    done.swap(m_discoveryDone);
+    if (done) done(true, host);
+}
+
+// ============================================================
+// update_discovery - 探索要求の送り直しとタイムアウト
+// ============================================================
+void NetworkManager::update_discovery(std::chrono::steady_clock::time_point now) {
+    if (now - m_discoveryStart >= std::chrono::milliseconds(DISCOVERY_TIMEOUT_MS)) {
+        m_discovering = false;
+        DiscoveryCallback done;
+        done.swap(m_discoveryDone);
+        if (done) done(false, DiscoveredHost());
+        return;
+    }
+    if (now - m_lastDiscoverySend >= std::chrono::milliseconds(DISCOVERY_RESEND_MS)) {
+        send_discover_broadcast(now);
+    }
+}
+
+// ============================================================
+// join - ホストのゲーム通信ポートへJOINを送る
+// 信頼チャンネルで送るので、届かなければupdate()のたびに再送される
+// ============================================================
+void NetworkManager::join(const Endpoint& host) {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_host = host;
+    m_joinRejected = false;
+    m_hostLink.reset();
+    m_hostPlayout.reset();
+    m_prediction.clear();
+    m_inputSeq = 0;
+    uint8_t join_pkt = PKT_JOIN;
+    queue_via_link(m_hostLink, &join_pkt, 1);
+    // 探索はブロッキングなので、ティックの終わりを待たずにすぐ送る
+    collect_link(m_hostLink, m_host, std::chrono::steady_clock::now());
+    flush_outgoing();
 }
 
 // ============================================================
 // update - メインスレッドから毎フレーム呼ばれる
 // ワーカースレッドがキューに積んだパケットを最大N個取り出して処理する
 // 1フレームに処理しすぎるとゲームが止まるので上限を設ける
+// 最後に信頼メッセージの再送とACK専用パケットの送信を行う
 // ============================================================
-void NetworkManager::update(float dt, Game::GameObject* localPlayer,
+void NetworkManager::update(float /*dt*/, Game::GameObject* localPlayer,
     std::vector<std::shared_ptr<Game::GameObject>>& worldObjects) {
+    service(localPlayer, worldObjects);
+
+    // ホスト: 届いた入力をクライアントのプレイヤーに1ティック分適用する
+    if (m_isHost) host_apply_inputs();
+}
+
+// ============================================================
+// service - 受信パケットの処理と、信頼メッセージの再送・ACKの送信
+// flush_messages()を使う呼び出し側では送信をそちらに任せる
+// （ここで送ると、受信へのACKだけのパケットとティックの終わりのパケットの2つになる）
+// ============================================================
+void NetworkManager::service(Game::GameObject* localPlayer,
+    std::vector<std::shared_ptr<Game::GameObject>>& worldObjects) {
+    // 受信を待つソケットが無ければ、ワーカースレッドの代わりにここで受信する
+    if (m_externalTransport && m_link.get_handle() == INVALID_SOCKET) poll_transport();
+
+    // ホストには接続数に比例してパケットが届くので、クライアントごとに上限を足す
+    // （m_clientsの要素数を変えるのはメインスレッドだけなので、ロックせずに読める）
+    const size_t limit = m_maxPacketsPerFrame +
+        (m_isHost ? m_clients.size() * PACKETS_PER_CLIENT_PER_FRAME : 0);
+
     size_t processed = 0;
-    while (processed < m_maxPacketsPerFrame) {
-        RecvPacket pkt;
-        {
-            // キューからパケットを1つ取り出す（ロック範囲を最小にする）
-            std::lock_guard<std::mutex> lk(m_recvMutex);
-            if (m_recvQueue.empty()) break;
-            pkt = std::move(m_recvQueue.front());
-            m_recvQueue.pop_front();
-        }
-        // パケットの種別に応じて処理する
-        process_received(pkt.data.data(), pkt.len, pkt.from_ip, pkt.from_port,
+    bool leftOver = false;
+    if (m_shards.empty()) {
+        processed = drain_queue(m_recvQueue, limit, localPlayer, worldObjects);
+        leftOver = m_recvQueue.size_approx() > 0;
+    } else {
+        // 受信シャードのキューも取り出す。上限で打ち切ったときに後ろのキューばかり
+        // 残らないように、最初に取り出すキューを毎回ずらす（1つのキューの中の順序は変えない）
+        const size_t queues = m_shards.size() + 1;
+        for (size_t i = 0; i < queues; ++i) {
+            const size_t q = (m_drainShard + i) % queues;
+            RecvQueue& queue = (q == 0) ? m_recvQueue : m_shards[q - 1]->queue;
+            if (processed < limit) {
+                processed += drain_queue(queue, limit - processed, localPlayer, worldObjects);
+            }
+            leftOver = leftOver || queue.size_approx() > 0;
+        }
+        m_drainShard = (m_drainShard + 1) % queues;
+    }
+
+    // 上限と実際に処理した数（m_maxPacketsPerFrameを決めるための統計）
+    m_drainLimit = limit;
+    if (processed > m_drainHighWater) m_drainHighWater = processed;
+    if (processed >= limit && leftOver) ++m_drainLimited;
+
+    if (m_isHost) host_check_timeouts(worldObjects);
+    if (m_discovering) update_discovery(std::chrono::steady_clock::now());
+    if (!m_flushByCaller) flush_links();
+    if (m_statsDump.is_open()) write_stats_dump(std::chrono::steady_clock::now());
+}
+
+// ============================================================
+// drain_queue - 受信キューの先頭から最大limit個を取り出して処理する
+// ============================================================
+size_t NetworkManager::drain_queue(RecvQueue& queue, size_t limit, Game::GameObject* localPlayer,
+    std::vector<std::shared_ptr<Game::GameObject>>& worldObjects) {
+    size_t processed = 0;
+    while (processed < limit) {
+        // キューの先頭から連続した範囲をまとめて受け取る（ロックなし）
+        auto span = queue.peek(limit - processed);
+        if (span.count == 0) break;
+
+        for (const RecvPacket& pkt : span) {
+            handle_received(pkt.data, pkt.len, pkt.from, pkt.isDiscovery, localPlayer, worldObjects);
+        }
+        queue.pop(span.count);
+        processed += span.count;
+    }
+    return processed;
+}
+
+// ============================================================
+// handle_received / replay_received - 受信キューから取り出した1パケットを処理する
+// キャプチャ中なら処理する前に記録する（再生するときに同じ順番になる）
+// ============================================================
+void NetworkManager::handle_received(const char* data, int len, const Endpoint& from,
+    bool isDiscovery, Game::GameObject* localPlayer,
+    std::vector<std::shared_ptr<Game::GameObject>>& worldObjects) {
+    if (m_capture.is_open()) {
+        m_capture.record(isDiscovery ? CAPTURE_RECV_DISCOVERY : CAPTURE_RECV, from, data, len);
+    }
+
+    if (isDiscovery) {
+        // 探索ソケットのパケットはReliableLinkを通さないので、探索の応答だけを受け付ける
+        // （JOIN・INPUT・STATE_ACKなどのゲームのパケットはゲームソケットのReliableLink経由でしか受け付けない）
+        if (len >= 1 && (uint8_t)data[0] == PKT_DISCOVER_REPLY) {
+            process_received(data, len, from, localPlayer, worldObjects);
+        }
+    } else {
+        receive_game_packet(data, len, from, localPlayer, worldObjects);
+    }
+}
+
+void NetworkManager::replay_received(const char* data, int len, const Endpoint& from,
+    bool isDiscovery, Game::GameObject* localPlayer,
+    std::vector<std::shared_ptr<Game::GameObject>>& worldObjects) {
+    handle_received(data, len, from, isDiscovery, localPlayer, worldObjects);
+}
+
+// ============================================================
+// receive_game_packet - 受信パケットからヘッダーを外して処理する
+// 束はメッセージごとに分け、非信頼メッセージはそのまま、信頼メッセージは順番が揃ったものから渡す
+// ホストは、未知の送信元からは信頼チャンネルのJOINを含むパケットだけを受け付ける
+// ============================================================
+void NetworkManager::receive_game_packet(const char* data, int len, const Endpoint& from,
+    Game::GameObject* localPlayer,
+    std::vector<std::shared_ptr<Game::GameObject>>& worldObjects) {
+    m_messages.clear();
+    m_delivered.clear();
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        ReliableLink* link = find_link(from);
+        if (!link && m_isHost && ReliableLink::is_join_request(data, len)) {
+            // IDはJOINを処理するときに割り当てる（host_handle_join）
+            link = &add_client(from, 0).link;
+        }
+        if (!link) return;
+        if (!link->receive(data, len, std::chrono::steady_clock::now(),
+            m_messages, m_delivered)) {
+            return;
+        }
+    }
+
+    // process_receivedは中でm_mutexを取るので、ロックを外してから呼ぶ
+    // （m_messagesはdataの中を指すので、dataはこの関数を抜けるまで変わらない）
+    for (const MessageView& msg : m_messages) {
+        process_received(msg.data, msg.len, from, localPlayer, worldObjects);
+    }
+    for (const std::vector<char>& msg : m_delivered) {
+        process_received(msg.data(), static_cast<int>(msg.size()), from,
             localPlayer, worldObjects);
-        ++processed;
     }
 }
 
@@ -167,8 +475,7 @@ void NetworkManager::update(float dt, Game::GameObject* localPlayer,
 // process_received - 受信パケットを種別ごとに処理する
 // ホストとクライアントで処理が異なる
 // ============================================================
-void NetworkManager::process_received(const char* buf, int len,
-    const std::string& from_ip, int from_port,
+void NetworkManager::process_received(const char* buf, int len, const Endpoint& from,
     Game::GameObject* localPlayer,
     std::vector<std::shared_ptr<Game::GameObject>>& worldObjects) {
     if (len <= 0) return;
@@ -176,80 +483,74 @@ void NetworkManager::process_received(const char* buf, int len,
     // パケットの先頭1バイトで種別を判定
     uint8_t t = (uint8_t)buf[0];
 
+    // RTTの測定はホストとクライアントで同じ
+    if (t == PKT_PING || t == PKT_PONG) {
+        handle_ping(buf, len, from);
+        return;
+    }
+
+    // 探索の応答（探索ソケットに届く。ホストもscan_channel_usageの応答を受け取る）
+    if (t == PKT_DISCOVER_REPLY) {
+        handle_discover_reply(buf, len, from);
+        return;
+    }
+
     if (m_isHost) {
         // ============ ホスト側の処理 ============
 
         if (t == PKT_JOIN) {
             // クライアントからの参加リクエスト
-            host_handle_join(from_ip, from_port, worldObjects);
+            host_handle_join(from, worldObjects);
 
         } else if (t == PKT_INPUT) {
-            // クライアントからの入力データ
-            if (len >= (int)sizeof(PacketInput)) {
-                PacketInput pi;
-                memcpy(&pi, buf, sizeof(PacketInput));
-                host_handle_input(pi, worldObjects);
-
-                // そのクライアントの最終通信時刻を更新
-                std::lock_guard<std::mutex> lk(m_mutex);
-                for (auto& client : m_clients) {
-                    if (client.playerId == pi.playerId) {
-                        client.lastSeen = std::chrono::steady_clock::now();
-                        break;
-                    }
-                }
+            // クライアントからの入力データ（最新と、その前の入力の控え）
+            PacketInput inputs[NetCodec::MAX_INPUTS_PER_PACKET];
+            const int count = NetCodec::read_input(buf, len, inputs);
+            if (count > 0) {
+                host_handle_input(inputs, count, from);
             }
 
-        } else if (t == PKT_PING) {
-            // 生存確認パケット（現状は何もしない）
-
-        } else if (t == PKT_STATE) {
-            // クライアントが自分の状態を送ってきた（FrameSync経由）
-            if (len >= (int)sizeof(PacketStateHeader)) {
-                PacketStateHeader hdr;
-                memcpy(&hdr, buf, sizeof(hdr));
-                const char* p = buf + sizeof(hdr);
-                size_t expected = sizeof(hdr) + (size_t)hdr.objectCount * sizeof(ObjectState);
-
-                if (len >= (int)expected) {
-                    const ObjectState* entries = (const ObjectState*)p;
-
-                    // 各オブジェクトの状態を適用する
-                    for (uint32_t i = 0; i < hdr.objectCount; ++i) {
-                        const ObjectState& os = entries[i];
-
-                        // 既存のGameObjectを探して補間ターゲットを設定
-                        bool applied = false;
-                        for (const auto& go : worldObjects) {
-                            if (go->getId() == os.id) {
-                                go->setNetworkTarget({ os.posX, os.posY, os.posZ },
-                                    { os.rotX, os.rotY, os.rotZ });
-                                applied = true;
-                                break;
-                            }
-                        }
-
-                        // 見つからなければ新しいGameObjectを生成して追加
-                        if (!applied) {
-                        }
-
-                        // そのクライアントの最終通信時刻を更新
-                        std::lock_guard<std::mutex> lk(m_mutex);
-                        for (auto& client : m_clients) {
-                            if (client.playerId == os.id) {
-                                client.lastSeen = std::chrono::steady_clock::now();
-                                break;
-                            }
-                        }
+        } else if (t == PKT_STATE_ACK) {
+            // クライアントがSTATEを受け取った → そのクライアントのベースラインを進める
+            if (len >= (int)sizeof(PacketStateAck)) {
+                PacketStateAck ack;
+                memcpy(&ack, buf, sizeof(ack));
+                std::lock_guard<std::mutex> lk(m_mutex);
+                if (ClientInfo* client = find_client(from)) {
+                    // 順番が入れ替わって届いた古いACKでは戻さない（反映は次の符号化でワーカーが行う）
+                    if (client->stateAck == SnapshotDelta::NO_BASELINE ||
+                        (int32_t)(ack.seq - client->stateAck) > 0) {
+                        client->stateAck = ack.seq;
                     }
+                    client->lastSeen = std::chrono::steady_clock::now();
                 }
             }
 
         } else if (t == PKT_BULLET) {
             // クライアントからの弾発射通知 → ローカルで弾を生成 + 他クライアントに転送
-            if (len >= (int)sizeof(PacketBullet)) {
-                PacketBullet pb;
-                memcpy(&pb, buf, sizeof(PacketBullet));
+            PacketBullet pb;
+            if (NetCodec::read_bullet(buf, len, pb)) {
+                // ラグ補償で巻き戻す上限（これより遅れた相手の分は諦めて近い時刻で判定する）
+                static const double MAX_LAG_COMPENSATION = 0.5;
+
+                // 撃ったプレイヤーは送信元の接続から決める（パケットのownerPlayerIdは信用しない）
+                uint32_t ownerId = 0;
+                {
+                    std::lock_guard<std::mutex> lk(m_mutex);
+                    if (const ClientInfo* client = find_client(from)) ownerId = client->playerId;
+                }
+                if (ownerId == 0) return;  // 参加していない送信元の弾は受け付けない
+
+                // 他のプレイヤーのIDが入っていれば、転送する分も送信元のIDで符号化し直す
+                const char* relay = buf;
+                int relayLen = len;
+                char fixed[NetCodec::MAX_BULLET_BYTES];
+                if (pb.ownerPlayerId != ownerId) {
+                    pb.ownerPlayerId = ownerId;
+                    relayLen = NetCodec::write_bullet(pb, fixed, sizeof(fixed));
+                    if (relayLen <= 0) return;
+                    relay = fixed;
+                }
 
                 // ホスト側で弾を生成
                 auto b = std::make_unique<Game::Bullet>();
@@ -257,14 +558,17 @@ void NetworkManager::process_received(const char* buf, int len,
                     { pb.posX, pb.posY, pb.posZ },
                     { pb.dirX, pb.dirY, pb.dirZ },
                     (int)pb.ownerPlayerId);
+
+                // 撃った側が見ていた時刻との差だけ、当たり判定を過去のプレイヤー位置で行う
+                const int16_t lagMs = (int16_t)(uint16_t)(time_ms16() - pb.viewTime);
+                double rewind = lagMs > 0 ? lagMs / 1000.0 : 0.0;
+                if (rewind > MAX_LAG_COMPENSATION) rewind = MAX_LAG_COMPENSATION;
+                b->rewindSeconds = rewind;
                 Game::BulletManager::GetInstance().Add(std::move(b));
 
-                // 他の全クライアントに転送（送信元以外）
+                // 他の全クライアントに転送（送信元以外、符号化済みのバイト列をそのまま送る）
                 std::lock_guard<std::mutex> lk(m_mutex);
-                for (const auto& c : m_clients) {
-                    if (c.ip == from_ip && c.port == from_port) continue;
-                    m_net.send_to(c.ip, c.port, &pb, (int)sizeof(PacketBullet));
-                }
+                send_to_all_clients(relay, relayLen, &from);
             }
         }
 
@@ -276,29 +580,62 @@ void NetworkManager::process_received(const char* buf, int len,
             if (len >= 1 + 4) {
                 uint32_t pid_net;
                 memcpy(&pid_net, buf + 1, 4);
-                m_myPlayerId = ntohl(pid_net);  // ネットワークバイト順→ホストバイト順に変換
+                const uint32_t assignedId = ntohl(pid_net);  // ネットワークバイト順→ホストバイト順に変換
+                if (assignedId == 0 || assignedId > (uint32_t)MAX_PLAYERS) {
+                    std::cout << "[Network] JOIN rejected: host is full\n";
+                    m_joinRejected = true;
+                } else if (m_myPlayerId == 0) {
+                    m_myPlayerId = assignedId;
+                    // 割り当てられたIDのプレイヤーを出して操作する
+                    if (m_gameBinding) {
+                        player_manager().SetInitialActivePlayer((int)assignedId);
+                        spawn_player(assignedId, worldObjects);
+                    }
+                }
             }
 
         } else if (t == PKT_STATE) {
-            // ホストからゲーム状態を受信
-            if (len >= (int)sizeof(PacketStateHeader)) {
-                PacketStateHeader hdr;
-                memcpy(&hdr, buf, sizeof(hdr));
-                const char* p = buf + sizeof(hdr);
-                size_t expected = sizeof(hdr) + (size_t)hdr.objectCount * sizeof(ObjectState);
-                if (len >= (int)expected) {
-                    client_handle_state(hdr, (const ObjectState*)p, localPlayer, worldObjects);
+            // ホストからゲーム状態を受信（ACK済みベースラインとの差分）
+            std::vector<ObjectState> states;
+            uint32_t seq = 0;
+            uint16_t timeMs = 0;
+            bool hasInputAck = false;
+            InputAck inputAck;
+            if (m_hostSnapshots.decode(buf, len, states, seq, timeMs, hasInputAck, inputAck)) {
+                send_state_ack(from, seq);
+                ++m_statesReceived;
+
+                // 自分のプレイヤーはホストの結果と予測を照合する
+                if (hasInputAck && m_gameBinding) {
+                    for (const ObjectState& os : states) {
+                        if (os.id == m_myPlayerId) {
+                            client_reconcile(os, inputAck);
+                            break;
+                        }
+                    }
+                }
+
+                // キープアライブの再送（時刻が進んでいない）は補間バッファに追加しない
+                double time = 0.0;
+                if (m_hostPlayout.on_snapshot(timeMs, get_time(), time)) {
+                    client_handle_state(states, time, localPlayer, worldObjects);
                 }
             }
 
+        } else if (t == PKT_STATE_ACK) {
+            // ホストが自分のSTATEを受け取った → ベースラインを進める
+            if (len >= (int)sizeof(PacketStateAck)) {
+                PacketStateAck ack;
+                memcpy(&ack, buf, sizeof(ack));
+                m_hostSnapshots.on_ack(ack.seq);
+            }
+
         } else if (t == PKT_BULLET) {
             // ホストから弾の発射通知を受信 → ローカルで弾を生成
-            if (len >= (int)sizeof(PacketBullet)) {
-                PacketBullet pb;
-                memcpy(&pb, buf, sizeof(PacketBullet));
-
+            PacketBullet pb;
+            if (NetCodec::read_bullet(buf, len, pb)) {
                 // 自分が撃った弾は既にローカルで生成済みなのでスキップ
-                if (pb.ownerPlayerId != m_myPlayerId) {
+                if (pb.ownerPlayerId != m_myPlayerId && m_gameBinding) {
                     auto b = std::make_unique<Game::Bullet>();
                     b->Initialize(GetPolygonTexture(),
                         { pb.posX, pb.posY, pb.posZ },
@@ -313,105 +650,439 @@ void NetworkManager::process_received(const char* buf, int len,
 
 // ============================================================
 // host_handle_join - ホスト: 新しいクライアントの参加処理
-// 1. 重複チェック（同じIP:Portなら無視）
+// 1. 重複チェック（同じIP:PortにID割り当て済みなら無視）
 // 2. 空いているプレイヤーIDを割り当て
-// 3. クライアント情報をリストに追加
-// 4. GameObjectを作成（既存なら再利用）
-// 5. JOIN_ACKを返送
+// 3. クライアント情報にIDを設定（receive_game_packetで仮登録済み）
+// 4. そのIDのプレイヤーを出現させる（PlayerManagerのプールから）
+// 5. JOIN_ACKを返送（満員ならID=0を返し、仮登録を外す）
 // ============================================================
-void NetworkManager::host_handle_join(const std::string& from_ip, int from_port,
+void NetworkManager::host_handle_join(const Endpoint& from,
     std::vector<std::shared_ptr<Game::GameObject>>& worldObjects) {
-        {
-            std::lock_guard<std::mutex> lk(m_mutex);
-            for (auto& c : m_clients) {
-                if (c.ip == from_ip && c.port == from_port) return;
+    uint32_t assignedId = 0;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        ClientInfo* client = find_client(from);
+        // 同じ送信元からの重複JOINは無視
+        if (client && client->playerId != 0) return;
+
+        assignedId = allocate_player_id();
+        if (assignedId != 0) {
+            if (!client) {
+                add_client(from, assignedId);
+            } else {
+                client->playerId = assignedId;
+                m_clientByPlayerId[assignedId] = m_clientByEndpoint[from];
             }
         }
+    }
+
+    if (assignedId != 0) {
+        m_appliedInputs[assignedId] = AppliedInput();  // 前にこのIDを使っていたクライアントの結果を消す
+        spawn_player(assignedId, worldObjects);
+        std::cout << "[Network] player " << assignedId << " joined\n";
+    } else {
+        std::cout << "[Network] JOIN rejected: all " << MAX_PLAYERS << " player slots are in use\n";
+    }
+
+    // JOIN_ACK返送
+    uint8_t reply[1 + 4];
+    reply[0] = PKT_JOIN_ACK;
+    uint32_t pid_net = htonl(assignedId);
+    memcpy(reply + 1, &pid_net, 4);
+    if (assignedId != 0) {
+        send_packet(from, reply, (int)(1 + 4));
+        return;
+    }
+
+    // 満員: send_packetはティックの終わりまで溜めるだけなので、仮登録の接続から断りを
+    // その場で送ってから外す（先に外すと接続ごと消えて何も届かない。届かなければJOINの再送でもう一度断る）
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto it = m_clientByEndpoint.find(from);
+    if (it == m_clientByEndpoint.end()) return;
+    const size_t index = it->second;
+    ReliableLink& link = m_clients[index].link;
+    queue_via_link(link, reply, (int)(1 + 4));
+    collect_link(link, from, std::chrono::steady_clock::now());
+    flush_outgoing();
+    remove_client(index);
+}
+
+// ============================================================
+// allocate_player_id / release_player_id - プレイヤーIDの確保と解放
+// 呼び出し側でm_mutexを保持していること
+// ============================================================
+uint32_t NetworkManager::allocate_player_id() {
+    for (uint32_t id = 1; id <= (uint32_t)MAX_PLAYERS; ++id) {
+        const uint64_t bit = 1ull << (id - 1);
+        if (!(m_usedPlayerIds & bit)) {
+            m_usedPlayerIds |= bit;
+            return id;
+        }
+    }
+    return 0;
+}
+
+void NetworkManager::release_player_id(uint32_t playerId) {
+    if (playerId == 0 || playerId > (uint32_t)MAX_PLAYERS) return;
+    m_usedPlayerIds &= ~(1ull << (playerId - 1));
+}
 
-        // クライアントにはID=2を割り当て（Player2に憑依）
-        uint32_t assignedId = 2;
-        {
-            std::lock_guard<std::mutex> lk(m_mutex);
-            ClientInfo ci;
-            ci.ip = from_ip;
-            ci.port = from_port;
-            ci.playerId = assignedId;
-            ci.lastSeen = std::chrono::steady_clock::now();
-            m_clients.push_back(ci);
+// ============================================================
+// host_check_timeouts - ホスト: 応答の無くなったクライアントを切断する
+// IDを解放してプレイヤーを消すので、同じIDを次の参加者に使える
+// ============================================================
+void NetworkManager::host_check_timeouts(
+    std::vector<std::shared_ptr<Game::GameObject>>& worldObjects) {
+    const auto now = std::chrono::steady_clock::now();
+    if (now - m_lastTimeoutCheck < std::chrono::seconds(1)) return;
+    m_lastTimeoutCheck = now;
+
+    uint64_t timedOut = 0;  // 消すプレイヤー（ビット = ID - 1）
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        // 末尾と入れ替えて外すので後ろから回る
+        for (size_t i = m_clients.size(); i-- > 0;) {
+            if (now - m_clients[i].lastSeen < m_clientTimeout) continue;
+            const uint32_t id = m_clients[i].playerId;
+            if (id != 0) {
+                std::cout << "[Network] player " << id << " timed out\n";
+                release_player_id(id);
+                timedOut |= 1ull << (id - 1);
+            }
+            remove_client(i);
         }
+    }
 
-        // ★ GameObjectの新規生成を削除（Player2は既にPlayerManagerが持っている）
+    // PlayerManagerはロックの外で触る
+    for (uint32_t id = 1; timedOut != 0; ++id, timedOut >>= 1) {
+        if (timedOut & 1) despawn_player(id, worldObjects);
+    }
+}
 
-        // JOIN_ACK返送
-        uint8_t reply[1 + 4];
-        reply[0] = PKT_JOIN_ACK;
-        uint32_t pid_net = htonl(assignedId);
-        memcpy(reply + 1, &pid_net, 4);
-        m_net.send_to(from_ip, from_port, reply, (int)(1 + 4));
+// ============================================================
+// player_manager - 入力の適用・予測・出現に使うPlayerManager
+// ============================================================
+Game::PlayerManager& NetworkManager::player_manager() {
+    return m_players ? *m_players : Game::PlayerManager::GetInstance();
 }
 
 // ============================================================
-// host_handle_input - ホスト: クライアントの入力を適用する
-// 対応するGameObjectの位置に移動量を加算する
+// spawn_player / despawn_player - プレイヤーの出現と削除
+// プレイヤーの本体はPlayerManagerのプールにあり、worldObjectsには所有しない参照を入れる
 // ============================================================
-void NetworkManager::host_handle_input(const PacketInput& pi,
+Game::Player* NetworkManager::spawn_player(uint32_t playerId,
     std::vector<std::shared_ptr<Game::GameObject>>& worldObjects) {
-    for (const auto& go : worldObjects) {
-        if (go->getId() == pi.playerId) {
-            auto pos = go->getPosition();
-            pos.x += pi.moveX;
-            pos.y += pi.moveY;
-            pos.z += pi.moveZ;
-            go->setPosition(pos);
-            return;
+    Game::PlayerManager& players = player_manager();
+    if (Game::Player* existing = players.GetPlayer((int)playerId)) return existing;
+
+    Game::Player* player = players.SpawnPlayer((int)playerId);
+    if (player) {
+        worldObjects.push_back(std::shared_ptr<Game::GameObject>(
+            player->GetGameObject(), [](Game::GameObject*) {}));
+    }
+    return player;
+}
+
+void NetworkManager::despawn_player(uint32_t playerId,
+    std::vector<std::shared_ptr<Game::GameObject>>& worldObjects) {
+    Game::PlayerManager& players = player_manager();
+    Game::Player* player = players.GetPlayer((int)playerId);
+    if (!player) return;
+
+    const Game::GameObject* go = player->GetGameObject();
+    worldObjects.erase(std::remove_if(worldObjects.begin(), worldObjects.end(),
+        [go](const std::shared_ptr<Game::GameObject>& o) { return o.get() == go; }),
+        worldObjects.end());
+    players.DespawnPlayer((int)playerId);
+}
+
+// ============================================================
+// host_handle_input - ホスト: クライアントの入力を入力キューに積む
+// inputsは新しい順（inputs[0]が最新、残りは控え）。古い順に見て、まだ受け取っていない
+// seqのものだけを積む（非信頼で届くので、古いものや重複は捨てる）
+// 前のINPUTが落ちていても、その入力が控えに載っていればここで埋まる
+// プレイヤーIDは送信元のクライアント情報から決める（パケット内のIDは使わない）
+// ============================================================
+void NetworkManager::host_handle_input(const PacketInput* inputs, int count, const Endpoint& from) {
+    static const size_t MAX_INPUT_QUEUE = 8;  // 溜まりすぎたら古いものから捨てる（遅延を増やさない）
+
+    std::lock_guard<std::mutex> lk(m_mutex);
+    ClientInfo* client = find_client(from);
+    if (!client || client->playerId == 0) return;
+    client->lastSeen = std::chrono::steady_clock::now();
+
+    for (int i = count - 1; i >= 0; --i) {
+        const PacketInput& pi = inputs[i];
+        if (client->hasQueuedInput) {
+            const int32_t ahead = (int32_t)(pi.seq - client->lastQueuedInputSeq);
+            if (ahead <= 0) continue;
+            // 控えにも載っていなかった分（このクライアントの入力無しで進めることになる）
+            if (ahead > 1) client->link.stats().on_input_missed((uint32_t)(ahead - 1));
+        }
+        client->hasQueuedInput = true;
+        client->lastQueuedInputSeq = pi.seq;
+        if (i > 0) client->link.stats().on_input_recovered();
+
+        client->inputQueue.push_back(pi);
+        if (client->inputQueue.size() > MAX_INPUT_QUEUE) {
+            client->inputQueue.pop_front();
+            client->link.stats().on_input_dropped();
         }
     }
+    client->link.stats().on_input_queued(client->inputQueue.size());
+}
+
+// ============================================================
+// host_apply_inputs - ホスト: 入力を1ティック分ずつプレイヤーに適用する
+//
+// 適用した入力はこの後のPlayerManager::Update()でシミュレーションされる。
+// ティックの終わりのpublish_snapshot()がその結果（位置はSTATE本体、縦速度と接地はInputAck）を
+// 同じスナップショットに写すので、STATEの位置とInputAckのseqは常に同じティックを指す。
+// ============================================================
+void NetworkManager::host_apply_inputs() {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    for (auto& c : m_clients) {
+        if (c.playerId == 0) continue;
+        Game::Player* player = player_manager().GetPlayer((int)c.playerId);
+        if (!player) continue;
+
+        // 届いていなければ最後の入力の移動を繰り返す（ジャンプは繰り返さない）。
+        // InputAckのseqは進めないので、このティックの分のずれはクライアントが照合で直す
+        if (c.inputQueue.empty()) {
+            if (!c.hasAppliedInput) continue;
+            const PacketInput& last = c.lastAppliedInput;
+            player->ApplyInput({ last.moveX, last.moveY, last.moveZ }, false, PredictionBuffer::TICK_DT);
+            continue;
+        }
+        const PacketInput in = c.inputQueue.front();
+        c.inputQueue.pop_front();
+        c.lastAppliedInput = in;
+        c.hasAppliedInput = true;
+
+        XMFLOAT3 rot = player->GetRotation();
+        rot.y = in.yaw;
+        player->ForceSetRotation(rot);
+        player->ApplyInput({ in.moveX, in.moveY, in.moveZ },
+            (in.buttons & INPUT_BUTTON_JUMP) != 0, PredictionBuffer::TICK_DT);
+        AppliedInput& applied = m_appliedInputs[c.playerId];
+        applied.applied = true;
+        applied.seq = in.seq;
+    }
+}
+
+// ============================================================
+// client_reconcile - クライアント: ホストの結果と予測を照合する
+// ずれていれば、ホストの結果に戻してから未処理の入力を同じ移動処理で適用し直す
+// ============================================================
+void NetworkManager::client_reconcile(const ObjectState& authoritative, const InputAck& ack) {
+    Game::Player* player = player_manager().GetPlayer((int)m_myPlayerId);
+    if (!player) return;
+
+    PredictedState auth;
+    auth.posX = authoritative.posX;
+    auth.posY = authoritative.posY;
+    auth.posZ = authoritative.posZ;
+    auth.velY = ack.velY;
+    auth.grounded = ack.grounded != 0;
+    if (!m_prediction.acknowledge(ack.inputSeq, auth)) return;
+
+    player->ResetMovementState({ auth.posX, auth.posY, auth.posZ }, auth.velY, auth.grounded);
+    for (int i = 0; i < m_prediction.pending_count(); ++i) {
+        const PacketInput& in = m_prediction.pending_input(i);
+        player->ApplyInput({ in.moveX, in.moveY, in.moveZ },
+            (in.buttons & INPUT_BUTTON_JUMP) != 0, PredictionBuffer::TICK_DT);
+        player->Update(PredictionBuffer::TICK_DT);
+
+        PredictedState s;
+        const XMFLOAT3 p = player->GetPosition();
+        s.posX = p.x; s.posY = p.y; s.posZ = p.z;
+        s.velY = player->GetVelocity().y;
+        s.grounded = player->IsGrounded();
+        m_prediction.set_predicted(in.seq, s);
+    }
 }
 
 // ============================================================
 // client_handle_state - クライアント: ホストから受信した状態を適用
 // 自分自身のIDはスキップ（ローカルの操作を優先するため）
-// 既存オブジェクトがあれば補間ターゲットを設定、なければ新規作成
+// 居なかったプレイヤーは出現させ、補間バッファに追加する
+// 一覧に無いプレイヤー（退出した・関心領域の外）は消す
 // ============================================================
-void NetworkManager::client_handle_state(const PacketStateHeader& hdr,
-    const ObjectState* entries,
-    Game::GameObject* localPlayer,
+void NetworkManager::client_handle_state(const std::vector<ObjectState>& states, double time,
+    Game::GameObject* /*localPlayer*/,
     std::vector<std::shared_ptr<Game::GameObject>>& worldObjects) {
+    if (!m_gameBinding) return;
 
-    for (uint32_t i = 0; i < hdr.objectCount; ++i) {
-        const ObjectState& os = entries[i];
+    uint64_t listed = 0;  // 一覧にあったプレイヤー（ビット = ID - 1）
+    for (const ObjectState& os : states) {
+        if (os.id == 0 || os.id > (uint32_t)MAX_PLAYERS) continue;
+        listed |= 1ull << (os.id - 1);
 
         // 自分自身のプレイヤーIDならスキップ（ローカル入力を優先する）
         if (os.id == m_myPlayerId) {
             continue;
         }
 
-        // 既存のGameObjectを探して補間ターゲットを設定
-        bool applied = false;
-        for (const auto& go : worldObjects) {
-            if (go->getId() == os.id) {
-                go->setNetworkTarget({ os.posX, os.posY, os.posZ },
-                    { os.rotX, os.rotY, os.rotZ });
-                applied = true;
-                break;
-            }
-        }
+        Game::Player* player = spawn_player(os.id, worldObjects);
+        if (!player) continue;
+        player->GetGameObject()->setNetworkTarget({ os.posX, os.posY, os.posZ },
+            { os.rotX, os.rotY, os.rotZ }, time);
+    }
 
-        // 見つからなければ新しいGameObjectを生成
-        if (!applied) {
-        }
+    // 消すと出現中の一覧が末尾と入れ替わるので後ろから回る
+    const std::vector<int>& active = player_manager().GetActivePlayerIds();
+    for (size_t i = active.size(); i-- > 0;) {
+        const uint32_t id = (uint32_t)active[i];
+        if (id == m_myPlayerId || (listed & (1ull << (id - 1)))) continue;
+        despawn_player(id, worldObjects);
+    }
+}
+
+// ============================================================
+// handle_ping - PINGにはPONGを返し、PONGからRTTを測る
+// PONGのtimeUsは自分が送ったPINGの時刻なので、相手と時計が揃っていなくてよい
+// ============================================================
+void NetworkManager::handle_ping(const char* buf, int len, const Endpoint& from) {
+    if (len < (int)sizeof(PacketPing)) return;
+    PacketPing ping;
+    memcpy(&ping, buf, sizeof(ping));
+
+    if (ping.type == PKT_PING) {
+        ping.type = PKT_PONG;
+        send_packet(from, &ping, (int)sizeof(ping));
+        return;
+    }
+
+    // 32ビットで折り返しても差は正しい（約71分より長いRTTは無い）
+    const uint32_t rttUs = time_us32(std::chrono::steady_clock::now()) - ping.timeUs;
+    std::lock_guard<std::mutex> lk(m_mutex);
+    ReliableLink* link = find_link(from);
+    if (link) link->stats().on_rtt_sample((float)rttUs / 1000.0f);
+}
+
+// ============================================================
+// send_state_ack - 復元できたSTATEのseqを送信元に返す
+// 送信側はACKされたスナップショットを次の差分の基準にする
+// ============================================================
+void NetworkManager::send_state_ack(const Endpoint& to, uint32_t seq) {
+    PacketStateAck ack;
+    ack.type = PKT_STATE_ACK;
+    ack.seq = seq;
+    send_packet(to, &ack, (int)sizeof(ack));
+}
+
+// ============================================================
+// find_client / find_client_by_player - 索引からクライアントを探す
+// 呼び出し側でm_mutexを保持していること
+// ============================================================
+NetworkManager::ClientInfo* NetworkManager::find_client(const Endpoint& ep) {
+    auto it = m_clientByEndpoint.find(ep);
+    return (it != m_clientByEndpoint.end()) ? &m_clients[it->second] : nullptr;
+}
+
+NetworkManager::ClientInfo* NetworkManager::find_client_by_player(uint32_t playerId) {
+    auto it = m_clientByPlayerId.find(playerId);
+    return (it != m_clientByPlayerId.end()) ? &m_clients[it->second] : nullptr;
+}
+
+// ============================================================
+// add_client - クライアントを追加して索引に登録する
+// 呼び出し側でm_mutexを保持していること
+// ============================================================
+NetworkManager::ClientInfo& NetworkManager::add_client(const Endpoint& ep, uint32_t playerId) {
+    size_t index = m_clients.size();
+    m_clients.emplace_back();
+    ClientInfo& ci = m_clients.back();
+    ci.endpoint = ep;
+    ci.playerId = playerId;
+    ci.lastSeen = std::chrono::steady_clock::now();
+    ci.stream = std::make_shared<StateStream>();
+
+    m_clientByEndpoint[ep] = index;
+    if (playerId != 0) m_clientByPlayerId[playerId] = index;  // 0 = JOIN処理前の仮登録
+    return ci;
+}
+
+// ============================================================
+// remove_client - クライアントを外して索引を直す
+// 末尾のクライアントを空いた位置に移すので、移したものの索引だけ書き換える
+// 呼び出し側でm_mutexを保持していること
+// ============================================================
+void NetworkManager::remove_client(size_t index) {
+    if (index >= m_clients.size()) return;
+    m_clientByEndpoint.erase(m_clients[index].endpoint);
+    if (m_clients[index].playerId != 0) m_clientByPlayerId.erase(m_clients[index].playerId);
+
+    const size_t last = m_clients.size() - 1;
+    if (index != last) {
+        m_clients[index] = std::move(m_clients[last]);
+        const ClientInfo& moved = m_clients[index];
+        m_clientByEndpoint[moved.endpoint] = index;
+        if (moved.playerId != 0) m_clientByPlayerId[moved.playerId] = index;
     }
+    m_clients.pop_back();
 }
 
 // ============================================================
 // send_input - クライアント: ホストに入力データを送信する
+// 送った入力は予測の照合用に保存する
 // ============================================================
-void NetworkManager::send_input(const PacketInput& input) {
+void NetworkManager::send_input(PacketInput& input) {
     // ホスト自身は送信不要
     if (m_isHost) return;
-    // ホストIPが設定されていなければ送信しない
-    if (m_hostIp.empty()) return;
-    m_net.send_to(m_hostIp, m_hostPort, &input, (int)sizeof(PacketInput));
+    // ホストが決まっていなければ送信しない
+    if (!m_host.is_valid()) return;
+
+    input.seq = ++m_inputSeq;
+    char buf[NetCodec::MAX_INPUT_BYTES];
+    int len = NetCodec::write_input(&input, 1, buf, (int)sizeof(buf));
+    if (len <= 0) return;
+
+    // ホストが復元するのと同じ値で予測するため、量子化後の値に置き換える
+    PacketInput quantized[NetCodec::MAX_INPUTS_PER_PACKET];
+    NetCodec::read_input(buf, len, quantized);
+    input = quantized[0];
+    m_prediction.push(input);
+
+    // ホストがまだ処理していない直前の入力を控えとして添える（新しい順、seqは連続している）
+    PacketInput inputs[NetCodec::MAX_INPUTS_PER_PACKET];
+    const int pending = m_prediction.pending_count();
+    const int count = std::min(m_inputRedundancy, pending);
+    for (int i = 0; i < count; ++i) inputs[i] = m_prediction.pending_input(pending - 1 - i);
+    len = NetCodec::write_input(inputs, count, buf, (int)sizeof(buf));
+    if (len <= 0) return;
+    send_packet(m_host, buf, len);
+}
+
+void NetworkManager::set_input_redundancy(int count) {
+    m_inputRedundancy = std::max(1, std::min(count, NetCodec::MAX_INPUTS_PER_PACKET));
+}
+
+// ============================================================
+// store_predicted_state - クライアント: 最新の入力を適用した結果を記録する
+// ============================================================
+void NetworkManager::store_predicted_state() {
+    if (m_isHost || m_myPlayerId == 0 || m_prediction.pending_count() == 0) return;
+    Game::Player* player = player_manager().GetPlayer((int)m_myPlayerId);
+    if (!player) return;
+
+    PredictedState s;
+    const XMFLOAT3 p = player->GetPosition();
+    s.posX = p.x; s.posY = p.y; s.posZ = p.z;
+    s.velY = player->GetVelocity().y;
+    s.grounded = player->IsGrounded();
+    m_prediction.set_predicted(m_inputSeq, s);
+}
+
+// ============================================================
+// get_input_ack_seq - ホスト: 最後に公開した入力の処理結果のseq
+// ============================================================
+bool NetworkManager::get_input_ack_seq(uint32_t playerId, uint32_t& seq) const {
+    if (playerId == 0 || playerId > (uint32_t)MAX_PLAYERS) return false;
+    const AppliedInput& applied = m_appliedInputs[playerId];
+    if (!applied.hasAck) return false;
+    seq = applied.ack.inputSeq;
+    return true;
 }
 
 // ============================================================
@@ -420,186 +1091,80 @@ void NetworkManager::send_input(const PacketInput& input) {
 // クライアント: ホストへ送信
 // ============================================================
 void NetworkManager::send_bullet(const PacketBullet& pb) {
+    char buf[NetCodec::MAX_BULLET_BYTES];
+    int len = NetCodec::write_bullet(pb, buf, (int)sizeof(buf));
+    if (len <= 0) return;
+
     if (m_isHost) {
         // ホスト: 全クライアントに弾情報を送信
         std::lock_guard<std::mutex> lk(m_mutex);
-        for (const auto& c : m_clients) {
-            m_net.send_to(c.ip, c.port, &pb, (int)sizeof(PacketBullet));
-        }
+        send_to_all_clients(buf, len);
     } else {
         // クライアント: ホストに弾情報を送信
-        if (!m_hostIp.empty()) {
-            m_net.send_to(m_hostIp, m_hostPort, &pb, (int)sizeof(PacketBullet));
+        if (m_host.is_valid()) {
+            send_packet(m_host, buf, len);
         }
     }
 }
 
 // ============================================================
-// send_state_to_clients_round_robin
-// ホスト: 1回の呼び出しにつき1クライアントだけに状態を送信する
-// 全クライアントに毎回送ると負荷が高いため、順番に1人ずつ送る
+// publish_snapshot - ホスト: ティックの終わりの状態をワーカースレッドへ公開する
+// ここではPlayerManagerから状態を写すだけで、ロックも送信もしない
+// （送るのはワーカーのsend_snapshot。間に合わなかったスナップショットは次のもので上書きされる）
 // ============================================================
-void NetworkManager::send_state_to_clients_round_robin(
-    std::vector<std::shared_ptr<Game::GameObject>>* worldObjectsPtr) {
-
-    std::lock_guard<std::mutex> lk(m_mutex);
-    if (m_clients.empty() || worldObjectsPtr == nullptr) return;
-
-    // 今回送信するクライアントをインデックスで選ぶ（ラウンドロビン）
-    size_t idx = m_stateSendIndex % m_clients.size();
-    ClientInfo& c = m_clients[idx];
-
-    // パケットヘッダーを作成（オブジェクト1個分）
-    PacketStateHeader header;
-    header.type = PKT_STATE;
-    header.seq = m_seq++;
-    header.objectCount = 1;
-
-    // 送信バッファを確保
-    std::vector<char> sendbuf;
-    sendbuf.resize(sizeof(header) + sizeof(ObjectState));
-    memcpy(sendbuf.data(), &header, sizeof(header));
-
-    // 該当クライアントのGameObjectから位置・回転を取得
-    ObjectState os = {};
-    os.id = c.playerId;
-    bool found = false;
-    for (const auto& go : *worldObjectsPtr) {
-        if (go && go->getId() == os.id) {
-            auto p = go->getPosition();
-            os.posX = p.x; os.posY = p.y; os.posZ = p.z;
-            auto rrot = go->getRotation();
-            os.rotX = rrot.x; os.rotY = rrot.y; os.rotZ = rrot.z;
-            found = true;
-            break;
-        }
-    }
-    // 見つからなければゼロ位置を送信
-    if (!found) {
-        os.posX = os.posY = os.posZ = 0.0f;
-        os.rotX = os.rotY = os.rotZ = 0.0f;
+void NetworkManager::publish_snapshot() {
+    if (!m_isHost) return;
+
+    WorldSnapshot& snap = m_snapshots.back();
+    snap.timeMs = time_ms16();
+    build_player_states(snap);
+    m_snapshots.publish();
+
+    // ワーカーが送る時刻を過ぎて待っていれば起こす（state_send_timeout_msと対になるフェンス）
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_snapshotWanted.load(std::memory_order_relaxed) && m_snapshotWanted.exchange(false)) {
+        m_reactor.wakeup();
     }
-    memcpy(sendbuf.data() + sizeof(header), &os, sizeof(ObjectState));
-
-    // 送信
-    m_net.send_to(c.ip, c.port, sendbuf.data(), static_cast<int>(sendbuf.size()));
-
-    // 次回は次のクライアントに送信する
-    m_stateSendIndex = (m_stateSendIndex + 1) % (m_clients.empty() ? 1 : m_clients.size());
 }
 
 // ============================================================
-// FrameSync - フレーム同期
-// メインループからNフレームごとに呼ばれる（例: 10フレームごと=6Hz）
-// プレイヤーID 1と2の位置・回転を送受信する
+// build_player_states - 出現中の全プレイヤーの状態をsnapに集める
+// ホストのローカルプレイヤーもPlayerManagerのプールにあるので区別しない
+// このティックで入力を適用したプレイヤーは、移動後の縦速度と接地を処理結果として記録する
 // ============================================================
-void NetworkManager::FrameSync(Game::GameObject* localPlayer,
-    std::vector<std::shared_ptr<Game::GameObject>>& worldObjects) {
-    if (!localPlayer) {
-        return;
-    }
-
-    // ============================================================
-    // ラムダ: 指定IDリストのObjectStateを構築する
-    // localPlayerのIDと一致すればそこから、なければworldObjectsから取得
-    // ============================================================
-    auto build_states_for_ids = [&](const std::vector<int>& ids) {
-        std::vector<ObjectState> states;
-        for (int id : ids) {
-            ObjectState os = {};
-            os.id = static_cast<uint32_t>(id);
-            bool found = false;
-
-            // まずlocalPlayerをチェック（自分自身の最新位置）
-            if (localPlayer && localPlayer->getId() == (uint32_t)id) {
-                auto p = localPlayer->getPosition();
-                auto r = localPlayer->getRotation();
-                os.posX = p.x; os.posY = p.y; os.posZ = p.z;
-                os.rotX = r.x; os.rotY = r.y; os.rotZ = r.z;
-                found = true;
-            } else {
-                // worldObjectsから探す
-                for (const auto& go : worldObjects) {
-                    if (!go) continue;
-                    if (go->getId() == (uint32_t)id) {
-                        auto p = go->getPosition();
-                        auto r = go->getRotation();
-                        os.posX = p.x; os.posY = p.y; os.posZ = p.z;
-                        os.rotX = r.x; os.rotY = r.y; os.rotZ = r.z;
-                        found = true;
-                        break;
-                    }
-                }
-            }
-            // 見つからなければゼロで埋める
-            if (!found) {
-                os.posX = os.posY = os.posZ = 0.0f;
-                os.rotX = os.rotY = os.rotZ = 0.0f;
-            }
-            states.push_back(os);
-        }
-        return states;
-        };
-
-    // 同期対象のプレイヤーID（現在は1と2の固定）
-    std::vector<int> targetIds = { 1, 2 };
-
-    if (m_isHost) {
-        // ============ ホスト: 全クライアントに状態を送信 ============
-        std::lock_guard<std::mutex> lk(m_mutex);
-        if (m_clients.empty()) {
-            return;
-        }
-
-        // ID 1と2の状態を構築
-        auto states = build_states_for_ids(targetIds);
-
-        // パケットを組み立てる
-        PacketStateHeader header;
-        header.type = PKT_STATE;
-        header.seq = m_seq++;
-        header.objectCount = (uint32_t)states.size();
-
-        std::vector<char> buf(sizeof(header) + states.size() * sizeof(ObjectState));
-        memcpy(buf.data(), &header, sizeof(header));
-        memcpy(buf.data() + sizeof(header), states.data(), states.size() * sizeof(ObjectState));
-
-        // 全クライアントに送信
-        for (const auto& c : m_clients) {
-            m_net.send_to(c.ip, c.port, buf.data(), (int)buf.size());
-        }
-
-    } else {
-        // ============ クライアント: ホストに自分の状態を送信 ============
-        if (m_hostIp.empty()) {
-            return;
-        }
-        // JOIN_ACKを受け取ってIDが割り当てられるまでSTATEは送信しない
-        if (m_myPlayerId == 0) {
-            return;
+void NetworkManager::build_player_states(WorldSnapshot& snap) {
+    Game::PlayerManager& players = player_manager();
+    snap.states.clear();
+    snap.inputAcks.clear();
+    snap.hasInputAck.clear();
+    for (int id : players.GetActivePlayerIds()) {
+        Game::Player* player = players.GetPlayer(id);
+        const Game::GameObject* go = player->GetGameObject();
+        ObjectState os = {};
+        os.id = static_cast<uint32_t>(id);
+        auto p = go->getPosition();
+        auto r = go->getRotation();
+        os.posX = p.x; os.posY = p.y; os.posZ = p.z;
+        os.rotX = r.x; os.rotY = r.y; os.rotZ = r.z;
+        snap.states.push_back(os);
+
+        AppliedInput& applied = m_appliedInputs[id];
+        if (applied.applied) {
+            applied.ack.inputSeq = applied.seq;
+            applied.ack.velY = player->GetVelocity().y;
+            applied.ack.grounded = player->IsGrounded() ? 1 : 0;
+            applied.hasAck = true;
+            applied.applied = false;
         }
-
-        // ID 1と2の状態を構築
-        auto states = build_states_for_ids(targetIds);
-
-        // パケットを組み立てる
-        PacketStateHeader header;
-        header.type = PKT_STATE;
-        header.seq = m_seq++;
-        header.objectCount = (uint32_t)states.size();
-
-        std::vector<char> buf(sizeof(header) + states.size() * sizeof(ObjectState));
-        memcpy(buf.data(), &header, sizeof(header));
-        memcpy(buf.data() + sizeof(header), states.data(), states.size() * sizeof(ObjectState));
-
-        // ホストに送信
-        m_net.send_to(m_hostIp, m_hostPort, buf.data(), (int)buf.size());
+        snap.inputAcks.push_back(applied.ack);
+        snap.hasInputAck.push_back(applied.hasAck ? 1 : 0);
     }
 }
 
 // ============================================================
 // scan_channel_usage - チャンネル使用状況をスキャンする
 // 負荷軽減のため30秒間隔でしか実行しない
+// 全チャンネルへ探索要求を送り、応答（handle_discover_reply）でチャンネル情報を作り直す
 // ============================================================
 void NetworkManager::scan_channel_usage() {
     auto now = std::chrono::steady_clock::now();
@@ -608,20 +1173,22 @@ void NetworkManager::scan_channel_usage() {
         return;
     }
     m_lastChannelScan = now;
+    m_channelInfo.clear();
+    send_discover_broadcast(now);
 }
 
 // ============================================================
 // find_least_crowded_channel - 最もユーザーが少ないチャンネルを返す
+// 応答の無かったチャンネルにはホストがいないので0人として扱う（同数なら番号の小さい方）
 // ============================================================
 int NetworkManager::find_least_crowded_channel() {
-    if (m_channelInfo.empty()) return 0;  // 情報がなければチャンネル0
-    int bestChannel = 0;
-    uint32_t minUsers = UINT32_MAX;
+    uint32_t users[NUM_CHANNELS] = {};
     for (const auto& info : m_channelInfo) {
-        if (info.userCount < minUsers) {
-            minUsers = info.userCount;
-            bestChannel = static_cast<int>(info.channelId);
-        }
+        if (info.channelId < (uint32_t)NUM_CHANNELS) users[info.channelId] += info.userCount;
+    }
+    int bestChannel = 0;
+    for (int i = 1; i < NUM_CHANNELS; ++i) {
+        if (users[i] < users[bestChannel]) bestChannel = i;
     }
     return bestChannel;
 }
@@ -629,21 +1196,41 @@ int NetworkManager::find_least_crowded_channel() {
 // ============================================================
 // switch_to_channel - 指定チャンネルに切り替える
 // 現在のソケットを閉じて新しいポートで再初期化する
+// 開けなければ元のポートで開き直し、ワーカーも再開してからfalseを返す（通信が止まったままにしない）
 // ============================================================
 bool NetworkManager::switch_to_channel(int channelId) {
     if (channelId < 0 || channelId >= NUM_CHANNELS) return false;
 
-    // 現在のソケットを閉じる
+    // ワーカーがリアクターに登録したソケットを閉じるので、先に止める
+    bool wasRunning = m_workerRunning.load();
+    stop_worker();
+
+    // 戻すときのために今のポートを覚えてから、現在のソケットを閉じる
+    const int oldNetPort = m_net.get_current_port();
+    const int oldDiscoveryPort = m_discovery.get_current_port();
     m_net.close_socket();
     m_discovery.close_socket();
+    m_link.clear();
 
     // 新しいチャンネルのポートで初期化
     int newNetPort = PORT_RANGES[channelId][0];
     int newDiscoveryPort = PORT_RANGES[channelId][1];
     if (!m_net.initialize(newNetPort) || !m_discovery.initialize_broadcast(newDiscoveryPort)) {
+        // 片方だけ開けていれば閉じて、元のチャンネルのポートで開き直す
+        m_net.close_socket();
+        m_discovery.close_socket();
+        if ((oldNetPort > 0 && !m_net.initialize(oldNetPort)) ||
+            (oldDiscoveryPort > 0 && !m_discovery.initialize_broadcast(oldDiscoveryPort))) {
+            std::cerr << "[Network] failed to reopen ports " << oldNetPort << "/" << oldDiscoveryPort
+                << " after switching to channel " << channelId << " failed\n";
+        }
+        if (wasRunning) start_worker();
         return false;
     }
     m_currentChannel = channelId;
+
+    // 新しいソケットで受信を再開
+    if (wasRunning) start_worker();
     return true;
 }
 
@@ -668,6 +1255,7 @@ bool NetworkManager::check_existing_firewall_rule() {
 // （学校環境などでは権限がないことが多いため）
 // ============================================================
 bool NetworkManager::add_firewall_exception() {
+#ifdef _WIN32
     // 管理者権限チェック
     BOOL isAdmin = FALSE;
     PSID administratorsGroup = NULL;
@@ -681,22 +1269,32 @@ bool NetworkManager::add_firewall_exception() {
     if (!isAdmin) {
         return true;
     }
+#endif
     // 管理者であっても実際のルール追加はスキップ（パフォーマンス優先）
     return true;
 }
 
 // ============================================================
-// handle_channel_scan - チャンネルスキャン要求への応答
-// 自分のチャンネル情報を要求元に返す
+// handle_channel_scan - 探索・チャンネルスキャン要求への応答
+// 自分のチャンネル情報と参加人数を要求元に返す（ワーカースレッドからその場で呼ぶ）
 // ============================================================
-void NetworkManager::handle_channel_scan(const std::string& from_ip, int from_port) {
-    ChannelInfo info;
-    info.type = PKT_CHANNEL_INFO;
-    info.channelId = static_cast<uint32_t>(m_currentChannel);
-    info.userCount = static_cast<uint32_t>(m_clients.size());
-    info.basePort = static_cast<uint32_t>(m_net.get_current_port());
-    info.discoveryPort = static_cast<uint32_t>(m_discovery.get_current_port());
-    m_discovery.send_to(from_ip, from_port, &info, sizeof(info));
+void NetworkManager::handle_channel_scan(const char* buf, int len, const Endpoint& from) {
+    PacketDiscover request = {};
+    if (len >= (int)sizeof(request)) memcpy(&request, buf, sizeof(request));
+
+    size_t players = get_client_count() + (m_hostHasLocalPlayer ? 1 : 0);
+    if (players > (size_t)MAX_PLAYERS) players = (size_t)MAX_PLAYERS;
+
+    PacketDiscoverReply reply;
+    reply.type = PKT_DISCOVER_REPLY;
+    reply.timeUs = request.timeUs;
+    reply.channelId = static_cast<uint8_t>(m_currentChannel.load(std::memory_order_relaxed));
+    reply.playerCount = static_cast<uint8_t>(players);
+    reply.maxPlayers = static_cast<uint8_t>(MAX_PLAYERS);
+    reply.gamePort = htons(static_cast<uint16_t>(m_net.get_current_port()));
+    m_discovery.send_to(from, &reply, (int)sizeof(reply));
+    m_capture.record(CAPTURE_RECV_DISCOVERY, from, buf, len);
+    m_capture.record(CAPTURE_SEND_DISCOVERY, from, &reply, (int)sizeof(reply));
 }
 
 // ============================================================
@@ -721,101 +1319,211 @@ void NetworkManager::handle_channel_info(const ChannelInfo& info) {
 // このスレッドは以下を繰り返す:
 // 1. ゲーム通信ソケットをポーリング → パケットをキューに追加
 // 2. 探索ソケットをポーリング → DISCOVERには即座に応答、それ以外はキューへ
-// 3. ホストの場合、定期的にラウンドロビンで最小限の状態を送信
-// 4. 5ms待機してCPU負荷を抑える
+// 3. ホストの場合、m_stateSendIntervalごとに最新のスナップショットからSTATEを送信
+// 4. 次の送信か受信まで待機してCPU負荷を抑える
 // ============================================================
 void NetworkManager::start_worker() {
+    // 待つためのソケットが無いNetTransportは、update()の中で受信する
+    if (m_externalTransport && m_link.get_handle() == INVALID_SOCKET) return;
+
     // 既に動作中なら何もしない（exchange=trueを返す場合は既にtrue）
     if (m_workerRunning.exchange(true)) return;
 
+    // ゲーム通信と探索のソケットを1つのリアクターに登録する（外から渡されたものは探索なし）
+    if (!m_reactor.open() ||
+        !m_reactor.add(m_link.get_handle(), REACTOR_TAG_GAME) ||
+        (!m_externalTransport && !m_reactor.add(m_discovery.get_handle(), REACTOR_TAG_DISCOVERY))) {
+        std::cerr << "[Network] reactor setup failed\n";
+        m_reactor.close();
+        m_workerRunning = false;
+        return;
+    }
+
+    m_lastStateSend = std::chrono::steady_clock::now();
     m_worker = std::thread([this]() {
-        // ワーカー内のローカル変数
-        std::vector<std::shared_ptr<Game::GameObject>> worldObjectsSnapshot;
-        auto lastStateSend = std::chrono::steady_clock::now();
 
         while (m_workerRunning.load()) {
 
-            // --- 1. ゲーム通信ソケットのポーリング ---
-            char buf[MAX_UDP_PACKET];
-            std::string from_ip;
-            int from_port = 0;
-
-            // 50msタイムアウトで受信を試みる
-            int r = m_net.poll_recv(buf, sizeof(buf), from_ip, from_port, 50);
-            if (r > 0) {
-                // 受信データをキューに積む（メインスレッドで処理する）
-                RecvPacket pkt;
-                pkt.data.assign(buf, buf + r);
-                pkt.len = r;
-                pkt.from_ip = from_ip;
-                pkt.from_port = from_port;
-                pkt.isDiscovery = false;
-                push_recv_packet(std::move(pkt));
+            // --- 1. 待機時間を決める ---
+            // ホストは次のSTATE送信まで、クライアントは受信かwakeupまで待つ
+            int timeout_ms = -1;
+            if (m_isHost) timeout_ms = state_send_timeout_ms(std::chrono::steady_clock::now());
+            // 回線状態の再現中は、遅らせているパケットの期限にも起きる
+            int due_ms = m_link.next_due_ms();
+            if (due_ms >= 0 && (timeout_ms < 0 || due_ms < timeout_ms)) timeout_ms = due_ms;
+
+            // --- 2. どちらかのソケットに届くか、起こされるまで待つ ---
+            int ready[NetReactor::MAX_SOCKETS];
+            int n = m_reactor.wait(timeout_ms, ready, NetReactor::MAX_SOCKETS);
+            if (!m_workerRunning.load()) break;
+
+            // --- 3. 読み込み可能なソケットを空になるまで読む ---
+            bool gameDrained = false;
+            for (int i = 0; i < n; ++i) {
+                drain_socket(static_cast<ReactorTag>(ready[i]));
+                gameDrained = gameDrained || ready[i] == REACTOR_TAG_GAME;
             }
 
-            // --- 2. 探索ソケットのポーリング ---
-            int dr = m_discovery.poll_recv(buf, sizeof(buf), from_ip, from_port, 10);
-            if (dr > 0) {
-                uint8_t dt = (uint8_t)buf[0];
-                if (m_isHost && dt == PKT_DISCOVER) {
-                    // ホストの場合、DISCOVER要求には即座に応答する（軽量処理）
-                    uint8_t reply = PKT_DISCOVER_REPLY;
-                    m_discovery.send_to(from_ip, from_port, &reply, 1);
-                } else {
-                    // それ以外のパケット（チャンネル情報など）はキューへ
-                    RecvPacket pkt;
-                    pkt.data.assign(buf, buf + dr);
-                    pkt.len = dr;
-                    pkt.from_ip = from_ip;
-                    pkt.from_port = from_port;
-                    pkt.isDiscovery = true;
-                    push_recv_packet(std::move(pkt));
-                }
+            // 回線状態の再現: 期限の来た送信を出し、受信を渡す
+            // （遅らせていたパケットではソケットが読み込み可能にならない）
+            if (m_link.enabled()) {
+                m_link.pump();
+                if (!gameDrained && m_link.has_due_incoming()) drain_socket(REACTOR_TAG_GAME);
             }
 
-            // --- 3. ホスト: 定期的な最小限状態送信 ---
-            // m_stateInterval（200ms）ごとに1クライアントに最小パケットを送る
-            // ネットワーク接続を維持するためのキープアライブ的な役割
-            auto now = std::chrono::steady_clock::now();
-            if (!m_isHost) {
-                // クライアントは何もしない
-            } else if (std::chrono::duration_cast<std::chrono::milliseconds>(
-                now - lastStateSend) >= m_stateInterval) {
-                // ワーカースレッドからworldObjectsに安全にアクセスできないため、
-                // 位置はゼロで埋めた最小パケットを送る（正確な位置はFrameSyncで送る）
-                std::lock_guard<std::mutex> lk(m_mutex);
-                if (!m_clients.empty()) {
-                    size_t idx = m_stateSendIndex % m_clients.size();
-                    ClientInfo& c = m_clients[idx];
-
-                    // 最小限の状態パケットを組み立て
-                    PacketStateHeader header;
-                    header.type = PKT_STATE;
-                    header.seq = m_seq++;
-                    header.objectCount = 1;
-                    ObjectState os = {};
-                    os.id = c.playerId;
-                    os.posX = os.posY = os.posZ = 0.0f;
-                    os.rotX = os.rotY = os.rotZ = 0.0f;
-
-                    std::vector<char> sendbuf;
-                    sendbuf.resize(sizeof(header) + sizeof(os));
-                    memcpy(sendbuf.data(), &header, sizeof(header));
-                    memcpy(sendbuf.data() + sizeof(header), &os, sizeof(os));
-                    m_net.send_to(c.ip, c.port, sendbuf.data(), static_cast<int>(sendbuf.size()));
-
-                    // 次のクライアントに進む
-                    m_stateSendIndex = (m_stateSendIndex + 1) %
-                        (m_clients.empty() ? 1 : m_clients.size());
-                }
-                lastStateSend = now;
-            }
-
-            // --- 4. CPU負荷軽減のためスリープ ---
-            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            // --- 4. ホスト: 最新のスナップショットからSTATEを送る ---
+            if (m_isHost) send_snapshot(std::chrono::steady_clock::now());
         }
         // ワーカースレッド終了
         });
+
+    start_receive_shards();
+}
+
+// ============================================================
+// send_snapshot - ホスト: 最新のスナップショットからSTATEを作って送る（ワーカースレッド）
+// メインスレッドが公開したスナップショットだけを読むので、ゲームのオブジェクトには触れない。
+// 新しいものが公開されていなければ（メインスレッドが止まっている）、m_stateInterval（200ms）ごとに
+// 同じものを送り直して接続を維持する（ACK済みなら差分はほぼヘッダーだけになる）
+// ============================================================
+void NetworkManager::send_snapshot(std::chrono::steady_clock::time_point now) {
+    if (now - m_lastStateSend < m_stateSendInterval) return;
+    const bool fresh = m_snapshots.acquire();
+    if (!fresh && now - m_lastStateSend < m_stateInterval) return;
+    // 予定の時刻を間隔ずつ進め、起きる時刻（ティックの刻みなど）とずれても平均の間隔を保つ
+    // （大きく遅れたときは今から数え直し、まとめて送らない）
+    m_lastStateSend = (now - m_lastStateSend < 2 * m_stateSendInterval) ?
+        m_lastStateSend + m_stateSendInterval : now;
+
+    send_states_to_clients(m_snapshots.front(), now);
+}
+
+// ============================================================
+// state_send_timeout_ms - ホスト: ワーカーが次にsend_snapshotを呼ぶまでに待つ時間
+// 送る時刻を過ぎても新しいスナップショットが無ければ、キープアライブの時刻まで待ちながら
+// publish_snapshot()に起こしてもらう（0で待つとメインスレッドが公開するまで空回りする）
+// ============================================================
+int NetworkManager::state_send_timeout_ms(std::chrono::steady_clock::time_point now) {
+    // 残り時間はミリ秒に切り上げる（切り捨てると1ms未満の間0で待ち続ける）
+    auto until = [&](std::chrono::milliseconds interval) {
+        const auto left = m_lastStateSend + interval - now;
+        if (left <= std::chrono::steady_clock::duration::zero()) return 0;
+        return static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(left).count());
+    };
+
+    const int sendMs = until(m_stateSendInterval);
+    if (sendMs > 0) return sendMs;
+
+    // フラグを立ててから確かめる。publish_snapshot()は公開してからフラグを見るので、
+    // どちらかが必ず相手の書き込みに気付く（見落として寝続けることはない）
+    m_snapshotWanted.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_snapshots.has_fresh()) {
+        m_snapshotWanted.store(false, std::memory_order_relaxed);
+        return 0;
+    }
+    return until(m_stateInterval);
+}
+
+// ============================================================
+// poll_transport - ワーカースレッドの代わりに1回分の送受信を進める
+// 受信キューへの書き込みと取り出しが同じスレッドになるだけで、SPSCの前提は崩れない
+// ============================================================
+void NetworkManager::poll_transport() {
+    m_link.pump();
+    drain_socket(REACTOR_TAG_GAME);
+    if (m_isHost) send_snapshot(std::chrono::steady_clock::now());
+}
+
+// ============================================================
+// drain_socket - 読み込み可能になったソケットから届いている分をすべて読む
+// ソケットはノンブロッキングなので、データが尽きたらrecv_from / recv_batchが0を返す
+// 受信キューが満杯のときは古いパケットを追い出せない（SPSC）ので、新しい方を捨てる
+// ============================================================
+void NetworkManager::drain_socket(ReactorTag tag) {
+    if (tag == REACTOR_TAG_GAME) {
+        drain_game_socket(m_link, m_recvQueue, m_recvStats);
+        return;
+    }
+
+    char scratch[MAX_UDP_PACKET];
+
+    // 探索ソケット: DISCOVERにはその場で応答するので1件ずつ読む
+    for (;;) {
+        // 空きスロットに直接受信する。満杯なら一時バッファに読んで捨てる
+        RecvPacket* slot = m_recvQueue.try_begin_push();
+        char* buf = slot ? slot->data : scratch;
+        Endpoint from;
+        int r = m_discovery.recv_from(buf, MAX_UDP_PACKET, from);
+        if (r <= 0) break;
+
+        if (m_isHost && ((uint8_t)buf[0] == PKT_DISCOVER || (uint8_t)buf[0] == PKT_CHANNEL_SCAN)) {
+            // ホストの場合、探索要求には即座に応答する（軽量処理）
+            handle_channel_scan(buf, r, from);
+            continue;
+        }
+
+        if (!slot) {
+            // メインスレッドが追いついていない → 新しいパケットを捨てる
+            m_recvStats.dropped.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        // それ以外のパケットはキューに公開する（メインスレッドで処理する）
+        slot->from = from;
+        slot->len = static_cast<uint16_t>(r);
+        slot->isDiscovery = true;
+        m_recvQueue.commit_push();
+        m_recvStats.received.fetch_add(1, std::memory_order_relaxed);
+        note_queue_depth(m_recvQueue, m_recvStats);
+    }
+}
+
+// ============================================================
+// drain_game_socket - ゲーム通信のソケットから届いている分をすべてqueueに積む
+// 連続した空きスロットにrecv_batchでまとめて受信する
+// ============================================================
+void NetworkManager::drain_game_socket(NetTransport& socket, RecvQueue& queue, RecvQueueStats& stats) {
+    char scratch[MAX_UDP_PACKET];
+    UdpRecvItem items[UdpNetwork::BATCH_MAX];
+    for (;;) {
+        auto span = queue.try_begin_push_span(UdpNetwork::BATCH_MAX);
+        if (span.count == 0) {
+            // メインスレッドが追いついていない → 一時バッファに読んで捨てる
+            Endpoint from;
+            if (socket.recv_from(scratch, sizeof(scratch), from) <= 0) break;
+            stats.dropped.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        for (size_t i = 0; i < span.count; ++i) {
+            items[i].buffer = span.data[i].data;
+            items[i].capacity = MAX_UDP_PACKET;
+        }
+        int n = socket.recv_batch(items, static_cast<int>(span.count));
+        if (n <= 0) break;
+
+        for (int i = 0; i < n; ++i) {
+            RecvPacket& slot = span.data[i];
+            slot.from = items[i].from;
+            slot.len = static_cast<uint16_t>(items[i].len);
+            slot.isDiscovery = false;
+            if (m_recvProbe) m_recvProbe(slot.data, slot.len);
+        }
+        queue.commit_push(static_cast<size_t>(n));
+        stats.received.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+        note_queue_depth(queue, stats);
+
+        // 用意した数より少なければソケットは空になっている
+        if (static_cast<size_t>(n) < span.count) break;
+    }
+}
+
+void NetworkManager::note_queue_depth(const RecvQueue& queue, RecvQueueStats& stats) {
+    const size_t depth = queue.size_approx();
+    if (depth > stats.highWater.load(std::memory_order_relaxed)) {
+        stats.highWater.store(depth, std::memory_order_relaxed);
+    }
 }
 
 // ============================================================
@@ -824,24 +1532,85 @@ void NetworkManager::start_worker() {
 void NetworkManager::stop_worker() {
     // フラグをfalseに設定（既にfalseなら何もしない）
     if (!m_workerRunning.exchange(false)) return;
+    // 待機中のワーカーを起こす
+    m_reactor.wakeup();
     // スレッドの終了を待つ
     if (m_worker.joinable()) {
         m_worker.join();
     }
+    m_reactor.clear();
+    m_reactor.close();
+    stop_receive_shards();
 }
 
 // ============================================================
-// push_recv_packet - ワーカースレッドからキューにパケットを追加する
-// キューが最大サイズ（1024）を超えたら古いパケットを捨てる
+// set_receive_shards - ゲーム通信ポートを受信するソケットの数を決める
 // ============================================================
-void NetworkManager::push_recv_packet(RecvPacket&& pkt) {
-    std::lock_guard<std::mutex> lk(m_recvMutex);
-    const size_t MAX_QUEUE = 1024;
-    if (m_recvQueue.size() >= MAX_QUEUE) {
-        // キューが満杯 → 最も古いパケットを削除
-        m_recvQueue.pop_front();
+void NetworkManager::set_receive_shards(int count) {
+    if (count < 1) count = 1;
+    if (count > MAX_RECV_SHARDS) count = MAX_RECV_SHARDS;
+    m_recvShardCount = count;
+}
+
+// ============================================================
+// start_receive_shards - 2つ目以降の受信ソケットを開き、それぞれの受信スレッドを始める
+// 開けなかった分は諦めて、開けた数だけで受信する（1つ目のm_netは必ずある）
+// ============================================================
+void NetworkManager::start_receive_shards() {
+    if (!m_isHost || m_recvShardCount <= 1 || m_externalTransport || !m_shards.empty()) return;
+    if (!UdpNetwork::reuse_port_supported()) {
+        std::cerr << "[Network] SO_REUSEPORT is not available, receiving on one socket\n";
+        return;
+    }
+    if (m_link.enabled()) {
+        // 回線状態の再現はm_linkを通った受信にしか掛からない
+        std::cerr << "[Network] link conditioner is active, receiving on one socket\n";
+        return;
+    }
+
+    for (int i = 1; i < m_recvShardCount; ++i) {
+        std::unique_ptr<RecvShard> shard(new RecvShard());
+        if (!shard->socket.initialize_shard(m_net.get_current_port()) ||
+            !shard->reactor.open() ||
+            !shard->reactor.add(shard->socket.get_handle(), REACTOR_TAG_GAME)) {
+            std::cerr << "[Network] failed to open receive shard " << i << "\n";
+            shard->reactor.close();
+            shard->socket.close_socket();
+            break;
+        }
+        m_shards.push_back(std::move(shard));
+    }
+    for (auto& shard : m_shards) {
+        RecvShard* s = shard.get();
+        s->thread = std::thread([this, s]() { shard_loop(*s); });
+    }
+    std::cout << "[Network] receiving on " << (m_shards.size() + 1)
+        << " sockets (port " << m_net.get_current_port() << ")\n";
+}
+
+void NetworkManager::stop_receive_shards() {
+    for (auto& shard : m_shards) {
+        shard->reactor.wakeup();
+        if (shard->thread.joinable()) shard->thread.join();
+        shard->reactor.clear();
+        shard->reactor.close();
+        shard->socket.close_socket();
+    }
+    m_shards.clear();
+    m_drainShard = 0;
+}
+
+// ============================================================
+// shard_loop - 受信シャードのスレッド
+// 自分のソケットに届くのを待ち、届いた分をすべて自分のキューに積む（送信はしない）
+// ============================================================
+void NetworkManager::shard_loop(RecvShard& shard) {
+    while (m_workerRunning.load()) {
+        int ready[1];
+        if (shard.reactor.wait(-1, ready, 1) > 0 && m_workerRunning.load()) {
+            drain_game_socket(shard.socket, shard.queue, shard.stats);
+        }
     }
-    m_recvQueue.push_back(std::move(pkt));
 }
 
 // ============================================================
@@ -870,72 +1639,355 @@ bool NetworkManager::initialize_with_fallback() {
 }
 
 // ============================================================
-// send_state_to_all - ホスト: 全クライアントに全オブジェクトの状態を送信
-// ホスト自身のプレイヤー（ID=1）も含めて送信する
+// send_to_all_clients - 同じデータを全クライアントの送信待ちに加える
+// 接続ごとにヘッダー（seq / ack）が違うので、パケットはflush_links()で
+// クライアントごとに作り、宛先一覧をsend_batchに渡す（Linuxでは1回のsendmmsg）
 // ============================================================
-void NetworkManager::send_state_to_all(
-    std::vector<std::shared_ptr<Game::GameObject>>& worldObjects) {
+void NetworkManager::send_to_all_clients(const void* data, int len, const Endpoint* exclude) {
+    for (auto& c : m_clients) {
+        if (exclude && c.endpoint == *exclude) continue;
+        queue_via_link(c.link, data, len);
+    }
+}
 
-    std::lock_guard<std::mutex> lk(m_mutex);
-    if (m_clients.empty()) {
-        return;
+// ============================================================
+// send_states_to_clients - クライアントごとに関心領域で絞り込み、
+// 優先度の高い順に帯域の上限まで差分を詰めてまとめて送る
+// 送信時刻にはスナップショットを公開した時刻を使う（ワーカーの送る間隔の揺れを補間に持ち込まない）
+//
+// 1. m_mutexを持って、接続ごとの送信の流れ・宛先・ACK済みのseq・プレイヤーの位置をm_stateJobsに写す
+// 2. ロックを外して、関心領域のセル分けと帯域の計算（このスレッド）、
+//    クライアントごとの符号化（m_encodePoolの全スレッドで分ける）
+// 3. m_mutexを持って、符号化したSTATEをその接続のパケットにまとめ、統計を更新する
+// 4. ロックを外して、作ったパケットを1回のsend_batchで送る
+// 符号化と送信の間はm_mutexを持たないので、メインスレッドのservice()を止めない
+// 作業用バッファはスレッドごとに使い回し、毎回確保し直さない
+// ============================================================
+void NetworkManager::send_states_to_clients(const WorldSnapshot& snap,
+    std::chrono::steady_clock::time_point now) {
+    const std::vector<ObjectState>& states = snap.states;
+    const auto encodeStart = std::chrono::steady_clock::now();
+
+    uint32_t seq = 0;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        if (m_clients.empty()) return;
+        seq = m_seq++;
+        m_stateJobs.resize(m_clients.size());
+        for (size_t i = 0; i < m_clients.size(); ++i) {
+            const ClientInfo& c = m_clients[i];
+            StateJob& job = m_stateJobs[i];
+            job.stream = c.stream;
+            job.endpoint = c.endpoint;
+            job.playerId = c.playerId;
+            job.ackedSeq = c.stateAck;
+            job.viewIndex = -1;
+        }
+        // 各クライアントのプレイヤーがstatesのどこにあるかを調べる
+        for (size_t i = 0; i < states.size(); ++i) {
+            auto it = m_clientByPlayerId.find(states[i].id);
+            if (it != m_clientByPlayerId.end()) m_stateJobs[it->second].viewIndex = (int)i;
+        }
     }
 
-    // 送信する状態リストを構築
-    std::vector<ObjectState> states;
+    // オブジェクトをセルに振り分ける
+    m_interest.rebuild(states);
 
-    // --- ホストのローカルプレイヤー（ID=1）を追加 ---
-    Game::GameObject* localPlayer = nullptr;
-    localPlayer = Game::GetLocalPlayerGameObject();
+    // 前回からの経過時間だけ優先度と帯域を積む
+    const double nowTime = get_time();
+    const float dt = (m_lastStateTime < 0.0) ? 0.0f : (float)(nowTime - m_lastStateTime);
+    m_lastStateTime = nowTime;
 
-    if (localPlayer && localPlayer->getId() == 1) {
-        ObjectState os = {};
-        os.id = 1;
-        auto p = localPlayer->getPosition();
-        auto r = localPlayer->getRotation();
-        os.posX = p.x; os.posY = p.y; os.posZ = p.z;
-        os.rotX = r.x; os.rotY = r.y; os.rotZ = r.z;
-        states.push_back(os);
+    // 1パケットに使えるバイト数（帯域 x 間隔、MTUを超えない）
+    // 先頭のクライアント自身のプレイヤーは予測の照合に必要なので、最低でもそれが入る分は使う
+    static const int MIN_STATE_BUDGET = 128;
+    int budget = (int)(m_stateBytesPerSecond * dt);
+    if (budget <= 0 || budget > MAX_STATE_BYTES) budget = MAX_STATE_BYTES;
+    if (budget < MIN_STATE_BUDGET) budget = MIN_STATE_BUDGET;
+
+    m_encodePool.run(m_stateJobs.size(), [&](int worker, size_t index) {
+        encode_client_state(m_stateJobs[index], seq, snap, dt, budget, m_encodeScratch[worker]);
+    });
+
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        // その接続に溜まっている分（このティックの弾・再送・ACKなど）と一緒にパケットにする
+        m_statePacketCount = 0;
+        for (const StateJob& job : m_stateJobs) {
+            // 符号化している間に切断した（同じアドレスで入り直した）クライアントには送らない
+            ClientInfo* c = find_client(job.endpoint);
+            if (!c || c->stream != job.stream) continue;
+            queue_via_link(c->link, job.encodeBuf.data(), static_cast<int>(job.encodeBuf.size()));
+            const size_t first = m_statePacketCount;
+            c->link.collect_outgoing(now, m_statePackets, m_statePacketCount);
+            if (m_statePacketTo.size() < m_statePacketCount) m_statePacketTo.resize(m_statePacketCount);
+            for (size_t i = first; i < m_statePacketCount; ++i) m_statePacketTo[i] = c->endpoint;
+        }
+
+        const double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - encodeStart).count();
+        ++m_encodeCount;
+        m_encodeSeconds += seconds;
+        if (seconds > m_encodeMaxSeconds) m_encodeMaxSeconds = seconds;
     }
 
-    // --- 各クライアントのGameObjectを追加 ---
-    for (const auto& c : m_clients) {
-        ObjectState os = {};
-        os.id = c.playerId;
-        bool found = false;
-        for (const auto& go : worldObjects) {
-            if (go && go->getId() == os.id) {
-                auto p = go->getPosition();
-                auto r = go->getRotation();
-                os.posX = p.x; os.posY = p.y; os.posZ = p.z;
-                os.rotX = r.x; os.rotY = r.y; os.rotZ = r.z;
-                found = true;
-                break;
-            }
+    m_stateFanout.clear();
+    for (size_t i = 0; i < m_statePacketCount; ++i) {
+        m_stateFanout.push_back({ m_statePacketTo[i], m_statePackets[i].data(),
+            static_cast<int>(m_statePackets[i].size()) });
+    }
+    send_fanout(m_stateFanout);
+}
+
+// ============================================================
+// encode_client_state - 1クライアント分のSTATEを作る
+// m_interest・snap・dt・budgetは読むだけで、書き込むのはjob・その送信の流れ・scratchだけ
+// （別々のクライアントなら、どのスレッドから同時に呼んでもよい）
+// ============================================================
+void NetworkManager::encode_client_state(StateJob& job, uint32_t seq, const WorldSnapshot& snap,
+    float dt, int budget, EncodeScratch& scratch) {
+    const std::vector<ObjectState>& states = snap.states;
+    StateStream& stream = *job.stream;
+
+    // 前回からクライアントがACKした分だけベースラインを進める
+    if (job.ackedSeq != SnapshotDelta::NO_BASELINE) stream.snapshots.on_ack(job.ackedSeq);
+
+    // プレイヤーの周りにあるものだけを候補にする（プレイヤーがまだ居なければ全部）
+    if (job.viewIndex >= 0) {
+        m_interest.query(states[job.viewIndex], job.playerId, scratch.relevant);
+    } else {
+        scratch.relevant.clear();
+        for (size_t i = 0; i < states.size(); ++i) scratch.relevant.push_back({ (uint32_t)i, 1.0f });
+    }
+
+    // 優先度の高い順に並べ、上限まで詰める（入らなかった分は次のパケットに回る）
+    stream.scheduler.accumulate(states, scratch.relevant, dt, job.playerId, scratch.sendOrder);
+    scratch.clientStates.clear();
+    for (uint32_t index : scratch.sendOrder) scratch.clientStates.push_back(states[index]);
+
+    // 処理結果はプレイヤーの状態と同じティックのものを返す
+    const InputAck* ack = (job.viewIndex >= 0 && snap.hasInputAck[job.viewIndex]) ?
+        &snap.inputAcks[job.viewIndex] : nullptr;
+    stream.snapshots.encode(seq, snap.timeMs, scratch.clientStates, job.encodeBuf,
+        ack, budget, &scratch.sentCurrent);
+    for (size_t i = 0; i < scratch.clientStates.size(); ++i) {
+        if (scratch.sentCurrent[i]) stream.scheduler.mark_current(scratch.clientStates[i].id);
+    }
+}
+
+// ============================================================
+// find_link - 宛先とのReliableLinkを返す
+// 呼び出し側でm_mutexを保持していること
+// ============================================================
+ReliableLink* NetworkManager::find_link(const Endpoint& to) {
+    if (m_isHost) {
+        ClientInfo* client = find_client(to);
+        return client ? &client->link : nullptr;
+    }
+    return (m_host.is_valid() && to == m_host) ? &m_hostLink : nullptr;
+}
+
+// ============================================================
+// send_packet - 宛先のReliableLinkに1つ溜める
+// 接続していない宛先には送らない。実際の送信はflush_links()（ティックの終わり）
+// ============================================================
+void NetworkManager::send_packet(const Endpoint& to, const void* data, int len) {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    ReliableLink* link = find_link(to);
+    if (!link) return;
+    queue_via_link(*link, data, len);
+}
+
+// ============================================================
+// queue_via_link - パケット種別で送り方を選んで接続に溜める
+// 信頼チャンネルはACKされるまで再送するキューへ、それ以外は次の1回だけ送るキューへ
+// 呼び出し側でm_mutexを保持していること
+// ============================================================
+void NetworkManager::queue_via_link(ReliableLink& link, const void* data, int len) {
+    if (len <= 0) return;
+
+    NetChannel channel = channel_for_packet(*static_cast<const uint8_t*>(data));
+    if (channel != CHANNEL_UNRELIABLE) {
+        link.queue_reliable(channel, data, len);
+    } else {
+        link.queue_unreliable(data, len);
+    }
+}
+
+// ============================================================
+// collect_link - 接続に溜まったメッセージをパケットにまとめて送信待ちに加える
+// （再送・新規の信頼メッセージ、非信頼メッセージ、必要ならACK専用パケット）
+// 呼び出し側でm_mutexを保持していること
+// ============================================================
+void NetworkManager::collect_link(ReliableLink& link, const Endpoint& to,
+    std::chrono::steady_clock::time_point now) {
+    size_t first = m_outCount;
+    link.collect_outgoing(now, m_outPackets, m_outCount);
+    if (m_outTo.size() < m_outCount) m_outTo.resize(m_outCount);
+    for (size_t i = first; i < m_outCount; ++i) m_outTo[i] = to;
+}
+
+// ============================================================
+// flush_outgoing - 送信待ちのパケットをまとめて送る
+// 呼び出し側でm_mutexを保持していること
+// ============================================================
+void NetworkManager::flush_outgoing() {
+    if (m_outCount == 0) return;
+    m_fanoutItems.clear();
+    for (size_t i = 0; i < m_outCount; ++i) {
+        m_fanoutItems.push_back({ m_outTo[i], m_outPackets[i].data(),
+            static_cast<int>(m_outPackets[i].size()) });
+    }
+    m_outCount = 0;
+    send_fanout(m_fanoutItems);
+}
+
+// ============================================================
+// send_fanout - itemsをまとめて送る
+// m_linkとm_captureは中で排他するので、m_mutexを持たずに呼んでよい
+// ============================================================
+void NetworkManager::send_fanout(const std::vector<UdpSendItem>& items) {
+    if (items.empty()) return;
+    m_link.send_batch(items.data(), static_cast<int>(items.size()));
+    if (m_capture.is_open()) {
+        for (const UdpSendItem& item : items) {
+            m_capture.record(CAPTURE_SEND, item.to, item.data, item.len);
         }
-        // worldObjectsに見つからなければゼロ位置で送信
-        if (!found) {
-            os.posX = os.posY = os.posZ = 0.0f;
-            os.rotX = os.rotY = os.rotZ = 0.0f;
+    }
+    // 回線状態の再現中は送信待ちの期限が変わったので、ワーカーの待ち時間を決め直させる
+    if (m_link.enabled() && m_workerRunning.load(std::memory_order_relaxed)) m_reactor.wakeup();
+}
+
+// ============================================================
+// flush_links / flush_messages - 全接続に溜まったメッセージを送る
+// 接続ごとに、このティックで溜めたメッセージとRTOを過ぎた信頼メッセージを
+// まとめたパケット（普段は1つ）を作り、受信だけが続いている接続にはACKを返す
+// m_pingIntervalごとに全接続へPINGも送る（RTTの統計用）
+// ============================================================
+void NetworkManager::flush_links() {
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lk(m_mutex);
+
+    const bool sendPing = now - m_lastPing >= m_pingInterval;
+    PacketPing ping;
+    ping.type = PKT_PING;
+    ping.timeUs = time_us32(now);
+    if (sendPing) m_lastPing = now;
+
+    if (m_isHost) {
+        for (auto& c : m_clients) {
+            if (sendPing) queue_via_link(c.link, &ping, (int)sizeof(ping));
+            collect_link(c.link, c.endpoint, now);
         }
-        states.push_back(os);
+    } else if (m_host.is_valid()) {
+        if (sendPing) queue_via_link(m_hostLink, &ping, (int)sizeof(ping));
+        collect_link(m_hostLink, m_host, now);
     }
+    flush_outgoing();
+}
 
-    if (states.empty()) {
-        return;
+void NetworkManager::flush_messages() {
+    m_flushByCaller = true;
+    flush_links();
+}
+
+// ============================================================
+// get_stats - 全接続と受信キューの統計を取り出す
+// ============================================================
+void NetworkManager::get_stats(NetStatsReport& out) {
+    out.time = get_time();
+    out.isHost = m_isHost;
+    out.myPlayerId = m_myPlayerId;
+    // 受信シャードがあれば全キューの合計（溜まった数の最大はキューごとの最大のうち最も大きいもの）
+    out.recvShards = static_cast<int>(m_shards.size()) + 1;
+    out.recvQueueDepth = m_recvQueue.size_approx();
+    out.recvQueueHighWater = m_recvStats.highWater.load(std::memory_order_relaxed);
+    out.recvQueueCapacity = RECV_QUEUE_SIZE;
+    out.recvPackets = m_recvStats.received.load(std::memory_order_relaxed);
+    out.recvDropped = m_recvStats.dropped.load(std::memory_order_relaxed);
+    out.recvShardPackets.assign(1, out.recvPackets);
+    for (const auto& shard : m_shards) {
+        const uint64_t received = shard->stats.received.load(std::memory_order_relaxed);
+        out.recvQueueDepth += shard->queue.size_approx();
+        out.recvQueueHighWater = std::max(out.recvQueueHighWater,
+            shard->stats.highWater.load(std::memory_order_relaxed));
+        out.recvPackets += received;
+        out.recvShardPackets.push_back(received);
+        out.recvDropped += shard->stats.dropped.load(std::memory_order_relaxed);
+    }
+    out.drainLimit = m_drainLimit;
+    out.drainHighWater = m_drainHighWater;
+    out.drainLimited = m_drainLimited;
+    out.stateIntervalMs = (uint32_t)m_stateInterval.count();
+
+    auto now = std::chrono::steady_clock::now();
+    auto add = [&](uint32_t playerId, const Endpoint& endpoint, const ReliableLink& link) {
+        out.connections.emplace_back();
+        NetStatsReport::Connection& c = out.connections.back();
+        c.playerId = playerId;
+        c.endpoint = endpoint;
+        c.ackRttMs = link.rtt_ms();
+        c.rtoMs = link.rto_ms();
+        c.resent = link.resent_count();
+        link.stats().fill(now, c.stats);
+    };
+
+    out.connections.clear();
+    std::lock_guard<std::mutex> lk(m_mutex);
+    out.encodeThreads = m_isHost ? m_encodePool.size() : 0;
+    out.encodeCount = m_encodeCount;
+    out.encodeSeconds = m_encodeSeconds;
+    out.encodeMaxMs = m_encodeMaxSeconds * 1000.0;
+    if (m_isHost) {
+        for (const ClientInfo& c : m_clients) add(c.playerId, c.endpoint, c.link);
+    } else if (m_host.is_valid()) {
+        add(0, m_host, m_hostLink);
     }
+}
 
-    // --- パケットを組み立てて全クライアントに送信 ---
-    PacketStateHeader header;
-    header.type = PKT_STATE;
-    header.seq = m_seq++;
-    header.objectCount = (uint32_t)states.size();
+// ============================================================
+// start_capture / stop_capture / record_capture_role - 送受信のキャプチャ
+// 最初に今の役割を記録するので、起動した後から始めても再生できる
+// ============================================================
+bool NetworkManager::start_capture(const std::string& path) {
+    if (!m_capture.open(path)) return false;
+    record_capture_role();
+    return true;
+}
 
-    std::vector<char> buf(sizeof(header) + states.size() * sizeof(ObjectState));
-    memcpy(buf.data(), &header, sizeof(header));
-    memcpy(buf.data() + sizeof(header), states.data(), states.size() * sizeof(ObjectState));
+void NetworkManager::stop_capture() {
+    m_capture.close();
+}
 
-    for (const auto& c : m_clients) {
-        m_net.send_to(c.ip, c.port, buf.data(), (int)buf.size());
+void NetworkManager::record_capture_role() {
+    if (!m_capture.is_open()) return;
+    if (m_isHost) {
+        const uint8_t hasLocalPlayer = m_hostHasLocalPlayer ? 1 : 0;
+        m_capture.record(CAPTURE_START_HOST, Endpoint(), &hasLocalPlayer, 1);
+    } else {
+        m_capture.record(CAPTURE_START_CLIENT, Endpoint(), nullptr, 0);
     }
 }
+
+// ============================================================
+// set_stats_dump / write_stats_dump - 統計の定期的な書き出し
+// ============================================================
+bool NetworkManager::set_stats_dump(const std::string& path, double intervalSeconds) {
+    if (m_statsDump.is_open()) m_statsDump.close();
+    if (path.empty()) return true;
+
+    m_statsDump.open(path, std::ios::out | std::ios::trunc);
+    m_statsDumpInterval = std::chrono::duration<double>(intervalSeconds > 0.0 ? intervalSeconds : 1.0);
+    m_lastStatsDump = std::chrono::steady_clock::now();
+    return m_statsDump.is_open();
+}
+
+void NetworkManager::write_stats_dump(std::chrono::steady_clock::time_point now) {
+    if (now - m_lastStatsDump < m_statsDumpInterval) return;
+    m_lastStatsDump = now;
+
+    NetStatsReport report;
+    get_stats(report);
+    write_stats_json(report, m_statsDump);
+    m_statsDump.flush();
+}
@@ -9,7 +9,21 @@
 #pragma once
 
 #include "udp_network.h"       // UDPソケットラッパー
+#include "link_conditioner.h"  // 回線状態の再現（遅延・ロスなど、デバッグ用）
 #include "network_common.h"    // パケット構造体・ポート定数
+#include "snapshot_delta.h"    // STATEのデルタ圧縮
+#include "net_reactor.h"       // ソケットの受信待ち（epoll / WSAPoll）
+#include "spsc_ring.h"         // 受信キュー（ロックフリー）
+#include "reliable_link.h"     // ACK・再送・順序保証（接続ごと）
+#include "interpolation_buffer.h"  // 補間の時間軸と表示遅延
+#include "prediction_buffer.h"     // クライアント側予測の入力履歴
+#include "interest_grid.h"         // STATEの関心領域（ホスト）
+#include "snapshot_scheduler.h"    // STATEに載せるオブジェクトの優先度（ホスト）
+#include "net_stats.h"             // 通信の統計（NetStatsReport）
+#include "net_capture.h"           // 送受信のキャプチャ
+#include "triple_buffer.h"         // メインスレッド→ワーカーのワールドスナップショット（ロックフリー）
+#include "net_task_pool.h"         // STATEの並列符号化（ホスト）
+#include <deque>
 #include <vector>
 #include <unordered_map>
 #include <memory>              // std::shared_ptr
@@ -17,11 +31,24 @@
 #include <chrono>              // 時刻計測
 #include <thread>              // std::thread（ワーカースレッド）
 #include <condition_variable>
-#include <deque>               // 受信キュー
 #include <atomic>              // std::atomic（スレッド間フラグ）
+#include <fstream>             // 統計の書き出し先
+#include <functional>          // std::function（探索の結果）
 
  // GameObjectの前方宣言（ヘッダーの相互依存を避ける）
-namespace Game { class GameObject; }
+namespace Game { class GameObject; class Player; class PlayerManager; }
+
+// ============================================================
+// DiscoveredHost 構造体
+// 探索で応答したホスト1つ分
+// ============================================================
+struct DiscoveredHost {
+    Endpoint endpoint;        // ゲーム通信ポート（JOINの宛先）
+    int channel = 0;          // ホストのチャンネル番号
+    uint32_t playerCount = 0; // 参加しているプレイヤー数（ホスト自身を含む）
+    uint32_t maxPlayers = 0;
+    float rttMs = 0.0f;       // 探索要求を送ってから応答が届くまで（ミリ秒）
+};
 
 // ============================================================
 // NetworkManager クラス
@@ -34,34 +61,93 @@ namespace Game { class GameObject; }
 // ============================================================
 class NetworkManager {
 public:
-    NetworkManager();
+    // transport: ゲーム通信に使うNetTransport（nullptrなら自前のUDPソケット）
+    // LoopbackTransportを渡すと、ソケットも探索も使わずに同じプロセス内の
+    // 別のNetworkManagerと通信する（テスト・ベンチマーク用、g_networkとは別に作れる）
+    explicit NetworkManager(NetTransport* transport = nullptr);
     ~NetworkManager();
+    NetworkManager(const NetworkManager&) = delete;
+    NetworkManager& operator=(const NetworkManager&) = delete;
 
     // ----------------------------------------------------------
     // 起動・接続
     // ----------------------------------------------------------
 
     // ホストとして起動する（ソケット初期化→ワーカースレッド開始）
-    bool start_as_host();
+    // 外から渡したNetTransportを使う場合、ソケットの初期化は行わない
+    // hasLocalPlayer: ホスト自身がID=1のプレイヤーを操作するか
+    //                 （falseなら専用サーバー。ID=1からクライアントに割り当てる）
+    bool start_as_host(bool hasLocalPlayer = true);
 
     // クライアントとして起動する（動的ポートで初期化→ワーカースレッド開始）
     bool start_as_client();
 
-    // クライアント用: ブロードキャストでホストを探してJOINを送る（ブロッキング）
-    // 成功時、out_host_ipにホストのIPアドレスが入る
-    bool discover_and_join(std::string& out_host_ip);
+    // 探索の結果（found = falseならタイムアウトで、hostは使わない）
+    using DiscoveryCallback = std::function<void(bool found, const DiscoveredHost& host)>;
+
+    // クライアント用: ホストを探し、見つかったらJOINを送る（ブロッキングしない）
+    // 全チャンネルの探索ポートへ同時にブロードキャストし、空きのあるホストから
+    // 最初に届いた応答へJOINして onDone(true, host) を呼ぶ（参加までの時間はほぼ1往復）。
+    // DISCOVERY_TIMEOUT_MSの間どこからも応答が無ければ onDone(false, ...) を呼ぶ。
+    // onDoneはupdate() / service()の中（メインスレッド）から呼ばれる
+    // 戻り値: 探索を始められたか（探索ソケットが無ければfalse）
+    bool start_discovery(DiscoveryCallback onDone);
+
+    // 探索中か（start_discoveryの結果がまだ出ていない）
+    bool is_discovering() const { return m_discovering; }
+
+    // 探索で応答したホストの一覧（届いた順、JOINした後も集め続ける）
+    const std::vector<DiscoveredHost>& get_discovered_hosts() const { return m_discoveredHosts; }
+
+    // クライアント用: 探索せずに指定したホスト（のゲーム通信ポート）へJOINを送る
+    void join(const Endpoint& host);
+
+    // ゲーム通信に使うNetTransportを差し替える（nullptrなら自前のUDPソケット）
+    // start_as_host / start_as_client より前に呼ぶ。g_networkをループバックで動かすときに使う
+    void set_transport(NetTransport* transport);
+
+    // falseにすると、クライアントとしてPlayerManager・BulletManagerに触れなくなる
+    // （受け取った状態を表示せず、予測の照合もしない）
+    // ホストと同じプロセスで動かすボットのクライアント用。start_as_clientより前に呼ぶ
+    void set_game_binding(bool enabled) { m_gameBinding = enabled; }
+
+    // 入力の適用・予測・出現に使うPlayerManager（nullptrならPlayerManager::GetInstance()）
+    // ホストとクライアントのワールドを同じプロセスで分けて動かすとき（自己テスト）に別のものを渡す
+    void set_player_manager(Game::PlayerManager* players) { m_players = players; }
 
     // ----------------------------------------------------------
     // 毎フレーム処理
     // ----------------------------------------------------------
 
     // メインスレッドから毎フレーム呼ぶ。キューに溜まったパケットを処理する
+    // 待つためのソケットが無いNetTransport（LoopbackTransport）では、ここで受信も行う
     // dt: デルタタイム（現状未使用だが将来の補間用に渡す）
     void update(float dt, Game::GameObject* localPlayer,
         std::vector<std::shared_ptr<Game::GameObject>>& worldObjects);
 
-    // クライアントの入力をホストへ送信する
-    void send_input(const PacketInput& input);
+    // update()のうち受信パケットの処理と再送・ACKの送信だけを行う（ホストは入力を適用しない）
+    // 専用サーバーが、シミュレーションのステップが無いティックで呼ぶ
+    void service(Game::GameObject* localPlayer,
+        std::vector<std::shared_ptr<Game::GameObject>>& worldObjects);
+
+    // このティックで溜めた送信（入力・弾・STATE・STATEのACKなど）を、接続ごとに
+    // まとめたパケット（普段は1つ）にして送る。送信を済ませた後、ティックの最後に呼ぶ
+    // 一度呼ぶと、以降のupdate() / service()は送信をせず、毎ティックここで送る前提になる
+    // （呼ばなければ、これまでどおりupdate() / service()の中で送る）
+    void flush_messages();
+
+    // クライアントの入力をホストへ送信する（1ティックに1回）
+    // seqを割り当て、ホストが受け取るのと同じ量子化後の値でinputを書き換えて返す
+    // 呼び出し側はその値でローカルのプレイヤーを動かす（クライアント側予測）
+    void send_input(PacketInput& input);
+
+    // クライアント: 1つのINPUTに載せる入力の数（1-NetCodec::MAX_INPUTS_PER_PACKET、1なら控えを載せない）
+    // 最新の入力に、ホストがまだ処理していない直前の入力をcount - 1個まで添えて送る
+    void set_input_redundancy(int count);
+
+    // クライアント: 今回の入力を適用した後のプレイヤーの状態を予測として記録する
+    // プレイヤーの更新（Player::Update）の後に毎ティック呼ぶ。ホストでは何もしない
+    void store_predicted_state();
 
     // 現在ホストモードかどうかを返す
     bool is_host() const { return m_isHost; }
@@ -69,10 +155,60 @@ public:
     // サーバーから割り当てられた自分のプレイヤーIDを取得する
     uint32_t getMyPlayerId() const;
 
-    // フレーム同期: Nフレームごとに呼び出し、位置情報を送受信する
-    // （例: 60FPSで10フレームごと = 6Hz）
-    void FrameSync(Game::GameObject* localPlayer,
-        std::vector<std::shared_ptr<Game::GameObject>>& worldObjects);
+    // ホスト: 参加済み（プレイヤーIDを割り当てた）クライアントの数
+    size_t get_client_count();
+
+    // クライアント: ホストが満員でJOINを断られたか（join()で戻す）
+    bool is_join_rejected() const { return m_joinRejected; }
+
+    // クライアント: 復元できたSTATEの数
+    uint64_t get_states_received() const { return m_statesReceived; }
+
+    // クライアント: 予測がホストの結果とずれて巻き戻した回数
+    uint64_t get_prediction_corrections() const { return m_prediction.correction_count(); }
+
+    // ホスト: playerIdのクライアントの入力を最後にどこまで処理したか（publish_snapshotで更新する）
+    // まだ1つも処理していなければfalse。予測とホストの結果を入力ごとに比べるのに使う
+    bool get_input_ack_seq(uint32_t playerId, uint32_t& seq) const;
+
+    // ネットワーク時刻（起動からの経過秒、補間バッファの時間軸）
+    double get_time() const;
+
+    // リモートオブジェクトを表示する時刻（get_time()から表示遅延を引いたもの）
+    // 遅延はホストから届くSTATEのジッターに合わせて調整する（ホストでは遅延なし）
+    double get_render_time();
+
+    // 撃った瞬間に見ていたホストの時刻（PacketBullet::viewTime、ラグ補償用）
+    // クライアントは補間で少し過去のホストを見ているので、表示時刻をホストの時間軸に戻す
+    uint16_t get_view_time_ms16();
+
+    // ホスト: 出現中の全プレイヤーの状態をスナップショットとして公開する（クライアントでは何もしない）
+    // シミュレーションを進めた後、ティックの最後に毎ティック呼ぶ。状態を写すだけで、
+    // STATEの符号化と送信はワーカースレッドがset_state_send_intervalの間隔で最新のものから行う
+    void publish_snapshot();
+
+    // ホスト: STATEを送る間隔（既定100ms = 10Hz）
+    // 新しいスナップショットが公開されていなければ、m_stateIntervalまで同じものを送り直さない
+    void set_state_send_interval(std::chrono::milliseconds interval) { m_stateSendInterval = interval; }
+
+    // ホスト: クライアントごとのSTATEを符号化するスレッドの数（送信するワーカースレッドを含む）
+    // 1なら追加のスレッドを作らない（既定）、0なら論理コア数。start_as_hostより前に呼ぶ
+    void set_encode_threads(int threads) { m_encodeThreads = threads; }
+
+    // ホスト（Linux）: ゲーム通信ポートをSO_REUSEPORTでcount個のソケットに分けて受信する
+    // ソケットごとに専用の受信スレッドと受信キューを持ち、1つのスレッドの受信が上限にならないようにする。
+    // カーネルは送信元（アドレスとポート）ごとに同じソケットへ振り分けるので、1つのクライアントの
+    // パケットはいつも同じシャードに届き、順序は変わらない（送信は最初のソケットから行う）。
+    // 1なら分けない（既定、1 - MAX_RECV_SHARDS）。start_as_hostより前に呼ぶ
+    // SO_REUSEPORTが無い環境・外から渡したNetTransport・回線状態の再現中は1つのまま
+    static const int MAX_RECV_SHARDS = 8;
+    void set_receive_shards(int count);
+
+    // ベンチマーク用: ゲーム通信のソケットから受信したパケットを受信キューに積む直前に呼ぶ
+    // （ワーカースレッド・受信シャードのスレッドから呼ばれる）。start_as_hostより前に呼ぶ
+    // 受信からキューに積むまでの遅れを、パケットに書いた送信時刻と比べて測るのに使う
+    using RecvProbe = std::function<void(const char* data, int len)>;
+    void set_recv_probe(RecvProbe probe) { m_recvProbe = std::move(probe); }
 
     // ----------------------------------------------------------
     // チャンネル管理（ポートが塞がっている場合の代替手段）
@@ -82,12 +218,14 @@ public:
     bool try_alternative_channels();
 
     // 各チャンネルの使用状況をスキャンする（30秒間隔で実行）
+    // 全チャンネルへ探索要求を送るだけで、応答はupdate()の中でチャンネル情報に反映される
     void scan_channel_usage();
 
-    // 最もユーザーが少ないチャンネル番号を返す
+    // 最もユーザーが少ないチャンネル番号を返す（応答の無かったチャンネルは0人として扱う）
     int find_least_crowded_channel();
 
     // 指定チャンネルに切り替える（ソケットを再初期化する）
+    // 新しいポートを開けなければ元のポートで開き直し、受信も再開してfalseを返す
     bool switch_to_channel(int channelId);
 
     // ----------------------------------------------------------
@@ -108,123 +246,417 @@ public:
     // 弾の発射情報を送信する（ホスト: 全クライアントへ、クライアント: ホストへ）
     void send_bullet(const PacketBullet& pb);
 
+    // ----------------------------------------------------------
+    // 回線状態の再現（デバッグ用）
+    // ----------------------------------------------------------
+
+    // ゲーム通信ソケットの送受信に遅延・ロスなどを掛ける（何も付いていなければ素通し）
+    // 起動時に環境変数 NET_CONDITIONER（LinkConditions::parseの形式）があればそれを使う
+    void set_link_conditions(const LinkConditions& conditions);
+    LinkConditions get_link_conditions() const { return m_link.get_conditions(); }
+    LinkStats get_link_outgoing_stats() const { return m_link.get_outgoing_stats(); }
+    LinkStats get_link_incoming_stats() const { return m_link.get_incoming_stats(); }
+
+    // ----------------------------------------------------------
+    // 通信の統計
+    // ----------------------------------------------------------
+
+    // 全接続のRTT・ロス・帯域と、受信キューの深さを取り出す（メインスレッドから呼ぶ）
+    void get_stats(NetStatsReport& out);
+
+    // intervalSeconds秒ごとにget_stats()の結果をpathへJSON Lines（1行1回分）で書き出す
+    // 書き出しはservice()の中で行う。pathが空なら止める。戻り値: ファイルを開けたか
+    // 起動時に環境変数 NET_STATS_DUMP（ファイル名）があれば1秒ごとに書き出す
+    bool set_stats_dump(const std::string& path, double intervalSeconds = 1.0);
+
+    // ----------------------------------------------------------
+    // キャプチャ（不具合の再現・受信処理のベンチマーク用）
+    // ----------------------------------------------------------
+
+    // 送受信したデータグラムをすべてpathに記録する（書き込みは別スレッド、形式はnet_capture.h）
+    // 起動時に環境変数 NET_CAPTURE（ファイル名）があれば最初から記録する
+    bool start_capture(const std::string& path);
+    void stop_capture();
+    bool is_capturing() const { return m_capture.is_open(); }
+
+    // キャプチャの再生用: 受信キューから取り出したのと同じように1パケットを処理する
+    // 受信キュー・ソケットを通さないので、ワーカースレッドが止まっていても（LoopbackTransport）使える
+    void replay_received(const char* data, int len, const Endpoint& from, bool isDiscovery,
+        Game::GameObject* localPlayer,
+        std::vector<std::shared_ptr<Game::GameObject>>& worldObjects);
+
 private:
     // ----------------------------------------------------------
     // ソケット
     // ----------------------------------------------------------
     UdpNetwork m_net;        // ゲーム通信用ソケット（NET_PORT）
     UdpNetwork m_discovery;  // ホスト探索用ソケット（DISCOVERY_PORT）
+    LinkConditioner m_link;  // ゲーム通信の送受信はすべてこれを通す（条件が無ければ素通し）
+    bool m_externalTransport = false;  // trueならm_netを使わず、コンストラクタで渡されたNetTransportを使う
     bool m_isHost = false;   // trueならホスト、falseならクライアント
+    bool m_hostHasLocalPlayer = true;  // ホスト: 自分のプレイヤー（ID=1）がいるか
 
     // ----------------------------------------------------------
     // スレッド安全用ミューテックス
     // ----------------------------------------------------------
-    std::mutex m_mutex;  // m_clients, m_seq などの保護用
+    std::mutex m_mutex;  // m_clients, m_seq, m_hostLink, 送信用の作業バッファなどの保護用
 
     // ----------------------------------------------------------
     // ホスト側のデータ
     // ----------------------------------------------------------
 
+    // クライアントごとのSTATEの送信の流れ（差分の履歴と優先度）
+    // ClientInfoとStateJobで共有し、送信するワーカーだけがm_mutexを持たずに触る
+    struct StateStream {
+        SnapshotDelta snapshots;      // このクライアントへのSTATE送信履歴（デルタ圧縮用）
+        SnapshotScheduler scheduler;  // このクライアントに送るオブジェクトの優先度
+    };
+
     // 接続中のクライアント情報
     struct ClientInfo {
-        std::string ip;       // クライアントのIPアドレス
-        int port;             // クライアントのポート番号
+        Endpoint endpoint;    // クライアントのアドレスとポート
         uint32_t playerId;    // 割り当てたプレイヤーID
-        std::chrono::steady_clock::time_point lastSeen;  // 最終通信時刻
+        std::chrono::steady_clock::time_point lastSeen;  // 最終通信時刻（CLIENT_TIMEOUTを過ぎたら切断する）
+        ReliableLink link;        // このクライアントとのACK・再送の状態
+        std::shared_ptr<StateStream> stream;             // STATEの送信の流れ（add_clientで作る）
+        uint32_t stateAck = SnapshotDelta::NO_BASELINE;  // ACKされた最新のSTATEのseq（次の符号化で反映する）
+
+        // 入力（ホストが1ティックに1つずつ、そのクライアントのプレイヤーに適用する）
+        std::deque<PacketInput> inputQueue;  // 届いたがまだ適用していない入力
+        bool hasQueuedInput = false;         // 1つでも受け取ったか
+        uint32_t lastQueuedInputSeq = 0;     // 最後に受け取った入力のseq（古い・重複を捨てる）
+        PacketInput lastAppliedInput = {};   // 最後に適用した入力（届いていないティックはこれを繰り返す）
+        bool hasAppliedInput = false;
     };
     std::vector<ClientInfo> m_clients;   // 接続中クライアントのリスト
-    uint32_t m_nextPlayerId = 1;         // 次に割り当てるプレイヤーID
+    std::unordered_map<Endpoint, size_t, EndpointHash> m_clientByEndpoint;  // 送信元→m_clientsの添字
+    std::unordered_map<uint32_t, size_t> m_clientByPlayerId;               // playerId→m_clientsの添字
+    std::vector<UdpSendItem> m_fanoutItems;       // まとめて送信する作業用（send_batchに渡す一覧）
+    InterestGrid m_interest;                      // STATEの関心領域（クライアントごとに送るオブジェクトを選ぶ）
+
+    // STATEの符号化（send_states_to_clients）
+    // m_mutexを持って接続の一覧をStateJobに写し、ロックを外してからクライアントを
+    // m_encodePoolのスレッドで分けて符号化する。作業用バッファはスレッドごとに持つ
+    struct alignas(64) EncodeScratch {
+        std::vector<InterestGrid::Relevant> relevant;  // 1クライアント分の送る候補
+        std::vector<ObjectState> clientStates;         // 1クライアント分の送る状態（優先度順）
+        std::vector<uint32_t> sendOrder;               // 優先度順のstatesの添字
+        std::vector<uint8_t> sentCurrent;              // 受信側が最新になったか（clientStatesと同じ並び）
+    };
+    // 1クライアント分の符号化に使う接続の写しと結果
+    struct StateJob {
+        std::shared_ptr<StateStream> stream;
+        Endpoint endpoint;
+        uint32_t playerId = 0;
+        uint32_t ackedSeq = SnapshotDelta::NO_BASELINE;  // ClientInfo::stateAckの写し
+        int viewIndex = -1;           // states内でのこのクライアントのプレイヤーの位置（関心領域の視点）
+        std::vector<char> encodeBuf;  // 符号化したSTATE（ReliableLinkのヘッダーを付ける前）
+    };
+    int m_encodeThreads = 1;                      // set_encode_threads
+    NetTaskPool m_encodePool;
+    // ここから m_lastStateTime までは送信するワーカー専用（m_mutexで保護しない）
+    std::vector<EncodeScratch> m_encodeScratch;   // 添字 = m_encodePoolのworker
+    std::vector<StateJob> m_stateJobs;            // 添字 = 写したときのm_clientsの添字
+    std::vector<std::vector<char>> m_statePackets;  // STATEを載せたパケット（先頭m_statePacketCount個が有効）
+    std::vector<Endpoint> m_statePacketTo;        // 各パケットの宛先
+    size_t m_statePacketCount = 0;
+    std::vector<UdpSendItem> m_stateFanout;       // STATEのパケットをsend_batchに渡す一覧
+    double m_lastStateTime = -1.0;                // 前回send_states_to_clients()した時刻（優先度の積み上げ用）
+    // 符号化にかかった時間（起動してから、m_mutexで保護）
+    uint64_t m_encodeCount = 0;
+    double m_encodeSeconds = 0.0;
+    double m_encodeMaxSeconds = 0.0;
+
+    // ホスト: ティックの終わりにメインスレッドが公開するワールドのスナップショット
+    // ワーカースレッドは最新のものだけを取り出し、ゲームのオブジェクトには触れずにSTATEを作る
+    struct WorldSnapshot {
+        uint16_t timeMs = 0;                  // 公開した時刻（STATEに載せる送信時刻、time_ms16()）
+        std::vector<ObjectState> states;      // 出現中の全プレイヤーの状態
+        std::vector<InputAck> inputAcks;      // statesと同じ並び: そのプレイヤーのクライアントへ返す処理結果
+        std::vector<uint8_t> hasInputAck;     // statesと同じ並び: inputAcksが有効か
+    };
+    TripleBuffer<WorldSnapshot> m_snapshots;
+    // ワーカーが送る時刻を過ぎても新しいスナップショットが無く、publish_snapshot()に起こしてもらうのを待っている
+    std::atomic<bool> m_snapshotWanted{ false };
+
+    // ホスト: 入力の処理結果（添字 = プレイヤーID、メインスレッド専用）
+    // host_apply_inputsで適用した入力のseqを覚え、シミュレーション後の状態と一緒に公開する
+    struct AppliedInput {
+        bool applied = false;   // このティックで入力を適用した（まだ公開していない）
+        uint32_t seq = 0;       // 適用した入力のseq
+        bool hasAck = false;    // ackが有効か
+        InputAck ack = {};      // 最後に公開した処理結果
+    };
+    AppliedInput m_appliedInputs[MAX_PLAYERS + 1];
+    uint64_t m_usedPlayerIds = 0;        // 使用中のプレイヤーID（ビット = ID - 1）
+    std::chrono::steady_clock::time_point m_lastTimeoutCheck;  // 前回タイムアウトを確認した時刻
     uint32_t m_seq = 0;                  // パケットのシーケンス番号（送信ごとにインクリメント）
 
     // ----------------------------------------------------------
     // クライアント側のデータ
     // ----------------------------------------------------------
-    std::string m_hostIp;              // 接続先ホストのIPアドレス
-    int m_hostPort = NET_PORT;         // 接続先ホストのポート番号
+    Endpoint m_host;                   // 接続先ホストのアドレスとポート（未設定=探索前）
     uint32_t m_myPlayerId = 0;         // サーバーから割り当てられた自分のID（0=未参加）
+    bool m_joinRejected = false;       // JOIN_ACKで断られた（満員）
+    SnapshotDelta m_hostSnapshots;     // ホストとのSTATE送受信履歴（デルタ圧縮用）
+    ReliableLink m_hostLink;           // ホストとのACK・再送の状態
+    PlayoutClock m_hostPlayout;        // ホストから届くSTATEの時間軸と表示遅延（メインスレッド専用）
+    PredictionBuffer m_prediction;     // 送った入力と予測結果（メインスレッド専用）
+    uint32_t m_inputSeq = 0;           // 最後に送った入力のseq
+    int m_inputRedundancy = 4;         // 1つのINPUTに載せる入力の数（最新 + 控え）
+    uint64_t m_statesReceived = 0;     // 復元できたSTATEの数
+    bool m_gameBinding = true;         // falseならPlayerManager・BulletManagerに触れない（ボット用）
+    Game::PlayerManager* m_players = nullptr;  // set_player_manager（nullptrならシングルトン）
+
+    // 使うPlayerManager（m_playersかシングルトン）
+    Game::PlayerManager& player_manager();
+
+    // ネットワーク時刻の基準（STATEに載せる送信時刻と補間の時間軸）
+    std::chrono::steady_clock::time_point m_clockStart;
+
+    // STATEに載せる送信時刻（ミリ秒の下位16ビット）
+    uint16_t time_ms16() const;
+
+    // ----------------------------------------------------------
+    // 送信待ちパケット（ReliableLinkのヘッダー付き、m_mutexで保護）
+    // メッセージは送るたびにReliableLinkに溜め、flush_links()で接続ごとに
+    // パケットにまとめてここに並べる（collect_link）
+    // 要素は使い回して毎回確保し直さない。flush_outgoing()でまとめて送る
+    // ----------------------------------------------------------
+    std::vector<std::vector<char>> m_outPackets;  // パケット本体（先頭m_outCount個が有効）
+    std::vector<Endpoint> m_outTo;                // 各パケットの宛先
+    size_t m_outCount = 0;
+    bool m_flushByCaller = false;                 // flush_messages()が呼ばれた（送信はティックの終わりにまとめる）
+    std::vector<MessageView> m_messages;          // 受信: パケットから取り出した非信頼メッセージ（メインスレッド専用）
+    std::vector<std::vector<char>> m_delivered;   // 受信: 並べ替えが済んだ信頼メッセージ（メインスレッド専用）
 
     // ----------------------------------------------------------
     // チャンネル管理
     // ----------------------------------------------------------
-    int m_currentChannel = 0;          // 現在使用中のチャンネル番号
+    std::atomic<int> m_currentChannel{ 0 };  // 現在使用中のチャンネル番号（ワーカーの探索の応答でも読む）
     std::vector<ChannelInfo> m_channelInfo;  // スキャン結果のチャンネル情報一覧
     std::chrono::steady_clock::time_point m_lastChannelScan;  // 最後にスキャンした時刻
 
+    // ----------------------------------------------------------
+    // ホストの探索（クライアント、メインスレッド専用）
+    // ----------------------------------------------------------
+    static const int DISCOVERY_TIMEOUT_MS = 1500;  // 応答を待つ時間
+    static const int DISCOVERY_RESEND_MS = 300;    // 要求を送り直す間隔（ブロードキャストのロス対策）
+    bool m_discovering = false;
+    DiscoveryCallback m_discoveryDone;
+    std::chrono::steady_clock::time_point m_discoveryStart;
+    std::chrono::steady_clock::time_point m_lastDiscoverySend;
+    std::vector<DiscoveredHost> m_discoveredHosts;
+
     // ----------------------------------------------------------
     // 受信パケットキュー
     // ワーカースレッドが受信してキューに積み、
     // メインスレッドのupdate()で取り出して処理する
+    // スロットは事前確保され、ワーカーがrecvfromで直接書き込む（受信ごとの確保なし）
     // ----------------------------------------------------------
     struct RecvPacket {
-        std::vector<char> data;  // 受信データ本体
-        int len;                 // データ長
-        std::string from_ip;     // 送信元IPアドレス
-        int from_port;           // 送信元ポート番号
-        bool isDiscovery;        // 探索ソケットからの受信かどうか
+        Endpoint from;               // 送信元
+        uint16_t len;                // データ長
+        bool isDiscovery;            // 探索ソケットからの受信かどうか
+        char data[MAX_UDP_PACKET];   // 受信データ本体
+    };
+    static const size_t RECV_QUEUE_SIZE = 1024;  // キューの容量（2の累乗）
+    typedef SpscRing<RecvPacket, RECV_QUEUE_SIZE> RecvQueue;
+
+    // 受信キュー1つ分の統計（書くのはそのキューに積むスレッドだけ）
+    struct RecvQueueStats {
+        std::atomic<uint64_t> received{ 0 };   // キューに積んだパケット数
+        std::atomic<uint64_t> dropped{ 0 };    // キュー満杯で捨てたパケット数
+        std::atomic<size_t> highWater{ 0 };    // キューに溜まった数の最大
+    };
+    RecvQueue m_recvQueue;          // ワーカー→メインの受信キュー
+    RecvQueueStats m_recvStats;     // m_recvQueueの統計
+    RecvProbe m_recvProbe;          // set_recv_probe（空なら呼ばない）
+
+    // ----------------------------------------------------------
+    // 受信シャード（set_receive_shards、ホストのみ）
+    // 2つ目以降のSO_REUSEPORTのソケットと、それぞれの受信スレッド・受信キュー
+    // 1つ目はm_netで、これまでどおりワーカースレッドがm_recvQueueに積む
+    // ----------------------------------------------------------
+    struct RecvShard {
+        UdpNetwork socket;
+        NetReactor reactor;          // このソケットと起床通知だけを待つ
+        std::thread thread;
+        RecvQueue queue;             // シャードの受信スレッド→メインの受信キュー
+        RecvQueueStats stats;
     };
-    std::deque<RecvPacket> m_recvQueue;  // 受信パケットのキュー（先入れ先出し）
-    std::mutex m_recvMutex;              // キュー操作用ミューテックス
-    std::condition_variable m_recvCv;    // キュー通知用（将来のブロッキング受信用）
+    int m_recvShardCount = 1;                          // set_receive_shards
+    std::vector<std::unique_ptr<RecvShard>> m_shards;  // 開けたシャード（1つ目のm_netは含まない）
+    size_t m_drainShard = 0;                           // service()で最初に取り出すキュー（順に回す）
+    // service()の受信処理（メインスレッド専用）
+    size_t m_drainLimit = 0;        // 直前のservice()で処理する上限
+    size_t m_drainHighWater = 0;    // 1回のservice()で処理した数の最大
+    uint64_t m_drainLimited = 0;    // 上限で打ち切ってキューに残した回数
 
     // ----------------------------------------------------------
     // ワーカースレッド
     // ----------------------------------------------------------
-    std::thread m_worker;                // 受信ポーリング用のバックグラウンドスレッド
+    std::thread m_worker;                // 受信用のバックグラウンドスレッド
     std::atomic<bool> m_workerRunning{ false };  // スレッド動作フラグ
+    NetReactor m_reactor;                // 両ソケットと起床通知をまとめて待つ
+
+    // NetReactorに登録するソケットの識別子
+    enum ReactorTag {
+        REACTOR_TAG_GAME = 0,       // ゲーム通信ソケット（m_net）
+        REACTOR_TAG_DISCOVERY = 1,  // 探索ソケット（m_discovery）
+    };
 
     // ----------------------------------------------------------
     // パフォーマンス・調整パラメータ
     // ----------------------------------------------------------
     size_t m_maxPacketsPerFrame = 8;    // 1フレームで処理する最大パケット数
-    std::chrono::milliseconds m_stateInterval{ 200 };  // ホストがSTATEを送信する間隔
-    size_t m_stateSendIndex = 0;        // ラウンドロビン送信のインデックス
+    // ホスト: 1クライアントあたり1フレームで追加で処理するパケット数（入力・ACK・再送）
+    static const size_t PACKETS_PER_CLIENT_PER_FRAME = 4;
+    std::chrono::seconds m_clientTimeout{ 10 };  // これだけ何も届かないクライアントは切断する
+    std::chrono::milliseconds m_stateSendInterval{ 100 };  // ホスト: ワーカーがSTATEを送る間隔
+    std::chrono::milliseconds m_stateInterval{ 200 };  // 新しいスナップショットが無いときに同じものを送り直す間隔（キープアライブ）
+    int m_stateBytesPerSecond = 16 * 1024;  // 1クライアントあたりのSTATEの帯域（バイト/秒）
+    std::chrono::milliseconds m_pingInterval{ 1000 };  // 各接続にPINGを送ってRTTを測る間隔
+    std::chrono::steady_clock::time_point m_lastPing;  // 前回PINGを送った時刻（m_mutexで保護）
 
     // ----------------------------------------------------------
     // パケット処理（private関数）
     // ----------------------------------------------------------
 
     // 受信パケットを種別に応じて振り分ける（メインスレッドで呼ばれる）
-    void process_received(const char* buf, int len,
-        const std::string& from_ip, int from_port,
+    void process_received(const char* buf, int len, const Endpoint& from,
         Game::GameObject* localPlayer,
         std::vector<std::shared_ptr<Game::GameObject>>& worldObjects);
 
     // ホスト: JOINパケットを受信した時の処理（ID割り当て・ACK送信）
-    void host_handle_join(const std::string& from_ip, int from_port,
+    void host_handle_join(const Endpoint& from,
         std::vector<std::shared_ptr<Game::GameObject>>& worldObjects);
 
-    // ホスト: INPUTパケットを受信した時の処理（プレイヤー移動を適用）
-    void host_handle_input(const PacketInput& pi,
+    // ホスト: INPUTパケットを受信した時の処理（送信元クライアントの入力キューに積む）
+    void host_handle_input(const PacketInput* inputs, int count, const Endpoint& from);
+
+    // ホスト: 各クライアントの入力を1ティック分ずつプレイヤーに適用する（毎フレーム）
+    // 直前のティックの結果はSTATEで返すInputAckとして記録する
+    void host_apply_inputs();
+
+    // クライアント: ホストの結果と予測を照合し、ずれていれば巻き戻して未処理の入力を再適用する
+    void client_reconcile(const ObjectState& authoritative, const InputAck& ack);
+
+    // クライアント: STATEパケットを復元した後の処理（他プレイヤーの補間バッファに追加）
+    // time: このスナップショットのローカル時刻
+    void client_handle_state(const std::vector<ObjectState>& states, double time,
+        Game::GameObject* localPlayer,
         std::vector<std::shared_ptr<Game::GameObject>>& worldObjects);
 
-    // クライアント: STATEパケットを受信した時の処理（他プレイヤーの位置を更新）
-    void client_handle_state(const PacketStateHeader& hdr, const ObjectState* entries,
+    // PKT_PINGにPKT_PONGを返す / PKT_PONGからRTTを測って接続の統計に入れる
+    // RTTには相手がPINGを取り出すまでの待ち（最大で相手の1フレーム）も含まれる
+    void handle_ping(const char* buf, int len, const Endpoint& from);
+
+    // PacketPing::timeUsに入れる時刻（ネットワーク時刻のマイクロ秒の下位32ビット）
+    uint32_t time_us32(std::chrono::steady_clock::time_point now) const;
+
+    // 復元できたSTATEのシーケンス番号を送信元にACKとして返す
+    void send_state_ack(const Endpoint& to, uint32_t seq);
+
+    // 受信キューから取り出した1パケットを（キャプチャ中なら記録してから）振り分ける
+    void handle_received(const char* data, int len, const Endpoint& from, bool isDiscovery,
         Game::GameObject* localPlayer,
         std::vector<std::shared_ptr<Game::GameObject>>& worldObjects);
 
-    // ホスト: 全クライアントに全オブジェクトの状態を送信する
-    void send_state_to_all(std::vector<std::shared_ptr<Game::GameObject>>& worldObjects);
+    // ゲーム通信ソケットで受信したパケットを送信元のReliableLinkに通し、
+    // 取り出せたメッセージをprocess_receivedに渡す
+    void receive_game_packet(const char* data, int len, const Endpoint& from,
+        Game::GameObject* localPlayer,
+        std::vector<std::shared_ptr<Game::GameObject>>& worldObjects);
+
+    // ----------------------------------------------------------
+    // ReliableLink経由の送信
+    // ----------------------------------------------------------
+
+    // 宛先とのReliableLinkを返す（m_mutexを保持して呼ぶ、未接続ならnullptr）
+    ReliableLink* find_link(const Endpoint& to);
+
+    // 宛先のReliableLinkに1つ溜める（パケット種別で信頼/非信頼を選ぶ、送るのはflush_links）
+    void send_packet(const Endpoint& to, const void* data, int len);
+
+    // 以下はm_mutexを保持して呼ぶ
+    // パケット種別に応じて接続の信頼 / 非信頼のキューに溜める
+    void queue_via_link(ReliableLink& link, const void* data, int len);
+    // 接続に溜まったメッセージと再送をパケットにまとめ、ACK専用パケットと合わせて送信待ちに加える
+    void collect_link(ReliableLink& link, const Endpoint& to,
+        std::chrono::steady_clock::time_point now);
+    // 送信待ちのパケットをsend_batchでまとめて送る
+    void flush_outgoing();
+    // itemsの一覧をsend_batchで送り、キャプチャ中なら記録する
+    // （m_linkとm_captureはスレッドセーフなので、m_mutexを持たずに呼んでよい）
+    void send_fanout(const std::vector<UdpSendItem>& items);
+
+    // 全接続の再送・ACKと、m_pingIntervalごとのPINGを処理する（メインスレッドから毎フレーム）
+    void flush_links();
+
+    // ホスト: 送信元/プレイヤーIDからクライアントを探す（m_mutexを保持して呼ぶ、無ければnullptr）
+    ClientInfo* find_client(const Endpoint& ep);
+    ClientInfo* find_client_by_player(uint32_t playerId);
+
+    // ホスト: クライアントを追加して索引に登録する（m_mutexを保持して呼ぶ）
+    ClientInfo& add_client(const Endpoint& ep, uint32_t playerId);
+
+    // ホスト: クライアントを外して索引を直す（m_mutexを保持して呼ぶ、末尾と入れ替える）
+    void remove_client(size_t index);
+
+    // ホスト: 空いているプレイヤーIDを確保する / 返す（m_mutexを保持して呼ぶ、満員なら0）
+    uint32_t allocate_player_id();
+    void release_player_id(uint32_t playerId);
+
+    // ホスト: m_clientTimeoutの間何も届いていないクライアントを切断し、プレイヤーを消す
+    // （1秒に1回だけ確認する）
+    void host_check_timeouts(std::vector<std::shared_ptr<Game::GameObject>>& worldObjects);
+
+    // プレイヤーを出現させてworldObjectsに加える / 消してworldObjectsから外す
+    // （出現済みならそのまま返す、m_mutexを保持せずに呼ぶ）
+    Game::Player* spawn_player(uint32_t playerId,
+        std::vector<std::shared_ptr<Game::GameObject>>& worldObjects);
+    void despawn_player(uint32_t playerId,
+        std::vector<std::shared_ptr<Game::GameObject>>& worldObjects);
+
+    // ホスト: 出現中の全プレイヤーの状態と入力の処理結果をsnapに集める（メインスレッド）
+    void build_player_states(WorldSnapshot& snap);
+
+    // ホスト: 同じデータを全クライアント（excludeを除く）にまとめて送る（m_mutexを保持して呼ぶ）
+    void send_to_all_clients(const void* data, int len, const Endpoint* exclude = nullptr);
+
+    // ホスト: スナップショットのうち各クライアントの関心領域にあるものを、
+    // クライアントごとのベースラインとの差分にして、溜まっている分と一緒にまとめて送る
+    // （送信するワーカーから呼ぶ。m_mutexは中で必要な間だけ持つ）
+    void send_states_to_clients(const WorldSnapshot& snap,
+        std::chrono::steady_clock::time_point now);
+
+    // ホスト: 1クライアント分のSTATEをjob.encodeBufに符号化する
+    // （m_encodePoolのスレッドから呼ばれる。触るのはjobとその送信の流れ、scratchだけ）
+    void encode_client_state(StateJob& job, uint32_t seq, const WorldSnapshot& snap,
+        float dt, int budget, EncodeScratch& scratch);
 
     // ----------------------------------------------------------
     // チャンネル関連（private関数）
     // ----------------------------------------------------------
 
-    // チャンネルスキャン要求に対して自分のチャンネル情報を返す
-    void handle_channel_scan(const std::string& from_ip, int from_port);
+    // 探索・チャンネルスキャン要求に、自分のチャンネルと参加人数を返す（ワーカースレッド）
+    void handle_channel_scan(const char* buf, int len, const Endpoint& from);
 
     // 受信したチャンネル情報をリストに追加・更新する
     void handle_channel_info(const ChannelInfo& info);
 
-    // ポートのフォールバック付き初期化（チャンネル0→1→…→動的ポート）
-    bool initialize_with_fallback();
+    // 全チャンネルの探索ポートへ探索要求をブロードキャストする
+    bool send_discover_broadcast(std::chrono::steady_clock::time_point now);
 
-    // ----------------------------------------------------------
-    // ラウンドロビン送信（ワーカースレッドから使用）
-    // ----------------------------------------------------------
+    // 探索の応答: ホストの一覧とチャンネル情報を更新し、探索中なら参加する
+    void handle_discover_reply(const char* buf, int len, const Endpoint& from);
+
+    // 探索中なら要求の送り直しとタイムアウトを処理する（service()から呼ぶ）
+    void update_discovery(std::chrono::steady_clock::time_point now);
 
-    // 1フレームにつき1クライアントだけに状態を送信して負荷を分散する
-    void send_state_to_clients_round_robin(
-        std::vector<std::shared_ptr<Game::GameObject>>* worldObjectsPtr);
+    // ポートのフォールバック付き初期化（チャンネル0→1→…→動的ポート）
+    bool initialize_with_fallback();
 
     // ----------------------------------------------------------
     // ワーカースレッド制御
@@ -236,8 +668,35 @@ private:
     // ワーカースレッドを停止してjoinする
     void stop_worker();
 
-    // ワーカースレッドからキューにパケットを追加する（容量制限付き）
-    void push_recv_packet(RecvPacket&& pkt);
+    // ワーカー: 読み込み可能になったソケットから届いている分をすべて読み、
+    // 受信キューのスロットに直接書き込む（満杯なら読み捨てて数える）
+    void drain_socket(ReactorTag tag);
+
+    // ゲーム通信のソケット1つから届いている分をすべてqueueに積む（ワーカー・シャードの受信スレッド）
+    void drain_game_socket(NetTransport& socket, RecvQueue& queue, RecvQueueStats& stats);
+
+    // queueに溜まった数の最大を記録する（書くのはqueueに積むスレッドだけなので、比べて置くだけでよい）
+    static void note_queue_depth(const RecvQueue& queue, RecvQueueStats& stats);
+
+    // queueから最大limit個を取り出して処理する（メインスレッド）。戻り値: 処理した数
+    size_t drain_queue(RecvQueue& queue, size_t limit, Game::GameObject* localPlayer,
+        std::vector<std::shared_ptr<Game::GameObject>>& worldObjects);
+
+    // 受信シャードを開いて受信スレッドを始める / 止めて閉じる（start_worker / stop_workerから呼ぶ）
+    void start_receive_shards();
+    void stop_receive_shards();
+    void shard_loop(RecvShard& shard);
+
+    // ホスト: m_stateSendIntervalごとに最新のスナップショットからSTATEを作って送る（ワーカースレッド）
+    void send_snapshot(std::chrono::steady_clock::time_point now);
+    std::chrono::steady_clock::time_point m_lastStateSend;  // 前回send_snapshotでSTATEを送った時刻
+
+    // ホスト: ワーカーが次にsend_snapshotを呼ぶまでに待つ時間（ミリ秒、0ならすぐ）
+    int state_send_timeout_ms(std::chrono::steady_clock::time_point now);
+
+    // ワーカースレッドの代わりに、呼んだスレッドで1回分の送受信を進める
+    // （待つためのソケットが無いNetTransportのとき、update()から呼ぶ）
+    void poll_transport();
 
     // ----------------------------------------------------------
     // ファイアウォール補助
@@ -250,6 +709,20 @@ private:
     // デバッグ設定
     // ----------------------------------------------------------
     bool m_verboseLogs = false;  // trueにすると詳細ログを出力する
+
+    // 統計の書き出し（set_stats_dump、メインスレッド専用）
+    std::ofstream m_statsDump;
+    std::chrono::duration<double> m_statsDumpInterval{ 1.0 };
+    std::chrono::steady_clock::time_point m_lastStatsDump;
+
+    // 書き出す間隔が過ぎていれば統計を1行書き出す（service()の最後に呼ぶ）
+    void write_stats_dump(std::chrono::steady_clock::time_point now);
+
+    // 送受信のキャプチャ（record()はどのスレッドからでもよい）
+    NetCapture m_capture;
+
+    // キャプチャに今の役割（ホスト / クライアント）を記録する
+    void record_capture_role();
 };
 
 // グローバルインスタンス宣言（実体はnetwork_manager.cppで定義）
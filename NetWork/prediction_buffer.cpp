@@ -0,0 +1,87 @@
+/*********************************************************************
+ * \file   prediction_buffer.cpp
+ * \brief  PredictionBufferクラスの実装
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#include "pch.h"
+#include "prediction_buffer.h"
+#include <cmath>
+
+// ============================================================
+// push - 送った入力を追加する（満杯なら最も古いものを捨てる）
+// ============================================================
+void PredictionBuffer::push(const PacketInput& input) {
+    if (m_count == CAPACITY) drop_front(1);
+    Entry& e = m_entries[(m_head + m_count) % CAPACITY];
+    e.input = input;
+    e.hasState = false;
+    ++m_count;
+}
+
+// ============================================================
+// set_predicted - 入力を適用した後の予測状態を記録する
+// 通常は最新のエントリなので後ろから探す
+// ============================================================
+void PredictionBuffer::set_predicted(uint32_t seq, const PredictedState& state) {
+    for (int i = m_count - 1; i >= 0; --i) {
+        Entry& e = at(i);
+        if (e.input.seq == seq) {
+            e.state = state;
+            e.hasState = true;
+            return;
+        }
+        if ((int32_t)(e.input.seq - seq) < 0) return;
+    }
+}
+
+// ============================================================
+// acknowledge - ホストの処理結果と予測を照合する
+// ============================================================
+bool PredictionBuffer::acknowledge(uint32_t seq, const PredictedState& authoritative) {
+    // seq番のエントリを探す（それより古いものは捨てる）
+    int index = -1;
+    int dropCount = 0;
+    for (int i = 0; i < m_count; ++i) {
+        const int32_t d = (int32_t)(at(i).input.seq - seq);
+        if (d < 0) { dropCount = i + 1; continue; }
+        if (d == 0) index = i;
+        break;
+    }
+
+    if (index < 0) {
+        // 空・先頭より古い（処理済みの結果が遅れて届いた）なら照合するものが無いので何もしない。
+        // 残っているどの入力よりも新しいときだけ、履歴から溢れた入力の結果なので巻き戻す
+        const bool overflow = (m_count > 0 && dropCount == m_count);
+        drop_front(dropCount);
+        if (!overflow) return false;
+        ++m_corrections;
+        return true;
+    }
+
+    const Entry& e = at(index);
+    bool mismatch = !e.hasState;
+    if (e.hasState) {
+        const float dx = e.state.posX - authoritative.posX;
+        const float dy = e.state.posY - authoritative.posY;
+        const float dz = e.state.posZ - authoritative.posZ;
+        mismatch = (dx * dx + dy * dy + dz * dz) > POSITION_TOLERANCE * POSITION_TOLERANCE ||
+            std::fabs(e.state.velY - authoritative.velY) > VELOCITY_TOLERANCE ||
+            e.state.grounded != authoritative.grounded;
+    }
+
+    // 照合したエントリまで捨てる（残りがホスト未処理の入力）
+    drop_front(index + 1);
+    if (mismatch) ++m_corrections;
+    return mismatch;
+}
+
+// ============================================================
+// drop_front - 古い方からn個を捨てる
+// ============================================================
+void PredictionBuffer::drop_front(int n) {
+    if (n > m_count) n = m_count;
+    m_head = (m_head + n) % CAPACITY;
+    m_count -= n;
+}
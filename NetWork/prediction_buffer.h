@@ -0,0 +1,83 @@
+/*********************************************************************
+ * \file   prediction_buffer.h
+ * \brief  クライアント側予測の入力履歴
+ *         ホストに送った入力と、それを自分で適用した結果（予測した状態）を保持し、
+ *         ホストから届いた処理結果と照合する
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include "network_common.h"  // PacketInput
+#include <cstdint>
+
+// ============================================================
+// 予測・照合に使うプレイヤーの移動状態
+// 水平速度は入力（Player::Move）で毎回決まるので持たない
+// ============================================================
+struct PredictedState {
+    float posX = 0.0f, posY = 0.0f, posZ = 0.0f;
+    float velY = 0.0f;
+    bool grounded = false;
+};
+
+// ============================================================
+// PredictionBuffer クラス
+//
+// 1. 入力を送るたびに push() し、ローカルでシミュレーションした結果を
+//    set_predicted() で同じエントリに記録する。
+// 2. ホストのSTATEに載った InputAck を acknowledge() に渡すと、
+//    それ以前の入力を捨て、予測とホストの結果が許容範囲を超えてずれていれば
+//    trueを返す。
+// 3. trueなら呼び出し側でプレイヤーをホストの結果に戻し、残っている入力
+//    （pending）を古い順に同じ移動処理で適用し直し、set_predicted()で更新する。
+// ============================================================
+class PredictionBuffer {
+public:
+    // 1入力あたりのシミュレーション時間（UpdatePlayers()の固定ステップと同じ）
+    static constexpr float TICK_DT = 1.0f / 60.0f;
+    // 保持する入力の数（60Hzで約2秒分、これを超える遅延では古いものから捨てる）
+    static const int CAPACITY = 128;
+    // 位置のずれの許容値（量子化誤差より十分大きく、見た目で分からない程度）
+    static constexpr float POSITION_TOLERANCE = 0.02f;
+    // 縦速度のずれの許容値
+    static constexpr float VELOCITY_TOLERANCE = 0.1f;
+
+    // 送った入力を追加する（seqは増えていくこと）
+    void push(const PacketInput& input);
+
+    // seq番の入力を適用した後の予測状態を記録する
+    void set_predicted(uint32_t seq, const PredictedState& state);
+
+    // ホストがseq番までの入力を処理した結果を受け取る
+    // seq以前の入力を捨て、予測とずれていて巻き戻しが必要ならtrue
+    bool acknowledge(uint32_t seq, const PredictedState& authoritative);
+
+    // ホストがまだ処理していない入力（古い順、iは0からpending_count()-1）
+    int pending_count() const { return m_count; }
+    const PacketInput& pending_input(int i) const { return at(i).input; }
+
+    void clear() { m_count = 0; }
+
+    // 巻き戻した回数（ずれの頻度の確認用）
+    uint64_t correction_count() const { return m_corrections; }
+
+private:
+    struct Entry {
+        PacketInput input = {};
+        PredictedState state;
+        bool hasState = false;
+    };
+
+    Entry m_entries[CAPACITY];
+    int m_head = 0;   // 最も古いエントリの位置
+    int m_count = 0;
+    uint64_t m_corrections = 0;
+
+    Entry& at(int i) { return m_entries[(m_head + i) % CAPACITY]; }
+    const Entry& at(int i) const { return m_entries[(m_head + i) % CAPACITY]; }
+
+    // 先頭からn個を捨てる
+    void drop_front(int n);
+};
@@ -0,0 +1,421 @@
+/*********************************************************************
+ * \file   reliable_link.cpp
+ * \brief  ReliableLinkクラスの実装
+ *         パケット番号とACKの管理、信頼メッセージの再送と並べ替え
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#include "pch.h"
+#include "reliable_link.h"
+#include <cstring>
+
+namespace {
+    // RTOの下限・上限（ミリ秒）
+    const float RTO_MIN_MS = 50.0f;
+    const float RTO_MAX_MS = 1000.0f;
+
+    float elapsed_ms(ReliableLink::TimePoint from, ReliableLink::TimePoint to) {
+        return std::chrono::duration<float, std::milli>(to - from).count();
+    }
+
+    // 束の見出し（PKT_BUNDLE・count）と、メッセージごとの見出し（len）の大きさ
+    const int BUNDLE_HEADER_BYTES = 2;
+    const int BUNDLE_ENTRY_BYTES = (int)sizeof(uint16_t);
+
+    // PacketHeaderの後ろのメッセージを1つずつfn(body, bodyLen)に渡す（束でなければ1回）
+    // fnがfalseを返したら止める。束が途中で切れていれば、そこまでで止める
+    template <typename Fn>
+    void for_each_message(const char* body, int bodyLen, Fn fn) {
+        if (bodyLen <= 0) return;
+        if ((uint8_t)body[0] != PKT_BUNDLE) {
+            fn(body, bodyLen);
+            return;
+        }
+        if (bodyLen < BUNDLE_HEADER_BYTES) return;
+
+        const int count = (uint8_t)body[1];
+        const char* p = body + BUNDLE_HEADER_BYTES;
+        const char* end = body + bodyLen;
+        for (int i = 0; i < count; ++i) {
+            if (end - p < BUNDLE_ENTRY_BYTES) return;
+            uint16_t len16;
+            memcpy(&len16, p, sizeof(len16));
+            p += BUNDLE_ENTRY_BYTES;
+            if (len16 == 0 || end - p < (int)len16) return;
+            if (!fn(p, (int)len16)) return;
+            p += len16;
+        }
+    }
+}
+
+// ============================================================
+// コンストラクタ / reset
+// ============================================================
+ReliableLink::ReliableLink() {}
+
+void ReliableLink::reset() {
+    *this = ReliableLink();
+}
+
+// ============================================================
+// begin_packet - ヘッダーを書き、送信履歴に記録する
+// ============================================================
+ReliableLink::SentPacket& ReliableLink::begin_packet(TimePoint now, std::vector<char>& out) {
+    PacketHeader h;
+    h.seq = m_localSeq;
+    h.ack = m_remoteSeq;
+    h.ackBits = m_remoteBits;
+    h.flags = m_hasRemote ? HEADER_HAS_ACK : 0;
+
+    SentPacket& sp = m_sent[m_localSeq % SENT_HISTORY];
+    sp.seq = m_localSeq;
+    sp.valid = true;
+    sp.acked = false;
+    sp.sendTime = now;
+    sp.reliableCount = 0;
+    ++m_localSeq;
+
+    out.resize(sizeof(h));
+    memcpy(out.data(), &h, sizeof(h));
+
+    // このパケットで受信状況を伝えるので、ACK専用パケットは不要になる
+    m_lastSendTime = now;
+    m_ackPending = false;
+    return sp;
+}
+
+// ============================================================
+// finish_packet - 束のメッセージ数を書く
+// 1つだけなら束の見出し（PKT_BUNDLE・count・len）を外し、束にしない形と同じにする
+// ============================================================
+void ReliableLink::finish_packet(TimePoint now, std::vector<char>& out, int messages) {
+    const size_t bundleAt = sizeof(PacketHeader);
+    if (messages == 1) {
+        out.erase(out.begin() + bundleAt,
+            out.begin() + bundleAt + BUNDLE_HEADER_BYTES + BUNDLE_ENTRY_BYTES);
+    } else {
+        out[bundleAt + 1] = (char)(uint8_t)messages;
+    }
+    m_stats.on_packet_sent(now, (int)out.size());
+}
+
+// ============================================================
+// queue_unreliable - 非信頼メッセージを溜める
+// ============================================================
+void ReliableLink::queue_unreliable(const void* msg, int len) {
+    if (len <= 0 || len > MAX_PACKET_BYTES - (int)sizeof(PacketHeader)) return;
+    const uint16_t len16 = (uint16_t)len;
+    const size_t offset = m_unreliable.size();
+    m_unreliable.resize(offset + sizeof(len16) + (size_t)len);
+    memcpy(m_unreliable.data() + offset, &len16, sizeof(len16));
+    memcpy(m_unreliable.data() + offset + sizeof(len16), msg, (size_t)len);
+}
+
+// ============================================================
+// queue_reliable - 信頼メッセージを送信キューに入れる
+// ============================================================
+void ReliableLink::queue_reliable(NetChannel channel, const void* msg, int len) {
+    if (channel >= NUM_RELIABLE_CHANNELS) return;
+    SendChannel& ch = m_sendChannels[channel];
+
+    ch.queue.emplace_back();
+    PendingMessage& m = ch.queue.back();
+    m.msgId = ch.nextMsgId++;
+    m.data.assign((const char*)msg, (const char*)msg + len);
+
+    size_t pending = 0;
+    for (const SendChannel& sc : m_sendChannels) pending += sc.queue.size();
+    m_stats.on_reliable_queued(pending);
+}
+
+// ============================================================
+// collect_outgoing - 送るべきメッセージをパケットにまとめる
+// 信頼メッセージは窓（先頭の未ACKメッセージからRELIABLE_WINDOW個）の中だけを送る
+// 入らなくなったら次のパケットを始める（1つのメッセージが2つのパケットに分かれることはない）
+// ============================================================
+void ReliableLink::collect_outgoing(TimePoint now, std::vector<std::vector<char>>& outPackets,
+    size_t& count) {
+    const size_t firstPacket = count;
+    std::vector<char>* out = nullptr;  // 作成中のパケット
+    SentPacket* sp = nullptr;
+    int messages = 0;
+
+    auto finish = [&]() {
+        if (!out) return;
+        finish_packet(now, *out, messages);
+        out = nullptr;
+        sp = nullptr;
+        messages = 0;
+    };
+
+    // 次のメッセージ（bodyLenバイト）の見出しを書く。入らなければ新しいパケットを始める
+    auto begin_message = [&](int bodyLen, bool reliable) {
+        if (out) {
+            const bool full = messages >= MAX_MESSAGES_PER_PACKET ||
+                (int)out->size() + BUNDLE_ENTRY_BYTES + bodyLen > MAX_PACKET_BYTES ||
+                (reliable && sp->reliableCount >= MAX_RELIABLE_PER_PACKET);
+            if (full) finish();
+        }
+        if (!out) {
+            if (count == outPackets.size()) outPackets.emplace_back();
+            out = &outPackets[count++];
+            sp = &begin_packet(now, *out);
+            out->push_back((char)PKT_BUNDLE);
+            out->push_back(0);  // メッセージ数（finish_packetで書く）
+        }
+        const uint16_t len16 = (uint16_t)bodyLen;
+        const size_t offset = out->size();
+        out->resize(offset + sizeof(len16));
+        memcpy(out->data() + offset, &len16, sizeof(len16));
+        ++messages;
+    };
+
+    for (uint8_t c = 0; c < NUM_RELIABLE_CHANNELS; ++c) {
+        SendChannel& ch = m_sendChannels[c];
+        int inWindow = 0;
+        for (PendingMessage& m : ch.queue) {
+            if (inWindow++ >= RELIABLE_WINDOW) break;
+            if (m.acked) continue;
+            if (m.sent && elapsed_ms(m.lastSent, now) < m_rtoMs) continue;
+
+            if (m.sent) ++m_resent;
+
+            // 再送でも新しいパケット番号で送る（どのパケットがACKされたかでRTTを測れる）
+            ReliableMessageHeader rh;
+            rh.type = PKT_RELIABLE;
+            rh.channel = c;
+            rh.msgId = m.msgId;
+            begin_message((int)(sizeof(rh) + m.data.size()), true);
+            size_t offset = out->size();
+            out->resize(offset + sizeof(rh));
+            memcpy(out->data() + offset, &rh, sizeof(rh));
+            out->insert(out->end(), m.data.begin(), m.data.end());
+
+            ReliableRef& ref = sp->reliable[sp->reliableCount++];
+            ref.channel = c;
+            ref.msgId = m.msgId;
+            m.sent = true;
+            m.lastSent = now;
+        }
+    }
+
+    // 溜まった非信頼メッセージ（送れるのは今回だけ）
+    size_t pos = 0;
+    while (pos + sizeof(uint16_t) <= m_unreliable.size()) {
+        uint16_t len16;
+        memcpy(&len16, m_unreliable.data() + pos, sizeof(len16));
+        const char* body = m_unreliable.data() + pos + sizeof(len16);
+        begin_message(len16, false);
+        out->insert(out->end(), body, body + len16);
+        pos += sizeof(len16) + len16;
+    }
+    m_unreliable.clear();
+    finish();
+
+    // 受け取るだけで何も送っていない → ACK専用パケットで受信状況を伝える
+    if (count == firstPacket && m_ackPending &&
+        elapsed_ms(m_lastSendTime, now) >= (float)ACK_IDLE_MS) {
+        if (count == outPackets.size()) outPackets.emplace_back();
+        std::vector<char>& ack = outPackets[count++];
+        begin_packet(now, ack);
+        ack.push_back((char)PKT_ACK);
+        m_stats.on_packet_sent(now, (int)ack.size());
+    }
+}
+
+// ============================================================
+// receive - 受信パケットのヘッダーを処理してメッセージを取り出す
+// ============================================================
+bool ReliableLink::receive(const char* buf, int len, TimePoint now,
+    std::vector<MessageView>& messages,
+    std::vector<std::vector<char>>& delivered) {
+    if (len < (int)sizeof(PacketHeader) + 1) return false;
+
+    PacketHeader h;
+    memcpy(&h, buf, sizeof(h));
+
+    // 同じパケットが2回届いた（経路上の複製など）
+    if (!record_received(h.seq)) return false;
+    m_stats.on_packet_received(now, len, h.seq);
+
+    if (h.flags & HEADER_HAS_ACK) process_acks(h.ack, h.ackBits, now);
+
+    for_each_message(buf + sizeof(h), len - (int)sizeof(h),
+        [&](const char* body, int bodyLen) {
+            receive_message(body, bodyLen, messages, delivered);
+            return true;
+        });
+    return true;
+}
+
+// ============================================================
+// receive_message - 1メッセージを振り分ける
+// ============================================================
+void ReliableLink::receive_message(const char* body, int bodyLen,
+    std::vector<MessageView>& messages, std::vector<std::vector<char>>& delivered) {
+    uint8_t type = (uint8_t)body[0];
+
+    if (type == PKT_ACK) return;
+
+    if (type != PKT_RELIABLE) {
+        // 非信頼メッセージはそのまま呼び出し側へ
+        messages.push_back({ body, bodyLen });
+        return;
+    }
+
+    // ---- 信頼メッセージ: msgId順に並べ替えて渡す ----
+    if (bodyLen <= (int)sizeof(ReliableMessageHeader)) return;
+    ReliableMessageHeader rh;
+    memcpy(&rh, body, sizeof(rh));
+    if (rh.channel >= NUM_RELIABLE_CHANNELS) return;
+
+    RecvChannel& rc = m_recvChannels[rh.channel];
+    uint16_t ahead = (uint16_t)(rh.msgId - rc.nextExpected);
+    if ((int16_t)ahead < 0) return;           // 渡し済み（ACKが届く前の再送）
+    if (ahead >= RELIABLE_WINDOW) return;     // 窓の外（送信側が守るので通常は来ない）
+
+    ReceivedMessage& slot = rc.window[rh.msgId % RELIABLE_WINDOW];
+    if (!slot.valid) {
+        slot.valid = true;
+        slot.msgId = rh.msgId;
+        slot.data.assign(body + sizeof(rh), body + bodyLen);
+    }
+
+    // 抜けが無くなった分を順番に渡す
+    for (;;) {
+        ReceivedMessage& next = rc.window[rc.nextExpected % RELIABLE_WINDOW];
+        if (!next.valid || next.msgId != rc.nextExpected) break;
+        delivered.push_back(std::move(next.data));
+        next.data.clear();
+        next.valid = false;
+        ++rc.nextExpected;
+    }
+}
+
+// ============================================================
+// record_received - 受信したパケット番号を ack / ackBits に記録する
+// ============================================================
+bool ReliableLink::record_received(uint16_t seq) {
+    if (!m_hasRemote) {
+        m_hasRemote = true;
+        m_remoteSeq = seq;
+        m_remoteBits = 0;
+    } else if (seq == m_remoteSeq) {
+        return false;
+    } else if (seq_greater(seq, m_remoteSeq)) {
+        // 新しい番号 → 履歴をずらし、これまでの最新をビットに移す
+        uint16_t shift = (uint16_t)(seq - m_remoteSeq);
+        if (shift < 32) {
+            m_remoteBits = (m_remoteBits << shift) | (1u << (shift - 1));
+        } else if (shift == 32) {
+            m_remoteBits = 1u << 31;
+        } else {
+            m_remoteBits = 0;
+        }
+        m_remoteSeq = seq;
+    } else {
+        // 古い番号（順番が入れ替わって届いた）
+        uint16_t back = (uint16_t)(m_remoteSeq - seq);
+        if (back <= 32) {
+            uint32_t bit = 1u << (back - 1);
+            if (m_remoteBits & bit) return false;
+            m_remoteBits |= bit;
+        }
+        // 33個以上前のものは重複を判定できないが、ACKもできないのでそのまま受け取る
+    }
+    m_ackPending = true;
+    return true;
+}
+
+// ============================================================
+// process_acks - 相手から届いた ack / ackBits を送信履歴に反映する
+// ============================================================
+void ReliableLink::process_acks(uint16_t ack, uint32_t ackBits, TimePoint now) {
+    auto mark = [&](uint16_t seq) {
+        SentPacket& sp = m_sent[seq % SENT_HISTORY];
+        if (sp.valid && sp.seq == seq && !sp.acked) on_packet_acked(sp, now);
+    };
+
+    mark(ack);
+    for (int i = 0; i < 32; ++i) {
+        if (ackBits & (1u << i)) mark((uint16_t)(ack - 1 - i));
+    }
+}
+
+// ============================================================
+// on_packet_acked - 送ったパケットがACKされた
+// RTTを更新し、載せていた信頼メッセージを完了にする
+// ============================================================
+void ReliableLink::on_packet_acked(SentPacket& sp, TimePoint now) {
+    sp.acked = true;
+    update_rtt(elapsed_ms(sp.sendTime, now));
+
+    for (int i = 0; i < sp.reliableCount; ++i) {
+        const ReliableRef& ref = sp.reliable[i];
+        SendChannel& ch = m_sendChannels[ref.channel];
+        if (ch.queue.empty()) continue;
+
+        // キューはmsgId順なので先頭からの差で位置が分かる
+        uint16_t index = (uint16_t)(ref.msgId - ch.queue.front().msgId);
+        if (index < ch.queue.size() && ch.queue[index].msgId == ref.msgId) {
+            ch.queue[index].acked = true;
+        }
+        // 先頭から連続してACK済みのものを取り除く（窓が進む）
+        while (!ch.queue.empty() && ch.queue.front().acked) {
+            ch.queue.pop_front();
+        }
+    }
+}
+
+// ============================================================
+// update_rtt - RTTの測定値からRTOを計算する（RFC 6298）
+// ============================================================
+void ReliableLink::update_rtt(float sampleMs) {
+    if (!m_hasRtt) {
+        m_hasRtt = true;
+        m_srttMs = sampleMs;
+        m_rttVarMs = sampleMs * 0.5f;
+    } else {
+        float err = m_srttMs - sampleMs;
+        if (err < 0.0f) err = -err;
+        m_rttVarMs = 0.75f * m_rttVarMs + 0.25f * err;
+        m_srttMs = 0.875f * m_srttMs + 0.125f * sampleMs;
+    }
+    float rto = m_srttMs + 4.0f * m_rttVarMs;
+    if (rto < RTO_MIN_MS) rto = RTO_MIN_MS;
+    if (rto > RTO_MAX_MS) rto = RTO_MAX_MS;
+    m_rtoMs = rto;
+}
+
+// ============================================================
+// pending_reliable - 未ACKの信頼メッセージ数
+// ============================================================
+size_t ReliableLink::pending_reliable() const {
+    size_t n = 0;
+    for (const SendChannel& ch : m_sendChannels) {
+        for (const PendingMessage& m : ch.queue) {
+            if (!m.acked) ++n;
+        }
+    }
+    return n;
+}
+
+// ============================================================
+// is_join_request - 信頼チャンネルで送られたJOINを含むか
+// ============================================================
+bool ReliableLink::is_join_request(const char* buf, int len) {
+    if (len < (int)sizeof(PacketHeader) + 1) return false;
+    bool found = false;
+    for_each_message(buf + sizeof(PacketHeader), len - (int)sizeof(PacketHeader),
+        [&](const char* body, int bodyLen) {
+            const int offset = (int)sizeof(ReliableMessageHeader);
+            if (bodyLen <= offset) return true;
+            ReliableMessageHeader rh;
+            memcpy(&rh, body, sizeof(rh));
+            found = rh.type == PKT_RELIABLE && rh.channel == CHANNEL_CONTROL &&
+                (uint8_t)body[offset] == PKT_JOIN;
+            return !found;
+        });
+    return found;
+}
@@ -0,0 +1,231 @@
+/*********************************************************************
+ * \file   reliable_link.h
+ * \brief  UDP上の軽量な信頼性レイヤー（1接続分）
+ *         全パケットにパケット番号とACK（ビットフィールド付き）を載せ、
+ *         信頼メッセージはACKされるまでRTTから決めた間隔で再送する
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include "network_common.h"  // PacketHeader, ReliableMessageHeader
+#include "net_stats.h"       // ConnectionStats
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// ============================================================
+// メッセージの送り方（パケット種別ごとに channel_for_packet() で選ぶ）
+// ============================================================
+enum NetChannel : uint8_t {
+    CHANNEL_CONTROL = 0,          // 信頼・順序保証: JOIN / JOIN_ACK
+    CHANNEL_EVENTS = 1,           // 信頼・順序保証: 弾の発射などのイベント
+    NUM_RELIABLE_CHANNELS = 2,
+    CHANNEL_UNRELIABLE = 0xFF,    // 非信頼: STATE / INPUT など（最新値だけが意味を持つもの）
+};
+
+// パケット種別から送り方を決める
+inline NetChannel channel_for_packet(uint8_t type) {
+    switch (type) {
+    case PKT_JOIN:
+    case PKT_JOIN_ACK:
+        return CHANNEL_CONTROL;
+    case PKT_BULLET:
+        return CHANNEL_EVENTS;
+    default:
+        return CHANNEL_UNRELIABLE;
+    }
+}
+
+// 受信したパケットから取り出した非信頼メッセージ（受信バッファの中を指す）
+struct MessageView {
+    const char* data;
+    int len;
+};
+
+// ============================================================
+// ReliableLink クラス
+//
+// 送信側:
+//   ・メッセージは送るたびにパケットにせず、接続ごとに溜めておく。
+//     collect_outgoing()で、溜まった非信頼メッセージと、送るべき信頼メッセージ
+//     （新規・RTOを過ぎた再送）をMAX_PACKET_BYTESに入るだけ1つのパケットにまとめる
+//     （PKT_BUNDLE。1ティックに1回呼べば、1接続あたり普段は1パケットになる）。
+//   ・すべての送信パケットの先頭にPacketHeader（seq / ack / ackBits）を付ける。
+//     ACKは普段のパケットに相乗りするので、ACK専用パケットは送らない
+//     （受け取るだけで何も送らない状態が続いたときだけ PKT_ACK を送る）。
+//   ・信頼メッセージはチャンネルごとのキューに入れ、それを載せたパケットが
+//     ACKされるまで、RTOごとに新しいパケット番号で送り直す。
+//
+// 受信側:
+//   ・パケット番号の受信履歴からack / ackBitsを作る。
+//   ・束はメッセージごとに分け、信頼メッセージはチャンネルごとにmsgId順に
+//     並べ替えて、抜けが埋まってから渡す。
+//
+// スレッドセーフではない。呼び出し側で排他すること。
+// ============================================================
+class ReliableLink {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+
+    // 送信履歴の数（この範囲のパケット番号に対するACKを受け付ける）
+    static const int SENT_HISTORY = 256;
+    // 1チャンネルで同時に未ACKにできる信頼メッセージ数（受信側の並べ替え窓と同じ）
+    static const int RELIABLE_WINDOW = 64;
+    // 受信だけが続いたとき、ACK専用パケットを送るまでの時間
+    static const int ACK_IDLE_MS = 50;
+    // 1パケットの大きさの上限（ヘッダーを含む）
+    static const int MAX_PACKET_BYTES = MAX_UDP_PACKET;
+    // 1パケットに載せる信頼メッセージの上限（ACKされたときに完了にする記録の数）
+    static const int MAX_RELIABLE_PER_PACKET = 16;
+    // 1つの束に入れるメッセージの上限（countが8ビット）
+    static const int MAX_MESSAGES_PER_PACKET = 255;
+
+    ReliableLink();
+
+    // 状態をすべて初期化する（接続し直すとき）
+    void reset();
+
+    // ----------------------------------------------------------
+    // 送信
+    // ----------------------------------------------------------
+
+    // 非信頼メッセージを溜める（次のcollect_outgoingで送り、送れなくても持ち越さない）
+    void queue_unreliable(const void* msg, int len);
+
+    // 信頼メッセージをチャンネルのキューに入れる（実際の送信はcollect_outgoing）
+    // キューが窓を超えて溜まっている場合もすべて保持し、ACKが進めば順に送る
+    void queue_reliable(NetChannel channel, const void* msg, int len);
+
+    // 未送信の信頼メッセージ、RTOを過ぎた未ACKメッセージ、溜まった非信頼メッセージを
+    // できるだけ少ないパケットにまとめる（信頼メッセージが先）
+    // 何も無くても受信だけが続いている場合はACK専用パケットを作る
+    // outPackets[count] から順に書き込んでcountを進める（既存の要素は容量を再利用し、足りなければ追加する）
+    void collect_outgoing(TimePoint now, std::vector<std::vector<char>>& outPackets, size_t& count);
+
+    // ----------------------------------------------------------
+    // 受信
+    // ----------------------------------------------------------
+
+    // 受信パケットのヘッダーを処理し、束ならメッセージごとに分ける
+    // 非信頼メッセージは messages に（bufの中を指したまま）追加し、
+    // 信頼メッセージは並べ替えて渡せるようになったものを delivered に追加する
+    // 重複パケット・短すぎるパケットならfalse（束の途中が壊れていれば、そこから後ろは捨てる）
+    bool receive(const char* buf, int len, TimePoint now,
+        std::vector<MessageView>& messages,
+        std::vector<std::vector<char>>& delivered);
+
+    // ----------------------------------------------------------
+    // 状態確認
+    // ----------------------------------------------------------
+
+    // 平滑化したRTT（ミリ秒）と現在の再送タイムアウト
+    float rtt_ms() const { return m_srttMs; }
+    float rto_ms() const { return m_rtoMs; }
+
+    // 未ACKの信頼メッセージ数（全チャンネル合計）
+    size_t pending_reliable() const;
+
+    // これまでに再送した信頼メッセージの延べ数
+    uint64_t resent_count() const { return m_resent; }
+
+    // この接続の送受信の統計（送受信したパケットはここで数える。RTTと入力キューは呼び出し側が入れる）
+    ConnectionStats& stats() { return m_stats; }
+    const ConnectionStats& stats() const { return m_stats; }
+
+    // 受信パケットが信頼チャンネルのJOIN要求を含むか（ホストが未知の送信元を受け入れる判定用）
+    static bool is_join_request(const char* buf, int len);
+
+private:
+    // パケットに載せた信頼メッセージ
+    struct ReliableRef {
+        uint8_t channel = 0;
+        uint16_t msgId = 0;
+    };
+
+    // 送ったパケット1つ分の記録
+    struct SentPacket {
+        uint16_t seq = 0;
+        bool valid = false;
+        bool acked = false;
+        TimePoint sendTime;
+        uint8_t reliableCount = 0;                        // 載せた信頼メッセージの数
+        ReliableRef reliable[MAX_RELIABLE_PER_PACKET];
+    };
+
+    // 送信待ち / ACK待ちの信頼メッセージ
+    struct PendingMessage {
+        uint16_t msgId = 0;
+        bool acked = false;
+        bool sent = false;
+        TimePoint lastSent;
+        std::vector<char> data;
+    };
+
+    // 受信側の並べ替え用スロット
+    struct ReceivedMessage {
+        bool valid = false;
+        uint16_t msgId = 0;
+        std::vector<char> data;
+    };
+
+    struct SendChannel {
+        uint16_t nextMsgId = 0;
+        std::deque<PendingMessage> queue;  // 先頭が最も古い未ACKメッセージ
+    };
+
+    struct RecvChannel {
+        uint16_t nextExpected = 0;              // 次に渡すmsgId
+        ReceivedMessage window[RELIABLE_WINDOW]; // msgId % RELIABLE_WINDOW で格納
+    };
+
+    // 送信側
+    uint16_t m_localSeq = 0;
+    SentPacket m_sent[SENT_HISTORY];
+    SendChannel m_sendChannels[NUM_RELIABLE_CHANNELS];
+    TimePoint m_lastSendTime;
+    std::vector<char> m_unreliable;  // 溜まった非信頼メッセージ（len(16) message[len] の並び）
+
+    // 受信側
+    bool m_hasRemote = false;
+    uint16_t m_remoteSeq = 0;   // 受け取った最新のパケット番号
+    uint32_t m_remoteBits = 0;  // m_remoteSeqの1-32個前の受信状況
+    bool m_ackPending = false;  // まだ相手に伝えていない受信がある
+    RecvChannel m_recvChannels[NUM_RELIABLE_CHANNELS];
+
+    // RTT推定（RFC 6298と同じ平滑化）
+    bool m_hasRtt = false;
+    float m_srttMs = 0.0f;
+    float m_rttVarMs = 0.0f;
+    float m_rtoMs = 200.0f;
+    uint64_t m_resent = 0;
+
+    // 統計
+    ConnectionStats m_stats;
+
+    // ヘッダーを書き、送信履歴に記録する（載せた信頼メッセージは呼び出し側が追加する）
+    SentPacket& begin_packet(TimePoint now, std::vector<char>& out);
+
+    // 束の中のメッセージ数を書く（1つだけなら束をやめてメッセージをそのまま置く）
+    void finish_packet(TimePoint now, std::vector<char>& out, int messages);
+
+    // 受信した1メッセージを非信頼 / 信頼に振り分ける
+    void receive_message(const char* body, int bodyLen,
+        std::vector<MessageView>& messages, std::vector<std::vector<char>>& delivered);
+
+    // 相手から届いたack / ackBitsを送信履歴に反映する
+    void process_acks(uint16_t ack, uint32_t ackBits, TimePoint now);
+    void on_packet_acked(SentPacket& sp, TimePoint now);
+
+    // 受信したパケット番号を記録する（重複ならfalse）
+    bool record_received(uint16_t seq);
+
+    // RTTの測定値を反映してRTOを更新する
+    void update_rtt(float sampleMs);
+
+    // 16ビットの通し番号の比較（折り返しを考慮）
+    static bool seq_greater(uint16_t a, uint16_t b) { return (int16_t)(a - b) > 0; }
+};
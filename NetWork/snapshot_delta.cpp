@@ -0,0 +1,284 @@
+/*********************************************************************
+ * \file   snapshot_delta.cpp
+ * \brief  SnapshotDeltaクラスの実装
+ *         スナップショット履歴の管理と差分の符号化・復元
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#include "pch.h"
+#include "snapshot_delta.h"
+#include "net_codec.h"
+#include <climits>
+
+// ============================================================
+// コンストラクタ
+// ============================================================
+SnapshotDelta::SnapshotDelta() {}
+
+// ============================================================
+// reset - 送受信の履歴をすべて破棄する
+// ============================================================
+void SnapshotDelta::reset() {
+    for (int i = 0; i < HISTORY_SIZE; ++i) {
+        m_sent[i].seq = NO_BASELINE;
+        m_sent[i].states.clear();
+        m_received[i].seq = NO_BASELINE;
+        m_received[i].states.clear();
+    }
+    m_ackedSeq = NO_BASELINE;
+    m_lastReceivedSeq = NO_BASELINE;
+}
+
+// ============================================================
+// find - 履歴リングからseq番のスナップショットを探す
+// 同じスロットが新しいseqで上書きされていれば見つからない扱い
+// ============================================================
+const SnapshotDelta::Snapshot* SnapshotDelta::find(const Snapshot* history, uint32_t seq) {
+    if (seq == NO_BASELINE) return nullptr;
+    const Snapshot& s = history[seq % HISTORY_SIZE];
+    return (s.seq == seq) ? &s : nullptr;
+}
+
+// ============================================================
+// diff_mask - 変化したフィールドのビットマスクを作る
+// 量子化後の値で比べるので、量子化誤差以下の揺れは変化なしになる
+// ============================================================
+uint8_t SnapshotDelta::diff_mask(const ObjectState& base, const ObjectState& cur) {
+    uint8_t mask = 0;
+    for (int f = 0; f < NetCodec::STATE_FIELD_COUNT; ++f) {
+        if (NetCodec::quantize_field(base, f) != NetCodec::quantize_field(cur, f)) {
+            mask |= (uint8_t)(1 << f);
+        }
+    }
+    return mask;
+}
+
+// ============================================================
+// encode - ACK済みベースラインとの差分パケットを作る
+//
+// パケット構成（ビット単位、network_common.h 参照）:
+//   type(8) seq(32) time(16) hasBase(1) [seq-baseSeq(5)]
+//   hasInputAck(1) [inputSeq(32) velY(16) grounded(1)] objectCount(varint)
+//   各オブジェクト: id(varint) mask(6) + 変化したフィールドの量子化値
+//   removedCount(varint) + 削除したオブジェクトのid(varint)
+//
+// ベースラインが古すぎて相手の履歴から消えている可能性がある場合は
+// 完全スナップショット（hasBase = 0）を送る
+// maxBytes を超える分は並び順の後ろから先送りする
+// ============================================================
+void SnapshotDelta::encode(uint32_t seq, uint16_t timeMs, const std::vector<ObjectState>& states,
+    std::vector<char>& out, const InputAck* inputAck, int maxBytes,
+    std::vector<uint8_t>* outCurrent) {
+    // ベースラインを決める（相手の受信履歴に確実に残っている範囲のみ使う）
+    const Snapshot* base = nullptr;
+    if (m_ackedSeq != NO_BASELINE && seq - m_ackedSeq < (uint32_t)HISTORY_SIZE) {
+        base = find(m_sent, m_ackedSeq);
+    }
+
+    // 受信側が復元するのと同じ（量子化を通した）値と、ベースラインとの変化マスクを求める
+    const size_t count = states.size();
+    m_quantized.resize(count);
+    m_masks.resize(count);
+    m_baseIndex.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        ObjectState& q = m_quantized[i];
+        q.id = states[i].id;
+        for (int f = 0; f < NetCodec::STATE_FIELD_COUNT; ++f) {
+            NetCodec::dequantize_field(q, f, NetCodec::quantize_field(states[i], f));
+        }
+
+        // ベースライン内の同じIDを探す（無ければ新規オブジェクトとして全フィールド送信）
+        uint8_t mask = FIELD_ALL;
+        int baseIndex = -1;
+        if (base) {
+            for (size_t k = 0; k < base->states.size(); ++k) {
+                if (base->states[k].id == q.id) {
+                    mask = diff_mask(base->states[k], q);
+                    baseIndex = (int)k;
+                    break;
+                }
+            }
+        }
+        m_masks[i] = mask;
+        m_baseIndex[i] = baseIndex;
+    }
+
+    // ベースラインにあって今回は無いオブジェクト（関心領域から外れたなど）
+    m_removed.clear();
+    int usedBits = MAX_HEADER_BYTES * 8;
+    if (base) {
+        for (const ObjectState& b : base->states) {
+            bool found = false;
+            for (const ObjectState& os : states) {
+                if (os.id == b.id) { found = true; break; }
+            }
+            if (!found) {
+                m_removed.push_back(b.id);
+                usedBits += BitWriter::varint_bits(b.id);
+            }
+        }
+    }
+
+    // 並び順（優先度の高い順）に、予算に入るものを選ぶ
+    // 入らなかったものは送らず、受信側の値（ベースライン）のまま次の機会に回す
+    const int budgetBits = (maxBytes > 0) ? maxBytes * 8 : INT_MAX;
+    uint32_t objectCount = 0;
+    if (outCurrent) outCurrent->assign(count, 1);
+    for (size_t i = 0; i < count; ++i) {
+        const uint8_t mask = m_masks[i];
+        if (mask == 0) continue;  // 変化なし（受信側は最新）
+
+        int cost = BitWriter::varint_bits(m_quantized[i].id) + NetCodec::STATE_FIELD_COUNT;
+        for (int f = 0; f < NetCodec::STATE_FIELD_COUNT; ++f) {
+            if (mask & (1 << f)) cost += NetCodec::field_bits(f);
+        }
+        if (usedBits + cost > budgetBits) {
+            m_masks[i] = MASK_DEFERRED;
+            if (outCurrent) (*outCurrent)[i] = 0;
+            continue;
+        }
+        usedBits += cost;
+        ++objectCount;
+    }
+
+    // 送信履歴に受信側が持つことになる状態を保存する
+    // 先送りしたものはベースラインの値、ベースラインにも無ければ受信側は知らないので入れない
+    Snapshot& slot = m_sent[seq % HISTORY_SIZE];
+    slot.seq = seq;
+    slot.timeMs = timeMs;
+    slot.states.clear();
+    for (size_t i = 0; i < count; ++i) {
+        if (m_masks[i] != MASK_DEFERRED) {
+            slot.states.push_back(m_quantized[i]);
+        } else if (m_baseIndex[i] >= 0) {
+            slot.states.push_back(base->states[m_baseIndex[i]]);
+        }
+    }
+
+    // 最大サイズで確保してから、実際に書いたバイト数に縮める
+    out.resize(MAX_HEADER_BYTES + objectCount * MAX_OBJECT_BYTES +
+        m_removed.size() * MAX_REMOVED_BYTES);
+    BitWriter w(out.data(), (int)out.size());
+    w.write_bits(PKT_STATE, 8);
+    w.write_bits(seq, 32);
+    w.write_bits(timeMs, 16);
+    w.write_bool(base != nullptr);
+    if (base) w.write_bits(seq - base->seq, BASE_OFFSET_BITS);
+    w.write_bool(inputAck != nullptr);
+    if (inputAck) NetCodec::write_input_ack(w, *inputAck);
+    w.write_varint(objectCount);
+
+    for (size_t i = 0; i < count; ++i) {
+        const uint8_t mask = m_masks[i];
+        // 変化なし・先送りのオブジェクトは送らない
+        if (mask == 0 || mask == MASK_DEFERRED) continue;
+
+        const ObjectState& os = m_quantized[i];
+        w.write_varint(os.id);
+        w.write_bits(mask, NetCodec::STATE_FIELD_COUNT);
+        for (int f = 0; f < NetCodec::STATE_FIELD_COUNT; ++f) {
+            if (mask & (1 << f)) {
+                w.write_bits(NetCodec::quantize_field(os, f), NetCodec::field_bits(f));
+            }
+        }
+    }
+
+    w.write_varint((uint32_t)m_removed.size());
+    for (uint32_t id : m_removed) w.write_varint(id);
+
+    out.resize(w.bytes_written());
+}
+
+// ============================================================
+// on_ack - 相手からACKを受け取った
+// 古いACKが後から届いても新しいベースラインを巻き戻さない
+// ============================================================
+void SnapshotDelta::on_ack(uint32_t seq) {
+    if (m_ackedSeq == NO_BASELINE || (int32_t)(seq - m_ackedSeq) > 0) {
+        m_ackedSeq = seq;
+    }
+}
+
+// ============================================================
+// decode - 差分パケットをベースラインに適用して完全な状態を復元する
+// ============================================================
+bool SnapshotDelta::decode(const char* buf, int len,
+    std::vector<ObjectState>& outStates, uint32_t& outSeq, uint16_t& outTimeMs,
+    bool& outHasInputAck, InputAck& outInputAck) {
+    BitReader r(buf, len);
+    if (r.read_bits(8) != PKT_STATE) return false;
+    const uint32_t seq = r.read_bits(32);
+    const uint16_t timeMs = (uint16_t)r.read_bits(16);
+    const bool hasBase = r.read_bool();
+    const uint32_t baseOffset = hasBase ? r.read_bits(BASE_OFFSET_BITS) : 0;
+    InputAck inputAck = {};
+    const bool hasInputAck = r.read_bool();
+    if (hasInputAck) NetCodec::read_input_ack(r, inputAck);
+    const uint32_t objectCount = r.read_varint();
+    if (r.overflowed()) return false;
+
+    // 入れ替わって遅れて届いた古いスナップショットは捨てる
+    if (m_lastReceivedSeq != NO_BASELINE && (int32_t)(seq - m_lastReceivedSeq) <= 0) {
+        return false;
+    }
+
+    // ベースラインから開始（完全スナップショットなら空から）
+    outStates.clear();
+    if (hasBase) {
+        const Snapshot* base = find(m_received, seq - baseOffset);
+        if (!base) return false;  // ベースラインを持っていないので復元できない
+        outStates = base->states;
+    }
+
+    for (uint32_t i = 0; i < objectCount; ++i) {
+        const uint32_t id = r.read_varint();
+        const uint32_t mask = r.read_bits(NetCodec::STATE_FIELD_COUNT);
+        if (r.overflowed()) return false;
+
+        // 対象オブジェクトを探す（無ければ追加）
+        ObjectState* target = nullptr;
+        for (ObjectState& os : outStates) {
+            if (os.id == id) { target = &os; break; }
+        }
+        if (!target) {
+            ObjectState os = {};
+            os.id = id;
+            outStates.push_back(os);
+            target = &outStates.back();
+        }
+
+        for (int f = 0; f < NetCodec::STATE_FIELD_COUNT; ++f) {
+            if (mask & (1u << f)) {
+                NetCodec::dequantize_field(*target, f, r.read_bits(NetCodec::field_bits(f)));
+            }
+        }
+        if (r.overflowed()) return false;
+    }
+
+    // 送られなくなったオブジェクトを消す
+    const uint32_t removedCount = r.read_varint();
+    for (uint32_t i = 0; i < removedCount && !r.overflowed(); ++i) {
+        const uint32_t id = r.read_varint();
+        for (size_t k = 0; k < outStates.size(); ++k) {
+            if (outStates[k].id == id) {
+                outStates.erase(outStates.begin() + k);
+                break;
+            }
+        }
+    }
+    if (r.overflowed()) return false;
+
+    // 復元した完全な状態を受信履歴に保存（次回以降のベースラインになる）
+    Snapshot& slot = m_received[seq % HISTORY_SIZE];
+    slot.seq = seq;
+    slot.timeMs = timeMs;
+    slot.states = outStates;
+    m_lastReceivedSeq = seq;
+
+    outSeq = seq;
+    outTimeMs = timeMs;
+    outHasInputAck = hasInputAck;
+    if (hasInputAck) outInputAck = inputAck;
+    return true;
+}
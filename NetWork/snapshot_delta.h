@@ -0,0 +1,121 @@
+/*********************************************************************
+ * \file   snapshot_delta.h
+ * \brief  PKT_STATE のデルタ圧縮（ACK済みベースラインとの差分符号化）
+ *         送信したスナップショットの履歴を接続ごとに保持し、
+ *         相手がACKした最新スナップショットとの差分だけを送る
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include "network_common.h"  // ObjectState, PKT_STATE
+#include <cstdint>
+#include <vector>
+
+// ============================================================
+// SnapshotDelta クラス
+//
+// 1つの接続（ホスト側ならクライアント1人、クライアント側ならホスト）に
+// 対応する、スナップショットの送信履歴と受信履歴を管理する。
+//
+// 送信側:
+//   encode() で新しいスナップショットを、相手がACKした最新の
+//   スナップショット（ベースライン）との差分として符号化する。
+//   変化していないオブジェクトは送らず、変化したフィールドだけを
+//   ビットマスク付きで送る。ベースラインにあって今回のstatesに無い
+//   オブジェクトは削除として送る（受信側の状態一覧からも消える）。
+//
+// 受信側:
+//   decode() でベースラインに差分を適用して完全な状態を復元し、
+//   受信履歴に保存する。呼び出し側は復元できたseqをACKとして返送する。
+// ============================================================
+class SnapshotDelta {
+public:
+    // ベースラインなし（全フィールドを送る完全スナップショット）を表す値
+    static const uint32_t NO_BASELINE = 0xFFFFFFFF;
+
+    // 保持するスナップショットの数（これより古いACKはベースラインに使わない）
+    static const int HISTORY_SIZE = 32;
+
+    SnapshotDelta();
+
+    // ----------------------------------------------------------
+    // 送信側
+    // ----------------------------------------------------------
+
+    // statesをseq番のスナップショットとして履歴に保存し、
+    // ACK済みベースラインとの差分パケット（ヘッダー込み）をoutに書き込む
+    // timeMs: statesを取得した時刻（ミリ秒の下位16ビット）
+    // inputAck: 相手の入力の処理結果（ホスト→クライアントのみ、無ければnullptr）
+    // maxBytes: パケットの上限（0なら無制限）。statesは優先度の高い順に並べておくこと。
+    //   入りきらないオブジェクトは送らず、受信側はベースラインの値のままになる
+    // outCurrent: statesの各要素について、このパケットで受信側が最新の値になるなら1
+    void encode(uint32_t seq, uint16_t timeMs, const std::vector<ObjectState>& states,
+        std::vector<char>& out, const InputAck* inputAck = nullptr,
+        int maxBytes = 0, std::vector<uint8_t>* outCurrent = nullptr);
+
+    // 相手からseq番のACKを受け取った
+    void on_ack(uint32_t seq);
+
+    // ----------------------------------------------------------
+    // 受信側
+    // ----------------------------------------------------------
+
+    // 差分パケットを復元してoutStatesに完全な状態一覧を返す（outTimeMsは送信側の取得時刻）
+    // 入力の処理結果が載っていれば outHasInputAck = true にして outInputAck に返す
+    // ベースラインが履歴に無い・古い・データが壊れている場合はfalse
+    bool decode(const char* buf, int len, std::vector<ObjectState>& outStates,
+        uint32_t& outSeq, uint16_t& outTimeMs,
+        bool& outHasInputAck, InputAck& outInputAck);
+
+    // 送受信の履歴をすべて破棄する（再接続時など）
+    void reset();
+
+private:
+    // ベースラインの位置を seq からの差（1-31）で送るビット数
+    static const int BASE_OFFSET_BITS = 5;
+
+    // 符号化後サイズの上限（ヘッダー / オブジェクト1体分 / 削除1体分、バッファ確保用）
+    // ヘッダー: 8+32+16+1+5+(1+32+16+1)+varint(最大40) ビット + removedCount(varint、最大40)
+    // 1体分: varint(最大40) + 6 + 14x3 + 12x3 ビット
+    // 削除1体分: varint(最大40) ビット
+    static const int MAX_HEADER_BYTES = 24;
+    static const int MAX_OBJECT_BYTES = 16;
+    static const int MAX_REMOVED_BYTES = 5;
+
+    // 変化したフィールドを示すビット（パケット内の各オブジェクトのmask）
+    enum FieldBit : uint8_t {
+        FIELD_POS_X = 1 << 0,
+        FIELD_POS_Y = 1 << 1,
+        FIELD_POS_Z = 1 << 2,
+        FIELD_ROT_X = 1 << 3,
+        FIELD_ROT_Y = 1 << 4,
+        FIELD_ROT_Z = 1 << 5,
+        FIELD_ALL = 0x3F,
+    };
+    // encode()の作業用: 予算に入らず先送りしたオブジェクト（パケットには書かない値）
+    static const uint8_t MASK_DEFERRED = 0xFF;
+
+    // 履歴1件分のスナップショット
+    struct Snapshot {
+        uint32_t seq = NO_BASELINE;        // スナップショット番号（NO_BASELINE=空き）
+        uint16_t timeMs = 0;               // 送信側の取得時刻（ミリ秒の下位16ビット）
+        std::vector<ObjectState> states;   // そのときの全オブジェクト状態
+    };
+
+    Snapshot m_sent[HISTORY_SIZE];      // 送信履歴（seq % HISTORY_SIZE で格納）
+    Snapshot m_received[HISTORY_SIZE];  // 受信履歴（復元済みの完全な状態）
+    uint32_t m_ackedSeq = NO_BASELINE;  // 相手がACKした最新のseq
+    uint32_t m_lastReceivedSeq = NO_BASELINE;  // 最後に復元できたseq
+    std::vector<ObjectState> m_quantized;  // encode()の作業用（量子化を通した値）
+    std::vector<uint8_t> m_masks;       // encode()の作業用（オブジェクトごとの変化マスク）
+    std::vector<int> m_baseIndex;       // encode()の作業用（ベースライン内の添字、無ければ-1）
+    std::vector<uint32_t> m_removed;    // encode()の作業用（ベースラインから消えたID）
+
+    // 履歴からseq番のスナップショットを探す（無ければnullptr）
+    static const Snapshot* find(const Snapshot* history, uint32_t seq);
+
+    // 2つの状態を量子化後の値で比べて、変化したフィールドのマスクを返す
+    static uint8_t diff_mask(const ObjectState& base, const ObjectState& cur);
+};
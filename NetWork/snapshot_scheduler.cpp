@@ -0,0 +1,69 @@
+/*********************************************************************
+ * \file   snapshot_scheduler.cpp
+ * \brief  SnapshotSchedulerクラスの実装
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#include "pch.h"
+#include "snapshot_scheduler.h"
+#include <algorithm>
+#include <cmath>
+
+// ============================================================
+// accumulate - 優先度を積み上げて送る順に並べる
+// ============================================================
+void SnapshotScheduler::accumulate(const std::vector<ObjectState>& states,
+    const std::vector<InterestGrid::Relevant>& candidates, float dt,
+    uint32_t firstId, std::vector<uint32_t>& outOrder) {
+    ++m_tick;
+    m_ranked.clear();
+    outOrder.clear();
+
+    for (const InterestGrid::Relevant& r : candidates) {
+        const ObjectState& os = states[r.index];
+        if (os.id == firstId) {
+            outOrder.push_back(r.index);
+            continue;
+        }
+
+        auto it = m_entries.find(os.id);
+        if (it == m_entries.end()) {
+            // 関心領域に入ったばかり
+            Entry e;
+            e.priority = NEW_ENTITY_PRIORITY;
+            it = m_entries.emplace(os.id, e).first;
+        } else if (dt > 0.0f) {
+            // 速く動いているものほど、送れていない間のずれが大きくなる
+            const Entry& e = it->second;
+            const float dx = os.posX - e.lastX;
+            const float dy = os.posY - e.lastY;
+            const float dz = os.posZ - e.lastZ;
+            const float speed = std::sqrt(dx * dx + dy * dy + dz * dz) / dt;
+            it->second.priority += dt * r.score * (1.0f + VELOCITY_WEIGHT * speed);
+        }
+
+        Entry& e = it->second;
+        e.lastX = os.posX; e.lastY = os.posY; e.lastZ = os.posZ;
+        e.tick = m_tick;
+        m_ranked.push_back({ e.priority, r.index });
+    }
+
+    // 候補から外れたものを捨てる（次に入ったときは新規として扱う）
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (it->second.tick != m_tick) it = m_entries.erase(it);
+        else ++it;
+    }
+
+    std::sort(m_ranked.begin(), m_ranked.end(),
+        [](const Ranked& a, const Ranked& b) { return a.priority > b.priority; });
+    for (const Ranked& r : m_ranked) outOrder.push_back(r.index);
+}
+
+// ============================================================
+// mark_current - 送れたので優先度を0に戻す
+// ============================================================
+void SnapshotScheduler::mark_current(uint32_t id) {
+    auto it = m_entries.find(id);
+    if (it != m_entries.end()) it->second.priority = 0.0f;
+}
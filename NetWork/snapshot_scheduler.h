@@ -0,0 +1,61 @@
+/*********************************************************************
+ * \file   snapshot_scheduler.h
+ * \brief  STATEに載せるオブジェクトの優先度（クライアントごと）
+ *         送れていない時間・距離・速さから優先度を積み上げ、
+ *         バイト数の上限に入る分を優先度の高い順に選ぶ
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include "network_common.h"  // ObjectState
+#include "interest_grid.h"   // InterestGrid::Relevant
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// ============================================================
+// SnapshotScheduler クラス（クライアントごと）
+//
+// 送るたびに、関心領域の候補それぞれの優先度を
+//   dt x 関連度（距離と見通し） x (1 + VELOCITY_WEIGHT x 速さ)
+// だけ増やし、高い順に並べる。SnapshotDelta::encode() が上限バイト数まで
+// 前から詰め、受信側が最新になったもの（送った・変化なし）は mark_current() で0に戻す。
+// 入らなかったものは優先度が残るので、次のパケットでは前に来る。
+// ============================================================
+class SnapshotScheduler {
+public:
+    // 速さ1m/sあたり優先度の伸びを増やす割合
+    static constexpr float VELOCITY_WEIGHT = 0.25f;
+    // 関心領域に入ったばかりのオブジェクトの初期優先度（すぐに送られるように）
+    static constexpr float NEW_ENTITY_PRIORITY = 1.0f;
+
+    // 候補の優先度をdt秒分積み上げ、優先度の高い順にstatesの添字をoutOrderに返す
+    // firstId（クライアント自身のプレイヤー）は常に先頭にする
+    // 候補から外れたオブジェクトの優先度は捨てる
+    void accumulate(const std::vector<ObjectState>& states,
+        const std::vector<InterestGrid::Relevant>& candidates, float dt,
+        uint32_t firstId, std::vector<uint32_t>& outOrder);
+
+    // 受信側がこのオブジェクトの最新の値を持った
+    void mark_current(uint32_t id);
+
+    void reset() { m_entries.clear(); }
+
+private:
+    struct Entry {
+        float priority = 0.0f;
+        float lastX = 0.0f, lastY = 0.0f, lastZ = 0.0f;  // 前回の位置（速さの計算用）
+        uint32_t tick = 0;                                // 最後に候補に入ったaccumulate()の回
+    };
+
+    std::unordered_map<uint32_t, Entry> m_entries;  // オブジェクトID → 優先度
+    uint32_t m_tick = 0;
+
+    struct Ranked {
+        float priority;
+        uint32_t index;
+    };
+    std::vector<Ranked> m_ranked;  // 並べ替えの作業用
+};
@@ -0,0 +1,132 @@
+/*********************************************************************
+ * \file   spsc_ring.h
+ * \brief  単一生産者・単一消費者（SPSC）のロックフリーリングバッファ
+ *         ワーカースレッド→メインスレッドの受信キューに使う
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// ============================================================
+// SpscRing クラステンプレート
+//
+// 要素は生成時にすべて確保しておき、生産者はスロットに直接書き込んでから
+// commit_push() で公開する。消費者は peek() で連続した範囲をまとめて受け取り、
+// 処理し終わったら pop() で解放する。
+//
+// ・生産者スレッドと消費者スレッドはそれぞれ1つだけであること
+// ・Capacityは2の累乗であること
+// ・head / tail は別々のキャッシュラインに置き、偽共有を防ぐ
+// ============================================================
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+        "SpscRing capacity must be a power of two");
+
+public:
+    static const size_t CACHE_LINE = 64;
+
+    // peek() が返す連続範囲（リングの末尾で折り返す場合は2回に分かれる）
+    struct Span {
+        T* data = nullptr;
+        size_t count = 0;
+        T* begin() const { return data; }
+        T* end() const { return data + count; }
+    };
+
+    SpscRing() : m_slots(Capacity) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // ----------------------------------------------------------
+    // 生産者側
+    // ----------------------------------------------------------
+
+    // 次に書き込むスロットを返す（満杯ならnullptr）
+    T* try_begin_push() {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_headCache >= Capacity) {
+            // キャッシュした消費位置が古いかもしれないので読み直す
+            m_headCache = m_head.load(std::memory_order_acquire);
+            if (tail - m_headCache >= Capacity) return nullptr;
+        }
+        return &m_slots[tail & (Capacity - 1)];
+    }
+
+    // 次に書き込める連続した空きスロットを最大maxCount個返す（満杯ならcount=0）
+    // 一度に複数件を受信する（recv_batch）ときに使う
+    Span try_begin_push_span(size_t maxCount) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t free = Capacity - (tail - m_headCache);
+        if (free < maxCount) {
+            m_headCache = m_head.load(std::memory_order_acquire);
+            free = Capacity - (tail - m_headCache);
+        }
+        const size_t index = tail & (Capacity - 1);
+        size_t count = free;
+        if (count > Capacity - index) count = Capacity - index;  // 折り返しの手前まで
+        if (count > maxCount) count = maxCount;
+
+        Span s;
+        s.data = &m_slots[index];
+        s.count = count;
+        return s;
+    }
+
+    // 書き込んだ先頭count個のスロットを消費者に公開する
+    void commit_push(size_t count = 1) {
+        m_tail.store(m_tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    // ----------------------------------------------------------
+    // 消費者側
+    // ----------------------------------------------------------
+
+    // 先頭から最大maxCount個の連続した要素を返す（取り出しはpop()で行う）
+    Span peek(size_t maxCount) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (m_tailCache == head) {
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+        }
+        size_t count = m_tailCache - head;
+        const size_t index = head & (Capacity - 1);
+        if (count > Capacity - index) count = Capacity - index;  // 折り返しの手前まで
+        if (count > maxCount) count = maxCount;
+
+        Span s;
+        s.data = &m_slots[index];
+        s.count = count;
+        return s;
+    }
+
+    // peek() で受け取った要素のうち先頭count個を解放する
+    void pop(size_t count) {
+        m_head.store(m_head.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    // ----------------------------------------------------------
+    // 状態確認（どちらのスレッドからでも呼べるが、目安の値）
+    // ----------------------------------------------------------
+    size_t size_approx() const {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    // 消費者が書き換える値（読み出し位置と、生産位置のキャッシュ）
+    alignas(CACHE_LINE) std::atomic<size_t> m_head{ 0 };
+    size_t m_tailCache = 0;
+
+    // 生産者が書き換える値（書き込み位置と、消費位置のキャッシュ）
+    alignas(CACHE_LINE) std::atomic<size_t> m_tail{ 0 };
+    size_t m_headCache = 0;
+
+    // 要素本体（生成時に確保し、以後は再確保しない）
+    alignas(CACHE_LINE) std::vector<T> m_slots;
+};
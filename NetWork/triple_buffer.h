@@ -0,0 +1,91 @@
+/*********************************************************************
+ * \file   triple_buffer.h
+ * \brief  1つの書き手から1つの読み手へ最新の値を渡すロックフリーのトリプルバッファ
+ *         メインスレッド→ワーカースレッドのワールドスナップショットに使う
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// ============================================================
+// TripleBuffer クラステンプレート
+//
+// 3つのスロットを「書き手用」「受け渡し用」「読み手用」に分けて持つ。
+// 書き手は back() に書き込んでから publish() で受け渡し用と入れ替え、
+// 読み手は acquire() で新しいものがあれば受け渡し用と自分のものを入れ替える。
+// 入れ替えは1回のexchangeなので、どちらも相手を待たない。
+//
+// ・書き手と読み手のスレッドはそれぞれ1つだけであること
+// ・読み手が取りに来る前に何度publish()しても、渡るのは最後の1つだけ（途中は捨てられる）
+// ・スロットは使い回すので、Tがvectorなら書き手は毎回確保し直さずに済む
+// ============================================================
+template <typename T>
+class TripleBuffer {
+public:
+    static const size_t CACHE_LINE = 64;
+
+    TripleBuffer() {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // ----------------------------------------------------------
+    // 書き手側
+    // ----------------------------------------------------------
+
+    // 次に公開するスロット（前に公開したものとは別。中身は何回か前のもの）
+    T& back() { return m_slots[m_back]; }
+
+    // back()に書いた内容を公開する（読み手がまだ取っていない前回分は捨てる）
+    void publish() {
+        const uint8_t prev = m_middle.exchange(
+            static_cast<uint8_t>(m_back | FRESH), std::memory_order_acq_rel);
+        m_back = prev & INDEX_MASK;
+    }
+
+    // ----------------------------------------------------------
+    // 読み手側
+    // ----------------------------------------------------------
+
+    // 新しく公開されたものがあればfront()をそれに替える（無ければfalseで、front()はそのまま）
+    bool acquire() {
+        if (!(m_middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        const uint8_t prev = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = prev & INDEX_MASK;
+        return true;
+    }
+
+    // 読み手がまだ取っていないものが公開されているか（front()は替えない）
+    bool has_fresh() const { return (m_middle.load(std::memory_order_relaxed) & FRESH) != 0; }
+
+    // 最後にacquire()したスロット（一度も公開されていなければ空のT）
+    const T& front() const { return m_slots[m_front]; }
+
+    // ----------------------------------------------------------
+    // どちらのスレッドも触っていないときだけ呼ぶ
+    // ----------------------------------------------------------
+
+    // 公開されていない状態に戻し、3つのスロットをすべて空のTにする
+    // （front()も空になるので、前に公開したものを読み手が使い続けることはない）
+    void reset() {
+        for (T& slot : m_slots) slot = T();
+        m_back = 0;
+        m_middle.store(1, std::memory_order_relaxed);
+        m_front = 2;
+    }
+
+private:
+    static const uint8_t INDEX_MASK = 3;
+    static const uint8_t FRESH = 4;  // 受け渡し用のスロットに読み手がまだ取っていないものがある
+
+    T m_slots[3];
+
+    // 書き手と読み手の添字は別々のキャッシュラインに置く
+    alignas(CACHE_LINE) uint8_t m_back = 0;                // 書き手専用
+    alignas(CACHE_LINE) std::atomic<uint8_t> m_middle{ 1 };  // 受け渡し用の添字 | FRESH
+    alignas(CACHE_LINE) uint8_t m_front = 2;               // 読み手専用
+};
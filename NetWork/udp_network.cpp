@@ -1,7 +1,7 @@
 /*********************************************************************
  * \file   udp_network.cpp
- * \brief  UdpNetworkNX̎
- *         WinSock2gUDP\Pbg̏EME|[gǗ
+ * \brief  UdpNetworkクラスの実装
+ *         WinSock2を使ったUDPソケットの初期化・送受信・ポート管理
  *
  * \author Ryoto Kikuchi
  * \date   2026/2/24
@@ -12,83 +12,146 @@
 #include <cstring>
 
  // ============================================================
- // ÓIȍi_|[gIp̗GWj
+ // 静的メンバの初期化（ランダムポート選択用の乱数エンジン）
  // ============================================================
 std::random_device UdpNetwork::rd;
 std::mt19937 UdpNetwork::gen(UdpNetwork::rd());
 
 // ============================================================
-// RXgN^ / fXgN^
+// コンストラクタ / デストラクタ
 // ============================================================
 
 UdpNetwork::UdpNetwork() {}
 
-// fXgN^Ń\Pbgmɕ
+// デストラクタでソケットを確実に閉じる
 UdpNetwork::~UdpNetwork() { close_socket(); }
 
-// \PbgLǂԂ
+// ソケットが有効かどうかを返す
 bool UdpNetwork::is_valid() const { return sock != INVALID_SOCKET; }
 
 // ============================================================
-// initialize - ʏUDP\Pbg쐬bind
+// open_socket - WinSockの参照を取り、UDPソケットを作る
 // ============================================================
-bool UdpNetwork::initialize(int bind_port) {
-    // WinSock2̏io[W2.2vj
-    WSADATA wsa;
-    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) {
+bool UdpNetwork::open_socket() {
+    close_socket();
+
+    // WinSockの初期化はプロセスで1回（参照カウント）
+    if (!net_startup()) {
         std::cerr << "WSAStartup failed\n";
         return false;
     }
+    winsock_started = true;
 
-    // UDP\Pbg쐬
+    // UDPソケットを作成
     sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
     if (sock == INVALID_SOCKET) {
         std::cerr << "socket() failed\n";
-        WSACleanup();
+        close_socket();
         return false;
     }
 
-    // \Pbgw|[gɃoCh
-    // INADDR_ANY = ׂẴlbg[NC^[tF[Xő҂󂯂
+#ifdef SO_REUSEPORT
+    // 同じポートに受信用のソケットを足せるようにする（bindより前に付ける必要がある）
+    if (reuse_port) {
+        BOOL bOpt = TRUE;
+        if (setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, (char*)&bOpt, sizeof(bOpt)) == SOCKET_ERROR) {
+            std::cerr << "setsockopt SO_REUSEPORT failed\n";
+            close_socket();
+            return false;
+        }
+    }
+#endif
+    return true;
+}
+
+// ============================================================
+// reuse_port_supported - SO_REUSEPORTでポートを共有できるか
+// ============================================================
+bool UdpNetwork::reuse_port_supported() {
+#ifdef SO_REUSEPORT
+    return true;
+#else
+    return false;
+#endif
+}
+
+// ============================================================
+// bind_socket - ソケットを指定ポートにbindし、実際のポート番号を読む
+// INADDR_ANY = すべてのネットワークインターフェースで待ち受ける
+// ============================================================
+bool UdpNetwork::bind_socket(int bind_port, bool join_shared) {
+    // SO_REUSEPORTを付けていると使用中のポートにもbindできてしまうので、新しく開くポートは
+    // 付けていない普通のbindが通る（誰も使っていない）ことを確かめる（チャンネルのフォールバック用）
+    if (reuse_port && bind_port != 0 && !join_shared && !is_port_available(bind_port)) return false;
+
     sockaddr_in addr;
     ZeroMemory(&addr, sizeof(addr));
     addr.sin_family = AF_INET;
     addr.sin_port = htons((unsigned short)bind_port);
     addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(sock, (sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR) return false;
+
+    // ポート0ならOSが選んだ番号になるので、実際に割り当てられた番号を読む
+    socklen_t addrLen = sizeof(addr);
+    if (getsockname(sock, (sockaddr*)&addr, &addrLen) == SOCKET_ERROR) return false;
+    current_port = ntohs(addr.sin_port);
+    return true;
+}
+
+// ============================================================
+// finish_initialize - bindの後の共通設定
+// ============================================================
+void UdpNetwork::finish_initialize() {
+    // ノンブロッキングモードにする
+    // ワーカーはNetReactorで読み込み可能を待ってから、データが尽きるまでrecv_fromで読む
+    net_set_non_blocking(sock, true);
+    is_broadcast_socket = false;
+}
 
-    if (bind(sock, (sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR) {
+// ============================================================
+// initialize - 通常のUDPソケットを作成してbindする
+// ============================================================
+bool UdpNetwork::initialize(int bind_port) {
+    if (!open_socket()) return false;
+    if (!bind_socket(bind_port)) {
         std::cerr << "bind() failed on port " << bind_port << "\n";
-        closesocket(sock);
-        sock = INVALID_SOCKET;
-        WSACleanup();
+        close_socket();
         return false;
     }
+    finish_initialize();
+    return true;
+}
 
-    // oChB݂̃|[gԍL^
-    current_port = bind_port;
-
-    // ubLO[ĥ܂܎gpipoll_recvłselect()Őj
-    // mode=0 ŃubLOɐݒ
-    u_long mode = 0;
-    ioctlsocket(sock, FIONBIO, &mode);
-
-    is_broadcast_socket = false;
+// ============================================================
+// initialize_shard - SO_REUSEPORTで共有しているポートに受信用のソケットを足す
+// ============================================================
+bool UdpNetwork::initialize_shard(int bind_port) {
+    set_reuse_port(true);
+    if (!reuse_port) return false;
+    if (!open_socket()) return false;
+    if (!bind_socket(bind_port, true)) {
+        std::cerr << "bind() with SO_REUSEPORT failed on port " << bind_port << "\n";
+        close_socket();
+        return false;
+    }
+    finish_initialize();
     return true;
 }
 
 // ============================================================
-// initialize_broadcast - u[hLXgΉ\PbgƂď
-// zXgT255.255.255.255֑M邽߂ɕKv
+// initialize_broadcast - ブロードキャスト対応ソケットとして初期化
+// ホスト探索で255.255.255.255へ送信するために必要
 // ============================================================
 bool UdpNetwork::initialize_broadcast(int bind_port) {
-    // ܂ʏ̃\PbgƂď
+    // まず通常のソケットとして初期化する
     if (!initialize(bind_port)) return false;
 
-    // SO_BROADCASTIvVLɂ
-    // ꂪȂ255.255.255.255ւ̑Ms
+    // SO_BROADCASTオプションを有効にする
+    // これがないと255.255.255.255への送信が失敗する
     BOOL bOpt = TRUE;
     if (setsockopt(sock, SOL_SOCKET, SO_BROADCAST, (char*)&bOpt, sizeof(bOpt)) == SOCKET_ERROR) {
         std::cerr << "setsockopt SO_BROADCAST failed\n";
+        close_socket();
         return false;
     }
     is_broadcast_socket = true;
@@ -96,192 +159,287 @@ bool UdpNetwork::initialize_broadcast(int bind_port) {
 }
 
 // ============================================================
-// initialize_dynamic_port - _ȋ󂫃|[gŏ
-// Œ|[gt@CAEH[ŃubNĂꍇ̃tH[obN
+// initialize_dynamic_port - 動的ポートで初期化する
+// 固定ポートがファイアウォールでブロックされている場合のフォールバック
+// 同じソケットでbindを試すだけなので、空きを調べてからbindし直す間に
+// 他のプロセスにポートを取られることはない
 // ============================================================
 bool UdpNetwork::initialize_dynamic_port() {
-    // 󂢂Ă|[g_ɒT
-    int port = get_random_available_port();
-    if (port < 0) {
+    if (!open_socket()) return false;
+
+    // 1. ポート0: OSが動的ポート範囲から空きを選ぶ（普通はこれで済む）
+    bool bound = bind_socket(0);
+
+    // 2. 残りの範囲（OSの範囲外）をランダムに試す
+    for (int rangeIdx = 2; !bound && rangeIdx < NUM_DYNAMIC_RANGES; rangeIdx++) {
+        std::uniform_int_distribution<> dis(DYNAMIC_PORT_RANGES[rangeIdx][0],
+            DYNAMIC_PORT_RANGES[rangeIdx][1]);
+        for (int attempts = 0; !bound && attempts < DYNAMIC_BIND_ATTEMPTS; attempts++) {
+            bound = bind_socket(dis(gen));
+        }
+    }
+    if (!bound) {
         std::cerr << "No available dynamic port found\n";
+        close_socket();
         return false;
     }
 
-    std::cout << "Using dynamic port: " << port << std::endl;
-    return initialize(port);
+    finish_initialize();
+    std::cout << "Using dynamic port: " << current_port << std::endl;
+    return true;
 }
 
 // ============================================================
-// send_to - wAhXUDPpPbg𑗐M
+// send_to - 指定アドレスへUDPパケットを送信する
 // ============================================================
 bool UdpNetwork::send_to(const std::string& ip, int port, const void* data, int len) {
+    // 文字列IP→バイナリに変換して送る
+    return send_to(Endpoint::from_string(ip, port), data, len);
+}
+
+// ============================================================
+// send_to - Endpointへ送信する（毎回の文字列変換をしない）
+// ============================================================
+bool UdpNetwork::send_to(const Endpoint& to, const void* data, int len) {
     if (sock == INVALID_SOCKET) return false;
 
-    // MAhXݒ
-    sockaddr_in dest;
-    ZeroMemory(&dest, sizeof(dest));
-    dest.sin_family = AF_INET;
-    dest.sin_port = htons((unsigned short)port);
-    inet_pton(AF_INET, ip.c_str(), &dest.sin_addr);  // IPoCiɕϊ
+    // 送信先アドレスを設定
+    sockaddr_in dest = to.to_sockaddr();
+
+    // sendtoでUDPパケットを送信
+    int sent = (int)sendto(sock, (const char*)data, len, 0, (sockaddr*)&dest, sizeof(dest));
+    return sent == len;  // 送信バイト数が要求と一致すれば成功
+}
 
-    // sendtoUDPpPbg𑗐M
-    int sent = sendto(sock, (const char*)data, len, 0, (sockaddr*)&dest, sizeof(dest));
-    return sent == len;  // MoCgvƈvΐ
+// ============================================================
+// send_batch - 複数の宛先へまとめて送信する
+// sendmmsgが途中で失敗した場合、その1件は飛ばして残りを送る（UDPなので再送はしない）
+// ============================================================
+int UdpNetwork::send_batch(const UdpSendItem* items, int count) {
+    if (sock == INVALID_SOCKET || count <= 0) return 0;
+
+#ifdef __linux__
+    mmsghdr msgs[BATCH_MAX];
+    iovec iovs[BATCH_MAX];
+    sockaddr_in addrs[BATCH_MAX];
+
+    int sent = 0;
+    int index = 0;
+    while (index < count) {
+        int n = count - index;
+        if (n > BATCH_MAX) n = BATCH_MAX;
+        for (int i = 0; i < n; ++i) {
+            const UdpSendItem& it = items[index + i];
+            addrs[i] = it.to.to_sockaddr();
+            iovs[i].iov_base = const_cast<void*>(it.data);
+            iovs[i].iov_len = (size_t)it.len;
+            memset(&msgs[i], 0, sizeof(msgs[i]));
+            msgs[i].msg_hdr.msg_name = &addrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int r = sendmmsg(sock, msgs, (unsigned int)n, 0);
+        if (r < 0) {
+            // 先頭の1件で失敗した → それを飛ばして続ける
+            ++index;
+            continue;
+        }
+        sent += r;
+        index += r;
+        if (r < n) ++index;  // r件目で失敗したので飛ばす
+    }
+    return sent;
+#else
+    int sent = 0;
+    for (int i = 0; i < count; ++i) {
+        if (send_to(items[i].to, items[i].data, items[i].len)) ++sent;
+    }
+    return sent;
+#endif
 }
 
 // ============================================================
-// send_broadcast - LANŜɃu[hLXgM
-// zXgTDISCOVERpPbgŎgp
+// send_broadcast - LAN内全体にブロードキャスト送信する
+// ホスト探索のDISCOVERパケットで使用
 // ============================================================
 bool UdpNetwork::send_broadcast(int port, const void* data, int len) {
     if (sock == INVALID_SOCKET) return false;
-    // 255.255.255.255 = Tulbg̑SzXgɓ͂ʂȃAhX
+    // 255.255.255.255 = サブネット内の全ホストに届く特別なアドレス
     return send_to("255.255.255.255", port, data, len);
 }
 
 // ============================================================
-// poll_recv - select()gĎMf[^邩mFAΎM
-// timeout_ms: ҋ@~bi0=ɖ߂A=҂j
-// ߂l: MoCgB0=f[^Ȃ
+// poll_recv - select()を使って受信データがあるか確認し、あれば受信する
+// timeout_ms: 待機ミリ秒（0=即座に戻る、負=無限待ち）
+// 戻り値: 受信バイト数。0=データなし
 // ============================================================
 int UdpNetwork::poll_recv(char* buffer, int bufferSize,
     std::string& from_ip, int& from_port,
     int timeout_ms) {
     if (sock == INVALID_SOCKET) return -1;
 
-    // select()p̃t@CfBXNv^Zbg
+    // select()用のファイルディスクリプタセットを準備
     fd_set readfds;
     FD_ZERO(&readfds);
     FD_SET(sock, &readfds);
 
-    // ^CAEglݒ
+    // タイムアウト値を設定
     timeval tv;
     tv.tv_sec = timeout_ms / 1000;
     tv.tv_usec = (timeout_ms % 1000) * 1000;
 
-    // select()Ń\PbgɃf[^͂Ă邩mF
+    // select()でソケットにデータが届いているか確認
     int sel = select((int)sock + 1, &readfds, nullptr, nullptr,
         (timeout_ms >= 0) ? &tv : nullptr);
-    if (sel <= 0) return 0;  // ^CAEg܂̓G[
+    if (sel <= 0) return 0;  // タイムアウトまたはエラー
 
-    // f[^͂Ă̂ŎM
-    sockaddr_in from;
-    int fromlen = sizeof(from);
-    int ret = recvfrom(sock, buffer, bufferSize, 0, (sockaddr*)&from, &fromlen);
-    if (ret <= 0) return 0;
-
-    // MIPAhXƃ|[gԍo
-    char ipbuf[INET_ADDRSTRLEN] = { 0 };
-    inet_ntop(AF_INET, &from.sin_addr, ipbuf, sizeof(ipbuf));  // oCiIPɕϊ
-    from_ip = ipbuf;
-    from_port = ntohs(from.sin_port);
-
-    return ret;  // MoCgԂ
+    // データが届いているので受信する
+    int ret = recv_from(buffer, bufferSize, from_ip, from_port);
+    return (ret > 0) ? ret : 0;
 }
 
 // ============================================================
-// close_socket - \PbgWinSock\[X
+// recv_from - 待たずに1パケット受信する
+// 戻り値: 受信バイト数。0=データなし、負=エラー
 // ============================================================
-void UdpNetwork::close_socket() {
-    if (sock != INVALID_SOCKET) {
-        closesocket(sock);
-        sock = INVALID_SOCKET;
-    }
-    WSACleanup();  // WinSock̎QƃJEg炷
+int UdpNetwork::recv_from(char* buffer, int bufferSize,
+    std::string& from_ip, int& from_port) {
+    Endpoint from;
+    int ret = recv_from(buffer, bufferSize, from);
+    if (ret <= 0) return ret;
+
+    // 送信元のIPアドレスとポート番号を取り出す
+    from_ip = from.ip_string();
+    from_port = from.port;
+    return ret;  // 受信したバイト数を返す
 }
 
 // ============================================================
-// is_port_available - w|[ggp\mF
-// ۂbind݂Đ邩Ŕ肷
+// recv_from - 待たずに1パケット受信する（送信元はEndpointのまま）
 // ============================================================
-bool UdpNetwork::is_port_available(int port) {
-    // bindeXgpWinSock
-    WSADATA wsa;
-    WSAStartup(MAKEWORD(2, 2), &wsa);
-
-    // eXgp̈ꎞ\Pbg쐬
-    SOCKET testSocket = socket(AF_INET, SOCK_DGRAM, 0);
-    if (testSocket == INVALID_SOCKET) {
-        WSACleanup();
-        return false;
-    }
-
-    // w|[gւbind݂
-    sockaddr_in addr = {};
-    addr.sin_family = AF_INET;
-    addr.sin_addr.s_addr = INADDR_ANY;
-    addr.sin_port = htons(port);
+int UdpNetwork::recv_from(char* buffer, int bufferSize, Endpoint& from) {
+    if (sock == INVALID_SOCKET) return -1;
 
-    bool available = (bind(testSocket, (sockaddr*)&addr, sizeof(addr)) == 0);
+    sockaddr_in sa;
+    socklen_t salen;
+    int ret;
+    for (;;) {
+        salen = sizeof(sa);
+        ret = (int)recvfrom(sock, buffer, bufferSize, 0, (sockaddr*)&sa, &salen);
+        if (ret >= 0) break;
+        if (net_would_block()) return 0;       // 読み切った
+        if (net_connection_reset()) continue;  // 過去の送信先が閉じていた通知なので次を読む
+        return -1;
+    }
+    if (ret == 0) return 0;
 
-    // eXgp\PbgăN[Abv
-    closesocket(testSocket);
-    WSACleanup();
-    return available;
+    from = Endpoint::from_sockaddr(sa);
+    return ret;
 }
 
 // ============================================================
-// get_random_available_port - _ɋ󂫃|[g1
-// DYNAMIC_PORT_RANGES e[u͈̔͂Ɏ
-// e͈͂ōő100񃉃_s
+// recv_batch - 届いているパケットをまとめて受信する
+// 戻り値: 受信した件数。0=データなし、負=エラー
 // ============================================================
-int UdpNetwork::get_random_available_port() {
-    for (int rangeIdx = 0; rangeIdx < NUM_DYNAMIC_RANGES; rangeIdx++) {
-        int min_port = DYNAMIC_PORT_RANGES[rangeIdx][0];
-        int max_port = DYNAMIC_PORT_RANGES[rangeIdx][1];
-
-        // ͈͓̔Ń_ȃ|[gԍ𐶐镪z
-        std::uniform_int_distribution<> dis(min_port, max_port);
+int UdpNetwork::recv_batch(UdpRecvItem* items, int count) {
+    if (sock == INVALID_SOCKET) return -1;
+    if (count <= 0) return 0;
+    if (count > BATCH_MAX) count = BATCH_MAX;
+
+#ifdef __linux__
+    mmsghdr msgs[BATCH_MAX];
+    iovec iovs[BATCH_MAX];
+    sockaddr_in addrs[BATCH_MAX];
+    for (int i = 0; i < count; ++i) {
+        iovs[i].iov_base = items[i].buffer;
+        iovs[i].iov_len = (size_t)items[i].capacity;
+        memset(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_name = &addrs[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
 
-        for (int attempts = 0; attempts < 100; attempts++) {
-            int port = dis(gen);
-            if (is_port_available(port)) {
-                return port;  // 󂫃|[g
-            }
-        }
+    int r;
+    for (;;) {
+        r = recvmmsg(sock, msgs, (unsigned int)count, MSG_DONTWAIT, nullptr);
+        if (r >= 0) break;
+        if (net_would_block()) return 0;       // 読み切った
+        if (net_connection_reset()) continue;  // 過去の送信先が閉じていた通知なので次を読む
+        return -1;
+    }
+    for (int i = 0; i < r; ++i) {
+        items[i].len = (int)msgs[i].msg_len;
+        items[i].from = Endpoint::from_sockaddr(addrs[i]);
+    }
+    return r;
+#else
+    int received = 0;
+    while (received < count) {
+        UdpRecvItem& it = items[received];
+        int r = recv_from(it.buffer, it.capacity, it.from);
+        if (r < 0) return received > 0 ? received : -1;
+        if (r == 0) break;
+        it.len = r;
+        ++received;
     }
-    return -1;  // S͈͂ŌȂ
+    return received;
+#endif
 }
 
 // ============================================================
-// get_available_port_list - ̋󂫃|[gTăXgŕԂ
+// close_socket - ソケットを閉じてWinSockの参照を返す
+// 開いていなければ何もしない（何度呼んでもよい）
 // ============================================================
-std::vector<int> UdpNetwork::get_available_port_list(int count) {
-    std::vector<int> ports;
-    for (int i = 0; i < count; i++) {
-        int port = get_random_available_port();
-        if (port > 0) {
-            ports.push_back(port);
-        }
+void UdpNetwork::close_socket() {
+    if (sock != INVALID_SOCKET) {
+        closesocket(sock);
+        sock = INVALID_SOCKET;
+    }
+    current_port = 0;
+    is_broadcast_socket = false;
+    if (winsock_started) {
+        winsock_started = false;
+        net_cleanup();  // 最後の参照ならWSACleanup
     }
-    return ports;
 }
 
 // ============================================================
-// get_local_ip - ̃}Ṽ[JIPAhX擾
-// gethostname()  getaddrinfo() ōŏɌIPv4AhXԂ
+// is_port_available - 指定ポートが使用可能か確認する
+// 実際にbindを試みて成功するかで判定する
+// ============================================================
+bool UdpNetwork::is_port_available(int port) {
+    UdpNetwork test;
+    return test.open_socket() && test.bind_socket(port);
+}
+
+// ============================================================
+// get_local_ip - このマシンのローカルIPアドレスを取得する
+// gethostname() → getaddrinfo() で最初に見つかったIPv4アドレスを返す
 // ============================================================
 std::string UdpNetwork::get_local_ip() {
-    // ܂zXg擾
+    // まずホスト名を取得
     char hostname[256];
     if (gethostname(hostname, sizeof(hostname)) == SOCKET_ERROR) {
-        return "127.0.0.1";  // slocalhostԂ
+        return "127.0.0.1";  // 失敗したらlocalhostを返す
     }
 
-    // zXgIPAhX
+    // ホスト名からIPアドレスを解決
     struct addrinfo hints = {}, * result;
-    hints.ai_family = AF_INET;       // IPv4̂
+    hints.ai_family = AF_INET;       // IPv4のみ
     hints.ai_socktype = SOCK_DGRAM;  // UDP
 
     if (getaddrinfo(hostname, NULL, &hints, &result) != 0) {
         return "127.0.0.1";
     }
 
-    // oCiAhX𕶎ɕϊ
+    // バイナリアドレスを文字列に変換
     char ip_str[INET_ADDRSTRLEN];
     struct sockaddr_in* addr_in = (struct sockaddr_in*)result->ai_addr;
     inet_ntop(AF_INET, &(addr_in->sin_addr), ip_str, INET_ADDRSTRLEN);
 
-    freeaddrinfo(result);  // mۂꂽ
+    freeaddrinfo(result);  // 確保されたメモリを解放
     return std::string(ip_str);
 }
@@ -1,115 +1,168 @@
 /*********************************************************************
  * \file   udp_network.h
- * \brief  VvUDPMbp[NXiWinSock2gpj
- *         Q[ʐM|[gƒTp|[g2g
+ * \brief  シンプルなUDP送受信ラッパークラス（WinSock2使用）
+ *         ゲーム通信ポートと探索用ポートの2つを使い分ける
  *
  * \author Ryoto Kikuchi
  * \date   2026/2/24
  *********************************************************************/
 #pragma once
 
-#include "network_common.h"  // |[g萔pPbg\
-#include <winsock2.h>        // WinSock2 API
-#include <ws2tcpip.h>        // inet_pton, inet_ntop Ȃ
+#include "network_common.h"  // ポート定数やパケット構造体
+#include "net_platform.h"    // WinSock2 / BSDソケットの差分吸収
+#include "net_endpoint.h"    // Endpoint（バイナリの送受信先）
+#include "net_transport.h"   // NetTransport（ゲーム通信の送受信インターフェース）
 #include <string>
 #include <vector>
-#include <random>            // _|[gIp
-
- // WinSock2CuN
-#pragma comment(lib, "Ws2_32.lib")
+#include <random>            // ランダムポート選択用
 
 // ============================================================
-// UdpNetwork NX
-// 1UDP\PbgbvAEMEMEN[Y񋟂B
-// NetworkManageruQ[ʐMpvƁuTpv2CX^XB
+// UdpNetwork クラス
+// 1つのUDPソケットをラップし、初期化・送信・受信・クローズを提供する。
+// NetworkManagerが「ゲーム通信用」と「探索用」で2つインスタンスを持つ。
+// ゲーム通信用はNetTransportとして使われる（テストではLoopbackTransportに差し替えられる）。
 // ============================================================
-class UdpNetwork {
+class UdpNetwork : public NetTransport {
 public:
     UdpNetwork();
-    ~UdpNetwork();
+    ~UdpNetwork() override;
 
     // ----------------------------------------------------------
-    // n
+    // 初期化系
     // ----------------------------------------------------------
 
-    // w|[gŃ\Pbg쐬bindiʏ̃Q[ʐMpj
-    // bind_port=0 ̏ꍇOSŃ|[g蓖Ă
+    // 指定ポートでソケットを作成しbindする（通常のゲーム通信用）
+    // bind_port=0 の場合はOSが自動でポートを割り当てる（実際のポートはget_current_port()）
+    // 既に開いていれば閉じてから作り直す
     bool initialize(int bind_port = NET_PORT);
 
-    // u[hLXgM\ȃ\PbgƂďiTpj
-    // initialize() Ă񂾌 SO_BROADCAST IvVݒ肷
+    // ブロードキャスト送信が可能なソケットとして初期化する（探索用）
+    // initialize() を呼んだ後に SO_BROADCAST オプションを設定する
     bool initialize_broadcast(int bind_port = DISCOVERY_PORT);
 
-    // t@CAEH[pF_ȋ󂫃|[gŏ
-    // DYNAMIC_PORT_RANGES e[u󂫃|[gT
+    // ファイアウォール回避用：動的ポートで初期化する
+    // まずポート0でOSに選ばせ（DYNAMIC_PORT_RANGESの先頭2つはOSの動的ポート範囲）、
+    // だめなら残りの範囲のポートをランダムに直接bindしてみる（空きを調べてからbindし直さない）
     bool initialize_dynamic_port();
 
+    // SO_REUSEPORTを使えるか（Linuxなど。Windowsには無い）
+    static bool reuse_port_supported();
+
+    // trueにすると、以降のinitialize系でbindの前にSO_REUSEPORTを付ける（使えない環境では何もしない）
+    // 同じポートにinitialize_shard()で受信用のソケットを足せるようになる
+    // 付けたソケットは同じ設定の他のプロセスのポートにもbindできてしまうので、
+    // ポートを指定したbindは先に普通のbindで空いていることを確かめる
+    void set_reuse_port(bool enabled) { reuse_port = enabled && reuse_port_supported(); }
+
+    // SO_REUSEPORTを付けて、既にset_reuse_port(true)で開いているbind_portにもう1つソケットを開く
+    // 届くパケットはカーネルが送信元（アドレスとポート）ごとにどれか1つのソケットへ振り分ける
+    bool initialize_shard(int bind_port);
+
     // ----------------------------------------------------------
-    // Mn
+    // 送信系
     // ----------------------------------------------------------
 
-    // wIPAhXƃ|[gɃf[^𑗐M
-    // ߂l: MoCglenƈvtrue
+    // 指定IPアドレスとポートにデータを送信する
+    // 戻り値: 送信バイト数がlenと一致すればtrue
     bool send_to(const std::string& ip, int port, const void* data, int len);
 
-    // 255.255.255.255 փu[hLXgMiLANSɓ͂j
-    // zXgTDISCOVERpPbgMɎgp
+    // Endpointへ送信する（文字列変換なし。通常の送信はこちらを使う）
+    bool send_to(const Endpoint& to, const void* data, int len) override;
+
+    // 複数の宛先・データをまとめて送信する
+    // Linuxでは sendmmsg で最大BATCH_MAX件を1回のシステムコールで送る（他はsendtoのループ）
+    // 戻り値: 送信できた件数
+    int send_batch(const UdpSendItem* items, int count) override;
+
+    // 255.255.255.255 へブロードキャスト送信する（LAN内全員に届く）
+    // ホスト探索のDISCOVERパケット送信に使用
     bool send_broadcast(int port, const void* data, int len);
 
     // ----------------------------------------------------------
-    // Mn
+    // 受信系
     // ----------------------------------------------------------
 
-    // select()Ń\PbgĎAf[^ΎM
-    // timeout_ms: ҋ@ԁi~bjB0Ȃ瑦Ƀ`FbNĖ߂
-    // ߂l: MoCgi0=f[^ȂA=G[j
+    // select()でソケットを1つだけ監視し、データがあれば受信する
+    // （ワーカースレッドはNetReactorを使う。これは探索時の単発待ち用）
+    // timeout_ms: 待機時間（ミリ秒）。0なら即座にチェックして戻る
+    // 戻り値: 受信バイト数（0=データなし、負=エラー）
     int poll_recv(char* buffer, int bufferSize,
         std::string& from_ip, int& from_port,
         int timeout_ms = 0);
 
+    // 待たずに1パケットだけ受信する（ソケットはノンブロッキング）
+    // NetReactorで読み込み可能になったソケットを空になるまで読むのに使う
+    // 戻り値: 受信バイト数（0=もうデータなし、負=エラー）
+    int recv_from(char* buffer, int bufferSize,
+        std::string& from_ip, int& from_port);
+
+    // recv_from() の送信元をEndpointで返す版（文字列を作らない）
+    int recv_from(char* buffer, int bufferSize, Endpoint& from) override;
+
+    // 届いているパケットを最大count件まとめて受信する（待たない）
+    // Linuxでは recvmmsg で1回のシステムコールにまとめる（他はrecv_fromのループ）
+    // 戻り値: 受信した件数（0=データなし、負=エラー）
+    int recv_batch(UdpRecvItem* items, int count) override;
+
+    // 1回のシステムコールでまとめて送受信する最大件数
+    static const int BATCH_MAX = 64;
+
     // ----------------------------------------------------------
-    // I
+    // 終了処理
     // ----------------------------------------------------------
 
-    // \PbgWinSockN[Abv
+    // ソケットを閉じてWinSockの参照を返す（net_cleanup）
     void close_socket();
 
     // ----------------------------------------------------------
-    // ԊmF
+    // 状態確認
     // ----------------------------------------------------------
 
-    // \PbgLiς݂ŕĂȂj肷
+    // ソケットが有効（初期化済みで閉じていない）か判定する
     bool is_valid() const;
 
     // ----------------------------------------------------------
-    // [eBeBiÓI\bhj
+    // ユーティリティ（静的メソッド）
     // ----------------------------------------------------------
 
-    // w|[ggp\mFibindeXgŔj
+    // 指定ポートが使用可能か確認する（bindテストで判定）
+    // 調べた後に他のプロセスが使うことがあるので、使うならinitialize()で直接bindする
     static bool is_port_available(int port);
 
-    // _ɋ󂫃|[g1ĕԂiȂ-1j
-    static int get_random_available_port();
-
-    // w萔󂫃|[gTăXgŕԂ
-    static std::vector<int> get_available_port_list(int count = 10);
-
-    // ̃}Ṽ[JIPAhX𕶎ŕԂi: "192.168.1.10"j
+    // このマシンのローカルIPアドレスを文字列で返す（例: "192.168.1.10"）
     static std::string get_local_ip();
 
     // ----------------------------------------------------------
-    // ANZT
+    // アクセサ
     // ----------------------------------------------------------
 
-    // bindĂ|[gԍ擾
+    // 現在bindしているポート番号を取得する（getsocknameで読んだ実際の番号）
     int get_current_port() const { return current_port; }
 
+    // ソケットハンドルを取得する（NetReactorへの登録用）
+    SOCKET get_handle() const override { return sock; }
+
 private:
-    SOCKET sock = INVALID_SOCKET;   // WinSock\Pbgnh
-    bool is_broadcast_socket = false; // u[hLXgΉ\Pbgǂ
-    int current_port = 0;            // bindĂ|[gԍ
+    // 動的ポートの範囲1つあたりに試すbindの回数（ポート0が使えなかったとき）
+    static const int DYNAMIC_BIND_ATTEMPTS = 16;
+
+    // WinSockの参照を取ってソケットを作る（bindはしない）
+    bool open_socket();
+
+    // 作ったソケットをbindし、実際のポート番号を読む（失敗してもソケットは閉じない）
+    // join_shared: SO_REUSEPORTのポートに加わる（空いているか確かめない）
+    bool bind_socket(int bind_port, bool join_shared = false);
+
+    // bindの後の共通設定（ノンブロッキング）
+    void finish_initialize();
+
+    SOCKET sock = INVALID_SOCKET;   // WinSockソケットハンドル
+    bool is_broadcast_socket = false; // ブロードキャスト対応ソケットかどうか
+    bool reuse_port = false;         // bindの前にSO_REUSEPORTを付けるか（set_reuse_port）
+    bool winsock_started = false;    // net_startup()の参照を持っているか
+    int current_port = 0;            // 現在bindしているポート番号
 
-    // _|[gp̗GWiÓIoASCX^Xʁj
+    // ランダムポート生成用の乱数エンジン（静的メンバ、全インスタンス共通）
     static std::random_device rd;
     static std::mt19937 gen;
 };
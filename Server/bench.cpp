@@ -0,0 +1,904 @@
+/*********************************************************************
+ * \file   bench.cpp
+ * \brief  ベンチマークの実装
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#include "pch.h"
+#include "bench.h"
+#include "bot_clients.h"          // BotClients
+#include "headless_world.h"       // HeadlessWorld
+#include "Engine/Collision/collider_history.h"  // Engine::ColliderHistory
+#include "Engine/Core/math_types.h"  // XMFLOAT3
+#include "Game/Managers/player_manager.h"  // Game::PlayerManager
+#include "NetWork/interest_grid.h"  // InterestGrid
+#include "NetWork/net_endpoint.h"   // Endpoint
+#include "NetWork/net_loopback.h"   // LoopbackNetwork, LoopbackTransport
+#include "NetWork/net_task_pool.h"  // NetTaskPool
+#include "NetWork/network_manager.h" // NetworkManager
+#include "NetWork/network_common.h" // MAX_UDP_PACKET
+#include "NetWork/prediction_buffer.h"  // PredictionBuffer::TICK_DT
+#include "NetWork/snapshot_delta.h" // SnapshotDelta
+#include "NetWork/snapshot_scheduler.h"  // SnapshotScheduler
+#include "NetWork/spsc_ring.h"      // SpscRing
+#include "NetWork/udp_network.h"    // UdpNetwork
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Server {
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// 起動からの経過ナノ秒（パケットに書いて、取り出したときの遅れを測る）
+uint64_t NowNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now().time_since_epoch()).count();
+}
+
+double SecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// 値の並びのp%点（samplesは並べ替える）
+double Percentile(std::vector<double>& samples, double p) {
+    if (samples.empty()) return 0.0;
+    std::sort(samples.begin(), samples.end());
+    size_t index = (size_t)(p / 100.0 * (double)(samples.size() - 1) + 0.5);
+    if (index >= samples.size()) index = samples.size() - 1;
+    return samples[index];
+}
+
+// 1行分の結果を揃えて表示する
+void PrintRow(const char* bench, const char* variant, const std::string& text) {
+    std::cout << "[Bench] " << bench << " " << std::left << std::setw(22) << variant << std::right
+        << text << "\n";
+}
+
+// ============================================================
+// recv_queue - 受信スレッド→メインスレッドのキュー
+// SpscRing（スロットに直接書き、まとめて取り出す）と、置き換える前の
+// ミューテックス + deque（受信ごとにvectorとIP文字列を確保し、1つずつロックして取り出す）を比べる
+// 生産者は受信スレッドの代わりに決まった大きさのパケットを作り続け、満杯なら空くまで待つ
+// ============================================================
+const int RECV_QUEUE_PACKETS = 200000;
+const int RECV_QUEUE_BYTES = 200;    // STATE・INPUTの大きさの目安
+const size_t RECV_QUEUE_BATCH = 64;  // メインスレッドが1回に取り出す数の上限
+const size_t RECV_QUEUE_SIZE = 1024; // NetworkManager::RECV_QUEUE_SIZEと同じ
+
+// 置き換える前のRecvPacket
+struct DequePacket {
+    std::vector<char> data;
+    int len = 0;
+    std::string from_ip;
+    int from_port = 0;
+    bool isDiscovery = false;
+};
+
+// 今のRecvPacketと同じ形のスロット
+struct RingSlot {
+    Endpoint from;
+    uint16_t len;
+    bool isDiscovery;
+    char data[MAX_UDP_PACKET];
+};
+
+// 受け取ったパケットの遅れを記録する（送信時刻はパケットの先頭8バイト）
+void ConsumePacket(const char* data, std::vector<double>& latencyUs, uint64_t& checksum) {
+    uint64_t sent;
+    memcpy(&sent, data, sizeof(sent));
+    latencyUs.push_back((double)(NowNs() - sent) / 1000.0);
+    checksum += (uint8_t)data[RECV_QUEUE_BYTES - 1];
+}
+
+void PrintQueueResult(const char* variant, double seconds, std::vector<double>& latencyUs) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(2) << (double)latencyUs.size() / seconds / 1e6 << " Mpkt/s"
+        << ", latency p50 " << std::setprecision(1) << Percentile(latencyUs, 50.0)
+        << " us, p99 " << Percentile(latencyUs, 99.0) << " us";
+    PrintRow("recv_queue", variant, text.str());
+}
+
+void BenchRecvQueue() {
+    char payload[RECV_QUEUE_BYTES];
+    for (int i = 0; i < RECV_QUEUE_BYTES; ++i) payload[i] = (char)i;
+    const Endpoint from = Endpoint::from_string("127.0.0.1", 50000);
+
+    // SpscRing
+    {
+        SpscRing<RingSlot, RECV_QUEUE_SIZE> ring;
+        std::vector<double> latencyUs;
+        latencyUs.reserve(RECV_QUEUE_PACKETS);
+        uint64_t checksum = 0;
+        const Clock::time_point start = Clock::now();
+        std::thread producer([&]() {
+            for (int i = 0; i < RECV_QUEUE_PACKETS; ++i) {
+                RingSlot* slot;
+                while ((slot = ring.try_begin_push()) == nullptr) std::this_thread::yield();
+                memcpy(slot->data, payload, RECV_QUEUE_BYTES);
+                const uint64_t now = NowNs();
+                memcpy(slot->data, &now, sizeof(now));
+                slot->len = RECV_QUEUE_BYTES;
+                slot->from = from;
+                slot->isDiscovery = false;
+                ring.commit_push();
+            }
+        });
+        int received = 0;
+        while (received < RECV_QUEUE_PACKETS) {
+            auto span = ring.peek(RECV_QUEUE_BATCH);
+            if (span.count == 0) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (const RingSlot& slot : span) ConsumePacket(slot.data, latencyUs, checksum);
+            ring.pop(span.count);
+            received += (int)span.count;
+        }
+        producer.join();
+        PrintQueueResult("spsc ring", SecondsSince(start), latencyUs);
+    }
+
+    // ミューテックス + deque（置き換える前）
+    {
+        std::deque<DequePacket> queue;
+        std::mutex mutex;
+        std::vector<double> latencyUs;
+        latencyUs.reserve(RECV_QUEUE_PACKETS);
+        uint64_t checksum = 0;
+        const Clock::time_point start = Clock::now();
+        std::thread producer([&]() {
+            char buf[MAX_UDP_PACKET];
+            for (int i = 0; i < RECV_QUEUE_PACKETS; ++i) {
+                memcpy(buf, payload, RECV_QUEUE_BYTES);
+                const uint64_t now = NowNs();
+                memcpy(buf, &now, sizeof(now));
+                DequePacket pkt;
+                pkt.data.assign(buf, buf + RECV_QUEUE_BYTES);
+                pkt.len = RECV_QUEUE_BYTES;
+                pkt.from_ip = from.ip_string();
+                pkt.from_port = from.port;
+                for (;;) {
+                    {
+                        std::lock_guard<std::mutex> lk(mutex);
+                        if (queue.size() < RECV_QUEUE_SIZE) {
+                            queue.push_back(std::move(pkt));
+                            break;
+                        }
+                    }
+                    std::this_thread::yield();
+                }
+            }
+        });
+        int received = 0;
+        while (received < RECV_QUEUE_PACKETS) {
+            DequePacket pkt;
+            {
+                std::lock_guard<std::mutex> lk(mutex);
+                if (!queue.empty()) {
+                    pkt = std::move(queue.front());
+                    queue.pop_front();
+                }
+            }
+            if (pkt.len == 0) {
+                std::this_thread::yield();
+                continue;
+            }
+            ConsumePacket(pkt.data.data(), latencyUs, checksum);
+            ++received;
+        }
+        producer.join();
+        PrintQueueResult("mutex + deque", SecondsSince(start), latencyUs);
+    }
+}
+
+// ============================================================
+// batch_send - ホストの送受信のシステムコール
+// 送信: 32クライアントへのファンアウト（1つずつsend_to と send_batch）
+// 受信: 32クライアントから1つずつ届いた分の読み出し（recv_fromの繰り返し と recv_batch）
+// 127.0.0.1のUDPソケットで、送る・読む呼び出しにかかった時間だけを測る。
+// Linuxではsend_batch / recv_batchの1回が1回のシステムコール（sendmmsg / recvmmsg）になる
+// ============================================================
+const int BATCH_CLIENTS = 32;
+const int BATCH_ROUNDS = 2000;
+const int BATCH_BYTES = 200;
+
+void PrintBatchResult(const char* variant, uint64_t packets, uint64_t calls, double seconds) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(2) << (double)packets / seconds / 1e6 << " Mpkt/s, "
+        << std::setprecision(0) << (double)calls / seconds << " calls/s, "
+        << std::setprecision(3) << (double)calls / (double)packets << " calls/pkt";
+    PrintRow("batch_send", variant, text.str());
+}
+
+void BenchBatchSend() {
+    UdpNetwork host;
+    std::vector<std::unique_ptr<UdpNetwork>> clients;
+    bool opened = host.initialize(0);
+    for (int i = 0; i < BATCH_CLIENTS && opened; ++i) {
+        clients.emplace_back(new UdpNetwork());
+        opened = clients.back()->initialize(0);
+    }
+    if (!opened) {
+        std::cout << "[Bench] batch_send could not open the sockets\n";
+        return;
+    }
+    const Endpoint hostEp = Endpoint::from_string("127.0.0.1", host.get_current_port());
+    std::vector<Endpoint> clientEps;
+    for (const auto& c : clients) clientEps.push_back(Endpoint::from_string("127.0.0.1", c->get_current_port()));
+
+    char payload[BATCH_BYTES];
+    memset(payload, 0x5A, sizeof(payload));
+    char recvBuffers[UdpNetwork::BATCH_MAX][MAX_UDP_PACKET];
+    UdpRecvItem items[UdpNetwork::BATCH_MAX];
+    for (int i = 0; i < UdpNetwork::BATCH_MAX; ++i) {
+        items[i].buffer = recvBuffers[i];
+        items[i].capacity = MAX_UDP_PACKET;
+    }
+    std::vector<UdpSendItem> fanout;
+    for (const Endpoint& ep : clientEps) fanout.push_back({ ep, payload, BATCH_BYTES });
+
+    // 受信側に溜まった分を捨てる（測らない）
+    auto drain = [&](UdpNetwork& socket) {
+        uint64_t n = 0;
+        for (int r; (r = socket.recv_batch(items, UdpNetwork::BATCH_MAX)) > 0;) n += (uint64_t)r;
+        return n;
+    };
+
+    // 送信（ファンアウト）
+    for (int batched = 0; batched < 2; ++batched) {
+        uint64_t calls = 0;
+        uint64_t delivered = 0;
+        double seconds = 0.0;
+        for (int round = 0; round < BATCH_ROUNDS; ++round) {
+            const Clock::time_point start = Clock::now();
+            if (batched) {
+                host.send_batch(fanout.data(), (int)fanout.size());
+                calls += (fanout.size() + UdpNetwork::BATCH_MAX - 1) / UdpNetwork::BATCH_MAX;
+            } else {
+                for (const UdpSendItem& item : fanout) host.send_to(item.to, item.data, item.len);
+                calls += fanout.size();
+            }
+            seconds += SecondsSince(start);
+            for (const auto& c : clients) delivered += drain(*c);
+        }
+        PrintBatchResult(batched ? "send_batch" : "send_to x 32", delivered, calls, seconds);
+    }
+
+    // 受信（ファンイン）
+    for (int batched = 0; batched < 2; ++batched) {
+        uint64_t calls = 0;
+        uint64_t received = 0;
+        double seconds = 0.0;
+        for (int round = 0; round < BATCH_ROUNDS; ++round) {
+            for (const auto& c : clients) c->send_to(hostEp, payload, BATCH_BYTES);
+            const Clock::time_point start = Clock::now();
+            for (;;) {
+                ++calls;  // データが尽きたと分かる最後の1回も数える
+                int r;
+                if (batched) {
+                    r = host.recv_batch(items, UdpNetwork::BATCH_MAX);
+                } else {
+                    Endpoint from;
+                    r = host.recv_from(recvBuffers[0], MAX_UDP_PACKET, from) > 0 ? 1 : 0;
+                }
+                if (r <= 0) break;
+                received += (uint64_t)r;
+            }
+            seconds += SecondsSince(start);
+        }
+        PrintBatchResult(batched ? "recv_batch" : "recv_from loop", received, calls, seconds);
+    }
+}
+
+// ============================================================
+// lag_history - ラグ補償のColliderHistory
+// 64人が動き回る記録（60Hzで64ティック、約1秒）に対して、
+// 毎ティックの記録、過去の時刻の箱の取り出し、巻き戻した弾の箱の重なり判定とレイ判定の1回あたりを測る。
+// 比べる対象は、巻き戻さずに今の箱だけと判定する場合（64人分の箱の配列を順に見る）
+// 弾はマップのどこかにばらまくので、ほとんど当たらず全員分を調べる（最も遅い場合）
+// ============================================================
+const int HISTORY_PLAYERS = 64;
+const int HISTORY_RECORD_TICKS = 100000;
+const int HISTORY_QUERIES = 1000000;
+const float HISTORY_AREA = 100.0f;           // プレイヤーが居る範囲（-100から100）
+const double HISTORY_TICK = 1.0 / 60.0;
+
+void PrintNsRow(const char* variant, double seconds, int count, const std::string& extra = std::string()) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(1) << seconds * 1e9 / (double)count << " ns" << extra;
+    PrintRow("lag_history", variant, text.str());
+}
+
+void BenchLagHistory() {
+    using DirectX::XMFLOAT3;
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<float> pos(-HISTORY_AREA, HISTORY_AREA);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    // 各プレイヤーの位置と速度（1ティックごとに進める）
+    XMFLOAT3 at[HISTORY_PLAYERS];
+    XMFLOAT3 vel[HISTORY_PLAYERS];
+    for (int i = 0; i < HISTORY_PLAYERS; ++i) {
+        at[i] = { pos(rng), 0.0f, pos(rng) };
+        vel[i] = { unit(rng) * 0.1f, 0.0f, unit(rng) * 0.1f };
+    }
+    const XMFLOAT3 half = { 0.4f, 0.9f, 0.4f };  // プレイヤーの箱の半分の大きさ
+
+    // 記録（BeginTick + 全員分のRecord）
+    static Engine::ColliderHistory history;  // 1ティック約1.5KB x 64なのでスタックに置かない
+    history.Clear();
+    double time = 0.0;
+    const Clock::time_point recordStart = Clock::now();
+    for (int tick = 0; tick < HISTORY_RECORD_TICKS; ++tick) {
+        time += HISTORY_TICK;
+        history.BeginTick(time);
+        for (int i = 0; i < HISTORY_PLAYERS; ++i) {
+            // 範囲の端で跳ね返る
+            if (std::fabs(at[i].x + vel[i].x) > HISTORY_AREA) vel[i].x = -vel[i].x;
+            if (std::fabs(at[i].z + vel[i].z) > HISTORY_AREA) vel[i].z = -vel[i].z;
+            at[i].x += vel[i].x;
+            at[i].z += vel[i].z;
+            history.Record(i, { at[i].x - half.x, at[i].y, at[i].z - half.z },
+                { at[i].x + half.x, at[i].y + 2.0f * half.y, at[i].z + half.z });
+        }
+    }
+    PrintNsRow("record tick (64)", SecondsSince(recordStart), HISTORY_RECORD_TICKS);
+
+    // 問い合わせ（乱数は先に作っておき、測る時間に入れない）
+    struct Query {
+        double time;
+        int slot;
+        XMFLOAT3 min, max;
+        XMFLOAT3 dir;
+    };
+    const double oldest = history.OldestTime();
+    const double span = history.NewestTime() - oldest;
+    std::uniform_real_distribution<double> when(0.0, span);
+    std::vector<Query> queries(HISTORY_QUERIES);
+    for (Query& q : queries) {
+        q.time = oldest + when(rng);
+        q.slot = (int)(rng() % HISTORY_PLAYERS);
+        const XMFLOAT3 c = { pos(rng), 1.0f, pos(rng) };
+        q.min = { c.x - 0.1f, c.y - 0.1f, c.z - 0.1f };
+        q.max = { c.x + 0.1f, c.y + 0.1f, c.z + 0.1f };
+        const float yaw = unit(rng) * 3.14159265f;
+        q.dir = { std::cos(yaw), 0.0f, std::sin(yaw) };
+    }
+
+    // 取り出した箱を使わないと最適化で消えるので、正の側に居た数を数える
+    int positive = 0;
+    Clock::time_point start = Clock::now();
+    for (const Query& q : queries) {
+        XMFLOAT3 bmin, bmax;
+        if (history.GetBounds(q.slot, q.time, bmin, bmax) && bmin.x > 0.0f) ++positive;
+    }
+    PrintNsRow("GetBounds", SecondsSince(start), HISTORY_QUERIES,
+        ", " + std::to_string(positive) + " at x > 0");
+
+    int hits = 0;
+    start = Clock::now();
+    for (const Query& q : queries) {
+        if (history.OverlapBox(q.time, q.min, q.max, -1) >= 0) ++hits;
+    }
+    PrintNsRow("OverlapBox (rewound)", SecondsSince(start), HISTORY_QUERIES,
+        ", " + std::to_string(hits) + " hits");
+
+    // 巻き戻さない場合: 今の箱だけを配列に持って順に調べる
+    struct Box { XMFLOAT3 min, max; };
+    Box current[HISTORY_PLAYERS];
+    for (int i = 0; i < HISTORY_PLAYERS; ++i) {
+        history.GetBounds(i, history.NewestTime(), current[i].min, current[i].max);
+    }
+    hits = 0;
+    start = Clock::now();
+    for (const Query& q : queries) {
+        for (const Box& b : current) {
+            if (q.min.x <= b.max.x && q.max.x >= b.min.x && q.min.y <= b.max.y && q.max.y >= b.min.y &&
+                q.min.z <= b.max.z && q.max.z >= b.min.z) {
+                ++hits;
+                break;
+            }
+        }
+    }
+    PrintNsRow("current boxes only", SecondsSince(start), HISTORY_QUERIES,
+        ", " + std::to_string(hits) + " hits");
+
+    hits = 0;
+    start = Clock::now();
+    for (const Query& q : queries) {
+        float dist;
+        const XMFLOAT3 origin = { (q.min.x + q.max.x) * 0.5f, 1.0f, (q.min.z + q.max.z) * 0.5f };
+        if (history.Raycast(q.time, origin, q.dir, 200.0f, -1, dist) >= 0) ++hits;
+    }
+    PrintNsRow("Raycast (rewound)", SecondsSince(start), HISTORY_QUERIES,
+        ", " + std::to_string(hits) + " hits");
+}
+
+// ============================================================
+// interest - ホストがSTATEを作る1回分の重さ（64クライアント・2000オブジェクト）
+// 関心領域（InterestGrid）で候補を絞って優先度順に帯域内で詰める今の方法と、
+// 置き換える前の全オブジェクトを全クライアントに送る方法を比べる。
+// 1回の送信 = セルへの振り分け + 全クライアント分の候補の取り出し・並べ替え・符号化
+// クライアントは毎回すぐACKする（ベースラインが毎回進む）として、オブジェクトは少しずつ動かす
+// 見通しの判定はマップが要るので使わない（候補が減らない分、遅い側になる）
+// ============================================================
+const int INTEREST_CLIENTS = 64;
+const int INTEREST_OBJECTS = 2000;       // 先頭のINTEREST_CLIENTS個が各クライアントのプレイヤー
+const int INTEREST_SENDS = 100;
+const float INTEREST_AREA = 25.0f;       // 50mのマップ（-25から25）
+const float INTEREST_SEND_DT = 1.0f / 30.0f;
+const int INTEREST_BYTES_PER_SECOND = 16 * 1024;  // NetworkManagerの1クライアントあたりの帯域と同じ
+
+// 1クライアント分の送信の流れ
+struct InterestClient {
+    SnapshotDelta snapshots;
+    SnapshotScheduler scheduler;
+};
+
+void RunInterest(const char* variant, bool useGrid) {
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<float> pos(-INTEREST_AREA, INTEREST_AREA);
+    std::uniform_real_distribution<float> step(-0.2f, 0.2f);
+
+    std::vector<ObjectState> states(INTEREST_OBJECTS);
+    for (int i = 0; i < INTEREST_OBJECTS; ++i) {
+        states[i] = { (uint32_t)(i + 1), pos(rng), 1.0f, pos(rng), 0.0f, 0.0f, 0.0f };
+    }
+    std::vector<std::unique_ptr<InterestClient>> clients;
+    for (int c = 0; c < INTEREST_CLIENTS; ++c) clients.push_back(std::make_unique<InterestClient>());
+
+    // 帯域 x 間隔（MTUを超えない）。全部を送る方法は上限なし
+    int budget = (int)(INTEREST_BYTES_PER_SECOND * INTEREST_SEND_DT);
+    if (budget > MAX_STATE_BYTES) budget = MAX_STATE_BYTES;
+
+    InterestGrid grid;
+    std::vector<InterestGrid::Relevant> relevant;
+    std::vector<uint32_t> sendOrder;
+    std::vector<ObjectState> clientStates;
+    std::vector<uint8_t> sentCurrent;
+    std::vector<char> packet;
+    uint64_t candidates = 0;
+    uint64_t bytes = 0;
+    double seconds = 0.0;
+    for (int send = 0; send < INTEREST_SENDS; ++send) {
+        // 動かすのは測る時間に入れない
+        for (ObjectState& s : states) {
+            s.posX = std::max(-INTEREST_AREA, std::min(INTEREST_AREA, s.posX + step(rng)));
+            s.posZ = std::max(-INTEREST_AREA, std::min(INTEREST_AREA, s.posZ + step(rng)));
+        }
+
+        const Clock::time_point start = Clock::now();
+        if (useGrid) grid.rebuild(states);
+        for (int c = 0; c < INTEREST_CLIENTS; ++c) {
+            InterestClient& client = *clients[c];
+            if (send > 0) client.snapshots.on_ack((uint32_t)send - 1);
+            if (useGrid) {
+                grid.query(states[c], states[c].id, relevant);
+                client.scheduler.accumulate(states, relevant, INTEREST_SEND_DT, states[c].id, sendOrder);
+                clientStates.clear();
+                for (uint32_t index : sendOrder) clientStates.push_back(states[index]);
+                client.snapshots.encode((uint32_t)send, (uint16_t)send, clientStates, packet,
+                    nullptr, budget, &sentCurrent);
+                for (size_t i = 0; i < clientStates.size(); ++i) {
+                    if (sentCurrent[i]) client.scheduler.mark_current(clientStates[i].id);
+                }
+                candidates += relevant.size();
+            } else {
+                client.snapshots.encode((uint32_t)send, (uint16_t)send, states, packet);
+                candidates += states.size();
+            }
+            bytes += packet.size();
+        }
+        seconds += SecondsSince(start);
+    }
+
+    const double perClient = 1.0 / ((double)INTEREST_SENDS * INTEREST_CLIENTS);
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(0) << seconds * 1e6 / INTEREST_SENDS << " us/send, "
+        << std::setprecision(1) << (double)candidates * perClient << " candidates, "
+        << std::setprecision(0) << (double)bytes * perClient << " bytes/client";
+    PrintRow("interest", variant, text.str());
+}
+
+void BenchInterest() {
+    RunInterest("grid + budget", true);
+    RunInterest("all objects", false);
+}
+
+// ============================================================
+// startup - ソケットを開くまでの時間
+// 今の動的ポート（1つのソケットでポート0をbind）と、置き換える前の方法
+// （ランダムなポートを is_port_available で調べてから initialize で開き直す）を比べる。
+// 調べたポートが空いていれば1回で済む、置き換える前の方法で最も速い場合になる
+// あわせて NetworkManager の start_as_client / start_as_host（専用サーバー）全体を測る
+// ============================================================
+const int STARTUP_RUNS = 200;
+
+// 測っている間だけ標準出力を捨てる（開くたびに書く"Using dynamic port"などのログの時間を入れない）
+class MuteStdout {
+public:
+    MuteStdout() : m_saved(std::cout.rdbuf(nullptr)) {}
+    ~MuteStdout() { std::cout.rdbuf(m_saved); }
+private:
+    std::streambuf* m_saved;
+};
+
+// STARTUP_RUNS回、新しいTを作ってopenで開くまでの時間を測り、中央値とp99と失敗した回数を表示する
+// 閉じるのはTを捨てるときなので測る時間に入れない
+template <typename T, typename Open>
+void MeasureStartup(const char* variant, Open open) {
+    std::vector<double> us;
+    int failed = 0;
+    {
+        MuteStdout mute;
+        for (int run = 0; run < STARTUP_RUNS; ++run) {
+            T net;
+            const Clock::time_point start = Clock::now();
+            if (!open(net)) ++failed;
+            us.push_back(SecondsSince(start) * 1e6);
+        }
+    }
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(1) << "median " << Percentile(us, 50.0) << " us, p99 "
+        << Percentile(us, 99.0) << " us";
+    if (failed > 0) text << ", " << failed << " failed";
+    PrintRow("startup", variant, text.str());
+}
+
+void BenchStartup() {
+    MeasureStartup<UdpNetwork>("bind port 0", [](UdpNetwork& net) {
+        return net.initialize_dynamic_port();
+    });
+
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<> dis(DYNAMIC_PORT_RANGES[0][0], DYNAMIC_PORT_RANGES[0][1]);
+    MeasureStartup<UdpNetwork>("probe + bind", [&](UdpNetwork& net) {
+        for (int attempts = 0; attempts < 100; ++attempts) {
+            const int port = dis(rng);
+            if (UdpNetwork::is_port_available(port) && net.initialize(port)) return true;
+        }
+        return false;
+    });
+
+    MeasureStartup<NetworkManager>("start_as_client", [](NetworkManager& net) {
+        return net.start_as_client();
+    });
+    MeasureStartup<NetworkManager>("start_as_host", [](NetworkManager& net) {
+        return net.start_as_host(false);
+    });
+}
+
+// ============================================================
+// shards - 受信シャード（SO_REUSEPORT）への振り分け
+// ループバックで多数の送信元ポートからホストのゲーム通信ポートへ送り続け、
+// 受信できたパケット/秒と、ソケットごとに受け取った数の偏りをシャード数ごとに比べる
+// 送信元ごとに同じ数を送るので、ソケットごとの数がカーネルの振り分けをそのまま表す
+// ホストはメインスレッドでservice()を回してキューを空ける（知らない相手のパケットは捨てられる）
+// 受信スレッドが並ぶ効果はコア数までしか出ない
+// ============================================================
+const int SHARD_SENDERS = 64;         // 送信元のソケット（ポート）の数
+const int SHARD_PACKET_BYTES = 64;
+const double SHARD_SECONDS = 1.0;
+const int SHARD_COUNTS[] = { 1, 2, 4, 8 };
+
+void RunShards(int shards) {
+    NetworkManager host;
+    host.set_receive_shards(shards);
+    bool started;
+    {
+        MuteStdout mute;
+        started = host.start_as_host(false);
+    }
+    if (!started) {
+        PrintRow("shards", "host", "could not start");
+        return;
+    }
+
+    std::vector<std::unique_ptr<UdpNetwork>> senders;
+    for (int i = 0; i < SHARD_SENDERS; ++i) {
+        auto sender = std::make_unique<UdpNetwork>();
+        if (sender->initialize(0)) senders.push_back(std::move(sender));
+    }
+    const Endpoint to = Endpoint::from_string("127.0.0.1", NET_PORT);
+
+    // 送信スレッド: 送信元を順に替えながら決まった時間だけ送る
+    std::atomic<bool> sending(true);
+    uint64_t sent = 0;
+    std::thread sendThread([&]() {
+        char packet[SHARD_PACKET_BYTES] = {};
+        const Clock::time_point start = Clock::now();
+        while (SecondsSince(start) < SHARD_SECONDS) {
+            for (auto& s : senders) {
+                if (s->send_to(to, packet, sizeof(packet))) ++sent;
+            }
+        }
+        sending = false;
+    });
+
+    std::vector<std::shared_ptr<Game::GameObject>> worldObjects;
+    const Clock::time_point start = Clock::now();
+    while (sending) host.service(nullptr, worldObjects);
+    sendThread.join();
+    const double seconds = SecondsSince(start);
+    // 受信スレッドがソケットに残った分を積み終えるのを少し待つ
+    const Clock::time_point drainStart = Clock::now();
+    while (SecondsSince(drainStart) < 0.1) host.service(nullptr, worldObjects);
+
+    NetStatsReport stats;
+    host.get_stats(stats);
+    uint64_t least = stats.recvShardPackets.empty() ? 0 : stats.recvShardPackets[0];
+    uint64_t most = 0;
+    std::ostringstream spread;
+    for (size_t i = 0; i < stats.recvShardPackets.size(); ++i) {
+        least = std::min(least, stats.recvShardPackets[i]);
+        most = std::max(most, stats.recvShardPackets[i]);
+        spread << (i > 0 ? "/" : "") << stats.recvShardPackets[i];
+    }
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(2) << (double)stats.recvPackets / seconds / 1e6 << " Mpkt/s, "
+        << "sent " << sent << ", queue full " << stats.recvDropped << ", socket full "
+        << sent - std::min(sent, stats.recvPackets + stats.recvDropped) << ", per socket " << spread.str();
+    if (least > 0) text << " (max/min " << std::setprecision(2) << (double)most / (double)least << ")";
+    const std::string variant = std::to_string(stats.recvShards) +
+        (stats.recvShards == 1 ? " socket" : " sockets");
+    PrintRow("shards", variant.c_str(), text.str());
+}
+
+void BenchShards() {
+    if (!UdpNetwork::reuse_port_supported()) {
+        PrintRow("shards", "", "SO_REUSEPORT is not available, only 1 socket");
+    }
+    if (!UdpNetwork::is_port_available(NET_PORT)) {
+        PrintRow("shards", "", "port " + std::to_string(NET_PORT) + " is in use, skipped");
+        return;
+    }
+    for (int shards : SHARD_COUNTS) RunShards(shards);
+}
+
+// ============================================================
+// encode - ホストのSTATEの符号化（send_states_to_clients）をスレッド数ごとに比べる
+// ループバックのボット64人を参加させて歩かせ、毎ティックのスナップショットを全員分
+// 符号化する（送信の間隔を0にして、公開したスナップショットをティックごとに送る）。
+// 時間はNetworkManagerが測る符号化の時間（写す・符号化する・パケットにまとめるまで、送信は含まない）
+// 追加のスレッドの効果はコア数までしか出ない
+// ============================================================
+const int ENCODE_WARMUP_TICKS = 60;    // 参加した後、ベースラインのACKが回るまで
+const int ENCODE_TICKS = 600;
+const std::chrono::seconds ENCODE_JOIN_LIMIT(3);
+
+// 1, 2, 4 ... と論理コア数（NetTaskPool::MAX_THREADSまで）
+std::vector<int> EncodeThreadCounts() {
+    int cores = (int)std::thread::hardware_concurrency();
+    if (cores < 1) cores = 1;
+    if (cores > NetTaskPool::MAX_THREADS) cores = NetTaskPool::MAX_THREADS;
+    std::vector<int> counts;
+    for (int n = 1; n < cores; n *= 2) counts.push_back(n);
+    counts.push_back(cores);
+    return counts;
+}
+
+// 1ティックの平均（マイクロ秒）。測れなければ負の値
+double RunEncode(HeadlessWorld& world, int threads, std::string& note) {
+    const float dt = PredictionBuffer::TICK_DT;
+
+    MuteStdout mute;
+    LoopbackNetwork network;
+    LoopbackTransport hostSocket(network);
+    std::unique_ptr<Game::PlayerManager> players(new Game::PlayerManager());
+    std::vector<std::shared_ptr<Game::GameObject>> hostObjects;
+
+    NetworkManager host(&hostSocket);
+    players->Initialize(world.GetMap(), nullptr, &host);
+    host.set_player_manager(players.get());
+    host.set_encode_threads(threads);
+    host.set_state_send_interval(std::chrono::milliseconds(0));
+    if (!host.start_as_host(false)) {
+        note = "could not start";
+        return -1.0;
+    }
+    BotClients bots(network, MAX_PLAYERS, 1);
+    if (!bots.Start(hostSocket.get_endpoint())) {
+        note = "could not start bots";
+        return -1.0;
+    }
+
+    // 専用サーバーのSimulationStepと同じ順序で1ティック進める
+    auto tick = [&]() {
+        bots.Step();
+        host.update(dt, nullptr, hostObjects);
+        players->UpdateSimulation(dt);
+        host.publish_snapshot();
+        host.flush_messages();
+    };
+
+    const Clock::time_point joinStart = Clock::now();
+    while (bots.GetJoinedCount() < MAX_PLAYERS && Clock::now() - joinStart < ENCODE_JOIN_LIMIT) {
+        tick();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    for (int i = 0; i < ENCODE_WARMUP_TICKS; ++i) tick();
+
+    NetStatsReport before;
+    host.get_stats(before);
+    for (int i = 0; i < ENCODE_TICKS; ++i) tick();
+    NetStatsReport after;
+    host.get_stats(after);
+
+    const uint64_t count = after.encodeCount - before.encodeCount;
+    if (count == 0) {
+        note = "no STATE encoded";
+        return -1.0;
+    }
+    std::ostringstream text;
+    text << bots.GetJoinedCount() << " clients, " << count << " ticks";
+    note = text.str();
+    return (after.encodeSeconds - before.encodeSeconds) * 1e6 / (double)count;
+}
+
+void BenchEncode() {
+    HeadlessWorld world;
+    if (!world.IsReady()) {
+        PrintRow("encode", "", "could not load the map");
+        return;
+    }
+
+    double single = -1.0;
+    for (int threads : EncodeThreadCounts()) {
+        std::string note;
+        const double us = RunEncode(world, threads, note);
+        const std::string variant = std::to_string(threads) + (threads == 1 ? " thread" : " threads");
+        if (us < 0.0) {
+            PrintRow("encode", variant.c_str(), note);
+            continue;
+        }
+        if (threads == 1) single = us;
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(1) << us << " us/tick";
+        if (single > 0.0) text << ", x" << std::setprecision(2) << single / us;
+        text << " (" << note << ")";
+        PrintRow("encode", variant.c_str(), text.str());
+    }
+}
+
+// ============================================================
+// reactor_latency - 受信スレッドが起きてパケットを受信キューに積むまでの遅れ
+// 送信時刻を書いたデータグラムを127.0.0.1のホストのゲーム通信ポートへ1つずつ送り、
+// ワーカーがそれを受信キューに積む（commit_push）直前の時刻との差を測る
+// （ソケットの待ち・起床・recv_batchまで）。積まれたのを見てから次を送るので、キューは溜まらない
+// 先頭のバイトはパケットの種別に無い値にして、メインスレッドでは捨てられるようにする
+// ============================================================
+const int REACTOR_LATENCY_PACKETS = 20000;
+const uint8_t REACTOR_LATENCY_MARK = 0xFF;
+const std::chrono::milliseconds REACTOR_LATENCY_TIMEOUT(50);  // これを過ぎたら届かなかったとみなす
+
+void BenchReactorLatency() {
+    if (!UdpNetwork::is_port_available(NET_PORT)) {
+        PrintRow("reactor_latency", "", "port " + std::to_string(NET_PORT) + " is in use, skipped");
+        return;
+    }
+
+    // ワーカースレッドが書き、メインスレッドはqueuedが増えたのを見てから読む
+    std::vector<double> latencyUs(REACTOR_LATENCY_PACKETS);
+    std::atomic<int> queued(0);
+    NetworkManager host;
+    host.set_recv_probe([&](const char* data, int len) {
+        if (len < 1 + (int)sizeof(uint64_t) || (uint8_t)data[0] != REACTOR_LATENCY_MARK) return;
+        const uint64_t now = NowNs();
+        uint64_t sent;
+        memcpy(&sent, data + 1, sizeof(sent));
+        const int index = queued.load(std::memory_order_relaxed);
+        if (index >= REACTOR_LATENCY_PACKETS) return;
+        latencyUs[index] = (double)(now - sent) / 1000.0;
+        queued.store(index + 1, std::memory_order_release);
+    });
+    bool started;
+    {
+        MuteStdout mute;
+        started = host.start_as_host(false);
+    }
+    UdpNetwork sender;
+    if (!started || !sender.initialize(0)) {
+        PrintRow("reactor_latency", "host", "could not start");
+        return;
+    }
+    const Endpoint to = Endpoint::from_string("127.0.0.1", NET_PORT);
+
+    std::vector<std::shared_ptr<Game::GameObject>> worldObjects;
+    char packet[1 + sizeof(uint64_t)] = {};
+    packet[0] = (char)REACTOR_LATENCY_MARK;
+    int lost = 0;
+    for (int i = 0; i < REACTOR_LATENCY_PACKETS; ++i) {
+        const int before = queued.load(std::memory_order_acquire);
+        const uint64_t sent = NowNs();
+        memcpy(packet + 1, &sent, sizeof(sent));
+        if (!sender.send_to(to, packet, sizeof(packet))) {
+            ++lost;
+            continue;
+        }
+        // 積まれるまで待つ間もメインスレッドと同じようにキューを空ける
+        // （先に積まれていても1回は取り出す。取り出さないとキューが溢れて捨てられる）
+        const Clock::time_point start = Clock::now();
+        do {
+            host.service(nullptr, worldObjects);
+            if (Clock::now() - start > REACTOR_LATENCY_TIMEOUT) {
+                ++lost;
+                break;
+            }
+        } while (queued.load(std::memory_order_acquire) == before);
+    }
+
+    // 遅れて届いた分はワーカーがまだ書き込むかもしれないので、積まれた分だけを写して使う
+    std::vector<double> samples(latencyUs.begin(), latencyUs.begin() + queued.load(std::memory_order_acquire));
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(1) << "p50 " << Percentile(samples, 50.0) << " us, p99 "
+        << Percentile(samples, 99.0) << " us, max " << Percentile(samples, 100.0) << " us ("
+        << samples.size() << " packets";
+    if (lost > 0) text << ", " << lost << " lost";
+    text << ")";
+    PrintRow("reactor_latency", "send to queue", text.str());
+}
+
+// 実行できるベンチマークの一覧
+struct Benchmark {
+    const char* name;
+    void (*run)();
+};
+
+const Benchmark BENCHMARKS[] = {
+    { "recv_queue", &BenchRecvQueue },
+    { "reactor_latency", &BenchReactorLatency },
+    { "batch_send", &BenchBatchSend },
+    { "lag_history", &BenchLagHistory },
+    { "interest", &BenchInterest },
+    { "startup", &BenchStartup },
+    { "shards", &BenchShards },
+    { "encode", &BenchEncode },
+};
+
+} // namespace
+
+// ============================================================
+// RunBenchmarks - 選んだベンチマークを順に実行する
+// ============================================================
+int RunBenchmarks(const std::string& name) {
+    std::cout << "[Bench] " << std::thread::hardware_concurrency() << " hardware threads\n";
+    int ran = 0;
+    for (const Benchmark& b : BENCHMARKS) {
+        if (name != "all" && name != b.name) continue;
+        b.run();
+        ++ran;
+    }
+    if (ran == 0) {
+        std::cout << "[Bench] unknown benchmark " << name << " (" << GetBenchmarkNames() << ")\n";
+        return -1;
+    }
+    return 0;
+}
+
+std::string GetBenchmarkNames() {
+    std::string names = "all";
+    for (const Benchmark& b : BENCHMARKS) {
+        names += " ";
+        names += b.name;
+    }
+    return names;
+}
+
+} // namespace Server
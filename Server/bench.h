@@ -0,0 +1,26 @@
+/*********************************************************************
+ * \file   bench.h
+ * \brief  通信まわりの部品のベンチマーク（DedicatedServer --bench）
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include <string>
+
+namespace Server {
+
+// ============================================================
+// ベンチマーク
+// 通信まわりの部品の速さを、置き換える前の方法と同じ条件で測って並べて表示する。
+// 値は環境（コア数・負荷）で大きく変わるので合否は判定しない
+// name: "all" なら全部、それ以外はその名前のものだけを実行する
+// 戻り値: 0なら実行できた、名前が見つからなければ-1
+// ============================================================
+int RunBenchmarks(const std::string& name);
+
+// 実行できるベンチマークの名前を空白区切りで返す（使い方の表示用）
+std::string GetBenchmarkNames();
+
+} // namespace Server
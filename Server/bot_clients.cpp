@@ -0,0 +1,116 @@
+/*********************************************************************
+ * \file   bot_clients.cpp
+ * \brief  BotClientsクラスの実装
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#include "pch.h"
+#include "bot_clients.h"
+#include "NetWork/network_manager.h"
+#include "NetWork/prediction_buffer.h"   // PredictionBuffer::TICK_DT
+#include <cmath>
+#include <iostream>
+
+namespace Server {
+
+BotClients::BotClients(LoopbackNetwork& network, int count, int inputRedundancy)
+    : m_network(network) {
+    m_bots.resize((size_t)(count > 0 ? count : 0));
+    for (size_t i = 0; i < m_bots.size(); ++i) {
+        Bot& bot = m_bots[i];
+        bot.transport.reset(new LoopbackTransport(m_network));
+        bot.net.reset(new NetworkManager(bot.transport.get()));
+        bot.net->set_game_binding(false);
+        bot.net->set_input_redundancy(inputRedundancy);
+        bot.rng = 0x9E3779B9u * (uint32_t)(i + 1);
+    }
+}
+
+BotClients::~BotClients() {
+    // NetworkManagerが先にLoopbackTransportを使い終わるようにする
+    for (Bot& bot : m_bots) bot.net.reset();
+}
+
+uint32_t BotClients::NextRandom(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// ============================================================
+// Start - 全員をクライアントとして起動してJOINを送る
+// JOIN_ACKはStep()の受信処理で受け取る（届かなければJOINが再送される）
+// ============================================================
+bool BotClients::Start(const Endpoint& host) {
+    for (Bot& bot : m_bots) {
+        if (!bot.transport->get_endpoint().is_valid() || !bot.net->start_as_client()) {
+            std::cerr << "[Bots] failed to start a bot client\n";
+            return false;
+        }
+        bot.net->join(host);
+    }
+    std::cout << "[Bots] " << m_bots.size() << " bots sent JOIN\n";
+    return true;
+}
+
+// ============================================================
+// Step - 1ステップ分の受信と入力の送信
+// 向きを時々変えながら前に歩き、たまにジャンプする
+// ============================================================
+void BotClients::Step() {
+    const float dt = PredictionBuffer::TICK_DT;
+    for (Bot& bot : m_bots) {
+        bot.net->update(dt, nullptr, m_noObjects);
+
+        const uint32_t playerId = bot.net->getMyPlayerId();
+        if (playerId == 0) continue;
+
+        if (--bot.turnSteps <= 0) {
+            bot.yaw = (float)(NextRandom(bot.rng) % 360);
+            bot.turnSteps = 30 + (int)(NextRandom(bot.rng) % 90);
+        }
+        const float yawRad = bot.yaw * 3.14159265f / 180.0f;
+
+        PacketInput input = {};
+        input.type = PKT_INPUT;
+        input.playerId = playerId;
+        input.moveX = std::sin(yawRad);
+        input.moveY = 0.0f;
+        input.moveZ = std::cos(yawRad);
+        input.yaw = bot.yaw;
+        input.buttons = (NextRandom(bot.rng) % 200 == 0) ? INPUT_BUTTON_JUMP : 0;
+        bot.net->send_input(input);
+        bot.net->flush_messages();
+    }
+}
+
+int BotClients::GetJoinedCount() const {
+    int joined = 0;
+    for (const Bot& bot : m_bots) {
+        if (bot.net->getMyPlayerId() != 0) ++joined;
+    }
+    return joined;
+}
+
+int BotClients::GetDistinctIdCount() const {
+    uint64_t seen = 0;
+    int distinct = 0;
+    for (const Bot& bot : m_bots) {
+        const uint32_t id = bot.net->getMyPlayerId();
+        if (id == 0 || id > (uint32_t)MAX_PLAYERS) continue;
+        const uint64_t bit = 1ull << (id - 1);
+        if (!(seen & bit)) ++distinct;
+        seen |= bit;
+    }
+    return distinct;
+}
+
+uint64_t BotClients::GetStatesReceived() const {
+    uint64_t total = 0;
+    for (const Bot& bot : m_bots) total += bot.net->get_states_received();
+    return total;
+}
+
+} // namespace Server
@@ -0,0 +1,67 @@
+/*********************************************************************
+ * \file   bot_clients.h
+ * \brief  専用サーバーと同じプロセスで動かすボットのクライアント（--bots）
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include "NetWork/net_loopback.h"  // LoopbackNetwork, LoopbackTransport
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class NetworkManager;
+namespace Game { class GameObject; }
+
+namespace Server {
+
+// ============================================================
+// BotClients クラス
+// LoopbackTransportを持つクライアントのNetworkManagerをcount個作り、
+// ホストへJOINさせて、参加できたものは毎ステップランダムに歩く入力を送る。
+// ソケットもウィンドウも使わないので、参加・ID割り当て・STATEの配信を
+// 1つのプロセスの中で最大MAX_PLAYERS人まで確かめられる。
+// ボットはホストと同じPlayerManagerを共有するので、ゲーム側には触れさせない
+// （NetworkManager::set_game_binding(false)）。
+// ============================================================
+class BotClients {
+public:
+    // inputRedundancy: 1つのINPUTに載せる入力の数（NetworkManager::set_input_redundancy）
+    BotClients(LoopbackNetwork& network, int count, int inputRedundancy);
+    ~BotClients();
+    BotClients(const BotClients&) = delete;
+    BotClients& operator=(const BotClients&) = delete;
+
+    // 全員をクライアントとして起動し、hostへJOINを送る
+    bool Start(const Endpoint& host);
+
+    // 1ステップ分進める（受信の処理、参加済みなら入力の送信）
+    void Step();
+
+    int GetCount() const { return (int)m_bots.size(); }
+    // プレイヤーIDを割り当てられたボットの数
+    int GetJoinedCount() const;
+    // 割り当てられたIDの種類（重複が無ければGetJoinedCountと同じ）
+    int GetDistinctIdCount() const;
+    // 全ボットが復元できたSTATEの合計
+    uint64_t GetStatesReceived() const;
+
+private:
+    struct Bot {
+        std::unique_ptr<LoopbackTransport> transport;
+        std::unique_ptr<NetworkManager> net;
+        uint32_t rng = 1;     // 乱数の状態（xorshift32）
+        float yaw = 0.0f;     // 歩いている向き（度）
+        int turnSteps = 0;    // 次に向きを変えるまでのステップ数
+    };
+
+    static uint32_t NextRandom(uint32_t& state);
+
+    LoopbackNetwork& m_network;
+    std::vector<Bot> m_bots;
+    std::vector<std::shared_ptr<Game::GameObject>> m_noObjects;  // ボットは何も表示しないので空のまま
+};
+
+} // namespace Server
@@ -0,0 +1,315 @@
+/*********************************************************************
+ * \file   dedicated_server.cpp
+ * \brief  DedicatedServerクラスの実装
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#include "pch.h"
+#include "dedicated_server.h"
+#include "bot_clients.h"
+#include "Engine/Collision/collision_system.h"
+#include "Engine/Collision/map_collision.h"
+#include "Game/Map/map.h"
+#include "Game/Managers/player_manager.h"
+#include "Game/Managers/bullet_manager.h"
+#include "Game/Objects/game_object.h"
+#include "NetWork/network_manager.h"
+#include "NetWork/prediction_buffer.h"   // PredictionBuffer::TICK_DT
+#include "NetWork/link_conditioner.h"
+#include "NetWork/net_loopback.h"
+#include "NetWork/capture_replay.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+namespace Server {
+
+volatile std::sig_atomic_t DedicatedServer::s_stopRequested = 0;
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+}
+
+DedicatedServer::DedicatedServer(const ServerConfig& config)
+    : m_config(config), m_clock(config.tickRate) {
+}
+
+DedicatedServer::~DedicatedServer() {
+    Finalize();
+}
+
+// ============================================================
+// Initialize - SceneGame::Initializeから描画・入力・役割の選択を除いたもの
+// ============================================================
+bool DedicatedServer::Initialize() {
+    // === マップ（テクスチャは描画にしか使わないので無し） ===
+    m_pMap.reset(new Game::Map());
+    if (!m_pMap->Initialize(nullptr)) {
+        std::cerr << "[Server] map initialization failed\n";
+        return false;
+    }
+
+    // === 衝突システム ===
+    // プレイヤーが自分の当たり判定を登録するので、プレイヤーより先に初期化する
+    Engine::CollisionSystem::GetInstance().Initialize();
+    Engine::MapCollision::GetInstance().Initialize(2.0f);
+    m_worldObjects.clear();
+    for (const auto& block : m_pMap->GetBlockObjects()) {
+        Engine::MapCollision::GetInstance().RegisterBlock(block->GetBoxCollider());
+        m_worldObjects.push_back(block);
+    }
+    Engine::CollisionSystem::GetInstance().SetCallback(Game::OnBulletPlayerCollision);
+
+    // === プレイヤー（全員クライアントが動かす） ===
+    // 参加したクライアントのプレイヤーはNetworkManagerがプールから出してworldObjectsに加える
+    Game::InitializePlayers(m_pMap.get(), nullptr, &g_network);
+
+    // === ネットワーク ===
+    if (!m_config.replayPath.empty()) {
+        // 再生: 相手のいないループバックを使う（起動は再生の中で行い、送信は捨てられる）
+        m_pLoopback.reset(new LoopbackNetwork());
+        m_pHostTransport.reset(new LoopbackTransport(*m_pLoopback));
+        g_network.set_transport(m_pHostTransport.get());
+        m_initialized = true;
+        std::cout << "[Server] replaying " << m_config.replayPath << " ("
+            << (m_config.replayRealTime ? "original" : "max") << " speed)\n";
+        return true;
+    }
+    if (!m_config.capturePath.empty() && !g_network.start_capture(m_config.capturePath)) {
+        std::cerr << "[Server] failed to open --capture: " << m_config.capturePath << "\n";
+        return false;
+    }
+    if (!m_config.conditions.empty()) {
+        LinkConditions conditions;
+        if (!LinkConditions::parse(m_config.conditions.c_str(), conditions)) {
+            std::cerr << "[Server] bad --net-conditions: " << m_config.conditions << "\n";
+            return false;
+        }
+        g_network.set_link_conditions(conditions);
+    }
+    if (m_config.bots > 0) {
+        // ソケットの代わりにループバックのゲーム通信ポートで待つ（チャンネルは使わない）
+        m_pLoopback.reset(new LoopbackNetwork());
+        m_pHostTransport.reset(new LoopbackTransport(*m_pLoopback, (uint16_t)NET_PORT));
+        g_network.set_transport(m_pHostTransport.get());
+    }
+    g_network.set_state_send_interval(std::chrono::milliseconds(
+        (int)(m_config.stateEvery * PredictionBuffer::TICK_DT * 1000.0f + 0.5f)));
+    g_network.set_encode_threads(m_config.encodeThreads);
+    g_network.set_receive_shards(m_config.recvShards);
+    if (!g_network.start_as_host(false)) {
+        std::cerr << "[Server] failed to open the host sockets\n";
+        return false;
+    }
+    if (!m_config.netStatsPath.empty() && !g_network.set_stats_dump(m_config.netStatsPath)) {
+        std::cerr << "[Server] failed to open --net-stats: " << m_config.netStatsPath << "\n";
+        return false;
+    }
+    if (!m_pLoopback && m_config.channel >= 0 && !g_network.switch_to_channel(m_config.channel)) {
+        std::cerr << "[Server] failed to switch to channel " << m_config.channel << "\n";
+        return false;
+    }
+    if (m_pLoopback) {
+        m_pBots.reset(new BotClients(*m_pLoopback, m_config.bots, m_config.inputRedundancy));
+        if (!m_pBots->Start(m_pHostTransport->get_endpoint())) return false;
+    }
+
+    m_initialized = true;
+    std::cout << "[Server] started: " << m_config.tickRate << " Hz ticks, STATE every "
+        << m_config.stateEvery << " steps\n";
+    return true;
+}
+
+// ============================================================
+// Run - 固定間隔でティックを回す
+// ============================================================
+int DedicatedServer::Run() {
+    if (!m_initialized) return 1;
+    if (!m_config.replayPath.empty()) return RunReplay();
+
+    const double statsInterval = (double)m_config.statsSeconds;
+    double statsElapsed = 0.0;
+    double totalElapsed = 0.0;
+
+    m_clock.Start();
+    while (!s_stopRequested) {
+        const double elapsed = m_clock.WaitNextTick();
+
+        const Clock::time_point begin = Clock::now();
+        Tick(elapsed);
+        const double work = std::chrono::duration<double>(Clock::now() - begin).count();
+
+        ++m_stats.ticks;
+        m_stats.workTotal += work;
+        m_stats.workMax = std::max(m_stats.workMax, work);
+
+        totalElapsed += elapsed;
+        statsElapsed += elapsed;
+        if (statsInterval > 0.0 && statsElapsed >= statsInterval) {
+            PrintStats(statsElapsed);
+            statsElapsed = 0.0;
+        }
+        if (m_config.durationSeconds > 0.0 && totalElapsed >= m_config.durationSeconds) break;
+    }
+
+    std::cout << "[Server] stopping after " << m_clock.GetTickCount() << " ticks ("
+        << m_clock.GetOverruns() << " late, " << m_clock.GetSkippedTicks() << " skipped)\n";
+
+    // ボット: 全員が別々のIDで参加し、STATEを受け取れていれば成功
+    if (m_pBots) {
+        const int joined = m_pBots->GetJoinedCount();
+        const int distinct = m_pBots->GetDistinctIdCount();
+        const uint64_t states = m_pBots->GetStatesReceived();
+        std::cout << "[Server] bots joined " << joined << "/" << m_pBots->GetCount()
+            << ", distinct ids " << distinct << ", players " << Game::PlayerManager::GetInstance()
+            .GetActivePlayerIds().size() << ", states received " << states << "\n";
+        if (joined != m_pBots->GetCount() || distinct != joined || (joined > 0 && states == 0)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void DedicatedServer::Finalize() {
+    if (!m_initialized) return;
+    m_initialized = false;
+
+    // 書き込みスレッドに残りを書かせてからファイルを閉じる
+    g_network.stop_capture();
+
+    m_pBots.reset();
+    if (m_pHostTransport) {
+        g_network.set_transport(nullptr);
+        m_pHostTransport.reset();
+    }
+    m_pLoopback.reset();
+
+    m_worldObjects.clear();
+    Game::BulletManager::GetInstance().Clear();
+    if (m_pMap) {
+        m_pMap->Uninitialize();
+        m_pMap.reset();
+    }
+    Engine::CollisionSystem::GetInstance().Shutdown();
+    Engine::MapCollision::GetInstance().Shutdown();
+}
+
+// ============================================================
+// Tick - 経過時間の分だけシミュレーションを進める
+// ============================================================
+void DedicatedServer::Tick(double elapsed) {
+    const double step = PredictionBuffer::TICK_DT;
+    m_accumulator += elapsed;
+
+    int steps = 0;
+    while (m_accumulator >= step && steps < MAX_STEPS_PER_TICK) {
+        SimulationStep();
+        m_accumulator -= step;
+        ++steps;
+    }
+    // 追いつけない分は捨てる（遅れを溜め続けると、毎ティック上限までステップを回すことになる）
+    if (steps == MAX_STEPS_PER_TICK) m_accumulator = std::min(m_accumulator, step);
+
+    // ステップの無いティックでも、届いたパケットの処理と再送は行う
+    if (steps == 0) g_network.service(nullptr, m_worldObjects);
+    m_stats.steps += (uint64_t)steps;
+}
+
+// ============================================================
+// SimulationStep - SceneGame::Updateと同じ順序で1ステップ進める
+// ============================================================
+void DedicatedServer::SimulationStep() {
+    const float dt = PredictionBuffer::TICK_DT;
+
+    // ボット: 前のステップのSTATEを受け取り、今回の入力を送る
+    if (m_pBots) m_pBots->Step();
+
+    // 受信処理と、クライアントの入力の適用
+    g_network.update(dt, nullptr, m_worldObjects);
+
+    // 移動と弾 → 移動後の位置で当たり判定
+    Game::PlayerManager::GetInstance().UpdateSimulation(dt);
+    Engine::CollisionSystem::GetInstance().Update();
+
+    // 移動後の状態を公開する（STATEはネットワーク側がstateEveryステップ分の間隔で送る）
+    g_network.publish_snapshot();
+
+    // このステップで溜めた送信をクライアントごとに1パケットにまとめて送る
+    g_network.flush_messages();
+}
+
+// ============================================================
+// PrintStats - ティックの処理時間と接続数を表示する
+// ============================================================
+void DedicatedServer::PrintStats(double seconds) {
+    const double period = m_clock.GetPeriodSeconds();
+    const double avg = m_stats.ticks ? m_stats.workTotal / (double)m_stats.ticks : 0.0;
+    std::cout << std::fixed << std::setprecision(3)
+        << "[Server] " << (double)m_stats.ticks / seconds << " ticks/s, "
+        << (double)m_stats.steps / seconds << " steps/s, work avg " << avg * 1000.0
+        << " ms / max " << m_stats.workMax * 1000.0 << " ms (budget " << period * 1000.0
+        << " ms, load " << std::setprecision(1) << (m_stats.workTotal / seconds * 100.0)
+        << "%), late " << m_clock.GetOverruns() << ", clients " << g_network.get_client_count();
+    if (m_pBots) std::cout << ", bots joined " << m_pBots->GetJoinedCount();
+
+    // 受信キューが溢れていないか（溢れるならm_maxPacketsPerFrameか処理時間を見直す）
+    NetStatsReport net;
+    g_network.get_stats(net);
+    std::cout << ", recv " << (double)(net.recvPackets - m_lastRecvPackets) / seconds << " pkts/s on "
+        << net.recvShards << (net.recvShards == 1 ? " socket" : " sockets")
+        << ", recv queue max " << net.recvQueueHighWater << "/" << net.recvQueueCapacity
+        << ", dropped " << net.recvDropped;
+    m_lastRecvPackets = net.recvPackets;
+
+    // 届かなかった入力（そのティックはクライアントの入力無しで進めたので、位置がずれる）
+    uint64_t inputMissed = 0;
+    uint64_t inputRecovered = 0;
+    for (const NetStatsReport::Connection& c : net.connections) {
+        inputMissed += c.stats.inputMissed;
+        inputRecovered += c.stats.inputRecovered;
+    }
+    std::cout << ", inputs missed " << inputMissed << " (recovered " << inputRecovered << ")";
+
+    // STATEの符号化（全クライアント分を1回送るのにかかった時間、--encode-threadsを決めるため）
+    const uint64_t encodes = net.encodeCount - m_lastEncodeCount;
+    const double encodeAvg = encodes ?
+        (net.encodeSeconds - m_lastEncodeSeconds) / (double)encodes : 0.0;
+    std::cout << std::setprecision(3) << ", encode avg " << encodeAvg * 1000.0 << " ms / max "
+        << net.encodeMaxMs << " ms (" << net.encodeThreads << " threads)";
+    m_lastEncodeCount = net.encodeCount;
+    m_lastEncodeSeconds = net.encodeSeconds;
+    std::cout << "\n";
+    std::cout.flush();
+    m_stats = TickStats();
+}
+
+// ============================================================
+// RunReplay - キャプチャの受信を流し直し、受信処理の時間を表示する
+// ============================================================
+int DedicatedServer::RunReplay() {
+    CaptureReplayResult result;
+    std::string error;
+    if (!replay_capture(m_config.replayPath, g_network, m_config.replayRealTime,
+        nullptr, m_worldObjects, result, error)) {
+        std::cerr << "[Server] replay failed: " << error << "\n";
+        return 1;
+    }
+
+    const double perPacketUs = result.replayed ?
+        result.processSeconds * 1000000.0 / (double)result.replayed : 0.0;
+    std::cout << std::fixed << std::setprecision(3)
+        << "[Server] replayed " << result.replayed << " received packets ("
+        << result.records << " records, " << result.sent << " sends skipped) as "
+        << (g_network.is_host() ? "host" : "client") << "\n"
+        << "[Server] capture " << result.captureSeconds << " s, wall " << result.wallSeconds
+        << " s, receive path " << result.processSeconds * 1000.0 << " ms ("
+        << perPacketUs << " us/packet), players " << Game::PlayerManager::GetInstance()
+        .GetActivePlayerIds().size() << ", states received " << g_network.get_states_received()
+        << "\n";
+    if (result.truncated) std::cout << "[Server] the last record of the capture was cut off\n";
+    return 0;
+}
+
+} // namespace Server
@@ -0,0 +1,94 @@
+/*********************************************************************
+ * \file   dedicated_server.h
+ * \brief  専用サーバー（描画・入力なしでシミュレーションとホストの通信だけを動かす）
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include "server_config.h"
+#include "tick_clock.h"
+#include <csignal>
+#include <memory>
+#include <vector>
+
+namespace Game {
+    class Map;
+    class GameObject;
+}
+class LoopbackNetwork;
+class LoopbackTransport;
+
+namespace Server {
+
+class BotClients;
+
+// ============================================================
+// DedicatedServer クラス
+// SceneGameからウィンドウ・描画・入力・カメラを除いたもの。自分のプレイヤーは持たず、
+// 全プレイヤーをクライアントの入力で動かす（参加したクライアントからID=1-MAX_PLAYERSを割り当てる）。
+// --botsを付けるとUDPの代わりにプロセス内のループバックで通信し、ボットのクライアントを参加させる。
+// --replayを付けると通信せず、キャプチャの受信を流し直して処理時間を表示する（ティックは回さない）。
+//
+// 1ティック（1 / tickRate 秒）ごとに:
+//   1. 経過時間をシミュレーションの時間に足す
+//   2. 溜まった分だけ固定の1/60秒のステップを進める（入力の適用 → 移動 → 当たり判定 → 状態の公開）
+//      STATEはネットワークのワーカースレッドが公開された状態から作って送る
+//      ステップの長さはクライアントの予測（PredictionBuffer::TICK_DT）と揃える必要がある
+//   3. ステップが無いティックでも受信と再送は行う（tickRateを上げると応答が早くなる）
+// ============================================================
+class DedicatedServer {
+public:
+    // 1ティックで進めるステップの上限（これ以上遅れた分は捨てる）
+    static const int MAX_STEPS_PER_TICK = 4;
+
+    explicit DedicatedServer(const ServerConfig& config);
+    ~DedicatedServer();
+    DedicatedServer(const DedicatedServer&) = delete;
+    DedicatedServer& operator=(const DedicatedServer&) = delete;
+
+    // マップ・プレイヤー・当たり判定を用意し、ホストとして通信を始める
+    bool Initialize();
+
+    // 止められるまで（またはdurationSeconds経つまで）ティックを回す
+    // 戻り値: プロセスの終了コード
+    int Run();
+
+    void Finalize();
+
+    // 止める（シグナルハンドラから呼んでもよい）
+    static void RequestStop() { s_stopRequested = 1; }
+
+private:
+    // 統計の表示間隔ごとの集計
+    struct TickStats {
+        uint64_t ticks = 0;
+        uint64_t steps = 0;
+        double workTotal = 0.0;  // ティックの処理時間の合計（秒）
+        double workMax = 0.0;    // ティックの処理時間の最大（秒）
+    };
+
+    void Tick(double elapsed);
+    void SimulationStep();
+    void PrintStats(double seconds);
+    int RunReplay();
+
+    ServerConfig m_config;
+    FixedTickClock m_clock;
+    std::unique_ptr<Game::Map> m_pMap;
+    std::unique_ptr<LoopbackNetwork> m_pLoopback;        // --bots: ホストとボットを繋ぐ / --replay: 送信の捨て先
+    std::unique_ptr<LoopbackTransport> m_pHostTransport; // --bots / --replay: g_networkが使う
+    std::unique_ptr<BotClients> m_pBots;
+    std::vector<std::shared_ptr<Game::GameObject>> m_worldObjects;
+    double m_accumulator = 0.0;  // まだステップにしていないシミュレーション時間（秒）
+    TickStats m_stats;
+    uint64_t m_lastRecvPackets = 0;     // 前回の表示までに受信キューに積んだパケット数
+    uint64_t m_lastEncodeCount = 0;     // 前回の表示までにSTATEを符号化した回数
+    double m_lastEncodeSeconds = 0.0;   // 前回の表示までに符号化にかかった時間（秒）
+    bool m_initialized = false;
+
+    static volatile std::sig_atomic_t s_stopRequested;
+};
+
+} // namespace Server
@@ -0,0 +1,31 @@
+/*********************************************************************
+ * \file   headless_render.cpp
+ * \brief  専用サーバー用の描画関数の空の実装
+ *         サーバーはDirect3Dを持たないので、シミュレーションのコードが呼ぶ
+ *         描画・テクスチャの関数をここで何もしないものに置き換える
+ *         （クライアントはgame_object_draw.cpp / primitive.cppの実装を使う）
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/17
+ *********************************************************************/
+#include "pch.h"
+#include "Game/Objects/game_object.h"
+#include "Engine/Graphics/primitive_data.h"
+
+namespace Engine {
+
+// テクスチャは読み込まない
+ID3D11ShaderResourceView* GetDefaultTexture() {
+    return nullptr;
+}
+
+} // namespace Engine
+
+namespace Game {
+
+// 頂点バッファは作らないので、描画も解放もしない
+void GameObject::draw() {}
+
+void GameObject::releaseVertexBuffer() {}
+
+} // namespace Game
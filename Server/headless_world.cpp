@@ -0,0 +1,30 @@
+/*********************************************************************
+ * \file   headless_world.cpp
+ * \brief  描画を使わないマップと当たり判定の実装
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/17
+ *********************************************************************/
+#include "pch.h"
+#include "headless_world.h"
+#include "Engine/Collision/collision_system.h"  // Engine::CollisionSystem
+#include "Engine/Collision/map_collision.h"     // Engine::MapCollision
+
+namespace Server {
+
+HeadlessWorld::HeadlessWorld() {
+    m_ready = m_map.Initialize(nullptr);
+    Engine::CollisionSystem::GetInstance().Initialize();
+    Engine::MapCollision::GetInstance().Initialize(2.0f);
+    for (const auto& block : m_map.GetBlockObjects()) {
+        Engine::MapCollision::GetInstance().RegisterBlock(block->GetBoxCollider());
+    }
+}
+
+HeadlessWorld::~HeadlessWorld() {
+    m_map.Uninitialize();
+    Engine::CollisionSystem::GetInstance().Shutdown();
+    Engine::MapCollision::GetInstance().Shutdown();
+}
+
+} // namespace Server
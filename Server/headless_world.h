@@ -0,0 +1,36 @@
+/*********************************************************************
+ * \file   headless_world.h
+ * \brief  描画を使わないマップと当たり判定（自己テスト・ベンチマーク用）
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/17
+ *********************************************************************/
+#pragma once
+
+#include "Game/Map/map.h"  // Game::Map
+
+namespace Server {
+
+// ============================================================
+// HeadlessWorld クラス
+// DedicatedServer::Initializeと同じようにマップを作り、ブロックを当たり判定に登録する。
+// 破棄するときに当たり判定（シングルトン）も片付けるので、同時に1つだけ作ること。
+// プレイヤーはこのマップを渡したPlayerManagerを別に作って動かす
+// ============================================================
+class HeadlessWorld {
+public:
+    HeadlessWorld();
+    ~HeadlessWorld();
+    HeadlessWorld(const HeadlessWorld&) = delete;
+    HeadlessWorld& operator=(const HeadlessWorld&) = delete;
+
+    // マップを作れたか
+    bool IsReady() const { return m_ready; }
+    Game::Map* GetMap() { return &m_map; }
+
+private:
+    Game::Map m_map;
+    bool m_ready = false;
+};
+
+} // namespace Server
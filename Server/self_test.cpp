@@ -0,0 +1,1011 @@
+/*********************************************************************
+ * \file   self_test.cpp
+ * \brief  自己テストの実装
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#include "pch.h"
+#include "self_test.h"
+#include "bot_clients.h"                        // BotClients
+#include "headless_world.h"                     // HeadlessWorld
+#include "Game/Managers/player_manager.h"       // Game::PlayerManager
+#include "Game/Objects/player.h"                // Game::Player
+#include "NetWork/bit_stream.h"            // BitWriter, BitReader
+#include "NetWork/interpolation_buffer.h"  // PlayoutClock
+#include "NetWork/link_conditioner.h"      // LinkConditioner, LinkConditions
+#include "NetWork/net_codec.h"             // NetCodec
+#include "NetWork/net_loopback.h"          // LoopbackNetwork, LoopbackTransport
+#include "NetWork/network_manager.h"       // NetworkManager
+#include "NetWork/prediction_buffer.h"     // PredictionBuffer
+#include "NetWork/reliable_link.h"         // ReliableLink
+#include "NetWork/triple_buffer.h"         // TripleBuffer
+#include "NetWork/udp_network.h"           // UdpNetwork
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace Server {
+
+namespace {
+
+// ============================================================
+// SelfTestContext クラス
+// 1つのテストのチェック数と失敗数を数え、失敗した式と場所を表示する
+// ============================================================
+class SelfTestContext {
+public:
+    explicit SelfTestContext(const char* suite) : m_suite(suite) {}
+
+    bool Check(bool ok, const char* expr, const char* file, int line) {
+        ++m_checks;
+        if (!ok) {
+            ++m_failures;
+            std::cout << "[SelfTest] FAILED " << m_suite << " " << file << ":" << line
+                << ": " << expr << "\n";
+        }
+        return ok;
+    }
+
+    int GetChecks() const { return m_checks; }
+    int GetFailures() const { return m_failures; }
+
+private:
+    const char* m_suite;
+    int m_checks = 0;
+    int m_failures = 0;
+};
+
+#define SELFTEST_CHECK(t, cond) (t).Check((cond), #cond, __FILE__, __LINE__)
+
+// 量子化の誤差の上限（1段の半分）
+float HalfStep(float minValue, float maxValue, int bits) {
+    return (maxValue - minValue) / (float)((1u << bits) - 1u) * 0.5f + 1e-5f;
+}
+
+bool Near(float a, float b, float tolerance) {
+    return std::fabs(a - b) <= tolerance;
+}
+
+// 角度の差（0-180、360度の折り返しを考える）
+float AngleDiff(float a, float b) {
+    float d = std::fmod(std::fabs(a - b), 360.0f);
+    return d > 180.0f ? 360.0f - d : d;
+}
+
+// ============================================================
+// bit_stream - BitWriter / BitReader の往復と、容量・データ不足の扱い
+// ============================================================
+void TestBitStream(SelfTestContext& t) {
+    // 1-32ビットの値と可変長整数を交互に書いて、同じ順番で読み戻す
+    static const uint32_t VARINTS[] = { 0, 1, 127, 128, 16383, 16384, 0x7FFFFFFF, 0xFFFFFFFF };
+    uint8_t buf[256];
+    memset(buf, 0xFF, sizeof(buf));  // 前の内容が残っていても結果が変わらないこと
+    BitWriter w(buf, sizeof(buf));
+    int expectedBits = 0;
+    for (int bits = 1; bits <= 32; ++bits) {
+        w.write_bits(0xA5C3F00Fu, bits);
+        w.write_bool(bits % 2 == 0);
+        expectedBits += bits + 1;
+    }
+    for (uint32_t v : VARINTS) {
+        w.write_varint(v);
+        expectedBits += BitWriter::varint_bits(v);
+    }
+    SELFTEST_CHECK(t, !w.overflowed());
+    SELFTEST_CHECK(t, w.bits_written() == expectedBits);
+    SELFTEST_CHECK(t, w.bytes_written() == (expectedBits + 7) / 8);
+    // 書いたバイトの先は触らない（バッファ全体をゼロクリアしない）
+    bool untouched = true;
+    for (int i = w.bytes_written(); i < (int)sizeof(buf); ++i) untouched = untouched && buf[i] == 0xFF;
+    SELFTEST_CHECK(t, untouched);
+
+    BitReader r(buf, w.bytes_written());
+    for (int bits = 1; bits <= 32; ++bits) {
+        const uint32_t mask = (bits == 32) ? 0xFFFFFFFFu : ((1u << bits) - 1u);
+        SELFTEST_CHECK(t, r.read_bits(bits) == (0xA5C3F00Fu & mask));
+        SELFTEST_CHECK(t, r.read_bool() == (bits % 2 == 0));
+    }
+    for (uint32_t v : VARINTS) SELFTEST_CHECK(t, r.read_varint() == v);
+    SELFTEST_CHECK(t, !r.overflowed());
+    SELFTEST_CHECK(t, r.bits_read() == w.bits_written());
+
+    // 容量を超える書き込みは無視され、それまでに書いた分は残る
+    uint8_t small[2];
+    BitWriter ws(small, sizeof(small));
+    ws.write_bits(0x1A5, 9);
+    ws.write_bits(0xFF, 8);
+    SELFTEST_CHECK(t, ws.overflowed());
+    SELFTEST_CHECK(t, ws.bits_written() == 9);
+    BitReader rs(small, ws.bytes_written());
+    SELFTEST_CHECK(t, rs.read_bits(9) == 0x1A5);
+
+    // データの末尾を超える読み込みは0を返し、以降もoverflowed()のまま
+    const uint8_t two[2] = { 0x34, 0x12 };
+    BitReader rt(two, sizeof(two));
+    SELFTEST_CHECK(t, rt.read_bits(16) == 0x1234);
+    SELFTEST_CHECK(t, rt.read_bits(1) == 0);
+    SELFTEST_CHECK(t, rt.overflowed());
+    SELFTEST_CHECK(t, rt.read_bits(1) == 0);
+
+    // 途中で切れた可変長整数と、32ビットに収まらない長さの可変長整数は壊れたデータ
+    uint8_t vbuf[8];
+    BitWriter wv(vbuf, sizeof(vbuf));
+    wv.write_varint(300000);
+    BitReader rv(vbuf, wv.bytes_written() - 1);
+    SELFTEST_CHECK(t, rv.read_varint() == 0);
+    SELFTEST_CHECK(t, rv.overflowed());
+    const uint8_t endless[6] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+    BitReader re(endless, sizeof(endless));
+    SELFTEST_CHECK(t, re.read_varint() == 0);
+    SELFTEST_CHECK(t, re.overflowed());
+}
+
+// ============================================================
+// quantize - 量子化の端と誤差の上限
+// ============================================================
+void TestQuantize(SelfTestContext& t) {
+    using namespace NetCodec;
+
+    // 範囲の端と範囲外（クランプ）、NaN
+    const uint32_t maxQ = (1u << POS_BITS) - 1u;
+    SELFTEST_CHECK(t, quantize(-POS_HALF_X, -POS_HALF_X, POS_HALF_X, POS_BITS) == 0);
+    SELFTEST_CHECK(t, quantize(POS_HALF_X, -POS_HALF_X, POS_HALF_X, POS_BITS) == maxQ);
+    SELFTEST_CHECK(t, quantize(-1e9f, -POS_HALF_X, POS_HALF_X, POS_BITS) == 0);
+    SELFTEST_CHECK(t, quantize(1e9f, -POS_HALF_X, POS_HALF_X, POS_BITS) == maxQ);
+    SELFTEST_CHECK(t, quantize(std::numeric_limits<float>::quiet_NaN(), -1.0f, 1.0f, DIR_BITS) == 0);
+    SELFTEST_CHECK(t, quantize(1.0f, 0.0f, 1.0f, 32) == 0xFFFFFFFFu);
+    SELFTEST_CHECK(t, dequantize(maxQ + 100, -POS_HALF_X, POS_HALF_X, POS_BITS) == POS_HALF_X);
+
+    // 範囲内の値は1段の半分以内に戻る
+    const float posTol = HalfStep(-POS_HALF_X, POS_HALF_X, POS_BITS);
+    const float moveTol = HalfStep(-INPUT_MOVE_RANGE, INPUT_MOVE_RANGE, INPUT_MOVE_BITS);
+    bool posOk = true;
+    bool moveOk = true;
+    for (int i = 0; i <= 1000; ++i) {
+        const float p = -POS_HALF_X + 2.0f * POS_HALF_X * (float)i / 1000.0f;
+        posOk = posOk && Near(dequantize(quantize(p, -POS_HALF_X, POS_HALF_X, POS_BITS),
+            -POS_HALF_X, POS_HALF_X, POS_BITS), p, posTol);
+        const float m = -1.0f + 2.0f * (float)i / 1000.0f;
+        moveOk = moveOk && Near(dequantize(quantize(m, -INPUT_MOVE_RANGE, INPUT_MOVE_RANGE,
+            INPUT_MOVE_BITS), -INPUT_MOVE_RANGE, INPUT_MOVE_RANGE, INPUT_MOVE_BITS), m, moveTol);
+    }
+    SELFTEST_CHECK(t, posOk);
+    SELFTEST_CHECK(t, moveOk);
+
+    // 角度は0-360に正規化され、360度は0度に折り返す
+    SELFTEST_CHECK(t, quantize_angle(0.0f) == 0);
+    SELFTEST_CHECK(t, quantize_angle(360.0f) == 0);
+    SELFTEST_CHECK(t, quantize_angle(-90.0f) == quantize_angle(270.0f));
+    SELFTEST_CHECK(t, quantize_angle(720.5f) == quantize_angle(0.5f));
+    SELFTEST_CHECK(t, quantize_angle(359.99f) == 0);
+    SELFTEST_CHECK(t, quantize_angle(std::numeric_limits<float>::infinity()) == 0);
+    const float angleTol = 360.0f / (float)(1u << ROT_BITS) * 0.5f + 1e-3f;
+    bool angleOk = true;
+    for (int i = -720; i <= 720; ++i) {
+        const float a = (float)i * 0.73f;
+        angleOk = angleOk && AngleDiff(dequantize_angle(quantize_angle(a)), a) <= angleTol;
+    }
+    SELFTEST_CHECK(t, angleOk);
+
+    // ObjectStateのフィールド単位（posは14ビット、rotは12ビット）
+    ObjectState os = {};
+    os.posX = 12.3f; os.posY = -4.5f; os.posZ = 0.01f;
+    os.rotX = 10.0f; os.rotY = 200.0f; os.rotZ = 359.0f;
+    ObjectState back = {};
+    for (int f = 0; f < STATE_FIELD_COUNT; ++f) dequantize_field(back, f, quantize_field(os, f));
+    SELFTEST_CHECK(t, field_bits(0) == POS_BITS && field_bits(5) == ROT_BITS);
+    SELFTEST_CHECK(t, Near(back.posX, os.posX, posTol));
+    SELFTEST_CHECK(t, Near(back.posY, os.posY, HalfStep(-POS_HALF_Y, POS_HALF_Y, POS_BITS)));
+    SELFTEST_CHECK(t, Near(back.posZ, os.posZ, HalfStep(-POS_HALF_Z, POS_HALF_Z, POS_BITS)));
+    SELFTEST_CHECK(t, AngleDiff(back.rotY, os.rotY) <= angleTol);
+    SELFTEST_CHECK(t, AngleDiff(back.rotZ, os.rotZ) <= angleTol);
+}
+
+// ============================================================
+// net_codec - INPUT / BULLET / InputAck の往復と、壊れたパケットを受け付けないこと
+// ============================================================
+void TestNetCodec(SelfTestContext& t) {
+    using namespace NetCodec;
+    const float moveTol = HalfStep(-INPUT_MOVE_RANGE, INPUT_MOVE_RANGE, INPUT_MOVE_BITS);
+    const float angleTol = 360.0f / (float)(1u << ROT_BITS) * 0.5f + 1e-3f;
+
+    // 新しい順に並べた入力（控えは同じ値が続くものと変わるものを混ぜる）
+    PacketInput inputs[MAX_INPUTS_PER_PACKET];
+    for (int i = 0; i < MAX_INPUTS_PER_PACKET; ++i) {
+        PacketInput& in = inputs[i];
+        in = {};
+        in.type = PKT_INPUT;
+        in.seq = 100000u - (uint32_t)i;
+        in.playerId = 37;
+        in.moveX = (i < 3) ? 0.5f : -1.0f;
+        in.moveY = 0.0f;
+        in.moveZ = 1.0f - 0.25f * (float)i;
+        in.yaw = (i % 2) ? 90.0f : -45.0f;
+        in.buttons = (i == 2) ? INPUT_BUTTON_JUMP : 0u;
+    }
+
+    for (int count : { 1, MAX_INPUTS_PER_PACKET }) {
+        char buf[MAX_INPUT_BYTES];
+        const int len = write_input(inputs, count, buf, sizeof(buf));
+        SELFTEST_CHECK(t, len > 0);
+
+        PacketInput out[MAX_INPUTS_PER_PACKET];
+        SELFTEST_CHECK(t, read_input(buf, len, out) == count);
+        bool same = true;
+        for (int i = 0; i < count; ++i) {
+            same = same && out[i].type == PKT_INPUT && out[i].seq == inputs[i].seq &&
+                out[i].playerId == inputs[i].playerId && out[i].buttons == inputs[i].buttons &&
+                Near(out[i].moveX, inputs[i].moveX, moveTol) &&
+                Near(out[i].moveY, inputs[i].moveY, moveTol) &&
+                Near(out[i].moveZ, inputs[i].moveZ, moveTol) &&
+                AngleDiff(out[i].yaw, inputs[i].yaw) <= angleTol;
+        }
+        SELFTEST_CHECK(t, same);
+
+        // 末尾が欠けたパケットはどこで切れても読まない
+        bool truncatedRejected = true;
+        for (int cut = 0; cut < len; ++cut) truncatedRejected = truncatedRejected && read_input(buf, cut, out) == 0;
+        SELFTEST_CHECK(t, truncatedRejected);
+
+        // 種別が違うものは読まない
+        buf[0] = (char)PKT_BULLET;
+        SELFTEST_CHECK(t, read_input(buf, len, out) == 0);
+    }
+
+    // 載せる数の範囲外と、容量不足は書かない
+    char tiny[4];
+    char big[MAX_INPUT_BYTES];
+    SELFTEST_CHECK(t, write_input(inputs, 0, big, sizeof(big)) == 0);
+    SELFTEST_CHECK(t, write_input(inputs, MAX_INPUTS_PER_PACKET + 1, big, sizeof(big)) == 0);
+    SELFTEST_CHECK(t, write_input(inputs, 1, tiny, sizeof(tiny)) == 0);
+
+    // BULLET（seq・ownerは可変長、viewTimeは16ビットそのまま、方向は正規化し直す）
+    PacketBullet pb = {};
+    pb.type = PKT_BULLET;
+    pb.seq = 0xFFFFFFFFu;
+    pb.ownerPlayerId = 64;
+    pb.viewTime = 0xFFFF;
+    pb.posX = -POS_HALF_X; pb.posY = 3.25f; pb.posZ = POS_HALF_Z;
+    pb.dirX = 0.6f; pb.dirY = 0.0f; pb.dirZ = -0.8f;
+    char bbuf[MAX_BULLET_BYTES];
+    const int blen = write_bullet(pb, bbuf, sizeof(bbuf));
+    SELFTEST_CHECK(t, blen > 0);
+    PacketBullet ob = {};
+    SELFTEST_CHECK(t, read_bullet(bbuf, blen, ob));
+    SELFTEST_CHECK(t, ob.seq == pb.seq && ob.ownerPlayerId == pb.ownerPlayerId && ob.viewTime == pb.viewTime);
+    SELFTEST_CHECK(t, Near(ob.posX, pb.posX, HalfStep(-POS_HALF_X, POS_HALF_X, POS_BITS)));
+    SELFTEST_CHECK(t, Near(ob.posY, pb.posY, HalfStep(-POS_HALF_Y, POS_HALF_Y, POS_BITS)));
+    SELFTEST_CHECK(t, Near(ob.posZ, pb.posZ, HalfStep(-POS_HALF_Z, POS_HALF_Z, POS_BITS)));
+    SELFTEST_CHECK(t, Near(std::sqrt(ob.dirX * ob.dirX + ob.dirY * ob.dirY + ob.dirZ * ob.dirZ), 1.0f, 1e-4f));
+    SELFTEST_CHECK(t, Near(ob.dirX, pb.dirX, 2e-3f) && Near(ob.dirZ, pb.dirZ, 2e-3f));
+    bool bulletTruncatedRejected = true;
+    for (int cut = 0; cut < blen; ++cut) bulletTruncatedRejected = bulletTruncatedRejected && !read_bullet(bbuf, cut, ob);
+    SELFTEST_CHECK(t, bulletTruncatedRejected);
+    SELFTEST_CHECK(t, write_bullet(pb, tiny, sizeof(tiny)) == 0);
+    bbuf[0] = (char)PKT_INPUT;
+    SELFTEST_CHECK(t, !read_bullet(bbuf, blen, ob));
+
+    // InputAck（縦速度は±VEL_RANGEでクランプ）
+    InputAck acks[2] = { { 4000000000u, -3.5f, 1 }, { 7u, 1000.0f, 0 } };
+    char abuf[32];
+    BitWriter aw(abuf, sizeof(abuf));
+    for (const InputAck& a : acks) write_input_ack(aw, a);
+    SELFTEST_CHECK(t, !aw.overflowed());
+    BitReader ar(abuf, aw.bytes_written());
+    InputAck a0 = {};
+    InputAck a1 = {};
+    read_input_ack(ar, a0);
+    read_input_ack(ar, a1);
+    SELFTEST_CHECK(t, !ar.overflowed());
+    SELFTEST_CHECK(t, a0.inputSeq == acks[0].inputSeq && a0.grounded == 1 &&
+        Near(a0.velY, acks[0].velY, HalfStep(-VEL_RANGE, VEL_RANGE, VEL_BITS)));
+    SELFTEST_CHECK(t, a1.inputSeq == acks[1].inputSeq && a1.grounded == 0 && a1.velY == VEL_RANGE);
+}
+
+// ============================================================
+// 条件を付けた回線で2つのReliableLinkを実時間で動かした結果
+// ============================================================
+struct ConditionedLinkResult {
+    float rttMs = 0.0f;          // ホスト側の平滑化RTT
+    float rtoMs = 0.0f;          // ホスト側のRTO
+    uint64_t resent = 0;         // ホストが再送した信頼メッセージの延べ数
+    int eventsSent = 0;          // ホストが送った信頼メッセージ
+    int eventsDelivered = 0;     // クライアントに届いた信頼メッセージ
+    bool eventsInOrder = true;   // 送った順に1回ずつ届いたか
+    int snapshots = 0;           // クライアントが受け付けたSTATE
+    int lateSnapshots = 0;       // 届いたときには表示時刻を過ぎていたSTATE
+    double delay = 0.0;          // クライアントの表示遅延（秒）
+    float jitterMs = 0.0f;       // クライアントが推定したジッター
+    float intervalMs = 0.0f;     // クライアントが推定した送信間隔
+};
+
+// ホスト側のソケットだけにconditionsを掛け（往復で latencyMs x 2 になる）、
+// ホストは50ミリ秒ごとにSTATEの代わり（種別と16ビットの送信時刻）と信頼メッセージを1つずつ、
+// クライアントは毎ティック入力の代わりを送る。durationMs送った後、未ACKが無くなるまで動かす
+ConditionedLinkResult RunConditionedLink(const LinkConditions& conditions, int durationMs) {
+    using Clock = std::chrono::steady_clock;
+    const std::chrono::milliseconds TICK(5);
+    const std::chrono::milliseconds STATE_INTERVAL(50);
+    const std::chrono::milliseconds DRAIN_LIMIT(3000);
+    const int RECV_BATCH = 8;
+
+    LoopbackNetwork network;
+    LoopbackTransport hostSocket(network);
+    LoopbackTransport clientSocket(network);
+    LinkConditioner hostNet(hostSocket);
+    hostNet.set_conditions(conditions);
+
+    ReliableLink host;
+    ReliableLink client;
+    PlayoutClock playout;
+    ConditionedLinkResult result;
+
+    std::vector<std::vector<char>> packets;
+    std::vector<MessageView> messages;
+    std::vector<std::vector<char>> delivered;
+    static char recvBuffers[RECV_BATCH][MAX_UDP_PACKET];
+    UdpRecvItem items[RECV_BATCH];
+    for (int i = 0; i < RECV_BATCH; ++i) {
+        items[i].buffer = recvBuffers[i];
+        items[i].capacity = MAX_UDP_PACKET;
+    }
+
+    const Clock::time_point start = Clock::now();
+    const Clock::time_point stopSending = start + std::chrono::milliseconds(durationMs);
+    Clock::time_point nextState = start;
+    auto seconds = [&](Clock::time_point tp) { return std::chrono::duration<double>(tp - start).count(); };
+
+    for (;;) {
+        const Clock::time_point now = Clock::now();
+        const bool sending = now < stopSending;
+        if (!sending && (host.pending_reliable() == 0 || now - stopSending > DRAIN_LIMIT)) break;
+
+        if (sending && now >= nextState) {
+            char state[3];
+            state[0] = (char)PKT_STATE;
+            const uint16_t sendMs = (uint16_t)std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count();
+            memcpy(state + 1, &sendMs, sizeof(sendMs));
+            host.queue_unreliable(state, sizeof(state));
+
+            char event[1 + 4];
+            event[0] = (char)PKT_BULLET;
+            memcpy(event + 1, &result.eventsSent, 4);
+            host.queue_reliable(CHANNEL_EVENTS, event, sizeof(event));
+            ++result.eventsSent;
+            nextState += STATE_INTERVAL;
+        }
+        if (sending) {
+            const char input = (char)PKT_INPUT;
+            client.queue_unreliable(&input, 1);
+        }
+
+        size_t count = 0;
+        host.collect_outgoing(now, packets, count);
+        for (size_t i = 0; i < count; ++i) {
+            hostNet.send_to(clientSocket.get_endpoint(), packets[i].data(), (int)packets[i].size());
+        }
+        count = 0;
+        client.collect_outgoing(now, packets, count);
+        for (size_t i = 0; i < count; ++i) {
+            clientSocket.send_to(hostSocket.get_endpoint(), packets[i].data(), (int)packets[i].size());
+        }
+        hostNet.pump();
+
+        for (int n; (n = hostNet.recv_batch(items, RECV_BATCH)) > 0;) {
+            for (int i = 0; i < n; ++i) {
+                messages.clear();
+                delivered.clear();
+                host.receive(items[i].buffer, items[i].len, Clock::now(), messages, delivered);
+            }
+        }
+        for (int n; (n = clientSocket.recv_batch(items, RECV_BATCH)) > 0;) {
+            for (int i = 0; i < n; ++i) {
+                const Clock::time_point arrival = Clock::now();
+                messages.clear();
+                delivered.clear();
+                client.receive(items[i].buffer, items[i].len, arrival, messages, delivered);
+
+                for (const MessageView& m : messages) {
+                    if (m.len != 3 || (uint8_t)m.data[0] != PKT_STATE) continue;
+                    uint16_t sendMs;
+                    memcpy(&sendMs, m.data + 1, sizeof(sendMs));
+                    double localTime = 0.0;
+                    if (!playout.on_snapshot(sendMs, seconds(arrival), localTime)) continue;
+                    ++result.snapshots;
+                    // 表示時刻（今 - 表示遅延）がこのSTATEの時刻を過ぎていれば補間に間に合っていない
+                    if (seconds(arrival) - playout.delay() > localTime + 0.001) ++result.lateSnapshots;
+                }
+                for (const std::vector<char>& d : delivered) {
+                    int index = -1;
+                    if (d.size() == 1 + 4) memcpy(&index, d.data() + 1, 4);
+                    if (index != result.eventsDelivered) result.eventsInOrder = false;
+                    ++result.eventsDelivered;
+                }
+            }
+        }
+
+        std::this_thread::sleep_for(TICK);
+    }
+
+    result.rttMs = host.rtt_ms();
+    result.rtoMs = host.rto_ms();
+    result.resent = host.resent_count();
+    result.delay = playout.delay();
+    result.jitterMs = playout.jitter_ms();
+    result.intervalMs = playout.interval_ms();
+    return result;
+}
+
+// ============================================================
+// link_timing - 遅延・ジッター・ロスを付けた回線でのRTT/RTOの推定と表示遅延
+// LinkConditioner + LoopbackTransport で実時間で動かす（約5秒かかる）
+// ============================================================
+void TestLinkTiming(SelfTestContext& t) {
+    // 許容する余分な遅れ（送受信をティックごとにまとめる分とスリープの遅れ）
+    const float SLACK_MS = 30.0f;
+    const int DURATION_MS = 1500;
+
+    // 往復50ミリ秒と200ミリ秒（ロス10%）、ジッターの有無
+    LinkConditions fast;
+    fast.latencyMs = 25;
+    LinkConditions slowLossy;
+    slowLossy.latencyMs = 100;
+    slowLossy.lossPercent = 10.0f;
+    slowLossy.seed = 7;
+    LinkConditions jittery;
+    jittery.latencyMs = 50;
+    jittery.jitterMs = 30;
+    jittery.seed = 3;
+
+    const ConditionedLinkResult rf = RunConditionedLink(fast, DURATION_MS);
+    const ConditionedLinkResult rs = RunConditionedLink(slowLossy, DURATION_MS);
+    const ConditionedLinkResult rj = RunConditionedLink(jittery, DURATION_MS);
+    std::cout << "[SelfTest] link_timing: rtt " << rf.rttMs << "/" << rs.rttMs << "/" << rj.rttMs
+        << " ms, rto " << rf.rtoMs << "/" << rs.rtoMs << "/" << rj.rtoMs
+        << " ms, playout delay " << rf.delay * 1000.0 << "/" << rs.delay * 1000.0 << "/" << rj.delay * 1000.0
+        << " ms, jitter " << rf.jitterMs << "/" << rs.jitterMs << "/" << rj.jitterMs << " ms\n";
+
+    // RTTは往復の遅延を下回らず、ジッター（両方向）と余分な遅れを超えて大きくならない
+    for (const ConditionedLinkResult* r : { &rf, &rs, &rj }) {
+        const LinkConditions& c = (r == &rf) ? fast : (r == &rs) ? slowLossy : jittery;
+        SELFTEST_CHECK(t, r->rttMs >= 2.0f * (float)c.latencyMs);
+        SELFTEST_CHECK(t, r->rttMs <= 2.0f * (float)(c.latencyMs + c.jitterMs) + SLACK_MS);
+        // RTOはRTTより長く、50-1000ミリ秒に収まる
+        SELFTEST_CHECK(t, r->rtoMs >= r->rttMs && r->rtoMs >= 50.0f && r->rtoMs <= 1000.0f);
+        // 信頼メッセージはロスがあっても全部、送った順に1回ずつ届く
+        SELFTEST_CHECK(t, r->eventsSent > 0 && r->eventsDelivered == r->eventsSent && r->eventsInOrder);
+        // STATEは表示時刻に間に合い、表示遅延は上下限の中にある
+        SELFTEST_CHECK(t, r->snapshots > 0 && r->lateSnapshots == 0);
+        SELFTEST_CHECK(t, r->delay >= PlayoutClock::MIN_DELAY && r->delay <= PlayoutClock::MAX_DELAY);
+    }
+    // ロスがあれば再送する
+    SELFTEST_CHECK(t, rs.resent > 0);
+    // 送信間隔は50ミリ秒と推定し、ジッターがあれば揺らぎを見積もって表示遅延を増やす
+    SELFTEST_CHECK(t, Near(rf.intervalMs, 50.0f, 10.0f));
+    // （0-30ミリ秒の一様なばらつきなら平均の差は10ミリ秒。スリープの遅れで揺れるので下限だけ見る）
+    SELFTEST_CHECK(t, rj.jitterMs >= 3.0f && rj.jitterMs > rf.jitterMs);
+    SELFTEST_CHECK(t, rj.delay > rf.delay);
+}
+
+// ============================================================
+// triple_buffer - 公開したものだけが読み手に渡り、reset()で3つのスロットがすべて空になる
+// （ホストを起動し直したとき、前のワールドをキープアライブで送り直さない）
+// ============================================================
+void TestTripleBuffer(SelfTestContext& t) {
+    TripleBuffer<std::vector<int>> buffer;
+    SELFTEST_CHECK(t, !buffer.acquire() && buffer.front().empty());
+
+    buffer.back().assign(3, 1);
+    buffer.publish();
+    buffer.back().assign(2, 2);
+    buffer.publish();
+    // 取りに来る前に2回公開したら、渡るのは後のものだけ
+    SELFTEST_CHECK(t, buffer.has_fresh() && buffer.acquire());
+    SELFTEST_CHECK(t, buffer.front().size() == 2 && buffer.front()[0] == 2);
+    SELFTEST_CHECK(t, !buffer.acquire() && buffer.front().size() == 2);
+
+    // 書き手の次のスロットにも前の中身が残っている状態で戻す
+    buffer.back().assign(4, 3);
+    buffer.reset();
+    SELFTEST_CHECK(t, !buffer.has_fresh() && !buffer.acquire());
+    SELFTEST_CHECK(t, buffer.front().empty() && buffer.back().empty());
+    buffer.publish();
+    SELFTEST_CHECK(t, buffer.acquire() && buffer.front().empty());
+
+    buffer.back().assign(1, 5);
+    buffer.publish();
+    SELFTEST_CHECK(t, buffer.acquire() && buffer.front().size() == 1 && buffer.front()[0] == 5);
+}
+
+// ============================================================
+// prediction_buffer - 入力履歴と、ホストの結果との照合
+// ============================================================
+void TestPredictionBuffer(SelfTestContext& t) {
+    auto input = [](uint32_t seq) {
+        PacketInput in = {};
+        in.type = PKT_INPUT;
+        in.seq = seq;
+        return in;
+    };
+    auto state = [](float x) {
+        PredictedState s;
+        s.posX = x;
+        s.grounded = true;
+        return s;
+    };
+
+    // 空なら照合するものが無いので巻き戻さない（数えない）
+    PredictionBuffer buffer;
+    SELFTEST_CHECK(t, !buffer.acknowledge(10, state(0.0f)));
+    SELFTEST_CHECK(t, buffer.correction_count() == 0);
+
+    // 予測どおり（許容値以内）なら、そこまでを捨てて巻き戻さない
+    for (uint32_t seq = 1; seq <= 5; ++seq) {
+        buffer.push(input(seq));
+        buffer.set_predicted(seq, state((float)seq));
+    }
+    SELFTEST_CHECK(t, !buffer.acknowledge(2, state(2.0f + PredictionBuffer::POSITION_TOLERANCE * 0.5f)));
+    SELFTEST_CHECK(t, buffer.pending_count() == 3 && buffer.pending_input(0).seq == 3);
+
+    // 残っているどれよりも古い結果（遅れて届いたSTATE）は何もしない
+    SELFTEST_CHECK(t, !buffer.acknowledge(1, state(100.0f)));
+    SELFTEST_CHECK(t, buffer.pending_count() == 3 && buffer.correction_count() == 0);
+
+    // ずれていれば巻き戻し、残りはホストが未処理の入力
+    SELFTEST_CHECK(t, buffer.acknowledge(3, state(3.5f)));
+    SELFTEST_CHECK(t, buffer.correction_count() == 1);
+    SELFTEST_CHECK(t, buffer.pending_count() == 2 && buffer.pending_input(0).seq == 4);
+
+    // 残っているどれよりも新しい結果は、履歴から溢れた入力のものなので巻き戻す
+    SELFTEST_CHECK(t, buffer.acknowledge(9, state(0.0f)));
+    SELFTEST_CHECK(t, buffer.correction_count() == 2 && buffer.pending_count() == 0);
+}
+
+// NetworkManagerの接続・参加の表示を止める（テストの結果だけを表示する）
+class MuteStdout {
+public:
+    MuteStdout() : m_saved(std::cout.rdbuf(nullptr)) {}
+    ~MuteStdout() { std::cout.rdbuf(m_saved); }
+private:
+    std::streambuf* m_saved;
+};
+
+// 予測のテストの入力（step < 0 なら止まる。ジグザグに歩き、ときどきジャンプする）
+PacketInput MakeTestInput(uint32_t playerId, int step) {
+    PacketInput in = {};
+    in.type = PKT_INPUT;
+    in.playerId = playerId;
+    if (step < 0) return in;
+    in.moveX = ((step / 8) % 2 == 0) ? 0.6f : -0.6f;
+    in.moveZ = 0.8f;
+    in.buttons = (step % 40 == 20) ? INPUT_BUTTON_JUMP : 0;
+    return in;
+}
+
+// ============================================================
+// 予測するクライアント1つとホストを動かした結果
+// ============================================================
+struct PredictionRunResult {
+    bool joined = false;         // クライアントがプレイヤーIDを受け取った
+    float finalError = 0.0f;     // 止まった後のクライアントの位置とホストの位置の差（m）
+    uint64_t corrections = 0;    // クライアントが予測を巻き戻した回数
+    uint64_t nudgeCorrections = 0;  // そのうち、予測をずらした後の回数
+    // 歩いている間の入力ごとの、最初の予測とホストがその入力を処理した後の位置の差（m）
+    float meanDivergence = 0.0f;
+    float maxDivergence = 0.0f;
+    int divergenceSamples = 0;   // 比べられた入力の数（ホストが処理しなかった入力は数えない）
+};
+
+float Distance(const XMFLOAT3& a, const XMFLOAT3& b) {
+    return std::sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y) + (a.z - b.z) * (a.z - b.z));
+}
+
+// ホストのソケットにconditionsを掛け（往復で latencyMs x 2 になる）、クライアントとホストを
+// 別々のPlayerManagerで1/60秒ごとに実時間で動かす。クライアントは地面に立ってから
+// MOVE_TICKSの間 MakeTestInput で歩き、その後は止まってホストの結果が届くのを待つ
+// nudgeStep >= 0 なら、その入力の後にクライアントのプレイヤーだけを1m横にずらす（予測の外れ）
+PredictionRunResult RunPredictedClient(HeadlessWorld& world, const LinkConditions& conditions,
+    int inputRedundancy, int nudgeStep) {
+    using Clock = std::chrono::steady_clock;
+    const float dt = PredictionBuffer::TICK_DT;
+    const std::chrono::microseconds TICK((long long)(dt * 1e6f));
+    const int JOIN_LIMIT_TICKS = 120;
+    const int SETTLE_TICKS = 30;   // 出現してから地面に立つまで
+    const int MOVE_TICKS = 90;
+    const int DRAIN_TICKS = 45;    // 止まってから、ホストが残りの入力を処理して結果が届くまで
+
+    PredictionRunResult result;
+    MuteStdout mute;
+
+    LoopbackNetwork network;
+    LoopbackTransport hostSocket(network);
+    LoopbackTransport clientSocket(network);
+    std::unique_ptr<Game::PlayerManager> hostPlayers(new Game::PlayerManager());
+    std::unique_ptr<Game::PlayerManager> clientPlayers(new Game::PlayerManager());
+    std::vector<std::shared_ptr<Game::GameObject>> hostObjects;
+    std::vector<std::shared_ptr<Game::GameObject>> clientObjects;
+
+    NetworkManager host(&hostSocket);
+    NetworkManager client(&clientSocket);
+    hostPlayers->Initialize(world.GetMap(), nullptr, &host);
+    clientPlayers->Initialize(world.GetMap(), nullptr, &client);
+    host.set_player_manager(hostPlayers.get());
+    client.set_player_manager(clientPlayers.get());
+    host.set_link_conditions(conditions);
+    client.set_input_redundancy(inputRedundancy);
+    if (!host.start_as_host(false) || !client.start_as_client()) return result;
+    client.join(hostSocket.get_endpoint());
+
+    std::map<uint32_t, XMFLOAT3> predictedPath;  // 入力のseq → その入力を適用した直後の予測
+    std::map<uint32_t, XMFLOAT3> hostPath;       // 入力のseq → ホストがその入力を処理した後の位置
+    uint32_t lastAckSeq = 0;
+
+    int joinedTick = -1;
+    Clock::time_point next = Clock::now();
+    for (int tick = 0;; ++tick) {
+        const uint32_t id = client.getMyPlayerId();
+        if (id != 0 && joinedTick < 0) joinedTick = tick;
+        if (joinedTick < 0 && tick >= JOIN_LIMIT_TICKS) break;
+        const int step = (joinedTick < 0) ? -1 : tick - joinedTick - SETTLE_TICKS;
+        if (step >= MOVE_TICKS + DRAIN_TICKS) break;
+
+        // クライアント: SceneGame::Updateと同じ順序（受信と照合 → 入力 → 移動 → 送信）
+        client.update(dt, nullptr, clientObjects);
+        Game::Player* predicted = clientPlayers->GetPlayer((int)id);
+        uint32_t inputSeq = 0;
+        if (predicted) {
+            PacketInput in = MakeTestInput(id, step < MOVE_TICKS ? step : -1);
+            client.send_input(in);
+            predicted->ApplyInput({ in.moveX, in.moveY, in.moveZ },
+                (in.buttons & INPUT_BUTTON_JUMP) != 0, dt);
+            inputSeq = in.seq;
+        }
+        clientPlayers->UpdateSimulation(dt);
+        if (predicted && step >= 0 && step < MOVE_TICKS) predictedPath[inputSeq] = predicted->GetPosition();
+        if (predicted && nudgeStep >= 0 && step == nudgeStep) {
+            // 予測だけがずれた状態にする（記録した予測も、ずらした位置に書き直す）
+            XMFLOAT3 p = predicted->GetPosition();
+            p.x += 1.0f;
+            predicted->ResetMovementState(p, predicted->GetVelocity().y, predicted->IsGrounded());
+            client.store_predicted_state();
+            result.nudgeCorrections = client.get_prediction_corrections();
+        }
+        client.flush_messages();
+
+        // ホスト: 専用サーバーのSimulationStepと同じ順序
+        host.update(dt, nullptr, hostObjects);
+        hostPlayers->UpdateSimulation(dt);
+        host.publish_snapshot();
+        host.flush_messages();
+        uint32_t ackSeq = 0;
+        Game::Player* authoritative = hostPlayers->GetPlayer((int)id);
+        if (authoritative && host.get_input_ack_seq(id, ackSeq) && ackSeq != lastAckSeq) {
+            hostPath[ackSeq] = authoritative->GetPosition();
+            lastAckSeq = ackSeq;
+        }
+
+        next += TICK;
+        std::this_thread::sleep_until(next);
+    }
+
+    result.joined = (joinedTick >= 0);
+    const uint32_t id = client.getMyPlayerId();
+    Game::Player* predicted = clientPlayers->GetPlayer((int)id);
+    Game::Player* authoritative = hostPlayers->GetPlayer((int)id);
+    if (result.joined && predicted && authoritative) {
+        result.finalError = Distance(predicted->GetPosition(), authoritative->GetPosition());
+    } else {
+        result.joined = false;
+    }
+    result.corrections = client.get_prediction_corrections();
+    result.nudgeCorrections = (nudgeStep >= 0) ? result.corrections - result.nudgeCorrections : 0;
+
+    double divergenceSum = 0.0;
+    for (const auto& p : predictedPath) {
+        const auto it = hostPath.find(p.first);
+        if (it == hostPath.end()) continue;
+        const float d = Distance(p.second, it->second);
+        divergenceSum += d;
+        result.maxDivergence = std::max(result.maxDivergence, d);
+        ++result.divergenceSamples;
+    }
+    if (result.divergenceSamples > 0) result.meanDivergence = (float)(divergenceSum / result.divergenceSamples);
+    return result;
+}
+
+// ============================================================
+// prediction - クライアント側予測とホストの結果との照合
+// LoopbackTransport + LinkConditioner で往復50/100/200ミリ秒にして実時間で動かす（約12秒かかる）
+// ============================================================
+void TestPrediction(SelfTestContext& t) {
+    // 止まった後の位置の差の上限（照合の許容値と、STATEの位置の量子化の分）
+    const float FINAL_TOLERANCE = PredictionBuffer::POSITION_TOLERANCE * 2.0f;
+    const int NUDGE_STEP = 30;
+
+    HeadlessWorld world;
+    SELFTEST_CHECK(t, world.IsReady());
+
+    const int LATENCIES_MS[] = { 25, 50, 100 };
+    PredictionRunResult results[3];
+    for (int i = 0; i < 3; ++i) {
+        LinkConditions conditions;
+        conditions.latencyMs = LATENCIES_MS[i];
+        results[i] = RunPredictedClient(world, conditions, 4, NUDGE_STEP);
+    }
+    // 予測をずらさなくても、最後はホストと同じ位置になる
+    // （出現した時刻の違いや着地で巻き戻すことはあるので、回数は表示するだけ）
+    LinkConditions fast;
+    fast.latencyMs = LATENCIES_MS[0];
+    const PredictionRunResult clean = RunPredictedClient(world, fast, 4, -1);
+
+    std::cout << "[SelfTest] prediction: rtt 50/100/200 ms, final error " << results[0].finalError
+        << "/" << results[1].finalError << "/" << results[2].finalError << " m, corrections "
+        << results[0].corrections << "/" << results[1].corrections << "/" << results[2].corrections
+        << " (after misprediction " << results[0].nudgeCorrections << "/" << results[1].nudgeCorrections
+        << "/" << results[2].nudgeCorrections << ", without " << clean.corrections << ")\n";
+
+    for (const PredictionRunResult& r : results) {
+        SELFTEST_CHECK(t, r.joined);
+        // ずらした予測は照合で見つかって巻き戻され、最後はホストと同じ位置になる
+        SELFTEST_CHECK(t, r.nudgeCorrections >= 1);
+        SELFTEST_CHECK(t, r.finalError <= FINAL_TOLERANCE);
+    }
+    SELFTEST_CHECK(t, clean.joined);
+    SELFTEST_CHECK(t, clean.finalError <= FINAL_TOLERANCE);
+}
+
+// ============================================================
+// input_redundancy - ロスのある回線での予測とホストの位置のずれ
+// INPUTに直前の入力を添えない（N=1）ときと添える（N=4）ときで、歩いている間の
+// 入力ごとの予測とホストの結果の差を比べる（往復100ミリ秒、ロス10%、約6秒かかる）
+// ============================================================
+void TestInputRedundancy(SelfTestContext& t) {
+    HeadlessWorld world;
+    SELFTEST_CHECK(t, world.IsReady());
+
+    LinkConditions lossy;
+    lossy.latencyMs = 50;
+    lossy.lossPercent = 10.0f;
+    lossy.seed = 11;
+    const PredictionRunResult single = RunPredictedClient(world, lossy, 1, -1);
+    const PredictionRunResult redundant = RunPredictedClient(world, lossy, 4, -1);
+
+    std::cout << "[SelfTest] input_redundancy: divergence N=1 mean " << single.meanDivergence << " m, max "
+        << single.maxDivergence << " m (" << single.divergenceSamples << " inputs), N=4 mean "
+        << redundant.meanDivergence << " m, max " << redundant.maxDivergence << " m ("
+        << redundant.divergenceSamples << " inputs), corrections " << single.corrections << "/"
+        << redundant.corrections << "\n";
+
+    SELFTEST_CHECK(t, single.joined && redundant.joined);
+    // 控えがあれば落ちた入力もホストに届き、その分だけ比べられる入力が多い
+    SELFTEST_CHECK(t, redundant.divergenceSamples > single.divergenceSamples);
+    // 落ちた入力をホストが推測で埋める回数が減るので、予測とホストの位置のずれが小さい
+    SELFTEST_CHECK(t, redundant.meanDivergence < single.meanDivergence);
+    // どちらも最後は照合でホストと同じ位置になる
+    SELFTEST_CHECK(t, single.finalError <= PredictionBuffer::POSITION_TOLERANCE * 2.0f);
+    SELFTEST_CHECK(t, redundant.finalError <= PredictionBuffer::POSITION_TOLERANCE * 2.0f);
+}
+
+// ============================================================
+// 64人のボットを1つのホストに参加させ、続けて65人目を参加させた結果
+// ============================================================
+struct JoinRunResult {
+    bool started = false;
+    size_t discoveryJoinClients = 0;   // 探索ソケットに届いた素のJOINの後のホストの接続数（0のはず）
+    int joined = 0;            // IDを受け取ったボット
+    int distinctIds = 0;       // ボットが受け取ったIDの種類
+    size_t hostClients = 0;    // ホストが参加済みとして数えた接続
+    int activeSlots = 0;       // ホストのPlayerManagerで出現中のID（1-MAX_PLAYERS）
+    bool extraRejected = false;    // 65人目がJOIN_ACKで断られた
+    uint32_t extraPlayerId = 0;    // 65人目が受け取ったID（0のはず）
+    size_t hostClientsAfter = 0;   // 65人目の後のホストの接続数
+};
+
+JoinRunResult RunJoin64(HeadlessWorld& world) {
+    using Clock = std::chrono::steady_clock;
+    const float dt = PredictionBuffer::TICK_DT;
+    const std::chrono::milliseconds STEP_SLEEP(1);
+    const std::chrono::seconds LIMIT(3);
+
+    JoinRunResult result;
+    MuteStdout mute;
+
+    LoopbackNetwork network;
+    LoopbackTransport hostSocket(network);
+    LoopbackTransport extraSocket(network);
+    std::unique_ptr<Game::PlayerManager> hostPlayers(new Game::PlayerManager());
+    std::vector<std::shared_ptr<Game::GameObject>> hostObjects;
+    std::vector<std::shared_ptr<Game::GameObject>> extraObjects;
+
+    NetworkManager host(&hostSocket);
+    NetworkManager extra(&extraSocket);
+    hostPlayers->Initialize(world.GetMap(), nullptr, &host);
+    host.set_player_manager(hostPlayers.get());
+    extra.set_game_binding(false);
+    if (!host.start_as_host(false) || !extra.start_as_client()) return result;
+
+    // ReliableLinkを通らない探索ソケットのJOINは受け付けない
+    const uint8_t bareJoin = PKT_JOIN;
+    host.replay_received((const char*)&bareJoin, 1, Endpoint::from_string("127.0.0.1", 40000), true,
+        nullptr, hostObjects);
+    result.discoveryJoinClients = host.get_client_count();
+
+    BotClients bots(network, MAX_PLAYERS, 4);
+    if (!bots.Start(hostSocket.get_endpoint())) return result;
+    result.started = true;
+
+    // 専用サーバーのSimulationStepと同じ順序で1ステップ進める
+    auto step = [&]() {
+        bots.Step();
+        host.update(dt, nullptr, hostObjects);
+        hostPlayers->UpdateSimulation(dt);
+        host.publish_snapshot();
+        host.flush_messages();
+        std::this_thread::sleep_for(STEP_SLEEP);
+    };
+
+    // 全員が参加するまで（JOINが落ちても再送で届く）
+    const Clock::time_point joinStart = Clock::now();
+    while (bots.GetJoinedCount() < MAX_PLAYERS && Clock::now() - joinStart < LIMIT) step();
+    result.joined = bots.GetJoinedCount();
+    result.distinctIds = bots.GetDistinctIdCount();
+    result.hostClients = host.get_client_count();
+    for (int id = 1; id <= MAX_PLAYERS; ++id) {
+        if (hostPlayers->GetPlayer(id)) ++result.activeSlots;
+    }
+
+    // 65人目
+    extra.join(hostSocket.get_endpoint());
+    const Clock::time_point extraStart = Clock::now();
+    while (!extra.is_join_rejected() && Clock::now() - extraStart < LIMIT) {
+        step();
+        extra.update(dt, nullptr, extraObjects);
+    }
+    result.extraRejected = extra.is_join_rejected();
+    result.extraPlayerId = extra.getMyPlayerId();
+    result.hostClientsAfter = host.get_client_count();
+    return result;
+}
+
+// ============================================================
+// join64 - 64人のクライアント（LoopbackTransportのボット）が1つのホストに参加する
+// IDがすべて違い、ホストのプレイヤーの枠がすべて埋まり、65人目のJOINは断られること
+// 探索ソケットに届いたJOINでは参加できないこと
+// ============================================================
+void TestJoin64(SelfTestContext& t) {
+    HeadlessWorld world;
+    SELFTEST_CHECK(t, world.IsReady());
+
+    const JoinRunResult r = RunJoin64(world);
+    std::cout << "[SelfTest] join64: joined " << r.joined << ", distinct ids " << r.distinctIds
+        << ", host clients " << r.hostClients << ", active slots " << r.activeSlots << ", 65th "
+        << (r.extraRejected ? "rejected" : "not rejected") << "\n";
+
+    SELFTEST_CHECK(t, r.started);
+    SELFTEST_CHECK(t, r.discoveryJoinClients == 0);
+    SELFTEST_CHECK(t, r.joined == MAX_PLAYERS);
+    SELFTEST_CHECK(t, r.distinctIds == MAX_PLAYERS);
+    SELFTEST_CHECK(t, r.hostClients == (size_t)MAX_PLAYERS);
+    SELFTEST_CHECK(t, r.activeSlots == MAX_PLAYERS);
+    SELFTEST_CHECK(t, r.extraRejected && r.extraPlayerId == 0);
+    SELFTEST_CHECK(t, r.hostClientsAfter == (size_t)MAX_PLAYERS);
+}
+
+// ============================================================
+// channel_switch - 切り替え先のチャンネルのポートが塞がっていれば、元のポートに戻って通信を続ける
+// 実際のUDPソケット（127.0.0.1）を使う。チャンネル0・1のポートが使用中なら何もしない
+// ============================================================
+void TestChannelSwitch(SelfTestContext& t) {
+    using Clock = std::chrono::steady_clock;
+    const float dt = PredictionBuffer::TICK_DT;
+    const std::chrono::seconds LIMIT(2);
+
+    for (int channel = 0; channel < 2; ++channel) {
+        if (!UdpNetwork::is_port_available(PORT_RANGES[channel][0]) ||
+            !UdpNetwork::is_port_available(PORT_RANGES[channel][1])) {
+            std::cout << "[SelfTest] channel_switch: ports of channel " << channel << " are in use, skipped\n";
+            return;
+        }
+    }
+
+    HeadlessWorld world;
+    SELFTEST_CHECK(t, world.IsReady());
+
+    bool switched = true;
+    bool joined = false;
+    {
+        MuteStdout mute;
+        Game::PlayerManager hostPlayers;
+        std::vector<std::shared_ptr<Game::GameObject>> hostObjects;
+        std::vector<std::shared_ptr<Game::GameObject>> clientObjects;
+        NetworkManager host;
+        NetworkManager client;
+        hostPlayers.Initialize(world.GetMap(), nullptr, &host);
+        host.set_player_manager(&hostPlayers);
+        client.set_game_binding(false);
+        if (!host.start_as_host(false) || !client.start_as_client()) return;
+
+        // チャンネル1の探索ポートを先に塞いでおく（ゲーム通信ポートは開けるので、片方だけ開いた状態から戻す）
+        UdpNetwork blocker;
+        SELFTEST_CHECK(t, blocker.initialize(PORT_RANGES[1][1]));
+        switched = host.switch_to_channel(1);
+
+        // 元のゲーム通信ポートに参加できれば、ソケットもワーカーも戻っている
+        client.join(Endpoint::from_string("127.0.0.1", PORT_RANGES[0][0]));
+        const Clock::time_point start = Clock::now();
+        while (client.getMyPlayerId() == 0 && Clock::now() - start < LIMIT) {
+            client.update(dt, nullptr, clientObjects);
+            host.update(dt, nullptr, hostObjects);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        joined = client.getMyPlayerId() != 0;
+    }
+    std::cout << "[SelfTest] channel_switch: switch " << (switched ? "succeeded" : "failed")
+        << ", join after rollback " << (joined ? "ok" : "failed") << "\n";
+
+    SELFTEST_CHECK(t, !switched);
+    SELFTEST_CHECK(t, joined);
+}
+
+// 実行できるテストの一覧
+struct SelfTestSuite {
+    const char* name;
+    void (*run)(SelfTestContext& t);
+};
+
+const SelfTestSuite SUITES[] = {
+    { "bit_stream", &TestBitStream },
+    { "quantize", &TestQuantize },
+    { "net_codec", &TestNetCodec },
+    { "link_timing", &TestLinkTiming },
+    { "triple_buffer", &TestTripleBuffer },
+    { "prediction_buffer", &TestPredictionBuffer },
+    { "prediction", &TestPrediction },
+    { "input_redundancy", &TestInputRedundancy },
+    { "join64", &TestJoin64 },
+    { "channel_switch", &TestChannelSwitch },
+};
+
+} // namespace
+
+// ============================================================
+// RunSelfTests - 選んだテストを順に実行して結果を表示する
+// ============================================================
+int RunSelfTests(const std::string& suite) {
+    int failures = 0;
+    int ran = 0;
+    for (const SelfTestSuite& s : SUITES) {
+        if (suite != "all" && suite != s.name) continue;
+        SelfTestContext t(s.name);
+        s.run(t);
+        ++ran;
+        failures += t.GetFailures();
+        std::cout << "[SelfTest] " << s.name << ": " << (t.GetChecks() - t.GetFailures()) << "/"
+            << t.GetChecks() << " checks passed\n";
+    }
+    if (ran == 0) {
+        std::cout << "[SelfTest] unknown test " << suite << " (" << GetSelfTestNames() << ")\n";
+        return -1;
+    }
+    std::cout << "[SelfTest] " << (failures == 0 ? "all passed" : "FAILED") << "\n";
+    return failures;
+}
+
+std::string GetSelfTestNames() {
+    std::string names = "all";
+    for (const SelfTestSuite& s : SUITES) {
+        names += " ";
+        names += s.name;
+    }
+    return names;
+}
+
+} // namespace Server
@@ -0,0 +1,25 @@
+/*********************************************************************
+ * \file   self_test.h
+ * \brief  通信まわりの部品の自己テスト（DedicatedServer --selftest）
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include <string>
+
+namespace Server {
+
+// ============================================================
+// 自己テスト
+// ウィンドウもソケットも使わずに、符号化・再送・補間などの部品を単体で確かめる。
+// suite: "all" なら全部、それ以外はその名前のものだけを実行する
+// 戻り値: 失敗したチェックの数（0なら全部通った、名前が見つからなければ-1）
+// ============================================================
+int RunSelfTests(const std::string& suite);
+
+// 実行できるテストの名前を空白区切りで返す（使い方の表示用）
+std::string GetSelfTestNames();
+
+} // namespace Server
@@ -0,0 +1,144 @@
+/*********************************************************************
+ * \file   server_config.cpp
+ * \brief  ServerConfigの実装
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#include "pch.h"
+#include "server_config.h"
+#include "NetWork/network_common.h"  // NUM_CHANNELS, MAX_PLAYERS
+#include "NetWork/net_codec.h"       // NetCodec::MAX_INPUTS_PER_PACKET
+#include "NetWork/net_task_pool.h"   // NetTaskPool::MAX_THREADS
+#include "NetWork/network_manager.h" // NetworkManager::MAX_RECV_SHARDS
+#include "bench.h"                   // GetBenchmarkNames
+#include "self_test.h"               // GetSelfTestNames
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace Server {
+
+namespace {
+    // 文字列全体が整数ならtrue
+    bool to_int(const char* text, int& out) {
+        char* end = nullptr;
+        const long v = std::strtol(text, &end, 10);
+        if (end == text || *end != '\0') return false;
+        out = (int)v;
+        return true;
+    }
+
+    bool to_double(const char* text, double& out) {
+        char* end = nullptr;
+        const double v = std::strtod(text, &end);
+        if (end == text || *end != '\0') return false;
+        out = v;
+        return true;
+    }
+}
+
+// ============================================================
+// Parse - "--名前 値" の並びを読む
+// ============================================================
+bool ServerConfig::Parse(int argc, char** argv, ServerConfig& out, std::string& error) {
+    error.clear();
+    for (int i = 1; i < argc; ++i) {
+        const char* name = argv[i];
+        if (std::strcmp(name, "--help") == 0 || std::strcmp(name, "-h") == 0) {
+            return false;
+        }
+
+        // これ以降のオプションはすべて値を1つ取る
+        if (i + 1 >= argc) {
+            error = std::string(name) + " needs a value";
+            return false;
+        }
+        const char* value = argv[++i];
+        bool ok = true;
+        if (std::strcmp(name, "--tick-rate") == 0) {
+            ok = to_int(value, out.tickRate) && out.tickRate >= 10 && out.tickRate <= 1000;
+        } else if (std::strcmp(name, "--state-every") == 0) {
+            ok = to_int(value, out.stateEvery) && out.stateEvery >= 1;
+        } else if (std::strcmp(name, "--encode-threads") == 0) {
+            ok = to_int(value, out.encodeThreads) && out.encodeThreads >= 0 &&
+                out.encodeThreads <= NetTaskPool::MAX_THREADS;
+        } else if (std::strcmp(name, "--recv-shards") == 0) {
+            ok = to_int(value, out.recvShards) && out.recvShards >= 1 &&
+                out.recvShards <= NetworkManager::MAX_RECV_SHARDS;
+        } else if (std::strcmp(name, "--channel") == 0) {
+            ok = to_int(value, out.channel) && out.channel >= -1 && out.channel < NUM_CHANNELS;
+        } else if (std::strcmp(name, "--duration") == 0) {
+            ok = to_double(value, out.durationSeconds) && out.durationSeconds >= 0.0;
+        } else if (std::strcmp(name, "--stats") == 0) {
+            ok = to_int(value, out.statsSeconds) && out.statsSeconds >= 0;
+        } else if (std::strcmp(name, "--net-conditions") == 0) {
+            out.conditions = value;
+        } else if (std::strcmp(name, "--bots") == 0) {
+            ok = to_int(value, out.bots) && out.bots >= 0 && out.bots <= MAX_PLAYERS;
+        } else if (std::strcmp(name, "--input-redundancy") == 0) {
+            ok = to_int(value, out.inputRedundancy) && out.inputRedundancy >= 1 &&
+                out.inputRedundancy <= NetCodec::MAX_INPUTS_PER_PACKET;
+        } else if (std::strcmp(name, "--net-stats") == 0) {
+            out.netStatsPath = value;
+        } else if (std::strcmp(name, "--capture") == 0) {
+            out.capturePath = value;
+        } else if (std::strcmp(name, "--replay") == 0) {
+            out.replayPath = value;
+        } else if (std::strcmp(name, "--selftest") == 0) {
+            out.selfTest = value;
+        } else if (std::strcmp(name, "--bench") == 0) {
+            out.bench = value;
+        } else if (std::strcmp(name, "--replay-speed") == 0) {
+            ok = std::strcmp(value, "original") == 0 || std::strcmp(value, "max") == 0;
+            out.replayRealTime = std::strcmp(value, "original") == 0;
+        } else {
+            error = std::string("unknown option ") + name;
+            return false;
+        }
+        if (!ok) {
+            error = std::string("bad value for ") + name + ": " + value;
+            return false;
+        }
+    }
+    if (!out.replayPath.empty() && out.bots > 0) {
+        error = "--replay cannot be combined with --bots";
+        return false;
+    }
+    return true;
+}
+
+void ServerConfig::PrintUsage(const char* exeName) {
+    std::cout << "usage: " << (exeName ? exeName : "DedicatedServer") << " [options]\n"
+        << "  --tick-rate N        server ticks per second, 10-1000 (default 60)\n"
+        << "  --state-every N      send STATE every N simulation steps (default 6 = 10 Hz)\n"
+        << "  --encode-threads N   threads that encode the per-client STATE, 1-"
+        << NetTaskPool::MAX_THREADS << ", 0 = one per core (default 0)\n"
+        << "  --recv-shards N      sockets and threads receiving on the game port, 1-"
+        << NetworkManager::MAX_RECV_SHARDS << "\n"
+        << "                       (SO_REUSEPORT, Linux only; default 1)\n"
+        << "  --channel N          port channel 0-" << (NUM_CHANNELS - 1)
+        << ", -1 = default ports (default -1)\n"
+        << "  --duration SEC       stop after SEC seconds, 0 = run until Ctrl+C (default 0)\n"
+        << "  --stats SEC          print tick statistics every SEC seconds, 0 = off (default 5)\n"
+        << "  --net-conditions S   simulate a bad link, e.g. latency=80,jitter=20,loss=2\n"
+        << "  --bots N             join N in-process bot clients over a loopback transport\n"
+        << "                       instead of opening UDP sockets, 0-" << MAX_PLAYERS
+        << " (default 0)\n"
+        << "  --input-redundancy N inputs per bot INPUT packet, the newest plus N-1 earlier\n"
+        << "                       ones, 1-" << NetCodec::MAX_INPUTS_PER_PACKET
+        << " (default 4, 1 = no redundancy)\n"
+        << "  --net-stats FILE     write per-connection network statistics to FILE every\n"
+        << "                       second, one JSON object per line\n"
+        << "  --capture FILE       record every sent and received datagram to FILE\n"
+        << "  --replay FILE        replay the received datagrams of a capture through the\n"
+        << "                       receive path without sockets, print timings and exit\n"
+        << "  --replay-speed S     original = keep the recorded timing, max = no waiting\n"
+        << "                       (default max)\n"
+        << "  --selftest NAME      run the headless self tests and exit, NAME is one of\n"
+        << "                       " << GetSelfTestNames() << "\n"
+        << "  --bench NAME         run the network benchmarks and exit, NAME is one of\n"
+        << "                       " << GetBenchmarkNames() << "\n";
+}
+
+} // namespace Server
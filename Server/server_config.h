@@ -0,0 +1,44 @@
+/*********************************************************************
+ * \file   server_config.h
+ * \brief  専用サーバーの設定（コマンドラインから読む）
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include <string>
+
+namespace Server {
+
+// ============================================================
+// ServerConfig 構造体
+// 例: DedicatedServer --tick-rate 128 --state-every 6 --stats 5
+// ============================================================
+struct ServerConfig {
+    int tickRate = 60;          // 1秒あたりのサーバーティック数（受信処理と送信の頻度、10-1000）
+    int stateEvery = 6;         // STATEを送る間隔（シミュレーションのステップ何回分か、6 = 10Hz）
+    int encodeThreads = 0;      // クライアントごとのSTATEを符号化するスレッドの数（0なら論理コア数）
+    int recvShards = 1;         // ゲーム通信ポートを受信するソケットとスレッドの数（SO_REUSEPORT、1なら分けない）
+    int channel = -1;           // 使うチャンネル（-1なら既定のポート）
+    double durationSeconds = 0; // 動かす秒数（0なら止められるまで）
+    int statsSeconds = 5;       // 統計を表示する間隔（秒、0なら表示しない）
+    std::string conditions;     // 回線状態の再現（LinkConditions::parseの形式、空なら無し）
+    int bots = 0;               // プロセス内のループバックで参加させるボットの数（0-MAX_PLAYERS、0なら通常のUDP）
+    int inputRedundancy = 4;    // ボットが1つのINPUTに載せる入力の数（1なら控え無し、ロスの比較用）
+    std::string netStatsPath;   // 通信の統計を1秒ごとにJSON Linesで書き出すファイル（空なら書き出さない）
+    std::string capturePath;    // 送受信を記録するキャプチャファイル（空なら記録しない）
+    std::string replayPath;     // 指定すると通信せず、このキャプチャを再生して終わる
+    bool replayRealTime = false; // 再生を記録された時刻に合わせるか（falseなら待たずに流す）
+    std::string selfTest;       // 指定すると通信せず、この名前の自己テスト（allなら全部）を実行して終わる
+    std::string bench;          // 指定すると通信せず、この名前のベンチマーク（allなら全部）を実行して終わる
+
+    // コマンドラインを読む。戻り値: 起動してよければtrue
+    // 読めなかった場合やヘルプを求められた場合はfalseで、errorに理由が入る（ヘルプなら空）
+    static bool Parse(int argc, char** argv, ServerConfig& out, std::string& error);
+
+    // 使い方を標準出力に表示する
+    static void PrintUsage(const char* exeName);
+};
+
+} // namespace Server
@@ -0,0 +1,47 @@
+/*********************************************************************
+ * \file   server_main.cpp
+ * \brief  専用サーバーのエントリーポイント（コンソールアプリ）
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#include "pch.h"
+#include "dedicated_server.h"
+#include "server_config.h"
+#include "self_test.h"
+#include "bench.h"
+#include <csignal>
+#include <iostream>
+
+namespace {
+    // Ctrl+C / kill で次のティックの後に止まる
+    void on_signal(int) {
+        Server::DedicatedServer::RequestStop();
+    }
+}
+
+int main(int argc, char** argv) {
+    Server::ServerConfig config;
+    std::string error;
+    if (!Server::ServerConfig::Parse(argc, argv, config, error)) {
+        if (!error.empty()) std::cerr << "[Server] " << error << "\n";
+        Server::ServerConfig::PrintUsage(argc > 0 ? argv[0] : nullptr);
+        return error.empty() ? 0 : 2;
+    }
+
+    if (!config.selfTest.empty()) {
+        return Server::RunSelfTests(config.selfTest) == 0 ? 0 : 1;
+    }
+    if (!config.bench.empty()) {
+        return Server::RunBenchmarks(config.bench) == 0 ? 0 : 1;
+    }
+
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+
+    Server::DedicatedServer server(config);
+    if (!server.Initialize()) return 1;
+    const int result = server.Run();
+    server.Finalize();
+    return result;
+}
@@ -0,0 +1,90 @@
+/*********************************************************************
+ * \file   tick_clock.cpp
+ * \brief  FixedTickClockクラスの実装
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#include "pch.h"
+#include "tick_clock.h"
+#include <algorithm>
+#include <thread>
+
+#ifdef _WIN32
+#include <timeapi.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+
+namespace Server {
+
+FixedTickClock::FixedTickClock(int ticksPerSecond)
+    : m_period(std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / (double)std::max(ticksPerSecond, 1)))) {
+}
+
+FixedTickClock::~FixedTickClock() {
+#ifdef _WIN32
+    if (m_timerPeriodSet) timeEndPeriod(1);
+#endif
+}
+
+FixedTickClock::Clock::duration FixedTickClock::SpinMargin() {
+#ifdef _WIN32
+    // timeBeginPeriod(1)でもスリープは1ms前後ずれる
+    return std::chrono::microseconds(1500);
+#else
+    // Linuxのnanosleepは数十マイクロ秒の精度
+    return std::chrono::microseconds(200);
+#endif
+}
+
+// ============================================================
+// Start - 最初のティックの時刻を今にする
+// ============================================================
+void FixedTickClock::Start() {
+#ifdef _WIN32
+    // スリープの精度を1msにする（プロセスが終わるまで、またはデストラクタで戻す）
+    if (!m_timerPeriodSet) m_timerPeriodSet = (timeBeginPeriod(1) == TIMERR_NOERROR);
+#endif
+    m_last = Clock::now();
+    m_next = m_last + m_period;
+    m_ticks = 0;
+    m_overruns = 0;
+    m_skipped = 0;
+}
+
+// ============================================================
+// WaitNextTick - 次のティックの時刻まで待つ
+// ============================================================
+double FixedTickClock::WaitNextTick() {
+    Clock::time_point now = Clock::now();
+    if (now >= m_next) {
+        ++m_overruns;
+        // 大きく遅れたら（ブレークポイントや高負荷）追いつこうとせずに数え直す
+        if (now - m_next > m_period * MAX_BEHIND_TICKS) {
+            m_skipped += (uint64_t)((now - m_next) / m_period);
+            m_next = now;
+        }
+    } else {
+        // 期限の手前まではスリープ、残りはyieldで待つ
+        const Clock::duration margin = SpinMargin();
+        if (m_next - now > margin) {
+            std::this_thread::sleep_for(m_next - now - margin);
+        }
+        while ((now = Clock::now()) < m_next) {
+            std::this_thread::yield();
+        }
+    }
+
+    const double elapsed = std::chrono::duration<double>(now - m_last).count();
+    m_last = now;
+    m_next += m_period;
+    ++m_ticks;
+    return elapsed;
+}
+
+double FixedTickClock::GetPeriodSeconds() const {
+    return std::chrono::duration<double>(m_period).count();
+}
+
+} // namespace Server
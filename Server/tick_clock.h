@@ -0,0 +1,59 @@
+/*********************************************************************
+ * \file   tick_clock.h
+ * \brief  一定間隔のティックを刻む時計（専用サーバーのメインループ用）
+ *
+ * \author Ryoto Kikuchi
+ * \date   2026/10/16
+ *********************************************************************/
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace Server {
+
+// ============================================================
+// FixedTickClock クラス
+// 期限の少し手前まではOSのスリープで待ち、残りはyieldしながら待つ。
+// スリープだけだとOSのタイマー精度（Windowsの既定は約15.6ms）で遅れ、
+// 待ち続けるとCPUを1コア使い切るので、その間を取る。
+// 期限は前の期限から1周期ずつ進めるので、処理時間がばらついても平均の間隔はずれない。
+// ============================================================
+class FixedTickClock {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    // 遅れがこの周期数を超えたら追いつくのを諦めて、今から数え直す
+    static const int MAX_BEHIND_TICKS = 5;
+
+    explicit FixedTickClock(int ticksPerSecond);
+    ~FixedTickClock();
+    FixedTickClock(const FixedTickClock&) = delete;
+    FixedTickClock& operator=(const FixedTickClock&) = delete;
+
+    // 最初のティックの時刻を今にする
+    void Start();
+
+    // 次のティックの時刻まで待つ
+    // 戻り値: 前回のティックからの経過秒（処理が遅れた場合は周期より長い）
+    double WaitNextTick();
+
+    double GetPeriodSeconds() const;
+    uint64_t GetTickCount() const { return m_ticks; }
+    uint64_t GetOverruns() const { return m_overruns; }       // 期限を過ぎてから待ちに入った回数
+    uint64_t GetSkippedTicks() const { return m_skipped; }    // 遅れすぎて飛ばしたティック数
+
+private:
+    // 期限の手前、スリープをやめてyieldに切り替える時間
+    static Clock::duration SpinMargin();
+
+    Clock::duration m_period;
+    Clock::time_point m_next;
+    Clock::time_point m_last;
+    uint64_t m_ticks = 0;
+    uint64_t m_overruns = 0;
+    uint64_t m_skipped = 0;
+    bool m_timerPeriodSet = false;
+};
+
+} // namespace Server
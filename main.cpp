@@ -11,6 +11,7 @@
 #include "Engine/Input/keyboard.h"
 #include "Engine/Input/mouse.h"
 #include "Engine/Core/timer.h"
+#include "NetWork/link_scenario.h"
 #include <Windows.h>
 
 //===================================
@@ -44,6 +45,17 @@ std::vector<std::shared_ptr<Game::GameObject>>& GetWorldObjects() {
 int APIENTRY WinMain(HINSTANCE hInstance,
     HINSTANCE hPrevInstance, LPSTR lpCmd, int nCmdShow) {
 
+    // --net-scenario [条件]: ゲームを起動せず、回線状態のシナリオを実行して統計を表示する
+    // 例: --net-scenario latency=80,jitter=20,loss=2,burst=1,count=1000,interval=16
+    if (lpCmd && strstr(lpCmd, "--net-scenario")) {
+        // Windowsアプリなのでコンソールが無い。起動元のコンソールに繋ぐか、新しく開く
+        if (!AttachConsole(ATTACH_PARENT_PROCESS)) AllocConsole();
+        FILE* fp = nullptr;
+        freopen_s(&fp, "CONOUT$", "w", stdout);
+        freopen_s(&fp, "CONOUT$", "w", stderr);
+        return run_link_scenario(LinkScenario::parse(lpCmd));
+    }
+
     HRESULT hr = CoInitializeEx(nullptr, COINITBASE_MULTITHREADED);
 
     WNDCLASS	wc;
@@ -1,5 +1,5 @@
 /*********************************************************************
-  \file    ʃwb_[ [main.h]
+  \file    共通ヘッダー [main.h]
   
   \Author  Ryoto Kikuchi
   \data    2025/9/29
@@ -9,7 +9,7 @@
 #pragma warning(push)
 #pragma warning(disable:4005)
 
-#define _CRT_SECURE_NO_WARNINGS			// scanf warningh~
+#define _CRT_SECURE_NO_WARNINGS			// scanf のwarning防止
 #include <stdio.h>
 
 // Ensure winsock2 is included before any windows.h to avoid conflicts with winsock.h
@@ -22,7 +22,7 @@
 #include <d3d11.h>
 #include <d3dcompiler.h>
 
-#define DIRECTINPUT_VERSION 0x0800		// xΏ
+#define DIRECTINPUT_VERSION 0x0800		// 警告対処
 #include "dinput.h"
 #include "mmsystem.h"
 
@@ -33,13 +33,13 @@ using namespace DirectX;
 
 
 //*****************************************************************************
-// }N`
+// マクロ定義
 //*****************************************************************************
-static constexpr int SCREEN_WIDTH (1920);			// EChE̕
-static constexpr int SCREEN_HEIGHT (1080);				// EChE̍
+static constexpr int SCREEN_WIDTH (1920);			// ウインドウの幅
+static constexpr int SCREEN_HEIGHT (1080);				// ウインドウの高さ
 
 
 //*****************************************************************************
-// vg^Cv錾
+// プロトタイプ宣言
 //*****************************************************************************
 
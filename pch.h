@@ -1,6 +1,6 @@
 /*********************************************************************
   \file    pch.h
-  \brief   vRpCς݃wb_[
+  \brief   プリコンパイル済みヘッダー
   \author  Ryoto Kikuchi
   \date    2025
  *********************************************************************/
@@ -8,6 +8,7 @@
 #define PCH_H
 
 // Winsock must come first
+#ifdef _WIN32
 #ifndef WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN
 #endif
@@ -18,12 +19,15 @@
 #include <winsock2.h>
 #include <ws2tcpip.h>
 #include <windows.h>
+#endif
 
-// DirectX
+// DirectX（専用サーバーは描画しないので持たない。ベクトル型はEngine/Core/math_types.h）
+#ifndef DEDICATED_SERVER
 #include <d3d11.h>
 #include <d3dcompiler.h>
 #include <DirectXMath.h>
 #include <wrl/client.h>
+#endif
 
 // C/C++ Standard
 #include <cstdint>